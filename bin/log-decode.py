@@ -0,0 +1,271 @@
+#!/usr/bin/env python3
+"""Turn binary log records (src/BinaryLog.h) back into the usual log lines.
+
+The format strings are read out of the firmware ELF the records came from, so pass the matching firmware.elf (or the
+meshtasticd binary).  Anything in the capture that isn't a binary record, such as output from before the log was
+switched to binary, is passed through unchanged.
+"""
+
+import argparse
+import os
+import re
+import struct
+import sys
+
+START1 = 0x94
+START2 = 0xC5
+VERSION = 1
+SYNC, THREAD, FORMAT, TEXT = 1, 2, 3, 4
+RELATIVE = 0x01
+NO_THREAD = 0xFF
+
+LEVELS = ["CRIT ", "ERROR", "WARN ", "INFO ", "DEBUG", "TRACE"]
+
+SPEC = re.compile(r"%([-+ #0]*)(\*|\d*)(?:\.(\*|\d*))?(hh|h|ll|l|j|z|t|L)?([diouxXcpsnfFeEgGaA%])")
+
+
+class Elf:
+    """Just enough of an ELF file to read strings at link time addresses"""
+
+    def __init__(self, path):
+        with open(path, "rb") as f:
+            self.data = f.read()
+        if self.data[:4] != b"\x7fELF":
+            raise ValueError(f"{path} isn't an ELF file")
+        is64 = self.data[4] == 2
+        endian = "<" if self.data[5] == 1 else ">"
+        if is64:
+            phoff, phentsize, phnum = (
+                struct.unpack_from(endian + "Q", self.data, 0x20)[0],
+                *struct.unpack_from(endian + "HH", self.data, 0x36),
+            )
+        else:
+            phoff, phentsize, phnum = (
+                struct.unpack_from(endian + "I", self.data, 0x1C)[0],
+                *struct.unpack_from(endian + "HH", self.data, 0x2A),
+            )
+        self.segments = []  # (vaddr, file offset, size in the file) of each loaded segment
+        for i in range(phnum):
+            at = phoff + i * phentsize
+            if is64:
+                p_type, _, p_offset, p_vaddr, _, p_filesz = struct.unpack_from(endian + "IIQQQQ", self.data, at)
+            else:
+                p_type, p_offset, p_vaddr, _, p_filesz = struct.unpack_from(endian + "IIIII", self.data, at)
+            if p_type == 1 and p_filesz:  # PT_LOAD
+                self.segments.append((p_vaddr, p_offset, p_filesz))
+        if not self.segments:
+            raise ValueError(f"{path} has nothing loaded")
+        self.start = min(s[0] for s in self.segments)
+        self.cache = {}
+
+    def string(self, addr):
+        if addr in self.cache:
+            return self.cache[addr]
+        s = None
+        for vaddr, offset, size in self.segments:
+            if vaddr <= addr < vaddr + size:
+                begin = offset + addr - vaddr
+                end = self.data.find(b"\0", begin, offset + size)
+                s = self.data[begin : end if end >= 0 else offset + size].decode("utf-8", "replace")
+                break
+        self.cache[addr] = s
+        return s
+
+
+class Reader:
+    def __init__(self, data):
+        self.data = data
+        self.pos = 0
+
+    def byte(self):
+        if self.pos >= len(self.data):
+            raise ValueError("Record cut short")
+        self.pos += 1
+        return self.data[self.pos - 1]
+
+    def varint(self):
+        v = 0
+        shift = 0
+        while True:
+            b = self.byte()
+            v |= (b & 0x7F) << shift
+            if not b & 0x80:
+                return v
+            shift += 7
+
+    def zigzag(self):
+        v = self.varint()
+        return (v >> 1) ^ -(v & 1)
+
+    def real(self):
+        if self.pos + 8 > len(self.data):
+            raise ValueError("Record cut short")
+        self.pos += 8
+        return struct.unpack_from("<d", self.data, self.pos - 8)[0]
+
+    def string(self):
+        end = self.data.find(b"\0", self.pos)
+        if end < 0:
+            raise ValueError("Record cut short")
+        s = self.data[self.pos : end].decode("utf-8", "replace")
+        self.pos = end + 1
+        return s
+
+    def rest(self):
+        s = self.data[self.pos :].decode("utf-8", "replace")
+        self.pos = len(self.data)
+        return s
+
+
+def render(fmt, r):
+    """printf, with the arguments read in the order BinaryLog::encodeArgs wrote them"""
+
+    def one(m):
+        flags, width, precision, _, conv = m.groups()
+        if conv == "%":
+            return "%"
+        if width == "*":
+            width = str(r.zigzag())
+        if precision == "*":
+            precision = str(r.zigzag())
+        spec = "%" + flags + width + ("." + precision if precision is not None else "")
+        if conv in "di":
+            return (spec + "d") % r.zigzag()
+        if conv == "u":
+            return (spec + "d") % r.varint()
+        if conv in "oxX":
+            return (spec + conv) % r.varint()
+        if conv == "c":
+            return (spec + "c") % chr(r.varint())
+        if conv == "p":
+            v = r.varint()
+            return (spec + "s") % (f"0x{v:x}" if v else "(nil)")
+        if conv == "s":
+            return (spec + "s") % r.string()
+        if conv == "n":
+            return ""
+        v = r.real()
+        if conv in "aA":
+            s = v.hex()
+            return (spec + "s") % (s.upper() if conv == "A" else s)
+        return (spec + conv) % v
+
+    return SPEC.sub(one, fmt)
+
+
+class Decoder:
+    def __init__(self, elf, out):
+        self.elf = elf
+        self.out = out
+        self.buf = b""
+        self.synced = False
+        self.base = 0
+        self.millis = 0
+        self.syncMillis = 0
+        self.rtcSec = 0
+        self.threads = {}
+
+    def feed(self, data):
+        self.buf += data
+        while True:
+            at = self.buf.find(bytes([START1]))
+            if at < 0:
+                self.passthrough(self.buf)
+                self.buf = b""
+                return
+            self.passthrough(self.buf[:at])
+            self.buf = self.buf[at:]
+            if len(self.buf) < 4:
+                return
+            if self.buf[1] != START2:
+                self.passthrough(self.buf[:1])
+                self.buf = self.buf[1:]
+                continue
+            length = self.buf[2]
+            header = 3
+            if length & 0x80:
+                length = (length & 0x7F) | (self.buf[3] << 7)
+                header = 4
+            if len(self.buf) < header + length:
+                return
+            payload = self.buf[header : header + length]
+            self.buf = self.buf[header + length :]
+            try:
+                self.record(payload)
+            except ValueError as e:
+                self.out.write(f"?? bad log record: {e}\n")
+
+    def passthrough(self, data):
+        if data:
+            self.out.write(data.decode("utf-8", "replace"))
+
+    def record(self, payload):
+        r = Reader(payload)
+        first = r.byte()
+        kind, level = first >> 4, first & 0x0F
+        if kind == SYNC:
+            version = r.byte()
+            if version != VERSION:
+                raise ValueError(f"version {version}, this decoder knows {VERSION}")
+            flags = r.byte()
+            base = r.varint()
+            self.base = self.elf.start + base if flags & RELATIVE else base
+            self.millis = self.syncMillis = r.varint()
+            self.rtcSec = r.varint()
+            self.synced = True
+        elif kind == THREAD:
+            index = r.byte()
+            self.threads[index] = r.rest()
+        elif kind in (FORMAT, TEXT):
+            self.millis = (self.millis + r.zigzag()) & 0xFFFFFFFF
+            thread = r.byte()
+            if kind == TEXT:
+                text = r.rest()
+            elif not self.synced:
+                text = "(format id before the first sync record)"
+            else:
+                addr = self.base + r.varint()
+                fmt = self.elf.string(addr)
+                text = render(fmt, r) if fmt is not None else f"(no format string at 0x{addr:x}, wrong ELF?)"
+            self.line(level, thread, text.rstrip("\n"))
+        else:
+            raise ValueError(f"unknown type {kind}")
+
+    def line(self, level, thread, text):
+        name = LEVELS[level] if level < len(LEVELS) else f"L{level}   "
+        if self.rtcSec:
+            hms = (self.rtcSec + (self.millis - self.syncMillis) // 1000) % 86400
+            clock = f"{hms // 3600:02d}:{hms % 3600 // 60:02d}:{hms % 60:02d}"
+        else:
+            clock = "??:??:??"
+        prefix = f"[{self.threads.get(thread, '?')}] " if thread != NO_THREAD else ""
+        self.out.write(f"{name} | {clock} {self.millis // 1000} {prefix}{text}\n")
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Decode Meshtastic binary log records")
+    parser.add_argument("elf", help="firmware.elf or meshtasticd binary that wrote the log")
+    parser.add_argument("file", nargs="?", help="captured log or serial device, - for stdin")
+    args = parser.parse_args()
+
+    try:
+        decoder = Decoder(Elf(args.elf), sys.stdout)
+    except (OSError, ValueError) as e:
+        sys.exit(str(e))
+    if args.file == "-" or args.file is None:
+        fd = sys.stdin.fileno()
+    else:
+        fd = os.open(args.file, os.O_RDONLY)
+    try:
+        while True:
+            data = os.read(fd, 4096)
+            if not data:
+                break
+            decoder.feed(data)
+            sys.stdout.flush()
+    except KeyboardInterrupt:
+        pass
+
+
+if __name__ == "__main__":
+    main()
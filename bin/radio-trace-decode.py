@@ -0,0 +1,149 @@
+#!/usr/bin/env python3
+"""Decode a radio event trace (src/mesh/RadioTrace.h) into a readable timeline.
+
+Get a trace with XModem (file /radiotrace.bin) or from meshtasticd with
+    curl -k https://localhost/api/v1/radiotrace -o radiotrace.bin
+
+The timeline ends with a summary of the transmitter's active periods: transmissions less than --gap apart count as one,
+since the radio (and the CPU) stay awake in between.  Each period pays the wake and ramp up costs once, which is what
+batching our own broadcasts (TX_BATCH events) saves.
+"""
+
+import argparse
+import struct
+import sys
+
+MAGIC = 0x5452544D
+HEADER = struct.Struct("<IHHIII")
+EVENT = struct.Struct("<IBBHI")
+
+# Keep in sync with RadioTraceEventType
+EVENT_NAMES = [
+    "NONE",
+    "RX_ISR",
+    "TX_ISR",
+    "RX_START",
+    "RX_DONE",
+    "RX_BAD",
+    "TX_DELAY",
+    "CHANNEL_BUSY",
+    "TX_START",
+    "TX_DONE",
+    "TX_CANCEL",
+    "TX_BATCH",
+]
+
+# Keep in sync with RadioTraceCancelReason
+CANCEL_REASONS = ["other", "relayed", "acked", "filtered", "superseded"]
+CANCEL_REMOVED = 0x80
+
+
+def describe(name, arg16, arg32):
+    if name in ("RX_ISR", "TX_ISR"):
+        return f"handled after {arg32}us"
+    if name == "RX_DONE":
+        return f"len={arg16} id=0x{arg32:08x}"
+    if name == "RX_BAD":
+        return f"error/len={struct.unpack('<h', struct.pack('<H', arg16))[0]}"
+    if name == "TX_DELAY":
+        return f"delay={arg16}ms id=0x{arg32:08x}"
+    if name == "TX_START":
+        return f"airtime={arg16}ms id=0x{arg32:08x}"
+    if name == "TX_DONE":
+        return f"id=0x{arg32:08x}"
+    if name == "TX_CANCEL":
+        reason = arg16 & ~CANCEL_REMOVED
+        reason = CANCEL_REASONS[reason] if reason < len(CANCEL_REASONS) else str(reason)
+        removed = "removed" if arg16 & CANCEL_REMOVED else "not queued"
+        return f"id=0x{arg32:08x} reason={reason} ({removed})"
+    if name == "TX_BATCH":
+        return f"packets={arg16}"
+    return ""
+
+
+def summarize(rows, out, gap_ms):
+    """Transmitter active periods and airtime, per hour of the trace"""
+    periods = packets = airtime = batches = 0
+    last_done = None
+    for t, type_, _, arg16, _ in rows:
+        name = EVENT_NAMES[type_] if type_ < len(EVENT_NAMES) else None
+        if name == "TX_START":
+            if last_done is None or t - last_done > gap_ms * 1000:
+                periods += 1
+            packets += 1
+            airtime += arg16
+            last_done = t
+        elif name == "TX_DONE":
+            last_done = t
+        elif name == "TX_BATCH" and arg16 > 1:
+            batches += 1
+    if not packets or not rows:
+        out.write("No transmissions in the trace\n")
+        return
+    hours = max(rows[-1][0] - rows[0][0], 1) / 3600e6
+    out.write(f"{packets} transmissions in {periods} active periods ({batches} batches of our own packets)\n")
+    out.write(f"per hour: {periods / hours:.1f} active periods, {packets / hours:.1f} transmissions, "
+              f"{airtime / hours / 1000:.2f}s airtime\n")
+
+
+def signed32(delta):
+    """Difference of two 32 bit timestamps, as a signed value"""
+    delta &= 0xFFFFFFFF
+    return delta - (1 << 32) if delta & 0x80000000 else delta
+
+
+def decode(data, out, gap_ms=1000):
+    if len(data) < HEADER.size:
+        raise ValueError("File too short for a radio trace header")
+    magic, version, event_size, num_events, total_events, now_usec = HEADER.unpack_from(data)
+    if magic != MAGIC:
+        raise ValueError(f"Bad magic 0x{magic:08x}, not a radio trace")
+    if version not in (1, 2) or event_size < EVENT.size:
+        raise ValueError(f"Unsupported trace version {version} (event size {event_size})")
+
+    num_events = min(num_events, (len(data) - HEADER.size) // event_size)
+    out.write(f"{num_events} events ({total_events - num_events} older ones overwritten)\n")
+
+    # micros() wraps every ~71 minutes, so unwrap relative to the previous event.  Version 1 stamped ISR events with the
+    # time of the interrupt, a little before events recorded ahead of handling it, so its deltas can be negative
+    step = signed32 if version == 1 else lambda delta: delta & 0xFFFFFFFF
+    t = 0
+    prev_raw = None
+    rows = []
+    for i in range(num_events):
+        raw, type_, depth, arg16, arg32 = EVENT.unpack_from(data, HEADER.size + i * event_size)
+        if prev_raw is not None:
+            t += step(raw - prev_raw)
+        prev_raw = raw
+        rows.append((t, type_, depth, arg16, arg32))
+    end = t + step(now_usec - prev_raw) if prev_raw is not None else 0
+
+    prev_t = None
+    for t, type_, depth, arg16, arg32 in rows:
+        name = EVENT_NAMES[type_] if type_ < len(EVENT_NAMES) else f"TYPE_{type_}"
+        delta = "" if prev_t is None else f"{(t - prev_t) / 1000:+.3f}"
+        prev_t = t
+        line = f"{(t - end) / 1000:12.3f}ms {delta:>12} q={depth:<2} {name:<13} {describe(name, arg16, arg32)}"
+        out.write(line.rstrip() + "\n")
+    summarize(rows, out, gap_ms)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Decode a Meshtastic radio event trace")
+    parser.add_argument("file", help="trace file, - for stdin")
+    parser.add_argument("--gap", type=int, default=1000, help="msecs between transmissions that still count as one period")
+    args = parser.parse_args()
+
+    if args.file == "-":
+        data = sys.stdin.buffer.read()
+    else:
+        with open(args.file, "rb") as f:
+            data = f.read()
+    try:
+        decode(data, sys.stdout, args.gap)
+    except ValueError as e:
+        sys.exit(str(e))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,122 @@
+#!/usr/bin/env python3
+"""Decode a telemetry history batch (src/modules/Telemetry/TelemetryHistory.h) into a table.
+
+Pass the payload of a packet on the telemetry history port, as a file or as hex with --hex.
+"""
+
+import argparse
+import datetime
+import sys
+
+VERSION = 1
+BATCH = 1
+MORE = 0x80
+
+# Keep in sync with TelemetryHistoryMetric: name, unit, scale
+METRICS = [
+    ("battery_level", "%", 1),
+    ("voltage", "V", 1000),
+    ("channel_utilization", "%", 100),
+    ("air_util_tx", "%", 100),
+    ("temperature", "C", 100),
+    ("relative_humidity", "%", 100),
+    ("barometric_pressure", "hPa", 100),
+    ("gas_resistance", "MOhm", 100),
+    ("iaq", "", 1),
+    ("lux", "lx", 100),
+    ("env_voltage", "V", 1000),
+    ("env_current", "mA", 100),
+    ("ch1_voltage", "V", 1000),
+    ("ch1_current", "mA", 100),
+    ("ch2_voltage", "V", 1000),
+    ("ch2_current", "mA", 100),
+    ("ch3_voltage", "V", 1000),
+    ("ch3_current", "mA", 100),
+]
+
+
+class Reader:
+    def __init__(self, data):
+        self.data = data
+        self.pos = 0
+
+    def byte(self):
+        if self.pos >= len(self.data):
+            raise ValueError("Batch cut short")
+        self.pos += 1
+        return self.data[self.pos - 1]
+
+    def varint(self):
+        v = 0
+        shift = 0
+        while True:
+            b = self.byte()
+            v |= (b & 0x7F) << shift
+            if not b & 0x80:
+                return v
+            shift += 7
+
+    def zigzag(self):
+        v = self.varint()
+        return (v >> 1) ^ -(v & 1)
+
+    def done(self):
+        return self.pos >= len(self.data)
+
+
+def format_time(secs):
+    # Without a valid clock the node counts from boot
+    if secs < 1000000000:
+        return f"+{secs}s"
+    return datetime.datetime.fromtimestamp(secs, datetime.timezone.utc).strftime("%Y-%m-%d %H:%M")
+
+
+def decode(data, out):
+    r = Reader(data)
+    version = r.byte()
+    kind = r.byte()
+    if version != VERSION or (kind & ~MORE) != BATCH:
+        raise ValueError(f"Not a telemetry history batch (version {version}, type {kind})")
+    period = r.varint()
+    if kind & MORE:
+        out.write("Partial batch, request the missing metrics for the rest\n")
+
+    while not r.done():
+        metric = r.byte()
+        name, unit, scale = METRICS[metric] if metric < len(METRICS) else (f"metric_{metric}", "", 1)
+        number = r.varint()
+        count = r.varint()
+        avg = 0
+        out.write(f"{name} ({unit or '-'}), {period}s buckets\n")
+        for i in range(count):
+            skip = r.varint()
+            number += (skip >> 1) + (1 if i else 0)
+            avg += r.zigzag()
+            lo = hi = avg
+            if skip & 1:
+                lo = avg - r.varint()
+                hi = avg + r.varint()
+            out.write(f"  {format_time(number * period):>16}  min {lo / scale:10.2f}  avg {avg / scale:10.2f}  max {hi / scale:10.2f}\n")
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Decode a Meshtastic telemetry history batch")
+    parser.add_argument("file", nargs="?", help="payload file, - for stdin")
+    parser.add_argument("--hex", help="payload as a hex string instead of a file")
+    args = parser.parse_args()
+
+    if args.hex:
+        data = bytes.fromhex(args.hex)
+    elif args.file == "-" or args.file is None:
+        data = sys.stdin.buffer.read()
+    else:
+        with open(args.file, "rb") as f:
+            data = f.read()
+    try:
+        decode(data, sys.stdout)
+    except ValueError as e:
+        sys.exit(str(e))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,100 @@
+#!/usr/bin/env python3
+"""Decode a thread stats report (src/modules/ThreadStatsModule.h) into a table.
+
+Pass the payload of a packet on the thread stats port, as a file or as hex with --hex.  After the table comes the wakeup
+budget: the threads that keep the CPU from sleeping, most wakeups per hour first.
+"""
+
+import argparse
+import sys
+
+VERSION = 2
+REPORT = 1
+MORE = 0x80
+
+
+class Reader:
+    def __init__(self, data):
+        self.data = data
+        self.pos = 0
+
+    def byte(self):
+        if self.pos >= len(self.data):
+            raise ValueError("Report cut short")
+        self.pos += 1
+        return self.data[self.pos - 1]
+
+    def varint(self):
+        v = 0
+        shift = 0
+        while True:
+            b = self.byte()
+            v |= (b & 0x7F) << shift
+            if not b & 0x80:
+                return v
+            shift += 7
+
+    def string(self):
+        end = self.data.find(b"\0", self.pos)
+        if end < 0:
+            raise ValueError("Report cut short")
+        s = self.data[self.pos : end].decode("utf-8", "replace")
+        self.pos = end + 1
+        return s
+
+    def done(self):
+        return self.pos >= len(self.data)
+
+
+def decode(data, out):
+    r = Reader(data)
+    version = r.byte()
+    kind = r.byte()
+    if version != VERSION or (kind & ~MORE) != REPORT:
+        raise ValueError(f"Not a thread stats report (version {version}, type {kind})")
+    counted = r.varint()
+    count = r.varint()
+    out.write(f"Counted over {counted}s, {count} threads\n")
+    out.write(f"{'thread':<13} {'runs':>9} {'total ms':>10} {'busy':>6} {'max us':>9} {'avg late':>9} {'max late':>9}\n")
+    budget = []
+    while not r.done():
+        name = r.string()
+        runs = r.varint()
+        total = r.varint()
+        max_us = r.varint()
+        avg_late = r.varint()
+        max_late = r.varint()
+        wakeups = r.varint()
+        busy = total / 10 / counted if counted else 0
+        out.write(f"{name:<13} {runs:>9} {total:>10} {busy:>5.1f}% {max_us:>9} {avg_late:>7}ms {max_late:>7}ms\n")
+        budget.append((wakeups * 3600 / counted if counted else 0, name))
+    if kind & MORE:
+        out.write(f"{count - len(budget)} less busy threads didn't fit\n")
+
+    out.write(f"\nWakeup budget, {sum(b[0] for b in budget):.0f} wakeups/hour\n")
+    for per_hour, name in sorted(budget, reverse=True):
+        if per_hour:
+            out.write(f"{name:<13} {per_hour:>9.0f}/h\n")
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Decode a Meshtastic thread stats report")
+    parser.add_argument("file", nargs="?", help="payload file, - for stdin")
+    parser.add_argument("--hex", help="payload as a hex string instead of a file")
+    args = parser.parse_args()
+
+    if args.hex:
+        data = bytes.fromhex(args.hex)
+    elif args.file == "-" or args.file is None:
+        data = sys.stdin.buffer.read()
+    else:
+        with open(args.file, "rb") as f:
+            data = f.read()
+    try:
+        decode(data, sys.stdout)
+    except ValueError as e:
+        sys.exit(str(e))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,550 @@
+#include "BinaryLog.h"
+#include <algorithm>
+#include <ctype.h>
+#include <stddef.h>
+#include <string.h>
+#include <type_traits>
+
+#ifdef ARCH_ESP32
+#include <soc/soc.h>
+#endif
+#if defined(ARCH_PORTDUINO) && defined(__linux__)
+#include <link.h>
+#endif
+
+// Where the format strings are, anything outside this was built at runtime
+#if defined(ARCH_ESP32)
+#define IMAGE_START ((uintptr_t)SOC_DROM_LOW)
+#define IMAGE_END ((uintptr_t)SOC_DROM_HIGH)
+#elif defined(ARCH_NRF52)
+#define IMAGE_START ((uintptr_t)0x00000000)
+#define IMAGE_END ((uintptr_t)0x00100000)
+#elif defined(ARCH_RP2040)
+#define IMAGE_START ((uintptr_t)0x10000000) // XIP flash
+#define IMAGE_END ((uintptr_t)0x11000000)
+#elif defined(ARCH_STM32WL)
+#define IMAGE_START ((uintptr_t)0x08000000)
+#define IMAGE_END ((uintptr_t)0x08040000)
+#elif defined(ARCH_PORTDUINO) && defined(__linux__)
+// Provided by the linker.  The executable may be loaded anywhere, so ids count from its start.  Only the read-only
+// segments of it are used, the writable ones hold buffers whose contents the decoder can't know.
+extern "C" char __executable_start[];
+#define IMAGE_START ((uintptr_t)__executable_start)
+#define IMAGE_RELATIVE
+#define IMAGE_SEGMENTS 4
+#endif
+
+#ifdef IMAGE_SEGMENTS
+/// Address ranges of the executable's read-only PT_LOAD segments, .rodata is in one of them
+struct ImageSegments {
+    uintptr_t start[IMAGE_SEGMENTS], end[IMAGE_SEGMENTS];
+    int count = 0;
+};
+
+static int findReadOnlySegments(struct dl_phdr_info *info, size_t size, void *data)
+{
+    (void)size;
+    ImageSegments *segs = (ImageSegments *)data;
+    for (int i = 0; i < info->dlpi_phnum && segs->count < IMAGE_SEGMENTS; i++) {
+        const ElfW(Phdr) &ph = info->dlpi_phdr[i];
+        if (ph.p_type == PT_LOAD && !(ph.p_flags & PF_W)) {
+            segs->start[segs->count] = info->dlpi_addr + ph.p_vaddr;
+            segs->end[segs->count] = segs->start[segs->count] + ph.p_memsz;
+            segs->count++;
+        }
+    }
+    return 1; // the executable itself is always reported first, we don't care about the libraries
+}
+
+static bool inImage(uintptr_t p)
+{
+    static const ImageSegments segs = [] {
+        ImageSegments s;
+        dl_iterate_phdr(findReadOnlySegments, &s);
+        return s;
+    }();
+    for (int i = 0; i < segs.count; i++)
+        if (p >= segs.start[i] && p < segs.end[i])
+            return true;
+    return false;
+}
+#elif defined(IMAGE_START)
+static bool inImage(uintptr_t p)
+{
+    return p >= IMAGE_START && p < IMAGE_END;
+}
+#endif
+
+typedef std::make_signed<size_t>::type ssize_type;
+typedef std::make_unsigned<ptrdiff_t>::type uptrdiff_type;
+
+enum LengthModifier : uint8_t { MOD_NONE, MOD_HH, MOD_H, MOD_L, MOD_LL, MOD_J, MOD_Z, MOD_T, MOD_LONG_DOUBLE };
+
+/// One printf conversion
+struct Spec {
+    const char *start; // the %
+    const char *end;   // just after the conversion character
+    bool starWidth, starPrecision;
+    int precision; // -1 if there is none, or it comes from an argument
+    LengthModifier mod;
+    char conv;
+};
+
+/// Parse the conversion at p, @return false if it isn't one we know
+static bool parseSpec(const char *p, Spec &s)
+{
+    s.start = p++;
+    while (*p && strchr("-+ #0", *p))
+        p++;
+    s.starWidth = *p == '*';
+    if (s.starWidth)
+        p++;
+    while (isdigit((unsigned char)*p))
+        p++;
+    s.starPrecision = false;
+    s.precision = -1;
+    if (*p == '.') {
+        p++;
+        s.starPrecision = *p == '*';
+        if (s.starPrecision) {
+            p++;
+        } else {
+            s.precision = 0;
+            while (isdigit((unsigned char)*p))
+                s.precision = s.precision * 10 + (*p++ - '0');
+        }
+    }
+    s.mod = MOD_NONE;
+    switch (*p) {
+    case 'h':
+        s.mod = p[1] == 'h' ? MOD_HH : MOD_H;
+        p += s.mod == MOD_HH ? 2 : 1;
+        break;
+    case 'l':
+        s.mod = p[1] == 'l' ? MOD_LL : MOD_L;
+        p += s.mod == MOD_LL ? 2 : 1;
+        break;
+    case 'j':
+        s.mod = MOD_J;
+        p++;
+        break;
+    case 'z':
+        s.mod = MOD_Z;
+        p++;
+        break;
+    case 't':
+        s.mod = MOD_T;
+        p++;
+        break;
+    case 'L':
+        s.mod = MOD_LONG_DOUBLE;
+        p++;
+        break;
+    }
+    s.conv = *p;
+    s.end = p + 1;
+    return s.conv && strchr("diouxXcpsnfFeEgGaA%", s.conv);
+}
+
+namespace
+{
+struct Writer {
+    uint8_t *p, *end;
+    bool ok;
+
+    Writer(uint8_t *buf, uint8_t *bufEnd) : p(buf), end(bufEnd), ok(true) {}
+
+    void byte(uint8_t b)
+    {
+        if (p < end)
+            *p++ = b;
+        else
+            ok = false;
+    }
+    void varint(uint64_t v)
+    {
+        while (v >= 0x80) {
+            byte(v | 0x80);
+            v >>= 7;
+        }
+        byte(v);
+    }
+    void zigzag(int64_t v) { varint(((uint64_t)v << 1) ^ (uint64_t)(v >> 63)); }
+    void bytes(const void *b, size_t n)
+    {
+        if ((size_t)(end - p) < n) {
+            ok = false;
+            return;
+        }
+        memcpy(p, b, n);
+        p += n;
+    }
+    void real(double d)
+    {
+        uint64_t bits;
+        memcpy(&bits, &d, sizeof(bits));
+        for (int i = 0; i < 8; i++)
+            byte(bits >> (8 * i));
+    }
+};
+
+struct Reader {
+    const uint8_t *p, *end;
+
+    Reader(const uint8_t *buf, size_t len) : p(buf), end(buf + len) {}
+
+    uint64_t varint()
+    {
+        uint64_t v = 0;
+        for (int shift = 0; p < end && shift < 64; shift += 7) {
+            uint8_t b = *p++;
+            v |= (uint64_t)(b & 0x7f) << shift;
+            if (!(b & 0x80))
+                break;
+        }
+        return v;
+    }
+    int64_t zigzag()
+    {
+        uint64_t v = varint();
+        return (int64_t)(v >> 1) ^ -(int64_t)(v & 1);
+    }
+    double real()
+    {
+        uint64_t bits = 0;
+        for (int i = 0; i < 8 && p < end; i++)
+            bits |= (uint64_t)*p++ << (8 * i);
+        double d;
+        memcpy(&d, &bits, sizeof(d));
+        return d;
+    }
+    const char *string()
+    {
+        const char *s = (const char *)p;
+        const uint8_t *nul = (const uint8_t *)memchr(p, 0, end - p);
+        if (!nul) {
+            p = end;
+            return "";
+        }
+        p = nul + 1;
+        return s;
+    }
+};
+} // namespace
+
+static int64_t getSigned(va_list *ap, LengthModifier mod)
+{
+    switch (mod) {
+    case MOD_HH:
+        return (signed char)va_arg(*ap, int);
+    case MOD_H:
+        return (short)va_arg(*ap, int);
+    case MOD_L:
+        return va_arg(*ap, long);
+    case MOD_LL:
+        return va_arg(*ap, long long);
+    case MOD_J:
+        return va_arg(*ap, intmax_t);
+    case MOD_Z:
+        return va_arg(*ap, ssize_type);
+    case MOD_T:
+        return va_arg(*ap, ptrdiff_t);
+    default:
+        return va_arg(*ap, int);
+    }
+}
+
+static uint64_t getUnsigned(va_list *ap, LengthModifier mod)
+{
+    switch (mod) {
+    case MOD_HH:
+        return (unsigned char)va_arg(*ap, unsigned int);
+    case MOD_H:
+        return (unsigned short)va_arg(*ap, unsigned int);
+    case MOD_L:
+        return va_arg(*ap, unsigned long);
+    case MOD_LL:
+        return va_arg(*ap, unsigned long long);
+    case MOD_J:
+        return va_arg(*ap, uintmax_t);
+    case MOD_Z:
+        return va_arg(*ap, size_t);
+    case MOD_T:
+        return va_arg(*ap, uptrdiff_type);
+    default:
+        return va_arg(*ap, unsigned int);
+    }
+}
+
+// Pass the value as the type the conversion expects, hh and h are promoted to int anyway
+static int printSigned(char *buf, size_t len, const char *spec, LengthModifier mod, int64_t v)
+{
+    switch (mod) {
+    case MOD_L:
+        return snprintf(buf, len, spec, (long)v);
+    case MOD_LL:
+        return snprintf(buf, len, spec, (long long)v);
+    case MOD_J:
+        return snprintf(buf, len, spec, (intmax_t)v);
+    case MOD_Z:
+        return snprintf(buf, len, spec, (ssize_type)v);
+    case MOD_T:
+        return snprintf(buf, len, spec, (ptrdiff_t)v);
+    default:
+        return snprintf(buf, len, spec, (int)v);
+    }
+}
+
+static int printUnsigned(char *buf, size_t len, const char *spec, LengthModifier mod, uint64_t v)
+{
+    switch (mod) {
+    case MOD_L:
+        return snprintf(buf, len, spec, (unsigned long)v);
+    case MOD_LL:
+        return snprintf(buf, len, spec, (unsigned long long)v);
+    case MOD_J:
+        return snprintf(buf, len, spec, (uintmax_t)v);
+    case MOD_Z:
+        return snprintf(buf, len, spec, (size_t)v);
+    case MOD_T:
+        return snprintf(buf, len, spec, (uptrdiff_type)v);
+    default:
+        return snprintf(buf, len, spec, (unsigned int)v);
+    }
+}
+
+bool BinaryLog::formatId(const char *format, uint32_t &id)
+{
+#ifdef IMAGE_START
+    uintptr_t p = (uintptr_t)format;
+    if (!inImage(p))
+        return false;
+    id = p - IMAGE_START;
+    return true;
+#else
+    (void)format;
+    (void)id;
+    return false;
+#endif
+}
+
+bool BinaryLog::encodeArgs(uint8_t *buf, size_t bufLen, const char *format, va_list arg, size_t &len)
+{
+    Writer w(buf, buf + bufLen);
+    va_list ap;
+    va_copy(ap, arg);
+    Spec s;
+    for (const char *p = format; w.ok && (p = strchr(p, '%')) != NULL; p = s.end) {
+        if (!parseSpec(p, s)) {
+            w.ok = false;
+            break;
+        }
+        if (s.starWidth)
+            w.zigzag(va_arg(ap, int));
+        if (s.starPrecision) {
+            s.precision = va_arg(ap, int);
+            w.zigzag(s.precision);
+        }
+        switch (s.conv) {
+        case 'd':
+        case 'i':
+            w.zigzag(getSigned(&ap, s.mod));
+            break;
+        case 'o':
+        case 'u':
+        case 'x':
+        case 'X':
+            w.varint(getUnsigned(&ap, s.mod));
+            break;
+        case 'c':
+            w.varint((unsigned char)va_arg(ap, int));
+            break;
+        case 'p':
+            w.varint((uintptr_t)va_arg(ap, void *));
+            break;
+        case 's': {
+            const char *str = va_arg(ap, const char *);
+            if (!str)
+                str = "(null)";
+            // With a precision the string needn't be terminated
+            size_t n = s.precision >= 0 ? strnlen(str, s.precision) : strlen(str);
+            w.bytes(str, n);
+            w.byte(0);
+            break;
+        }
+        case 'n':
+            (void)va_arg(ap, void *);
+            break;
+        case '%':
+            break;
+        default:
+            w.real(s.mod == MOD_LONG_DOUBLE ? (double)va_arg(ap, long double) : va_arg(ap, double));
+        }
+    }
+    va_end(ap);
+    len = w.p - buf;
+    return w.ok;
+}
+
+size_t BinaryLog::render(char *buf, size_t bufLen, const char *format, const uint8_t *args, size_t argsLen)
+{
+    Reader r(args, argsLen);
+    size_t pos = 0;
+    Spec s;
+    for (const char *p = format; *p && pos + 1 < bufLen; p = s.end) {
+        const char *pct = strchr(p, '%');
+        size_t literal = std::min(pct ? (size_t)(pct - p) : strlen(p), bufLen - 1 - pos);
+        memcpy(buf + pos, p, literal);
+        pos += literal;
+        if (!pct || !parseSpec(pct, s) || pos + 1 >= bufLen)
+            break;
+        if (s.conv == '%') {
+            buf[pos++] = '%';
+            continue;
+        }
+
+        // The same conversion with the width and precision arguments filled in
+        char spec[32];
+        size_t n = 0;
+        for (const char *q = s.start; q < s.end && n < sizeof(spec) - 12; q++) {
+            if (*q == '*')
+                n += snprintf(spec + n, sizeof(spec) - n, "%d", (int)r.zigzag());
+            else
+                spec[n++] = *q;
+        }
+        spec[n] = '\0';
+
+        char *out = buf + pos;
+        size_t room = bufLen - pos;
+        int written;
+        switch (s.conv) {
+        case 'd':
+        case 'i':
+            written = printSigned(out, room, spec, s.mod, r.zigzag());
+            break;
+        case 'o':
+        case 'u':
+        case 'x':
+        case 'X':
+            written = printUnsigned(out, room, spec, s.mod, r.varint());
+            break;
+        case 'c':
+            written = snprintf(out, room, spec, (int)r.varint());
+            break;
+        case 'p':
+            written = snprintf(out, room, spec, (void *)(uintptr_t)r.varint());
+            break;
+        case 's':
+            written = snprintf(out, room, spec, r.string());
+            break;
+        case 'n':
+            written = 0;
+            break;
+        default:
+            if (s.mod == MOD_LONG_DOUBLE)
+                written = snprintf(out, room, spec, (long double)r.real());
+            else
+                written = snprintf(out, room, spec, r.real());
+        }
+        if (written > 0)
+            pos += std::min((size_t)written, room - 1);
+    }
+    if (bufLen)
+        buf[pos] = '\0';
+    return pos;
+}
+
+/// Turn the payload that was written at out + 4 into a frame, @return the length of the frame
+static size_t finishFrame(uint8_t *out, size_t payloadLen)
+{
+    out[0] = BINARY_LOG_START1;
+    out[1] = BINARY_LOG_START2;
+    if (payloadLen < 0x80) {
+        out[2] = payloadLen;
+        memmove(out + 3, out + 4, payloadLen);
+        return 3 + payloadLen;
+    }
+    out[2] = 0x80 | (payloadLen & 0x7f);
+    out[3] = payloadLen >> 7;
+    return 4 + payloadLen;
+}
+
+uint8_t BinaryLog::threadIndex(const char *name, uint8_t *&out, uint8_t *end)
+{
+    if (!name[0])
+        return BINARY_LOG_NO_THREAD;
+    uint8_t i;
+    for (i = 0; i < BINARY_LOG_THREADS; i++) {
+        if (strcmp(threads[i], name) == 0)
+            break;
+    }
+    if (i == BINARY_LOG_THREADS) {
+        i = nextThread;
+        nextThread = (nextThread + 1) % BINARY_LOG_THREADS;
+        strncpy(threads[i], name, LOG_QUEUE_THREAD_LEN - 1);
+        announced &= ~(1 << i);
+    }
+    if (!(announced & (1 << i)) && end - out > 4) {
+        Writer w(out + 4, end);
+        w.byte(BINARY_LOG_THREAD << 4);
+        w.byte(i);
+        w.bytes(threads[i], strlen(threads[i]));
+        if (w.ok) {
+            out += finishFrame(out, w.p - (out + 4));
+            announced |= 1 << i;
+        }
+    }
+    return i;
+}
+
+size_t BinaryLog::encode(const LogLine &line, uint8_t *buf, size_t bufLen)
+{
+    uint8_t *out = buf, *end = buf + bufLen;
+
+    if (sinceSync >= BINARY_LOG_SYNC_RECORDS) {
+        Writer w(out + 4, end);
+        w.byte(BINARY_LOG_SYNC << 4);
+        w.byte(BINARY_LOG_VERSION);
+#ifdef IMAGE_RELATIVE
+        w.byte(BINARY_LOG_RELATIVE);
+        w.varint(0);
+#else
+        w.byte(0);
+#ifdef IMAGE_START
+        w.varint(IMAGE_START);
+#else
+        w.varint(0);
+#endif
+#endif
+        w.varint(line.millis);
+        w.varint(line.rtcSec);
+        if (!w.ok)
+            return 0;
+        out += finishFrame(out, w.p - (out + 4));
+        announced = 0;
+        sinceSync = 0;
+        lastMillis = line.millis;
+    }
+
+    uint8_t thread = threadIndex(line.thread, out, end);
+    uint32_t id;
+    bool hasId = line.format && formatId(line.format, id);
+
+    Writer w(out + 4, end);
+    w.byte((hasId ? BINARY_LOG_FORMAT : BINARY_LOG_TEXT) << 4 | line.level);
+    // Lines from other threads may have been stamped a little before the one ahead of them
+    w.zigzag((int32_t)(line.millis - lastMillis));
+    w.byte(thread);
+    if (hasId) {
+        w.varint(id);
+        w.bytes(line.args, line.argsLen);
+    } else {
+        w.bytes(line.text, strlen(line.text));
+    }
+    if (!w.ok)
+        return 0;
+    out += finishFrame(out, w.p - (out + 4));
+    lastMillis = line.millis;
+    sinceSync++;
+    return out - buf;
+}
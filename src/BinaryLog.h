@@ -0,0 +1,89 @@
+#pragma once
+
+#include "LogQueue.h"
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/// Write the serial port (and BLE) log as binary records instead of text, decode them with bin/log-decode.py
+#ifndef DEBUG_LOG_BINARY
+#define DEBUG_LOG_BINARY 0
+#endif
+
+/// Same first byte as StreamAPI frames, so clients can skip them
+#define BINARY_LOG_START1 0x94
+#define BINARY_LOG_START2 0xc5
+
+#define BINARY_LOG_VERSION 1
+
+/// A sync record goes out at least this often, for decoders that start listening halfway
+#define BINARY_LOG_SYNC_RECORDS 32
+
+/// Thread names the decoder is told about once and then referred to by index
+#define BINARY_LOG_THREADS 8
+#define BINARY_LOG_NO_THREAD 0xff
+
+/// Frames for one line, including the sync and thread records that may have to go first
+#define BINARY_LOG_MAX_FRAMES (LOG_QUEUE_LINE_LEN + 64)
+
+/**
+ * High nibble of the first payload byte, the low nibble is the MeshtasticLogLevel if there is one.
+ * Keep in sync with bin/log-decode.py
+ */
+enum BinaryLogRecordType : uint8_t {
+    BINARY_LOG_SYNC = 1,   // u8 version, u8 flags, varint base, varint millis, varint rtcSec
+    BINARY_LOG_THREAD = 2, // u8 index, name
+    BINARY_LOG_FORMAT = 3, // zigzag varint ms since the previous record, u8 thread, varint format id, arguments
+    BINARY_LOG_TEXT = 4,   // zigzag varint ms since the previous record, u8 thread, text
+};
+
+/// Set in the sync flags if format ids count from the first loaded segment of the ELF, rather than from base
+#define BINARY_LOG_RELATIVE 0x01
+
+/**
+ * Log messages as a format string id and their raw arguments, instead of formatted text.
+ *
+ * A format string that lives in the read-only part of the firmware image is identified by its offset in there, so the ids
+ * are fixed when the firmware is linked and cost nothing to look up; bin/log-decode.py reads the strings back out of the
+ * ELF.  Formats built at runtime, or kept in writable memory, are sent as text.
+ *
+ * Arguments are encoded in the order the format consumes them: integers as varints (zigzag for %d and %i), doubles as
+ * 8 little endian bytes, strings NUL terminated.  The same encoding is what LogLine holds until someone needs the text,
+ * so only the sinks that want text pay for printf.
+ *
+ * Every frame is START1, START2, varint payload length, payload.
+ */
+class BinaryLog
+{
+  public:
+    /**
+     * @param id set to the id of format
+     * @return false if format isn't in the read-only part of the firmware image, and so can't be found by the decoder
+     */
+    static bool formatId(const char *format, uint32_t &id);
+
+    /**
+     * Encode the arguments format consumes
+     * @param len set to the bytes of buf used
+     * @return false if they didn't fit, or format has a conversion we don't know
+     */
+    static bool encodeArgs(uint8_t *buf, size_t bufLen, const char *format, va_list arg, size_t &len);
+
+    /// Format the encoded arguments like vsnprintf would have
+    static size_t render(char *buf, size_t bufLen, const char *format, const uint8_t *args, size_t argsLen);
+
+    /**
+     * Turn a line into frames, preceded by a sync and thread record where needed
+     * @return bytes written, 0 if it didn't fit
+     */
+    size_t encode(const LogLine &line, uint8_t *buf, size_t bufLen);
+
+  private:
+    char threads[BINARY_LOG_THREADS][LOG_QUEUE_THREAD_LEN] = {};
+    uint8_t announced = 0; // bitmask of threads the decoder has heard of since the last sync
+    uint8_t nextThread = 0;
+    uint8_t sinceSync = BINARY_LOG_SYNC_RECORDS;
+    uint32_t lastMillis = 0;
+
+    uint8_t threadIndex(const char *name, uint8_t *&out, uint8_t *end);
+};
@@ -254,7 +254,8 @@ int32_t ButtonThread::runOnce()
         btnEvent = BUTTON_EVENT_NONE;
     }
 
-    return 50;
+    // While a button is in use OneButton needs ticking to time the press.  Otherwise the button interrupts wake us
+    return canSleep ? INT32_MAX : 50;
 }
 
 /*
@@ -277,9 +278,9 @@ void ButtonThread::attachButtonInterrupts()
 #endif
         []() {
             ButtonThread::userButton.tick();
-            runASAP = true;
             BaseType_t higherWake = 0;
-            mainDelay.interruptFromISR(&higherWake);
+            if (buttonThread)
+                buttonThread->wakeFromISR(&higherWake);
         },
         CHANGE);
 #endif
@@ -291,6 +292,9 @@ void ButtonThread::attachButtonInterrupts()
 #ifdef BUTTON_PIN_TOUCH
     wakeOnIrq(BUTTON_PIN_TOUCH, FALLING);
 #endif
+
+    // A press while the interrupts were off (such as the one that woke us from sleep) has to be looked at now
+    wake();
 }
 
 /*
@@ -330,8 +334,8 @@ void ButtonThread::wakeOnIrq(int irq, int mode)
         irq,
         [] {
             BaseType_t higherWake = 0;
-            mainDelay.interruptFromISR(&higherWake);
-            runASAP = true;
+            if (buttonThread)
+                buttonThread->wakeFromISR(&higherWake);
         },
         FALLING);
 }
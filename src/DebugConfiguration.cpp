@@ -33,10 +33,30 @@ SOFTWARE.*/
 /// A C wrapper for LOG_DEBUG that can be used from arduino C libs that don't know about C++ or meshtastic
 extern "C" void logLegacy(const char *level, const char *fmt, ...)
 {
+    MeshtasticLogLevel ll;
+    switch (level ? level[0] : 'D') {
+    case 'C':
+        ll = MESHTASTIC_LOG_LEVEL_CRIT;
+        break;
+    case 'E':
+        ll = MESHTASTIC_LOG_LEVEL_ERROR;
+        break;
+    case 'W':
+        ll = MESHTASTIC_LOG_LEVEL_WARN;
+        break;
+    case 'I':
+        ll = MESHTASTIC_LOG_LEVEL_INFO;
+        break;
+    case 'T':
+        ll = MESHTASTIC_LOG_LEVEL_TRACE;
+        break;
+    default:
+        ll = MESHTASTIC_LOG_LEVEL_DEBUG;
+    }
     va_list args;
     va_start(args, fmt);
     if (console)
-        console->vprintf(level, fmt, args);
+        console->vlog(ll, fmt, args);
     va_end(args);
 }
 
@@ -142,6 +162,16 @@ bool Syslog::vlogf(uint16_t pri, const char *appName, const char *fmt, va_list a
     return result;
 }
 
+bool Syslog::log(uint16_t pri, const char *message)
+{
+    return this->_sendLog(pri, this->_appName, message);
+}
+
+bool Syslog::log(uint16_t pri, const char *appName, const char *message)
+{
+    return this->_sendLog(pri, appName, message);
+}
+
 inline bool Syslog::_sendLog(uint16_t pri, const char *appName, const char *message)
 {
     int result;
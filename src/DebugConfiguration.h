@@ -17,13 +17,7 @@
 #define SERIAL_BAUD 115200 // Serial debug baud rate
 #endif
 
-#define MESHTASTIC_LOG_LEVEL_DEBUG "DEBUG"
-#define MESHTASTIC_LOG_LEVEL_INFO "INFO "
-#define MESHTASTIC_LOG_LEVEL_WARN "WARN "
-#define MESHTASTIC_LOG_LEVEL_ERROR "ERROR"
-#define MESHTASTIC_LOG_LEVEL_CRIT "CRIT "
-#define MESHTASTIC_LOG_LEVEL_TRACE "TRACE"
-
+// The MESHTASTIC_LOG_LEVEL_* values come from RedirectablePrint.h
 #include "SerialConsole.h"
 
 // If defined we will include support for ARM ICE "semihosting" for a virtual
@@ -162,6 +156,9 @@ class Syslog
 
     bool vlogf(uint16_t pri, const char *fmt, va_list args) __attribute__((format(printf, 3, 0)));
     bool vlogf(uint16_t pri, const char *appName, const char *fmt, va_list args) __attribute__((format(printf, 3, 0)));
+
+    bool log(uint16_t pri, const char *message);
+    bool log(uint16_t pri, const char *appName, const char *message);
 };
 
 #endif // HAS_ETHERNET || HAS_WIFI
\ No newline at end of file
@@ -0,0 +1,46 @@
+#include "LogQueue.h"
+
+LogQueue::LogQueue() : enqueuePos(0), drops(0)
+{
+    for (uint32_t i = 0; i < LOG_QUEUE_SLOTS; i++)
+        slots[i].seq.store(i, std::memory_order_relaxed);
+}
+
+LogLine *LogQueue::reserve(uint32_t &ticket)
+{
+    uint32_t pos = enqueuePos.load(std::memory_order_relaxed);
+    for (;;) {
+        Slot &s = slots[pos & (LOG_QUEUE_SLOTS - 1)];
+        int32_t diff = (int32_t)(s.seq.load(std::memory_order_acquire) - pos);
+        if (diff == 0) {
+            // Free, try to claim it before another producer does (a failed CAS reloads pos)
+            if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                ticket = pos;
+                return &s.line;
+            }
+        } else if (diff < 0) {
+            // The consumer hasn't got to the line that was written here last time round
+            drop();
+            return NULL;
+        } else {
+            pos = enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+void LogQueue::commit(uint32_t ticket)
+{
+    slots[ticket & (LOG_QUEUE_SLOTS - 1)].seq.store(ticket + 1, std::memory_order_release);
+}
+
+LogLine *LogQueue::peek()
+{
+    Slot &s = slots[dequeuePos & (LOG_QUEUE_SLOTS - 1)];
+    return s.seq.load(std::memory_order_acquire) == dequeuePos + 1 ? &s.line : NULL;
+}
+
+void LogQueue::pop()
+{
+    slots[dequeuePos & (LOG_QUEUE_SLOTS - 1)].seq.store(dequeuePos + LOG_QUEUE_SLOTS, std::memory_order_release);
+    dequeuePos++;
+}
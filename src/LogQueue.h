@@ -0,0 +1,97 @@
+#pragma once
+
+#include "configuration.h"
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+/// Log lines that can wait for the console at once, must be a power of two.  Each costs about LOG_QUEUE_LINE_LEN + 32 bytes
+#ifndef LOG_QUEUE_SLOTS
+#if defined(ARCH_PORTDUINO)
+#define LOG_QUEUE_SLOTS 64
+#elif defined(ARCH_STM32WL)
+#define LOG_QUEUE_SLOTS 4
+#elif defined(ARCH_NRF52)
+#define LOG_QUEUE_SLOTS 8
+#else
+#define LOG_QUEUE_SLOTS 16
+#endif
+#endif
+
+/// Longest message kept, the rest of a line is cut off
+#ifndef LOG_QUEUE_LINE_LEN
+#if ENABLE_JSON_LOGGING || defined(ARCH_PORTDUINO)
+#define LOG_QUEUE_LINE_LEN 512
+#elif defined(ARCH_STM32WL)
+#define LOG_QUEUE_LINE_LEN 128
+#else
+#define LOG_QUEUE_LINE_LEN 160
+#endif
+#endif
+
+#define LOG_QUEUE_THREAD_LEN 16
+
+/**
+ * One formatted log message, with what we knew about it when it was logged
+ */
+struct LogLine {
+    MeshtasticLogLevel level;
+    uint32_t millis;
+    uint32_t rtcSec; // 0 if we had no valid time
+    char thread[LOG_QUEUE_THREAD_LEN];
+    const char *format; // if set, args holds its arguments (see BinaryLog) and nobody formatted them yet
+    uint16_t argsLen;
+    union {
+        char text[LOG_QUEUE_LINE_LEN]; // without the final newline
+        uint8_t args[LOG_QUEUE_LINE_LEN];
+    };
+};
+
+/**
+ * Bounded multi-producer, single-consumer queue of log lines.
+ *
+ * Any thread, task or interrupt may reserve a slot, fill it in and commit it, without taking a lock, while one
+ * consumer at a time peeks and pops.  Every slot carries a sequence number that tells producers whether it is free and the
+ * consumer whether it holds a committed line (D. Vyukov's bounded queue).  If the queue is full the line is counted as
+ * dropped instead of waiting for the consumer.
+ */
+class LogQueue
+{
+  public:
+    LogQueue();
+
+    /**
+     * Claim the next free slot
+     * @param ticket set to what commit() needs
+     * @return the line to fill in, NULL if the queue is full
+     */
+    LogLine *reserve(uint32_t &ticket);
+
+    /// Hand a reserved line to the consumer
+    void commit(uint32_t ticket);
+
+    /// @return the oldest committed line, NULL if there is none (or its producer is still writing it)
+    LogLine *peek();
+
+    /// Release the line peek() returned
+    void pop();
+
+    /// Count a line that was never queued
+    void drop() { drops.fetch_add(1, std::memory_order_relaxed); }
+
+    /// @return the lines dropped since the last call
+    uint32_t takeDrops() { return drops.exchange(0); }
+
+  private:
+    static_assert((LOG_QUEUE_SLOTS & (LOG_QUEUE_SLOTS - 1)) == 0, "LOG_QUEUE_SLOTS must be a power of two");
+
+    struct Slot {
+        std::atomic<uint32_t> seq;
+        LogLine line;
+    };
+    Slot slots[LOG_QUEUE_SLOTS];
+
+    std::atomic<uint32_t> enqueuePos;
+    uint32_t dequeuePos = 0; // only the consumer touches this
+    std::atomic<uint32_t> drops;
+};
@@ -45,7 +45,7 @@ void PowerFSM_setup();
 #else
 #include <Fsm.h>
 extern Fsm powerFSM;
-extern State stateON, statePOWER, stateSERIAL, stateDARK;
+extern State stateON, statePOWER, stateSERIAL, stateDARK, stateLS;
 
 void PowerFSM_setup();
 #endif
\ No newline at end of file
@@ -6,6 +6,11 @@
 #include "main.h"
 #include "power.h"
 
+/// How often the power state machine runs in states where all it does is time out, every timeout is at least seconds long
+#ifndef POWER_FSM_IDLE_INTERVAL_MS
+#define POWER_FSM_IDLE_INTERVAL_MS 1000
+#endif
+
 namespace concurrency
 {
 /// Wrapper to convert our powerFSM stuff into a 'thread'
@@ -35,7 +40,8 @@ class PowerFSMThread : public OSThread
             powerFSM.trigger(EVENT_SHUTDOWN);
         }
 
-        return 100;
+        // LS, ON and POWER have work to do on every run (and SERIAL keeps us awake anyway), the rest only wait for timeouts
+        return (state == &stateLS || state == &stateON || !canSleep) ? 100 : POWER_FSM_IDLE_INTERVAL_MS;
 #else
         return INT32_MAX;
 #endif
@@ -1,10 +1,13 @@
 #include "RedirectablePrint.h"
+#include "BinaryLog.h"
+#include "LogQueue.h"
 #include "NodeDB.h"
 #include "RTC.h"
 #include "concurrency/OSThread.h"
 #include "configuration.h"
 #include "main.h"
 #include "mesh/generated/meshtastic/mesh.pb.h"
+#include <algorithm>
 #include <assert.h>
 #include <cstring>
 #include <memory>
@@ -19,13 +22,29 @@
 #if HAS_NETWORKING
 extern Syslog syslog;
 #endif
-void RedirectablePrint::rpInit()
+
+static const char *const levelNames[] = {"CRIT ", "ERROR", "WARN ", "INFO ", "DEBUG", "TRACE"};
+static const char *const levelColors[] = {"", "\u001b[31m", "\u001b[33m", "\u001b[32m", "\u001b[34m", "\u001b[35m"};
+
+/// @return true if we were called from an interrupt handler, which mustn't write to the serial port
+static bool inInterrupt()
 {
-#ifdef HAS_FREE_RTOS
-    inDebugPrint = xSemaphoreCreateMutexStatic(&this->_MutexStorageSpace);
+#if defined(ARCH_ESP32)
+    return xPortInIsrContext();
+#elif defined(__arm__) && !defined(ARCH_PORTDUINO)
+    uint32_t ipsr;
+    __asm__ volatile("mrs %0, ipsr" : "=r"(ipsr));
+    return ipsr != 0;
+#else
+    return false;
 #endif
 }
 
+RedirectablePrint::RedirectablePrint(Print *_dest)
+    : dest(_dest), queue(new LogQueue()), binaryLog(new BinaryLog()), binarySerial(DEBUG_LOG_BINARY), flushing(false)
+{
+}
+
 void RedirectablePrint::setDestination(Print *_dest)
 {
     assert(_dest);
@@ -47,80 +66,49 @@ size_t RedirectablePrint::write(uint8_t c)
               // serial port said (which could be zero)
 }
 
-size_t RedirectablePrint::vprintf(const char *logLevel, const char *format, va_list arg)
+/// Replace anything the terminal might choke on
+static void sanitize(char *buf, size_t len)
 {
-    va_list copy;
-#if ENABLE_JSON_LOGGING || ARCH_PORTDUINO
-    static char printBuf[512];
-#else
-    static char printBuf[160];
-#endif
+    for (size_t f = 0; f < len; f++) {
+        if (!std::isprint(static_cast<unsigned char>(buf[f])) && buf[f] != '\n')
+            buf[f] = '#';
+    }
+}
 
-#ifdef ARCH_PORTDUINO
-    bool color = !settingsMap[ascii_logs];
-#else
-    bool color = true;
-#endif
+size_t RedirectablePrint::vprintf(const char *format, va_list arg)
+{
+    static char printBuf[LOG_QUEUE_LINE_LEN];
 
+    // Keep the order of what was logged before
+    flushLog();
+
+    va_list copy;
     va_copy(copy, arg);
     size_t len = vsnprintf(printBuf, sizeof(printBuf), format, copy);
     va_end(copy);
 
     // If the resulting string is longer than sizeof(printBuf)-1 characters, the remaining characters are still counted for the
     // return value
-
-    if (len > sizeof(printBuf) - 1) {
+    if (len > sizeof(printBuf) - 1)
         len = sizeof(printBuf) - 1;
-        printBuf[sizeof(printBuf) - 2] = '\n';
-    }
-    for (size_t f = 0; f < len; f++) {
-        if (!std::isprint(static_cast<unsigned char>(printBuf[f])) && printBuf[f] != '\n')
-            printBuf[f] = '#';
-    }
-    if (color && logLevel != nullptr) {
-        if (strcmp(logLevel, MESHTASTIC_LOG_LEVEL_DEBUG) == 0)
-            Print::write("\u001b[34m", 5);
-        if (strcmp(logLevel, MESHTASTIC_LOG_LEVEL_INFO) == 0)
-            Print::write("\u001b[32m", 5);
-        if (strcmp(logLevel, MESHTASTIC_LOG_LEVEL_WARN) == 0)
-            Print::write("\u001b[33m", 5);
-        if (strcmp(logLevel, MESHTASTIC_LOG_LEVEL_ERROR) == 0)
-            Print::write("\u001b[31m", 5);
-    }
-    len = Print::write(printBuf, len);
-    if (color && logLevel != nullptr) {
-        Print::write("\u001b[0m", 4);
-    }
-    return len;
+    sanitize(printBuf, len);
+    return Print::write(printBuf, len);
 }
 
-void RedirectablePrint::log_to_serial(const char *logLevel, const char *format, va_list arg)
+void RedirectablePrint::log_to_serial(const LogLine &line)
 {
-    size_t r = 0;
-
 #ifdef ARCH_PORTDUINO
     bool color = !settingsMap[ascii_logs];
 #else
     bool color = true;
 #endif
+    const char *reset = color ? "\u001b[0m" : "";
+    char header[32 + LOG_QUEUE_THREAD_LEN];
+    size_t len;
 
     // include the header
-    if (color) {
-        if (strcmp(logLevel, MESHTASTIC_LOG_LEVEL_DEBUG) == 0)
-            Print::write("\u001b[34m", 5);
-        if (strcmp(logLevel, MESHTASTIC_LOG_LEVEL_INFO) == 0)
-            Print::write("\u001b[32m", 5);
-        if (strcmp(logLevel, MESHTASTIC_LOG_LEVEL_WARN) == 0)
-            Print::write("\u001b[33m", 5);
-        if (strcmp(logLevel, MESHTASTIC_LOG_LEVEL_ERROR) == 0)
-            Print::write("\u001b[31m", 5);
-        if (strcmp(logLevel, MESHTASTIC_LOG_LEVEL_TRACE) == 0)
-            Print::write("\u001b[35m", 5);
-    }
-
-    uint32_t rtc_sec = getValidTime(RTCQuality::RTCQualityDevice, true); // display local time on logfile
-    if (rtc_sec > 0) {
-        long hms = rtc_sec % SEC_PER_DAY;
+    if (line.rtcSec > 0) {
+        long hms = line.rtcSec % SEC_PER_DAY;
         // hms += tz.tz_dsttime * SEC_PER_HOUR;
         // hms -= tz.tz_minuteswest * SEC_PER_MIN;
         // mod `hms` to ensure in positive range of [0...SEC_PER_DAY)
@@ -130,221 +118,264 @@ void RedirectablePrint::log_to_serial(const char *logLevel, const char *format,
         int hour = hms / SEC_PER_HOUR;
         int min = (hms % SEC_PER_HOUR) / SEC_PER_MIN;
         int sec = (hms % SEC_PER_HOUR) % SEC_PER_MIN; // or hms % SEC_PER_MIN
-#ifdef ARCH_PORTDUINO
-        ::printf("%s ", logLevel);
-        if (color) {
-            ::printf("\u001b[0m");
-        }
-        ::printf("| %02d:%02d:%02d %u ", hour, min, sec, millis() / 1000);
-#else
-        printf("%s ", logLevel);
-        if (color) {
-            printf("\u001b[0m");
-        }
-        printf("| %02d:%02d:%02d %u ", hour, min, sec, millis() / 1000);
-#endif
+        len = snprintf(header, sizeof(header), "%s%s %s| %02d:%02d:%02d %u ", color ? levelColors[line.level] : "",
+                       levelNames[line.level], reset, hour, min, sec, line.millis / 1000);
     } else {
-#ifdef ARCH_PORTDUINO
-        ::printf("%s ", logLevel);
-        if (color) {
-            ::printf("\u001b[0m");
-        }
-        ::printf("| ??:??:?? %u ", millis() / 1000);
-#else
-        printf("%s ", logLevel);
-        if (color) {
-            printf("\u001b[0m");
-        }
-        printf("| ??:??:?? %u ", millis() / 1000);
-#endif
-    }
-    auto thread = concurrency::OSThread::currentThread;
-    if (thread) {
-        print("[");
-        // printf("%p ", thread);
-        // assert(thread->ThreadName.length());
-        print(thread->ThreadName);
-        print("] ");
+        len = snprintf(header, sizeof(header), "%s%s %s| ??:??:?? %u ", color ? levelColors[line.level] : "",
+                       levelNames[line.level], reset, line.millis / 1000);
     }
-    r += vprintf(logLevel, format, arg);
+    if (line.thread[0] && len < sizeof(header))
+        len += snprintf(header + len, sizeof(header) - len, "[%s] ", line.thread);
+    Print::write(header, std::min(len, sizeof(header) - 1));
+
+    if (color && line.level != MESHTASTIC_LOG_LEVEL_TRACE)
+        Print::write(levelColors[line.level]);
+    Print::write(line.text, strlen(line.text));
+    Print::write(color ? "\u001b[0m\n" : "\n");
 }
 
-void RedirectablePrint::log_to_syslog(const char *logLevel, const char *format, va_list arg)
+void RedirectablePrint::log_to_syslog(const LogLine &line)
 {
 #if HAS_NETWORKING && !defined(ARCH_PORTDUINO)
     // if syslog is in use, collect the log messages and send them to syslog
     if (syslog.isEnabled()) {
-        int ll = 0;
-        switch (logLevel[0]) {
-        case 'D':
-            ll = SYSLOG_DEBUG;
-            break;
-        case 'I':
-            ll = SYSLOG_INFO;
-            break;
-        case 'W':
-            ll = SYSLOG_WARN;
-            break;
-        case 'E':
-            ll = SYSLOG_ERR;
-            break;
-        case 'C':
-            ll = SYSLOG_CRIT;
-            break;
-        default:
-            ll = 0;
-        }
-        auto thread = concurrency::OSThread::currentThread;
-        if (thread) {
-            syslog.vlogf(ll, thread->ThreadName.c_str(), format, arg);
+        static const uint16_t syslogLevels[] = {SYSLOG_CRIT, SYSLOG_ERR, SYSLOG_WARN, SYSLOG_INFO, SYSLOG_DEBUG, SYSLOG_DEBUG};
+        if (line.thread[0]) {
+            syslog.log(syslogLevels[line.level], line.thread, line.text);
         } else {
-            syslog.vlogf(ll, format, arg);
+            syslog.log(syslogLevels[line.level], line.text);
         }
     }
+#else
+    (void)line;
 #endif
 }
 
-void RedirectablePrint::log_to_ble(const char *logLevel, const char *format, va_list arg)
-{
 #if !MESHTASTIC_EXCLUDE_BLUETOOTH
-    if (config.security.debug_log_api_enabled && !pauseBluetoothLogging) {
-        bool isBleConnected = false;
+/// @return true if a phone wants our log over BLE
+static bool bleLogConnected()
+{
+    if (!config.security.debug_log_api_enabled || pauseBluetoothLogging)
+        return false;
 #ifdef ARCH_ESP32
-        isBleConnected = nimbleBluetooth && nimbleBluetooth->isActive() && nimbleBluetooth->isConnected();
+    return nimbleBluetooth && nimbleBluetooth->isActive() && nimbleBluetooth->isConnected();
 #elif defined(ARCH_NRF52)
-        isBleConnected = nrf52Bluetooth != nullptr && nrf52Bluetooth->isConnected();
+    return nrf52Bluetooth != nullptr && nrf52Bluetooth->isConnected();
+#else
+    return false;
 #endif
-        if (isBleConnected) {
-            char *message;
-            size_t initialLen;
-            size_t len;
-            initialLen = strlen(format);
-            message = new char[initialLen + 1];
-            len = vsnprintf(message, initialLen + 1, format, arg);
-            if (len > initialLen) {
-                delete[] message;
-                message = new char[len + 1];
-                vsnprintf(message, len + 1, format, arg);
-            }
-            auto thread = concurrency::OSThread::currentThread;
-            meshtastic_LogRecord logRecord = meshtastic_LogRecord_init_zero;
-            logRecord.level = getLogLevel(logLevel);
-            strcpy(logRecord.message, message);
-            if (thread)
-                strcpy(logRecord.source, thread->ThreadName.c_str());
-            logRecord.time = getValidTime(RTCQuality::RTCQualityDevice, true);
-
-            uint8_t *buffer = new uint8_t[meshtastic_LogRecord_size];
-            size_t size = pb_encode_to_bytes(buffer, meshtastic_LogRecord_size, meshtastic_LogRecord_fields, &logRecord);
+}
+
+static void bleSendLog(const uint8_t *buf, size_t len)
+{
 #ifdef ARCH_ESP32
-            nimbleBluetooth->sendLog(buffer, size);
+    nimbleBluetooth->sendLog(buf, len);
 #elif defined(ARCH_NRF52)
-            nrf52Bluetooth->sendLog(buffer, size);
+    nrf52Bluetooth->sendLog(buf, len);
+#else
+    (void)buf;
+    (void)len;
 #endif
-            delete[] message;
-            delete[] buffer;
-        }
+}
+#endif
+
+void RedirectablePrint::log_to_ble(const LogLine &line)
+{
+#if !MESHTASTIC_EXCLUDE_BLUETOOTH
+    if (bleLogConnected()) {
+        meshtastic_LogRecord logRecord = meshtastic_LogRecord_init_zero;
+        logRecord.level = getLogLevel(line.level);
+        strncpy(logRecord.message, line.text, sizeof(logRecord.message) - 1);
+        strncpy(logRecord.source, line.thread, sizeof(logRecord.source) - 1);
+        logRecord.time = line.rtcSec;
+
+        uint8_t *buffer = new uint8_t[meshtastic_LogRecord_size];
+        size_t size = pb_encode_to_bytes(buffer, meshtastic_LogRecord_size, meshtastic_LogRecord_fields, &logRecord);
+        bleSendLog(buffer, size);
+        delete[] buffer;
     }
 #else
-    (void)logLevel;
-    (void)format;
-    (void)arg;
+    (void)line;
 #endif
 }
 
-meshtastic_LogRecord_Level RedirectablePrint::getLogLevel(const char *logLevel)
+void RedirectablePrint::log_binary(const uint8_t *frames, size_t len)
 {
-    meshtastic_LogRecord_Level ll = meshtastic_LogRecord_Level_UNSET; // default to unset
-    switch (logLevel[0]) {
-    case 'D':
-        ll = meshtastic_LogRecord_Level_DEBUG;
-        break;
-    case 'I':
-        ll = meshtastic_LogRecord_Level_INFO;
-        break;
-    case 'W':
-        ll = meshtastic_LogRecord_Level_WARNING;
-        break;
-    case 'E':
-        ll = meshtastic_LogRecord_Level_ERROR;
-        break;
-    case 'C':
-        ll = meshtastic_LogRecord_Level_CRITICAL;
-        break;
+    if (binarySerial) {
+        // Not through a subclass's write(), a \r before every 0x0a would break the frames
+        for (size_t i = 0; i < len; i++)
+            RedirectablePrint::write(frames[i]);
     }
-    return ll;
+#if DEBUG_LOG_BINARY && !MESHTASTIC_EXCLUDE_BLUETOOTH
+    if (bleLogConnected())
+        bleSendLog(frames, len);
+#endif
+#ifdef ARCH_PORTDUINO
+    if (binaryLogFile.is_open())
+        binaryLogFile.write((const char *)frames, len);
+#endif
 }
 
-void RedirectablePrint::log(const char *logLevel, const char *format, ...)
+meshtastic_LogRecord_Level RedirectablePrint::getLogLevel(MeshtasticLogLevel logLevel)
 {
+    static const meshtastic_LogRecord_Level levels[] = {
+        meshtastic_LogRecord_Level_CRITICAL, meshtastic_LogRecord_Level_ERROR, meshtastic_LogRecord_Level_WARNING,
+        meshtastic_LogRecord_Level_INFO,     meshtastic_LogRecord_Level_DEBUG, meshtastic_LogRecord_Level_UNSET};
+    return levels[logLevel];
+}
 
-    // append \n to format
-    size_t len = strlen(format);
-    char *newFormat = new char[len + 2];
-    strcpy(newFormat, format);
-    newFormat[len] = '\n';
-    newFormat[len + 1] = '\0';
+bool RedirectablePrint::isLevelEnabled(MeshtasticLogLevel logLevel)
+{
+#if ARCH_PORTDUINO
+    // level_error...level_trace line up with ERROR...TRACE, critical messages always get through
+    if (logLevel > MESHTASTIC_LOG_LEVEL_ERROR + settingsMap[logoutputlevel])
+        return false;
+#endif
+    if (moduleConfig.serial.override_console_serial_port && logLevel == MESHTASTIC_LOG_LEVEL_DEBUG)
+        return false;
+    return true;
+}
+
+void RedirectablePrint::log(MeshtasticLogLevel logLevel, const char *format, ...)
+{
+    va_list arg;
+    va_start(arg, format);
+    vlog(logLevel, format, arg);
+    va_end(arg);
+}
 
+void RedirectablePrint::vlog(MeshtasticLogLevel logLevel, const char *format, va_list arg)
+{
 #if ARCH_PORTDUINO
     // level trace is special, two possible ways to handle it.
-    if (strcmp(logLevel, MESHTASTIC_LOG_LEVEL_TRACE) == 0) {
-        if (settingsStrings[traceFilename] != "") {
-            va_list arg;
-            va_start(arg, format);
-            try {
-                traceFile << va_arg(arg, char *) << std::endl;
-            } catch (const std::ios_base::failure &e) {
-            }
-            va_end(arg);
-        }
-        if (settingsMap[logoutputlevel] < level_trace && strcmp(logLevel, MESHTASTIC_LOG_LEVEL_TRACE) == 0) {
-            delete[] newFormat;
-            return;
+    if (logLevel == MESHTASTIC_LOG_LEVEL_TRACE && settingsStrings[traceFilename] != "") {
+        va_list copy;
+        va_copy(copy, arg);
+        try {
+            traceFile << va_arg(copy, char *) << std::endl;
+        } catch (const std::ios_base::failure &e) {
         }
+        va_end(copy);
     }
-    if (settingsMap[logoutputlevel] < level_debug && strcmp(logLevel, MESHTASTIC_LOG_LEVEL_DEBUG) == 0) {
-        delete[] newFormat;
-        return;
-    } else if (settingsMap[logoutputlevel] < level_info && strcmp(logLevel, MESHTASTIC_LOG_LEVEL_INFO) == 0) {
-        delete[] newFormat;
+#endif
+    // Bail out before formatting anything if nobody will see this message
+    if (!isLevelEnabled(logLevel))
         return;
-    } else if (settingsMap[logoutputlevel] < level_warn && strcmp(logLevel, MESHTASTIC_LOG_LEVEL_WARN) == 0) {
-        delete[] newFormat;
+
+    // From an interrupt we can only keep the raw arguments (no printf, no RTC), and only if the format string stays around
+    uint32_t id;
+    bool isr = inInterrupt();
+    bool hasId = BinaryLog::formatId(format, id);
+    if (isr && !hasId) {
+        queue->drop();
         return;
     }
-#endif
-    if (moduleConfig.serial.override_console_serial_port && strcmp(logLevel, MESHTASTIC_LOG_LEVEL_DEBUG) == 0) {
-        delete[] newFormat;
-        return;
+
+    uint32_t ticket;
+    LogLine *line = queue->reserve(ticket);
+    if (line) {
+        line->level = logLevel;
+        line->millis = millis();
+        line->rtcSec = isr ? 0 : getValidTime(RTCQuality::RTCQualityDevice, true); // display local time on logfile
+        concurrency::OSThread *thread = isr ? NULL : concurrency::OSThread::currentThread;
+        strncpy(line->thread, thread ? thread->ThreadName.c_str() : "", sizeof(line->thread) - 1);
+        line->thread[sizeof(line->thread) - 1] = '\0';
+
+        // Leave the formatting to whoever needs the text, if the format string is still around by then
+        size_t argsLen;
+        line->format = NULL;
+        if (hasId && BinaryLog::encodeArgs(line->args, sizeof(line->args), format, arg, argsLen)) {
+            line->format = format;
+            line->argsLen = argsLen;
+        } else if (isr) {
+            // Arguments we can't encode, the format string itself is better than nothing
+            strncpy(line->text, format, sizeof(line->text) - 1);
+            line->text[sizeof(line->text) - 1] = '\0';
+        } else {
+            va_list copy;
+            va_copy(copy, arg);
+            int len = vsnprintf(line->text, sizeof(line->text), format, copy);
+            va_end(copy);
+            len = std::min(std::max(len, 0), (int)sizeof(line->text) - 1);
+            if (len > 0 && line->text[len - 1] == '\n') // we add our own
+                line->text[len - 1] = '\0';
+        }
+        queue->commit(ticket);
     }
 
-#ifdef HAS_FREE_RTOS
-    if (inDebugPrint != nullptr && xSemaphoreTake(inDebugPrint, portMAX_DELAY) == pdTRUE) {
-#else
-    if (!inDebugPrint) {
-        inDebugPrint = true;
-#endif
+    // Until the main loop takes over, and for errors that might be the last thing we get to say, don't wait for it
+    if ((!async || logLevel <= MESHTASTIC_LOG_LEVEL_ERROR) && !isr)
+        flushLog();
+}
 
-        va_list arg;
-        va_start(arg, format);
+void RedirectablePrint::flushLog()
+{
+    // Only one consumer at a time, whoever has it writes out what the others queued meanwhile
+    if (flushing.exchange(true, std::memory_order_acquire))
+        return;
 
-        log_to_serial(logLevel, newFormat, arg);
-        log_to_syslog(logLevel, newFormat, arg);
-        log_to_ble(logLevel, newFormat, arg);
+    uint32_t dropped = queue->takeDrops();
+    if (dropped) {
+        static LogLine notice;
+        notice.level = MESHTASTIC_LOG_LEVEL_WARN;
+        notice.millis = millis();
+        notice.rtcSec = getValidTime(RTCQuality::RTCQualityDevice, true);
+        notice.thread[0] = '\0';
+        notice.format = NULL;
+        snprintf(notice.text, sizeof(notice.text), "%u log messages dropped, the console can't keep up", dropped);
+        emit(notice);
+    }
 
-        va_end(arg);
-#ifdef HAS_FREE_RTOS
-        xSemaphoreGive(inDebugPrint);
-#else
-        inDebugPrint = false;
+    LogLine *line;
+    while ((line = queue->peek()) != NULL) {
+        emit(*line);
+        queue->pop();
+    }
+    flushing.store(false, std::memory_order_release);
+}
+
+void RedirectablePrint::emit(LogLine &line)
+{
+    bool binary = binarySerial;
+#if DEBUG_LOG_BINARY && !MESHTASTIC_EXCLUDE_BLUETOOTH
+    binary = binary || bleLogConnected();
 #endif
+#ifdef ARCH_PORTDUINO
+    binary = binary || binaryLogFile.is_open();
+#endif
+    if (binary) {
+        static uint8_t frames[BINARY_LOG_MAX_FRAMES];
+        log_binary(frames, binaryLog->encode(line, frames, sizeof(frames)));
     }
 
-    delete[] newFormat;
-    return;
+    bool text = !binarySerial;
+#if HAS_NETWORKING && !defined(ARCH_PORTDUINO)
+    text = text || syslog.isEnabled();
+#endif
+#if !DEBUG_LOG_BINARY && !MESHTASTIC_EXCLUDE_BLUETOOTH
+    text = text || bleLogConnected();
+#endif
+    if (!text)
+        return;
+
+    if (line.format) {
+        static char rendered[LOG_QUEUE_LINE_LEN];
+        size_t len = BinaryLog::render(rendered, sizeof(rendered), line.format, line.args, line.argsLen);
+        if (len > 0 && rendered[len - 1] == '\n') // we add our own
+            rendered[--len] = '\0';
+        memcpy(line.text, rendered, len + 1);
+        line.format = NULL;
+    }
+    sanitize(line.text, strlen(line.text));
+    if (!binarySerial)
+        log_to_serial(line);
+    log_to_syslog(line);
+#if !DEBUG_LOG_BINARY
+    log_to_ble(line);
+#endif
 }
 
-void RedirectablePrint::hexDump(const char *logLevel, unsigned char *buf, uint16_t len)
+void RedirectablePrint::hexDump(MeshtasticLogLevel logLevel, unsigned char *buf, uint16_t len)
 {
     const char alphabet[17] = "0123456789abcdef";
     log(logLevel, "    +------------------------------------------------+ +----------------+");
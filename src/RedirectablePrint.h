@@ -3,57 +3,97 @@
 #include "../freertosinc.h"
 #include "mesh/generated/meshtastic/mesh.pb.h"
 #include <Print.h>
+#include <atomic>
 #include <stdarg.h>
 #include <string>
 
+/**
+ * Severity of a log message, most severe first
+ */
+enum MeshtasticLogLevel : uint8_t {
+    MESHTASTIC_LOG_LEVEL_CRIT = 0,
+    MESHTASTIC_LOG_LEVEL_ERROR,
+    MESHTASTIC_LOG_LEVEL_WARN,
+    MESHTASTIC_LOG_LEVEL_INFO,
+    MESHTASTIC_LOG_LEVEL_DEBUG,
+    MESHTASTIC_LOG_LEVEL_TRACE,
+};
+
+struct LogLine;
+class LogQueue;
+class BinaryLog;
+
 /**
  * A Printable that can be switched to squirt its bytes to a different sink.
  * This class is mostly useful to allow debug printing to be redirected away from Serial
  * to some other transport if we switch Serial usage (on the fly) to some other purpose.
+ *
+ * Log messages go into a LogQueue, whoever logs them never waits for a sink.  flushLog() writes them out, with their
+ * header, to the serial port, syslog and BLE.  Until setAsync() is called every log call flushes right away.
+ *
+ * Messages whose format string is part of the firmware image aren't even formatted by the caller, the queue holds the
+ * raw arguments until a sink needs text.  Binary sinks (see BinaryLog) never do.
  */
 class RedirectablePrint : public Print
 {
     Print *dest;
+    LogQueue *queue;
+    BinaryLog *binaryLog;
+    volatile bool async = false;
+    bool binarySerial;
+    std::atomic<bool> flushing;
 
-#ifdef HAS_FREE_RTOS
-    SemaphoreHandle_t inDebugPrint = nullptr;
-    StaticSemaphore_t _MutexStorageSpace;
-#else
-    volatile bool inDebugPrint = false;
-#endif
   public:
-    explicit RedirectablePrint(Print *_dest) : dest(_dest) {}
+    explicit RedirectablePrint(Print *_dest);
 
     /**
      * Set a new destination
      */
-    void rpInit();
     void setDestination(Print *dest);
 
     virtual size_t write(uint8_t c);
 
     /**
-     * Debug logging print message
+     * Debug logging print message, one line per call
      *
-     * If the provide format string ends with a newline we assume it is the final print of a single
-     * log message.  Otherwise we assume more prints will come before the log message ends.  This
-     * allows you to call logDebug a few times to build up a single log message line if you wish.
+     * Safe to call from any thread or interrupt, it never waits for a lock.  If the queue is full the message is dropped
+     * and counted, the next flush says how many were lost.
+     */
+    void log(MeshtasticLogLevel logLevel, const char *format, ...) __attribute__((format(printf, 3, 4)));
+
+    /** like log but va_list based */
+    void vlog(MeshtasticLogLevel logLevel, const char *format, va_list arg);
+
+    /** like printf but va_list based, written straight to the destination without a header */
+    size_t vprintf(const char *format, va_list arg);
+
+    void hexDump(MeshtasticLogLevel logLevel, unsigned char *buf, uint16_t len);
+
+    /** @return false if a message at logLevel would be dropped anyway, so callers can skip expensive formatting */
+    bool isLevelEnabled(MeshtasticLogLevel logLevel);
+
+    /**
+     * Leave writing out log messages to whoever calls flushLog(), the main loop when it is idle.  Errors and critical
+     * messages are still written right away, unless they were logged from an interrupt.
      */
-    void log(const char *logLevel, const char *format, ...) __attribute__((format(printf, 3, 4)));
+    void setAsync(bool enabled) { async = enabled; }
 
-    /** like printf but va_list based */
-    size_t vprintf(const char *logLevel, const char *format, va_list arg);
+    /** Write out every queued message, does nothing if someone else already is */
+    void flushLog();
 
-    void hexDump(const char *logLevel, unsigned char *buf, uint16_t len);
+    /** Write the log to the serial port as binary records (see BinaryLog) instead of text */
+    void setBinary(bool enabled) { binarySerial = enabled; }
 
     std::string mt_sprintf(const std::string fmt_str, ...);
 
   protected:
     /// Subclasses can override if they need to change how we format over the serial port
-    virtual void log_to_serial(const char *logLevel, const char *format, va_list arg);
-    meshtastic_LogRecord_Level getLogLevel(const char *logLevel);
+    virtual void log_to_serial(const LogLine &line);
+    meshtastic_LogRecord_Level getLogLevel(MeshtasticLogLevel logLevel);
 
   private:
-    void log_to_syslog(const char *logLevel, const char *format, va_list arg);
-    void log_to_ble(const char *logLevel, const char *format, va_list arg);
-};
\ No newline at end of file
+    void emit(LogLine &line);
+    void log_to_syslog(const LogLine &line);
+    void log_to_ble(const LogLine &line);
+    void log_binary(const uint8_t *frames, size_t len);
+};
@@ -1,5 +1,6 @@
 #include "SerialConsole.h"
 #include "Default.h"
+#include "LogQueue.h"
 #include "NodeDB.h"
 #include "PowerFSM.h"
 #include "Throttle.h"
@@ -23,14 +24,13 @@ SerialConsole *console;
 void consoleInit()
 {
     new SerialConsole(); // Must be dynamically allocated because we are now inheriting from thread
-    DEBUG_PORT.rpInit(); // Simply sets up semaphore
 }
 
 void consolePrintf(const char *format, ...)
 {
     va_list arg;
     va_start(arg, format);
-    console->vprintf(nullptr, format, arg);
+    console->vprintf(format, arg);
     va_end(arg);
     console->flush();
 }
@@ -46,6 +46,11 @@ SerialConsole::SerialConsole() : StreamAPI(&Port), RedirectablePrint(&Port), con
     Port.setRX(SERIAL2_RX);
 #endif
     Port.begin(SERIAL_BAUD);
+#if defined(ARCH_ESP32) && !ARDUINO_USB_CDC_ON_BOOT && !defined(USER_DEBUG_PORT)
+    // Called from the UART event task once bytes arrive, so we needn't keep polling the port while no client is connected
+    Port.onReceive([]() { console->wake(); });
+    rxWakes = true;
+#endif
 #if defined(ARCH_NRF52) || defined(CONFIG_IDF_TARGET_ESP32S2) || defined(CONFIG_IDF_TARGET_ESP32S3) || defined(ARCH_RP2040) ||   \
     defined(CONFIG_IDF_TARGET_ESP32C3) || defined(CONFIG_IDF_TARGET_ESP32C6)
     time_t timeout = millis();
@@ -69,6 +74,7 @@ int32_t SerialConsole::runOnce()
 
 void SerialConsole::flush()
 {
+    flushLog();
     Port.flush();
 }
 
@@ -88,6 +94,7 @@ bool SerialConsole::handleToRadio(const uint8_t *buf, size_t len)
     if (config.has_lora && config.security.serial_enabled) {
         // Switch to protobufs for log messages
         usingProtobufs = true;
+        setBinary(false); // the client wants LogRecords
         canWrite = true;
 
         return StreamAPI::handleToRadio(buf, len);
@@ -96,12 +103,10 @@ bool SerialConsole::handleToRadio(const uint8_t *buf, size_t len)
     }
 }
 
-void SerialConsole::log_to_serial(const char *logLevel, const char *format, va_list arg)
+void SerialConsole::log_to_serial(const LogLine &line)
 {
-    if (usingProtobufs && config.security.debug_log_api_enabled) {
-        meshtastic_LogRecord_Level ll = RedirectablePrint::getLogLevel(logLevel);
-        auto thread = concurrency::OSThread::currentThread;
-        emitLogRecord(ll, thread ? thread->ThreadName.c_str() : "", format, arg);
-    } else
-        RedirectablePrint::log_to_serial(logLevel, format, arg);
+    if (usingProtobufs && config.security.debug_log_api_enabled)
+        emitLogRecord(RedirectablePrint::getLogLevel(line.level), line.thread, line.rtcSec, line.text);
+    else
+        RedirectablePrint::log_to_serial(line);
 }
\ No newline at end of file
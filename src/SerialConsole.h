@@ -31,6 +31,7 @@ class SerialConsole : public StreamAPI, public RedirectablePrint, private concur
 
     virtual int32_t runOnce() override;
 
+    /// Write out the queued log messages and wait until the port has sent them
     void flush();
 
   protected:
@@ -38,7 +39,7 @@ class SerialConsole : public StreamAPI, public RedirectablePrint, private concur
     virtual bool checkIsConnected() override;
 
     /// Possibly switch to protobufs if we see a valid protobuf message
-    virtual void log_to_serial(const char *logLevel, const char *format, va_list arg);
+    virtual void log_to_serial(const LogLine &line) override;
 };
 
 // A simple wrapper to allow non class aware code write to the console
@@ -2,6 +2,11 @@
 
 #include "../freertosinc.h"
 
+#ifdef ARCH_PORTDUINO
+#include <condition_variable>
+#include <mutex>
+#endif
+
 namespace concurrency
 {
 
@@ -9,7 +14,12 @@ namespace concurrency
 
 class BinarySemaphorePosix
 {
-    // SemaphoreHandle_t semaphore;
+#ifdef ARCH_PORTDUINO
+    // Given from worker and web server threads
+    std::mutex mutex;
+    std::condition_variable cond;
+    bool given = false;
+#endif
 
   public:
     BinarySemaphorePosix();
@@ -1,6 +1,8 @@
 #include "OSThread.h"
 #include "configuration.h"
+#include "main.h"
 #include "memGet.h"
+#include <algorithm>
 #include <assert.h>
 
 namespace concurrency
@@ -17,16 +19,213 @@ bool OSThread::showWaiting = false;
 
 const OSThread *OSThread::currentThread;
 
-ThreadController mainController, timerController;
+OSThreadController mainController, timerController;
 InterruptableDelay mainDelay;
 
+bool OSThreadController::add(OSThread *t)
+{
+    if (!ThreadController::add(t))
+        return false;
+    push(t, now64());
+    return true;
+}
+
+void OSThreadController::remove(OSThread *t)
+{
+    ThreadController::remove(t);
+
+    for (auto &d : due)
+        if (d == t)
+            d = NULL;
+
+    if (t->heapIndex >= 0) {
+        size_t i = t->heapIndex;
+        OSThread *last = heap.back();
+        heap.pop_back();
+        t->heapIndex = -1;
+        if (last != t) {
+            place(i, last);
+            siftUp(i);
+            siftDown(last->heapIndex);
+        }
+    }
+}
+
+uint64_t OSThreadController::now64()
+{
+    uint32_t ms = millis();
+    if (ms < lastMillis)
+        millisHigh += 1ULL << 32;
+    lastMillis = ms;
+    return millisHigh + ms;
+}
+
+void OSThreadController::setKey(OSThread *t, uint64_t now)
+{
+    // Clear this before looking at woken, a wake() that comes in between flags the thread again
+    t->rescheduled = false;
+    // wake() may come from another task, so it leaves setting the interval to us
+    if (t->woken)
+        t->Thread::setInterval(0);
+    if (!t->enabled) {
+        t->runAt = UINT64_MAX;
+        return;
+    }
+    // Same wrap-around rule as Thread::shouldRun(): due once the 32 bit difference is no longer negative
+    int32_t wait = (int32_t)(uint32_t)(t->_cached_next_run - (uint32_t)now);
+    t->runAt = (wait < 0 && (uint64_t)-(int64_t)wait > now) ? 0 : now + wait;
+}
+
+void OSThreadController::place(size_t i, OSThread *t)
+{
+    heap[i] = t;
+    t->heapIndex = i;
+}
+
+void OSThreadController::siftUp(size_t i)
+{
+    OSThread *t = heap[i];
+    while (i > 0) {
+        size_t parent = (i - 1) / 2;
+        if (heap[parent]->runAt <= t->runAt)
+            break;
+        place(i, heap[parent]);
+        i = parent;
+    }
+    place(i, t);
+}
+
+void OSThreadController::siftDown(size_t i)
+{
+    OSThread *t = heap[i];
+    size_t n = heap.size();
+    for (;;) {
+        size_t child = 2 * i + 1;
+        if (child >= n)
+            break;
+        if (child + 1 < n && heap[child + 1]->runAt < heap[child]->runAt)
+            child++;
+        if (t->runAt <= heap[child]->runAt)
+            break;
+        place(i, heap[child]);
+        i = child;
+    }
+    place(i, t);
+}
+
+void OSThreadController::push(OSThread *t, uint64_t now)
+{
+    setKey(t, now);
+    heap.push_back(t);
+    siftUp(heap.size() - 1);
+}
+
+OSThread *OSThreadController::pop()
+{
+    OSThread *t = heap[0];
+    OSThread *last = heap.back();
+    heap.pop_back();
+    t->heapIndex = -1;
+    if (!heap.empty()) {
+        place(0, last);
+        siftDown(0);
+    }
+    return t;
+}
+
+void OSThreadController::applyReschedules(uint64_t now)
+{
+    if (!rescheduleRequested)
+        return;
+    // Clear this first, a thread flagged while we sweep is picked up next time
+    rescheduleRequested = false;
+
+    // Collect before moving anything, sifting would reorder the entries we haven't looked at yet
+    moved.clear();
+    for (auto t : heap)
+        if (t->rescheduled)
+            moved.push_back(t);
+
+    for (auto t : moved) {
+        uint64_t old = t->runAt;
+        setKey(t, now);
+        if (t->runAt < old)
+            siftUp(t->heapIndex);
+        else
+            siftDown(t->heapIndex);
+    }
+}
+
+std::vector<const OSThread *> OSThreadController::getThreadsByRuntime()
+{
+    std::vector<const OSThread *> threads;
+    for (int i = 0; i < MAX_THREADS; i++) {
+        // Everything we add() is an OSThread
+        auto t = static_cast<const OSThread *>(get(i));
+        if (t)
+            threads.push_back(t);
+    }
+    std::sort(threads.begin(), threads.end(),
+              [](const OSThread *a, const OSThread *b) { return a->stats.totalUs > b->stats.totalUs; });
+    return threads;
+}
+
+void OSThreadController::resetStats()
+{
+    for (int i = 0; i < MAX_THREADS; i++) {
+        auto t = static_cast<OSThread *>(get(i));
+        if (t)
+            t->stats = {};
+    }
+    statsStartMs = millis();
+}
+
+uint32_t OSThreadController::getStatsMs() const
+{
+    return millis() - statsStartMs;
+}
+
+long OSThreadController::runOrDelay()
+{
+    uint64_t now = now64();
+    applyReschedules(now);
+
+    // Take every due thread off the heap before running any, so one that keeps asking to run again right away can't
+    // starve the others
+    due.clear();
+    while (!heap.empty() && heap[0]->runAt <= now)
+        due.push_back(pop());
+
+    // The first due thread is the one the main loop woke up for, unless something woke it
+    if (!due.empty() && !due[0]->woken)
+        due[0]->stats.wakeups++;
+
+    unsigned long time = millis();
+    for (size_t i = 0; i < due.size(); i++) {
+        if (due[i] && due[i]->shouldRun(time))
+            due[i]->run();
+        // Running it may have deleted it, or another due thread
+        if (due[i])
+            push(due[i], now64());
+    }
+    due.clear();
+    runned();
+
+    now = now64();
+    applyReschedules(now);
+    if (heap.empty() || heap[0]->runAt == UINT64_MAX)
+        return INT32_MAX;
+    uint64_t next = heap[0]->runAt;
+    return next > now ? (long)std::min(next - now, (uint64_t)INT32_MAX) : 0;
+}
+
 void OSThread::setup()
 {
     mainController.ThreadName = "mainController";
     timerController.ThreadName = "timerController";
 }
 
-OSThread::OSThread(const char *_name, uint32_t period, ThreadController *_controller)
+OSThread::OSThread(const char *_name, uint32_t period, OSThreadController *_controller)
     : Thread(NULL, period), controller(_controller)
 {
     assertIsSetup();
@@ -45,6 +244,20 @@ OSThread::~OSThread()
         controller->remove(this);
 }
 
+/**
+ * Wait a specified number msecs starting from the last time we were run
+ *
+ * Also called from ISRs, so only tell the controller to look at us again
+ */
+void IRAM_ATTR OSThread::setInterval(unsigned long _interval)
+{
+    Thread::setInterval(_interval);
+
+    rescheduled = true;
+    if (controller)
+        controller->requestReschedule();
+}
+
 /**
  * Wait a specified number msecs starting from the current time (rather than the last time we were run)
  */
@@ -55,6 +268,33 @@ void OSThread::setIntervalFromNow(unsigned long _interval)
 
     // Cache the next run based on the last_run
     _cached_next_run = millis() + interval;
+
+    rescheduled = true;
+    if (controller)
+        controller->requestReschedule();
+}
+
+/**
+ * Only sets flags, so it is safe from other tasks too: the controller sets the interval on the main loop
+ */
+void OSThread::wake()
+{
+    woken = true;
+    rescheduled = true;
+    if (controller)
+        controller->requestReschedule();
+    runASAP = true;
+    mainDelay.interrupt();
+}
+
+void IRAM_ATTR OSThread::wakeFromISR(BaseType_t *higherPriWoken)
+{
+    woken = true;
+    rescheduled = true;
+    if (controller)
+        controller->requestReschedule();
+    runASAP = true;
+    mainDelay.interruptFromISR(higherPriWoken);
 }
 
 bool OSThread::shouldRun(unsigned long time)
@@ -82,7 +322,21 @@ void OSThread::run()
     auto heap = memGet.getFreeHeap();
 #endif
     currentThread = this;
+
+    // How long we were kept waiting past the time we asked for, by other threads or by sleep.  A woken thread didn't ask
+    uint32_t late = (uint32_t)(millis() - _cached_next_run);
+    if (!woken && late < INT32_MAX) {
+        stats.totalLateMs += late;
+        stats.maxLateMs = std::max(stats.maxLateMs, late);
+    }
+
+    woken = false;
+    uint32_t start = micros();
     auto newDelay = runOnce();
+    uint32_t took = micros() - start;
+    stats.runs++;
+    stats.totalUs += took;
+    stats.maxUs = std::max(stats.maxUs, took);
 #ifdef DEBUG_HEAP
     auto newHeap = memGet.getFreeHeap();
     if (newHeap < heap)
@@ -93,6 +347,9 @@ void OSThread::run()
 
     runned();
 
+    // What it was waiting for may have happened after runOnce() looked
+    if (woken)
+        newDelay = 0;
     if (newDelay >= 0)
         setInterval(newDelay);
 
@@ -107,6 +364,15 @@ int32_t OSThread::disable()
     return INT32_MAX;
 }
 
+void IRAM_ATTR OSThread::enable()
+{
+    enabled = true;
+
+    rescheduled = true;
+    if (controller)
+        controller->requestReschedule();
+}
+
 /**
  * This flag is set **only** when setup() starts, to provide a way for us to check for sloppy static constructor calls.
  * Call assertIsSetup() to force a crash if someone tries to create an instance too early.
@@ -2,6 +2,7 @@
 
 #include <cstdlib>
 #include <stdint.h>
+#include <vector>
 
 #include "Thread.h"
 #include "ThreadController.h"
@@ -10,7 +11,79 @@
 namespace concurrency
 {
 
-extern ThreadController mainController, timerController;
+class OSThread;
+
+/**
+ * What an OSThread cost the main loop since boot (or since OSThreadController::resetStats())
+ */
+struct OSThreadStats {
+    uint32_t runs;
+    uint64_t totalUs;     // in runOnce()
+    uint32_t maxUs;       // the longest single runOnce()
+    uint64_t totalLateMs; // how long after its requested time each run started, summed up
+    uint32_t maxLateMs;
+    uint32_t wakeups; // runs its own timer started ahead of every other due thread, each one keeps the CPU from sleeping
+};
+
+/**
+ * A ThreadController that keeps its OSThreads in a min-heap ordered by their next run time.
+ *
+ * The stock runOrDelay() asks every thread whether it wants to run, on every pass of the main loop.  Here a pass only looks
+ * at the threads that are due and at the top of the heap, and moving a thread after it ran costs O(log n).
+ *
+ * setInterval() may be called from ISRs and other tasks (see NotifiedWorkerThread::notifyFromISR), so it never touches the
+ * heap.  It only flags the thread, and the flagged threads are moved at the start and end of the next runOrDelay().
+ *
+ * A disabled thread sits at the bottom of the heap and is never looked at, so turn it back on with OSThread::enable() (or
+ * follow the write to enabled with a setInterval()), never with a bare enabled = true.
+ */
+class OSThreadController : public ThreadController
+{
+  public:
+    bool add(OSThread *t);
+    void remove(OSThread *t);
+
+    /**
+     * Run every thread that is due
+     * @return msecs until the next one is due, INT32_MAX if none is enabled
+     */
+    long runOrDelay();
+
+    /// Called by OSThread from any context when its schedule changed
+    void requestReschedule() { rescheduleRequested = true; }
+
+    /// Every thread we run, the ones that spent the most time in runOnce() first
+    std::vector<const OSThread *> getThreadsByRuntime();
+
+    /// Start the stats of every thread from zero
+    void resetStats();
+
+    /// How many msecs the stats have been counting for, to turn them into rates
+    uint32_t getStatsMs() const;
+
+  private:
+    std::vector<OSThread *> heap; // heap[0] runs next
+    std::vector<OSThread *> due;  // popped off the heap by the current runOrDelay(), NULL once removed
+    std::vector<OSThread *> moved;
+
+    volatile bool rescheduleRequested = false;
+    uint32_t statsStartMs = 0;
+
+    // millis() extended to 64 bits so keys never wrap, only touched from the main loop
+    uint32_t lastMillis = 0;
+    uint64_t millisHigh = 0;
+
+    uint64_t now64();
+    void setKey(OSThread *t, uint64_t now);
+    void push(OSThread *t, uint64_t now);
+    OSThread *pop();
+    void siftUp(size_t i);
+    void siftDown(size_t i);
+    void place(size_t i, OSThread *t);
+    void applyReschedules(uint64_t now);
+};
+
+extern OSThreadController mainController, timerController;
 extern InterruptableDelay mainDelay;
 
 #define RUN_SAME -1
@@ -30,7 +103,17 @@ extern InterruptableDelay mainDelay;
  */
 class OSThread : public Thread
 {
-    ThreadController *controller;
+    friend class OSThreadController;
+
+    OSThreadController *controller;
+
+    // Scheduling state, owned by the controller
+    uint64_t runAt = 0; // when the heap thinks we are due, UINT64_MAX while disabled
+    int32_t heapIndex = -1;
+    volatile bool rescheduled = false; // set from any context, picked up by the controller
+    volatile bool woken = false;       // wake() was called since runOnce() last started
+
+    OSThreadStats stats = {};
 
     /// Show debugging info for disabled threads
     static bool showDisabled;
@@ -45,7 +128,7 @@ class OSThread : public Thread
     /// For debug printing only (might be null)
     static const OSThread *currentThread;
 
-    OSThread(const char *name, uint32_t period = 0, ThreadController *controller = &mainController);
+    OSThread(const char *name, uint32_t period = 0, OSThreadController *controller = &mainController);
 
     virtual ~OSThread();
 
@@ -55,11 +138,37 @@ class OSThread : public Thread
 
     virtual int32_t disable();
 
+    /**
+     * Undo disable(), the thread runs once its interval is up (follow with setInterval() to pick a new one)
+     *
+     * Safe from any context, like setInterval()
+     */
+    void enable();
+
+    const OSThreadStats &getStats() const { return stats; }
+
+    /**
+     * Wait a specified number msecs starting from the last time we were run
+     */
+    virtual void setInterval(unsigned long _interval) override;
+
     /**
      * Wait a specified number msecs starting from the current time (rather than the last time we were run)
      */
     void setIntervalFromNow(unsigned long _interval);
 
+    /**
+     * Run as soon as the main loop gets to it.  Safe to call from other tasks.
+     *
+     * For threads that wait for something instead of polling for it: runOnce() returns a long interval (INT32_MAX if nothing
+     * else needs doing) and whatever the thread waits for calls this.  A wake while runOnce() is running is not lost, the
+     * thread runs again straight after whatever interval it returned.
+     */
+    void wake();
+
+    /// wake() from an ISR
+    void wakeFromISR(BaseType_t *higherPriWoken);
+
   protected:
     /**
      * The method that will be called each time our thread gets a chance to run
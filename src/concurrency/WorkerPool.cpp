@@ -0,0 +1,88 @@
+#include "WorkerPool.h"
+#include "configuration.h"
+
+namespace concurrency
+{
+
+WorkerPool *workerPool;
+
+WorkerPool::WorkerPool(unsigned numThreads) : OSThread("WorkerPool")
+{
+#ifdef ARCH_PORTDUINO
+    for (unsigned i = 0; i < numThreads; i++)
+        threads.emplace_back(&WorkerPool::workerLoop, this);
+    LOG_INFO("Started %u worker threads", numThreads);
+#endif
+    // Woken by the workers when there is something to complete
+    setInterval(INT32_MAX);
+}
+
+WorkerPool::~WorkerPool()
+{
+#ifdef ARCH_PORTDUINO
+    {
+        std::lock_guard<std::mutex> g(mutex);
+        stopping = true;
+    }
+    jobReady.notify_all();
+    for (auto &t : threads)
+        t.join();
+#endif
+}
+
+void WorkerPool::submit(Job work, Job done)
+{
+#ifdef ARCH_PORTDUINO
+    if (workerPool && !workerPool->threads.empty()) {
+        {
+            std::lock_guard<std::mutex> g(workerPool->mutex);
+            workerPool->jobs.emplace_back(std::move(work), std::move(done));
+        }
+        workerPool->jobReady.notify_one();
+        return;
+    }
+#endif
+    work();
+    if (done)
+        done();
+}
+
+#ifdef ARCH_PORTDUINO
+void WorkerPool::workerLoop()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    for (;;) {
+        jobReady.wait(lock, [this] { return stopping || !jobs.empty(); });
+        if (stopping)
+            return;
+        auto job = std::move(jobs.front());
+        jobs.pop_front();
+
+        lock.unlock();
+        job.first();
+        lock.lock();
+
+        completions.push_back(std::move(job.second));
+        // Only flags us, the main loop moves us in its run queue
+        wake();
+    }
+}
+#endif
+
+int32_t WorkerPool::runOnce()
+{
+#ifdef ARCH_PORTDUINO
+    std::deque<Job> done;
+    {
+        std::lock_guard<std::mutex> g(mutex);
+        done.swap(completions);
+    }
+    for (auto &d : done)
+        if (d)
+            d();
+#endif
+    // A worker that finished while we drained woke us again, run() doesn't lose that
+    return INT32_MAX;
+}
+
+} // namespace concurrency
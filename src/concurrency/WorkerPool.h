@@ -0,0 +1,58 @@
+#pragma once
+
+#include "OSThread.h"
+#include <functional>
+
+#ifdef ARCH_PORTDUINO
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+#endif
+
+namespace concurrency
+{
+
+/**
+ * @brief Runs CPU heavy jobs off the main loop
+ *
+ * On meshtasticd with General.WorkerThreads set, a job runs on one of that many OS threads.  Its completion is queued and run
+ * on the main loop by this OSThread, so Router, NodeDB and the rest keep a single writer.  A job must therefore only touch
+ * what it was handed (copy globals like owner into it), and leave the logging to its completion (the logger isn't thread
+ * safe).
+ *
+ * Everywhere else, and without workers, submit() runs the job and its completion right away.
+ */
+class WorkerPool : private OSThread
+{
+  public:
+    typedef std::function<void()> Job;
+
+    explicit WorkerPool(unsigned numThreads);
+    ~WorkerPool();
+
+    /**
+     * Run work on a worker, then done (if set) on the main loop
+     */
+    static void submit(Job work, Job done = nullptr);
+
+  protected:
+    virtual int32_t runOnce() override;
+
+#ifdef ARCH_PORTDUINO
+  private:
+    std::vector<std::thread> threads;
+    std::mutex mutex;
+    std::condition_variable jobReady;
+    std::deque<std::pair<Job, Job>> jobs;
+    std::deque<Job> completions;
+    bool stopping = false;
+
+    void workerLoop();
+#endif
+};
+
+extern WorkerPool *workerPool;
+
+} // namespace concurrency
@@ -215,6 +215,12 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #define GPS_THREAD_INTERVAL 200
 #endif
 
+// Have u-blox M8 and later send UBX-NAV-PVT instead of NMEA. NMEA stays on if the module doesn't ACK the switch, define
+// to 0 (e.g. in variant.h) to always use NMEA
+#ifndef GPS_UBX_NAV_PVT
+#define GPS_UBX_NAV_PVT 1
+#endif
+
 /* Step #2: follow with defines common to the architecture;
    also enable HAS_ option not specifically disabled by variant.h */
 #include "architecture.h"
@@ -310,6 +316,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #define MESHTASTIC_EXCLUDE_PKI 1
 #define MESHTASTIC_EXCLUDE_POWER_FSM 1
 #define MESHTASTIC_EXCLUDE_TZ 1
+#define MESHTASTIC_EXCLUDE_RADIO_TRACE 1
 #endif
 
 // Turn off all optional modules
@@ -334,6 +341,18 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #define MESHTASTIC_EXCLUDE_SERIAL 1
 #define MESHTASTIC_EXCLUDE_POWERSTRESS 1
 #define MESHTASTIC_EXCLUDE_ADMIN 1
+#define MESHTASTIC_EXCLUDE_TELEMETRY_HISTORY 1
+#define MESHTASTIC_EXCLUDE_THREAD_STATS 1
+#endif
+
+// The radio event trace keeps RADIO_TRACE_SIZE events of 12 bytes in RAM, so only meshtasticd has it unless a build asks for
+// it with -DMESHTASTIC_EXCLUDE_RADIO_TRACE=0
+#ifndef MESHTASTIC_EXCLUDE_RADIO_TRACE
+#ifdef ARCH_PORTDUINO
+#define MESHTASTIC_EXCLUDE_RADIO_TRACE 0
+#else
+#define MESHTASTIC_EXCLUDE_RADIO_TRACE 1
+#endif
 #endif
 
 // // Turn off wifi even if HW supports wifi (webserver relies on wifi and is also disabled)
@@ -2,6 +2,8 @@
 
 #if !MESHTASTIC_EXCLUDE_I2C
 
+#include "FSCommon.h"
+#include "SPILock.h"
 #include "concurrency/LockGuard.h"
 #if defined(ARCH_PORTDUINO)
 #include "linux/LinuxHardwareI2C.h"
@@ -15,6 +17,24 @@
 #define XPOWERS_AXP192_AXP2101_ADDRESS 0x34
 #endif
 
+#define I2C_SCAN_CACHE_MAGIC 0x53433249 // "I2CS"
+
+typedef struct I2CScanCacheHeader {
+    uint32_t magic;
+    uint32_t key; // cacheKey(), a cache from another board or firmware is ignored
+    uint8_t count;
+    uint8_t reserved[3];
+} I2CScanCacheHeader;
+
+/// FNV-1a of the firmware version and hardware model, newer firmware may tell chips apart differently
+static uint32_t cacheKey()
+{
+    uint32_t h = 2166136261UL ^ HW_VENDOR;
+    for (const char *c = optstr(APP_VERSION); *c; c++)
+        h = (h ^ (uint8_t)*c) * 16777619UL;
+    return h;
+}
+
 bool in_array(uint8_t *array, int size, uint8_t lookfor)
 {
     int i;
@@ -114,6 +134,27 @@ uint16_t ScanI2CTwoWire::getRegisterValue(const ScanI2CTwoWire::RegisterLocation
     return value;
 }
 
+/// @return 0 if a device acknowledged address, like TwoWire::endTransmission()
+uint8_t ScanI2CTwoWire::probeAddress(TwoWire *i2cBus, uint8_t address) const
+{
+    uint8_t err;
+    i2cBus->beginTransmission(address);
+#ifdef ARCH_PORTDUINO
+    err = 2;
+    if ((address >= 0x30 && address <= 0x37) || (address >= 0x50 && address <= 0x5F)) {
+        if (i2cBus->read() != -1)
+            err = 0;
+    } else {
+        err = i2cBus->writeQuick((uint8_t)0);
+    }
+    if (err != 0)
+        err = 2;
+#else
+    err = i2cBus->endTransmission();
+#endif
+    return err;
+}
+
 #define SCAN_SIMPLE_CASE(ADDR, T, ...)                                                                                           \
     case ADDR:                                                                                                                   \
         logFoundDevice(__VA_ARGS__);                                                                                             \
@@ -162,20 +203,7 @@ void ScanI2CTwoWire::scanPort(I2CPort port, uint8_t *address, uint8_t asize)
                 continue;
             LOG_DEBUG("Scan address 0x%x", (uint8_t)addr.address);
         }
-        i2cBus->beginTransmission(addr.address);
-#ifdef ARCH_PORTDUINO
-        err = 2;
-        if ((addr.address >= 0x30 && addr.address <= 0x37) || (addr.address >= 0x50 && addr.address <= 0x5F)) {
-            if (i2cBus->read() != -1)
-                err = 0;
-        } else {
-            err = i2cBus->writeQuick((uint8_t)0);
-        }
-        if (err != 0)
-            err = 2;
-#else
-        err = i2cBus->endTransmission();
-#endif
+        err = probeAddress(i2cBus, addr.address);
         type = NONE;
         if (err == 0) {
             switch (addr.address) {
@@ -499,6 +527,117 @@ void ScanI2CTwoWire::scanPort(I2CPort port)
     scanPort(port, nullptr, 0);
 }
 
+void ScanI2CTwoWire::loadCache()
+{
+    cacheLoaded = true;
+#if defined(FSCom) && !MESHTASTIC_EXCLUDE_I2C_SCAN_CACHE
+    concurrency::LockGuard g(spiLock);
+    auto f = FSCom.open(I2C_SCAN_CACHE_FILE, FILE_O_READ);
+    if (!f)
+        return;
+    I2CScanCacheHeader header;
+    if (f.read((uint8_t *)&header, sizeof(header)) == sizeof(header) && header.magic == I2C_SCAN_CACHE_MAGIC &&
+        header.key == cacheKey() && header.count <= I2C_SCAN_CACHE_MAX &&
+        f.read((uint8_t *)cache, header.count * sizeof(CacheEntry)) == header.count * sizeof(CacheEntry)) {
+        cacheCount = header.count;
+    } else {
+        LOG_INFO("I2C scan cache is stale, full scan");
+    }
+    f.close();
+#endif
+}
+
+void ScanI2CTwoWire::scanPortCached(I2CPort port)
+{
+    if (!cacheLoaded)
+        loadCache();
+
+    // Devices whose probe does more than identify them (RTC setup), that has to happen on every boot
+    uint8_t reprobe[I2C_SCAN_CACHE_MAX];
+    uint8_t numReprobe = 0;
+    bool verified = false;
+    {
+        concurrency::LockGuard guard((concurrency::Lock *)&lock);
+        uint8_t numCached = 0;
+        for (uint8_t i = 0; i < cacheCount; i++) {
+            const CacheEntry &e = cache[i];
+            if (e.port != port)
+                continue;
+            numCached++;
+            DeviceAddress addr(port, e.address);
+            if (probeAddress(fetchI2CBus(addr), e.address) != 0) {
+                LOG_INFO("Cached I2C device at 0x%x is gone", e.address);
+                numCached = 0;
+                break;
+            }
+        }
+
+        if (numCached) {
+            for (uint8_t i = 0; i < cacheCount; i++) {
+                const CacheEntry &e = cache[i];
+                if (e.port != port)
+                    continue;
+#ifdef RV3028_RTC
+                if (e.type == RTC_RV3028) {
+                    reprobe[numReprobe++] = e.address;
+                    continue;
+                }
+#endif
+                DeviceAddress addr(port, e.address);
+                deviceAddresses[(DeviceType)e.type] = addr;
+                foundDevices[addr] = (DeviceType)e.type;
+                LOG_DEBUG("I2C device type %u at 0x%x from cache", e.type, e.address);
+            }
+            verified = true;
+        }
+    }
+
+    if (!verified) {
+        cacheDirty = true;
+        scanPort(port);
+    } else if (numReprobe) {
+        scanPort(port, reprobe, numReprobe);
+    }
+}
+
+void ScanI2CTwoWire::saveCache()
+{
+    if (!cacheDirty)
+        return;
+    cacheDirty = false;
+#if defined(FSCom) && !MESHTASTIC_EXCLUDE_I2C_SCAN_CACHE
+    I2CScanCacheHeader header = {I2C_SCAN_CACHE_MAGIC, cacheKey(), 0, {}};
+    CacheEntry found[I2C_SCAN_CACHE_MAX];
+    {
+        concurrency::LockGuard guard((concurrency::Lock *)&lock);
+        for (auto &d : foundDevices) {
+            if (header.count == I2C_SCAN_CACHE_MAX)
+                break;
+            found[header.count++] = {(uint8_t)d.first.port, d.first.address, (uint8_t)d.second};
+        }
+    }
+    // A full scan that found the same devices (an empty bus, say) needn't wear the flash
+    if (header.count == cacheCount && memcmp(found, cache, header.count * sizeof(CacheEntry)) == 0)
+        return;
+    memcpy(cache, found, sizeof(found));
+    cacheCount = header.count;
+
+    concurrency::LockGuard g(spiLock);
+    FSCom.mkdir("/prefs");
+    FSCom.remove(I2C_SCAN_CACHE_FILE);
+    auto f = FSCom.open(I2C_SCAN_CACHE_FILE, FILE_O_WRITE);
+    if (!f) {
+        LOG_WARN("Can't write I2C scan cache");
+        return;
+    }
+    f.write((const uint8_t *)&header, sizeof(header));
+    f.write((const uint8_t *)cache, header.count * sizeof(CacheEntry));
+    f.flush();
+    f.close();
+    LOG_DEBUG("Saved %u I2C devices to %s", header.count, I2C_SCAN_CACHE_FILE);
+#endif
+}
+
 TwoWire *ScanI2CTwoWire::fetchI2CBus(ScanI2C::DeviceAddress address) const
 {
     if (address.port == ScanI2C::I2CPort::WIRE) {
@@ -14,6 +14,12 @@
 
 #include "../concurrency/Lock.h"
 
+/// Where scanPortCached() keeps the devices found by the last full scan, delete it (or factory reset) to force a full scan
+#define I2C_SCAN_CACHE_FILE "/prefs/i2cscan.dat"
+
+/// Devices kept in the cache, across all ports
+#define I2C_SCAN_CACHE_MAX 16
+
 class ScanI2CTwoWire : public ScanI2C
 {
   public:
@@ -21,6 +27,16 @@ class ScanI2CTwoWire : public ScanI2C
 
     void scanPort(ScanI2C::I2CPort, uint8_t *, uint8_t) override;
 
+    /**
+     * Scan a port, trusting what the last full scan on this board and firmware found there: if every cached device still
+     * answers at its address we take its cached type, instead of probing all addresses and reading registers to tell chips
+     * apart.  Falls back to a full scan if any of them is gone, or if there is nothing cached for the port.
+     */
+    void scanPortCached(ScanI2C::I2CPort);
+
+    /// Store the results for the next boot, if a full scan changed them
+    void saveCache();
+
     ScanI2C::FoundDevice find(ScanI2C::DeviceType) const override;
 
     TwoWire *fetchI2CBus(ScanI2C::DeviceAddress) const;
@@ -53,6 +69,21 @@ class ScanI2CTwoWire : public ScanI2C
 
     concurrency::Lock lock;
 
+    typedef struct CacheEntry {
+        uint8_t port;
+        uint8_t address;
+        uint8_t type;
+    } CacheEntry;
+
+    CacheEntry cache[I2C_SCAN_CACHE_MAX];
+    uint8_t cacheCount = 0;
+    bool cacheLoaded = false;
+    bool cacheDirty = false;
+
+    void loadCache();
+
+    uint8_t probeAddress(TwoWire *, uint8_t) const;
+
     uint16_t getRegisterValue(const RegisterLocation &, ResponseWidth, bool) const;
 
     DeviceType probeOLED(ScanI2C::DeviceAddress) const;
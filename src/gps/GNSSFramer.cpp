@@ -0,0 +1,235 @@
+#include "GNSSFramer.h"
+
+#define UBX_SYNC1 0xB5
+#define UBX_SYNC2 0x62
+#define CAS_SYNC1 0xBA
+#define CAS_SYNC2 0xCE
+
+/// Sync bytes, class/id and the 16 bit length
+#define BINARY_HEADER_SIZE 6
+
+/// The NMEA checksum and line ending we append after the '*'
+#define NMEA_TRAILER_SIZE 4
+
+static uint8_t hexValue(uint8_t c)
+{
+    if (c >= '0' && c <= '9')
+        return c - '0';
+    if (c >= 'A' && c <= 'F')
+        return c - 'A' + 10;
+    if (c >= 'a' && c <= 'f')
+        return c - 'a' + 10;
+    return 0xFF;
+}
+
+static uint16_t readU16(const uint8_t *p)
+{
+    return p[0] | (p[1] << 8);
+}
+
+static uint32_t readU32(const uint8_t *p)
+{
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+bool GNSSFramer::feed(uint8_t c)
+{
+    counters.bytes++;
+
+    switch (state) {
+    case WAIT_SYNC:
+        sync(c);
+        return false;
+
+    case NMEA_BODY:
+        if ((c == '\r' || c == '\n') && len > 1) {
+            // Some proprietary sentences have no checksum at all
+            state = WAIT_SYNC;
+            return finishNMEA(false);
+        }
+        if (c < 0x20 || c > 0x7E || c == '$') {
+            // Binary output or a new sentence cut it short
+            counters.badFrames++;
+            sync(c);
+            return false;
+        }
+        if (len >= sizeof(buf) - NMEA_TRAILER_SIZE) {
+            counters.overflows++;
+            state = WAIT_SYNC;
+            return false;
+        }
+        buf[len++] = c;
+        if (c == '*')
+            state = NMEA_CHECKSUM;
+        else
+            nmeaSum ^= c;
+        return false;
+
+    case NMEA_CHECKSUM:
+        if (hexValue(c) > 0xF) {
+            counters.badFrames++;
+            sync(c);
+            return false;
+        }
+        buf[len++] = c;
+        if (buf[len - 2] == '*')
+            return false; // wait for the second digit
+        state = WAIT_SYNC;
+        return finishNMEA(true);
+
+    case BINARY_SYNC2:
+        if (c == (type == GNSS_FRAME_UBX ? UBX_SYNC2 : CAS_SYNC2)) {
+            buf[len++] = c;
+            state = BINARY_BODY;
+        } else {
+            sync(c);
+        }
+        return false;
+
+    case BINARY_BODY:
+        buf[len++] = c;
+        if (len == BINARY_HEADER_SIZE) {
+            uint32_t payloadLen = readU16(type == GNSS_FRAME_UBX ? buf + 4 : buf + 2);
+            uint32_t total = BINARY_HEADER_SIZE + payloadLen + (type == GNSS_FRAME_UBX ? 2 : 4);
+            if (total > sizeof(buf)) {
+                counters.overflows++;
+                state = WAIT_SYNC;
+                return false;
+            }
+            frameLen = total;
+        }
+        if (len < BINARY_HEADER_SIZE || len < frameLen)
+            return false;
+        state = WAIT_SYNC;
+        return finishBinary();
+    }
+    return false;
+}
+
+void GNSSFramer::sync(uint8_t c)
+{
+    len = 0;
+    if (c == '$' || c == '!') {
+        type = GNSS_FRAME_NMEA;
+        nmeaSum = 0;
+        buf[len++] = c;
+        state = NMEA_BODY;
+    } else if (c == UBX_SYNC1 || c == CAS_SYNC1) {
+        type = c == UBX_SYNC1 ? GNSS_FRAME_UBX : GNSS_FRAME_CAS;
+        buf[len++] = c;
+        state = BINARY_SYNC2;
+    } else {
+        state = WAIT_SYNC;
+        if (c != '\r' && c != '\n')
+            counters.discarded++;
+    }
+}
+
+bool GNSSFramer::finishNMEA(bool hasChecksum)
+{
+    if (hasChecksum) {
+        uint8_t sum = (hexValue(buf[len - 2]) << 4) | hexValue(buf[len - 1]);
+        if (sum != nmeaSum) {
+            counters.badFrames++;
+            return false;
+        }
+    }
+    // Leave out the '$', and the '*' with its two digits
+    uint16_t payloadLen = len - 1 - (hasChecksum ? NMEA_TRAILER_SIZE - 1 : 0);
+
+    // Hand it out with a line ending, whatever the receiver used, so TinyGPS commits it right away
+    buf[len++] = '\r';
+    buf[len++] = '\n';
+
+    current.type = GNSS_FRAME_NMEA;
+    current.data = buf;
+    current.len = len;
+    current.msgClass = 0;
+    current.msgId = 0;
+    current.payload = buf + 1; // between the '$' and the '*' or the line ending
+    current.payloadLen = payloadLen;
+    current.hasChecksum = hasChecksum;
+    if (hasChecksum)
+        counters.nmeaFrames++;
+    else
+        counters.nmeaNoSum++;
+    return true;
+}
+
+bool GNSSFramer::finishBinary()
+{
+    const uint8_t *payload = buf + BINARY_HEADER_SIZE;
+
+    if (type == GNSS_FRAME_UBX) {
+        uint16_t payloadLen = frameLen - BINARY_HEADER_SIZE - 2;
+
+        // 8 bit Fletcher over class, id, length and payload
+        uint8_t ckA = 0, ckB = 0;
+        for (uint16_t i = 2; i < frameLen - 2; i++) {
+            ckA += buf[i];
+            ckB += ckA;
+        }
+        if (ckA != buf[frameLen - 2] || ckB != buf[frameLen - 1]) {
+            counters.badFrames++;
+            return false;
+        }
+
+        current.msgClass = buf[2];
+        current.msgId = buf[3];
+        current.payloadLen = payloadLen;
+        counters.ubxFrames++;
+    } else {
+        uint16_t payloadLen = frameLen - BINARY_HEADER_SIZE - 4;
+
+        // Sum of id << 24, class << 16, the length and the payload as little endian words
+        uint32_t sum = ((uint32_t)buf[5] << 24) + ((uint32_t)buf[4] << 16) + payloadLen;
+        for (uint16_t i = 0; i + 4 <= payloadLen; i += 4)
+            sum += readU32(payload + i);
+        if (sum != readU32(buf + frameLen - 4)) {
+            counters.badFrames++;
+            return false;
+        }
+
+        current.msgClass = buf[4];
+        current.msgId = buf[5];
+        current.payloadLen = payloadLen;
+        counters.casFrames++;
+    }
+
+    current.type = type;
+    current.data = buf;
+    current.len = frameLen;
+    current.payload = payload;
+    current.hasChecksum = true;
+    return true;
+}
+
+bool parseUBXNavPvt(const GNSSFrame &frame, UBXNavPvt &pvt)
+{
+    // u-blox 7 sends a shorter, older version, we only need the fields up to pDOP
+    if (frame.type != GNSS_FRAME_UBX || frame.msgClass != UBX_CLASS_NAV || frame.msgId != UBX_NAV_PVT || frame.payloadLen < 78)
+        return false;
+
+    const uint8_t *p = frame.payload;
+    pvt.iTOW = readU32(p);
+    pvt.year = readU16(p + 4);
+    pvt.month = p[6];
+    pvt.day = p[7];
+    pvt.hour = p[8];
+    pvt.min = p[9];
+    pvt.sec = p[10];
+    pvt.timeValid = (p[11] & 0x07) == 0x07; // validDate, validTime and fullyResolved
+    pvt.fixType = p[20];
+    pvt.fixOK = p[21] & 0x01;
+    pvt.diffSoln = p[21] & 0x02;
+    pvt.numSV = p[23];
+    pvt.lon = (int32_t)readU32(p + 24);
+    pvt.lat = (int32_t)readU32(p + 28);
+    pvt.height = (int32_t)readU32(p + 32);
+    pvt.hMSL = (int32_t)readU32(p + 36);
+    pvt.hAcc = readU32(p + 40);
+    pvt.gSpeed = (int32_t)readU32(p + 60);
+    pvt.headMot = (int32_t)readU32(p + 64);
+    pvt.pDOP = readU16(p + 76);
+    return true;
+}
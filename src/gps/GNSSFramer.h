@@ -0,0 +1,111 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+/// Largest frame we can hold, longer frames are dropped (UBX-MON-VER with many extensions is the biggest one we ask for)
+#ifndef GNSS_MAX_FRAME_SIZE
+#define GNSS_MAX_FRAME_SIZE 512
+#endif
+
+enum GNSSFrameType : uint8_t {
+    GNSS_FRAME_NMEA, // $...*hh, always handed out terminated by \r\n
+    GNSS_FRAME_UBX,  // u-blox binary: B5 62 class id len16 payload ck_a ck_b
+    GNSS_FRAME_CAS   // AT6558 binary: BA CE len16 class id payload ck32
+};
+
+/**
+ * A complete frame with a valid checksum (or an NMEA sentence sent without one), pointing into the framer's buffer
+ */
+struct GNSSFrame {
+    GNSSFrameType type;
+    const uint8_t *data; // the whole frame, including sync bytes and checksum
+    uint16_t len;
+    uint8_t msgClass; // UBX/CAS only
+    uint8_t msgId;    // UBX/CAS only
+    const uint8_t *payload;
+    uint16_t payloadLen;
+    bool hasChecksum; // false for an NMEA sentence the receiver sent without one
+};
+
+struct GNSSFramerStats {
+    uint32_t bytes;        // everything fed in
+    uint32_t nmeaFrames;   // valid NMEA sentences
+    uint32_t nmeaNoSum;    // NMEA sentences without a checksum (e.g. UC6580 $PDTINFO), handed out unchecked
+    uint32_t ubxFrames;    // valid UBX frames
+    uint32_t casFrames;    // valid CAS frames
+    uint32_t badFrames;    // frames dropped because they were cut short or their checksum didn't match
+    uint32_t overflows;    // frames dropped because they didn't fit GNSS_MAX_FRAME_SIZE
+    uint32_t discarded;    // bytes outside of any frame (not counting line endings)
+};
+
+/**
+ * Splits the interleaved NMEA, UBX and CAS output of a GNSS receiver into whole, checksum-verified frames.
+ *
+ * Feed it one byte at a time in the order received.  Nothing is copied out: when feed() returns true the frame can be read
+ * with frame() until the next byte is fed.  A broken frame is dropped and the framer resyncs on the next sync byte, so a
+ * binary frame that starts in the middle of a truncated NMEA sentence is still found.
+ */
+class GNSSFramer
+{
+  public:
+    /** @return true if c completed a frame */
+    bool feed(uint8_t c);
+
+    /** The last completed frame, only valid right after feed() returned true */
+    const GNSSFrame &frame() const { return current; }
+
+    /** Drop any partially received frame */
+    void reset() { state = WAIT_SYNC; }
+
+    const GNSSFramerStats &stats() const { return counters; }
+
+  private:
+    enum State : uint8_t { WAIT_SYNC, NMEA_BODY, NMEA_CHECKSUM, BINARY_SYNC2, BINARY_BODY };
+
+    State state = WAIT_SYNC;
+    GNSSFrameType type = GNSS_FRAME_NMEA;
+    uint16_t len = 0;      // bytes in buf so far
+    uint16_t frameLen = 0; // expected length of a binary frame, once its header is in
+    uint8_t nmeaSum = 0;   // running XOR of the NMEA sentence
+    uint8_t buf[GNSS_MAX_FRAME_SIZE];
+
+    GNSSFrame current = {};
+    GNSSFramerStats counters = {};
+
+    /** Drop any frame in progress, and look for a new one starting at c */
+    void sync(uint8_t c);
+
+    bool finishNMEA(bool hasChecksum);
+    bool finishBinary();
+};
+
+/**
+ * The fields of UBX-NAV-PVT we use
+ */
+struct UBXNavPvt {
+    uint32_t iTOW; // GPS time of week of the navigation epoch, msec
+    uint16_t year;
+    uint8_t month, day, hour, min, sec;
+    bool timeValid;  // date and time are valid and fully resolved
+    uint8_t fixType; // 0 no fix, 1 dead reckoning, 2 2D, 3 3D, 4 GNSS + dead reckoning, 5 time only
+    bool fixOK;      // within the DOP and accuracy masks
+    bool diffSoln;   // differential corrections applied
+    uint8_t numSV;
+    int32_t lon, lat; // degrees * 1e7
+    int32_t height;   // above the ellipsoid, mm
+    int32_t hMSL;     // above mean sea level, mm
+    uint32_t hAcc;    // horizontal accuracy estimate, mm
+    int32_t gSpeed;   // ground speed, mm/s
+    int32_t headMot;  // heading of motion, degrees * 1e5
+    uint16_t pDOP;    // * 0.01
+};
+
+#define UBX_CLASS_NAV 0x01
+#define UBX_NAV_PVT 0x07
+
+/**
+ * Decode a UBX-NAV-PVT frame
+ * @return false if frame is something else or too short
+ */
+bool parseUBXNavPvt(const GNSSFrame &frame, UBXNavPvt &pvt);
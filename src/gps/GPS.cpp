@@ -182,45 +182,55 @@ uint8_t GPS::makeCASPacket(uint8_t class_id, uint8_t msg_id, uint8_t payload_siz
 
 GPS_RESPONSE GPS::getACK(const char *message, uint32_t waitMillis)
 {
-    uint8_t buffer[768] = {0};
-    uint8_t b;
-    int bytesRead = 0;
-    uint32_t startTimeout = millis() + waitMillis;
-#ifdef GPS_DEBUG
-    std::string debugmsg = "";
-#endif
-    while (millis() < startTimeout) {
-        if (_serial_gps->available()) {
-            b = _serial_gps->read();
+    uint32_t startTime = millis();
 
+    while (waitFrame(startTime, waitMillis)) {
+        const GNSSFrame &f = framer.frame();
+        if (f.type != GNSS_FRAME_NMEA)
+            continue;
 #ifdef GPS_DEBUG
-            debugmsg += vformat("%c", (b >= 32 && b <= 126) ? b : '.');
+        LOG_DEBUG("%.*s", f.len - 2, (const char *)f.data);
 #endif
-            buffer[bytesRead] = b;
-            bytesRead++;
-            if ((bytesRead == 767) || (b == '\r')) {
-                if (strnstr((char *)buffer, message, bytesRead) != nullptr) {
+        if (strnstr((const char *)f.data, message, f.len) != nullptr) {
 #ifdef GPS_DEBUG
-                    LOG_DEBUG("Found: %s", message); // Log the found message
+            LOG_DEBUG("Found: %s", message); // Log the found message
 #endif
-                    return GNSS_RESPONSE_OK;
-                } else {
-                    bytesRead = 0;
-#ifdef GPS_DEBUG
-                    LOG_DEBUG(debugmsg.c_str());
-#endif
-                }
-            }
+            return GNSS_RESPONSE_OK;
         }
     }
     return GNSS_RESPONSE_NONE;
 }
 
+bool GPS::readFrame()
+{
+    while (_serial_gps->available() > 0) {
+        if (framer.feed(_serial_gps->read()))
+            return true;
+    }
+    return false;
+}
+
+bool GPS::waitFrame(uint32_t startTime, uint32_t waitMillis)
+{
+    for (;;) {
+        if (readFrame())
+            return true;
+
+        uint32_t elapsed = millis() - startTime;
+        if (elapsed >= waitMillis)
+            return false;
+
+        // Nothing buffered, let the UART driver block until the next byte (or the deadline) instead of polling it
+        uint8_t b;
+        _serial_gps->setTimeout(waitMillis - elapsed);
+        if (_serial_gps->readBytes(&b, 1) == 1 && framer.feed(b))
+            return true;
+    }
+}
+
 GPS_RESPONSE GPS::getACKCas(uint8_t class_id, uint8_t msg_id, uint32_t waitMillis)
 {
     uint32_t startTime = millis();
-    uint8_t buffer[CAS_ACK_NACK_MSG_SIZE] = {0};
-    uint8_t bufferPos = 0;
 
     // CAS-ACK-(N)ACK structure
     //         | H1   | H2   | Payload Len | cls  | msg  | Payload                   | Checksum (4)              |
@@ -229,49 +239,26 @@ GPS_RESPONSE GPS::getACKCas(uint8_t class_id, uint8_t msg_id, uint32_t waitMilli
     // ACK-NACK| 0xBA | 0xCE | 0x04 | 0x00 | 0x05 | 0x00 | 0xXX | 0xXX | 0x00 | 0x00 | 0xXX | 0xXX | 0xXX | 0xXX |
     // ACK-ACK | 0xBA | 0xCE | 0x04 | 0x00 | 0x05 | 0x01 | 0xXX | 0xXX | 0x00 | 0x00 | 0xXX | 0xXX | 0xXX | 0xXX |
 
-    while (Throttle::isWithinTimespanMs(startTime, waitMillis)) {
-        if (_serial_gps->available()) {
-            buffer[bufferPos++] = _serial_gps->read();
-
-            // keep looking at the first two bytes of buffer until
-            // we have found the CAS frame header (0xBA, 0xCE), if not
-            // keep reading bytes until we find a frame header or we run
-            // out of time.
-            if ((bufferPos == 2) && !(buffer[0] == 0xBA && buffer[1] == 0xCE)) {
-                buffer[0] = buffer[1];
-                buffer[1] = 0;
-                bufferPos = 1;
-            }
-        }
+    while (waitFrame(startTime, waitMillis)) {
+        const GNSSFrame &f = framer.frame();
+        if (f.type != GNSS_FRAME_CAS || f.msgClass != 0x05 || f.payloadLen < 2 || f.payload[0] != class_id ||
+            f.payload[1] != msg_id)
+            continue; // This isn't the frame we are looking for
 
-        // we have read all the bytes required for the Ack/Nack (14-bytes)
-        // and we must have found a frame to get this far
-        if (bufferPos == sizeof(buffer) - 1) {
-            uint8_t msg_cls = buffer[4];     // message class should be 0x05
-            uint8_t msg_msg_id = buffer[5];  // message id should be 0x00 or 0x01
-            uint8_t payload_cls = buffer[6]; // payload class id
-            uint8_t payload_msg = buffer[7]; // payload message id
-
-            // Check for an ACK-ACK for the specified class and message id
-            if ((msg_cls == 0x05) && (msg_msg_id == 0x01) && payload_cls == class_id && payload_msg == msg_id) {
+        // Check for an ACK-ACK for the specified class and message id
+        if (f.msgId == 0x01) {
 #ifdef GPS_DEBUG
-                LOG_INFO("Got ACK for class %02X message %02X in %dms", class_id, msg_id, millis() - startTime);
+            LOG_INFO("Got ACK for class %02X message %02X in %dms", class_id, msg_id, millis() - startTime);
 #endif
-                return GNSS_RESPONSE_OK;
-            }
+            return GNSS_RESPONSE_OK;
+        }
 
-            // Check for an ACK-NACK for the specified class and message id
-            if ((msg_cls == 0x05) && (msg_msg_id == 0x00) && payload_cls == class_id && payload_msg == msg_id) {
+        // Check for an ACK-NACK for the specified class and message id
+        if (f.msgId == 0x00) {
 #ifdef GPS_DEBUG
-                LOG_WARN("Got NACK for class %02X message %02X in %dms", class_id, msg_id, millis() - startTime);
+            LOG_WARN("Got NACK for class %02X message %02X in %dms", class_id, msg_id, millis() - startTime);
 #endif
-                return GNSS_RESPONSE_NAK;
-            }
-
-            // This isn't the frame we are looking for, clear the buffer
-            // and try again until we run out of time.
-            memset(buffer, 0x0, sizeof(buffer));
-            bufferPos = 0;
+            return GNSS_RESPONSE_NAK;
         }
     }
     return GNSS_RESPONSE_NONE;
@@ -279,68 +266,37 @@ GPS_RESPONSE GPS::getACKCas(uint8_t class_id, uint8_t msg_id, uint32_t waitMilli
 
 GPS_RESPONSE GPS::getACK(uint8_t class_id, uint8_t msg_id, uint32_t waitMillis)
 {
-    uint8_t b;
-    uint8_t ack = 0;
-    const uint8_t ackP[2] = {class_id, msg_id};
-    uint8_t buf[10] = {0xB5, 0x62, 0x05, 0x01, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00};
     uint32_t startTime = millis();
-    const char frame_errors[] = "More than 100 frame errors";
-    int sCounter = 0;
+
+    while (waitFrame(startTime, waitMillis)) {
+        const GNSSFrame &f = framer.frame();
 #ifdef GPS_DEBUG
-    std::string debugmsg = "";
+        LOG_DEBUG("Got frame type %d class %02X message %02X len %u", f.type, f.msgClass, f.msgId, f.len);
 #endif
+        if (f.type == GNSS_FRAME_NMEA) {
+            // u-blox tells us over NMEA TXT when we talk to it at the wrong baud rate
+            if (strnstr((const char *)f.data, "More than 100 frame errors", f.len))
+                return GNSS_RESPONSE_FRAME_ERRORS;
+            continue;
+        }
 
-    for (int j = 2; j < 6; j++) {
-        buf[8] += buf[j];
-        buf[9] += buf[8];
-    }
+        // UBX-ACK-ACK / UBX-ACK-NAK carry the class and id of the message they answer
+        if (f.type != GNSS_FRAME_UBX || f.msgClass != 0x05 || f.payloadLen < 2 || f.payload[0] != class_id ||
+            f.payload[1] != msg_id)
+            continue;
 
-    for (int j = 0; j < 2; j++) {
-        buf[6 + j] = ackP[j];
-        buf[8] += buf[6 + j];
-        buf[9] += buf[8];
-    }
-
-    while (Throttle::isWithinTimespanMs(startTime, waitMillis)) {
-        if (ack > 9) {
+        if (f.msgId == 0x01) {
 #ifdef GPS_DEBUG
             LOG_INFO("Got ACK for class %02X message %02X in %dms", class_id, msg_id, millis() - startTime);
 #endif
             return GNSS_RESPONSE_OK; // ACK received
         }
-        if (_serial_gps->available()) {
-            b = _serial_gps->read();
-            if (b == frame_errors[sCounter]) {
-                sCounter++;
-                if (sCounter == 26) {
-#ifdef GPS_DEBUG
-
-                    LOG_DEBUG(debugmsg.c_str());
-#endif
-                    return GNSS_RESPONSE_FRAME_ERRORS;
-                }
-            } else {
-                sCounter = 0;
-            }
-#ifdef GPS_DEBUG
-            debugmsg += vformat("%02X", b);
-#endif
-            if (b == buf[ack]) {
-                ack++;
-            } else {
-                if (ack == 3 && b == 0x00) { // UBX-ACK-NAK message
-#ifdef GPS_DEBUG
-                    LOG_DEBUG(debugmsg.c_str());
-#endif
-                    LOG_WARN("Got NAK for class %02X message %02X", class_id, msg_id);
-                    return GNSS_RESPONSE_NAK; // NAK received
-                }
-                ack = 0; // Reset the acknowledgement counter
-            }
+        if (f.msgId == 0x00) {
+            LOG_WARN("Got NAK for class %02X message %02X", class_id, msg_id);
+            return GNSS_RESPONSE_NAK; // NAK received
         }
     }
 #ifdef GPS_DEBUG
-    LOG_DEBUG(debugmsg.c_str());
     LOG_WARN("No response for class %02X message %02X", class_id, msg_id);
 #endif
     return GNSS_RESPONSE_NONE; // No response received within timeout
@@ -357,73 +313,20 @@ GPS_RESPONSE GPS::getACK(uint8_t class_id, uint8_t msg_id, uint32_t waitMillis)
  */
 int GPS::getACK(uint8_t *buffer, uint16_t size, uint8_t requestedClass, uint8_t requestedID, uint32_t waitMillis)
 {
-    uint16_t ubxFrameCounter = 0;
     uint32_t startTime = millis();
-    uint16_t needRead = 0;
-
-    while (Throttle::isWithinTimespanMs(startTime, waitMillis)) {
-        if (_serial_gps->available()) {
-            int c = _serial_gps->read();
-            switch (ubxFrameCounter) {
-            case 0:
-                // ubxFrame 'μ'
-                if (c == 0xB5) {
-                    ubxFrameCounter++;
-                }
-                break;
-            case 1:
-                // ubxFrame 'b'
-                if (c == 0x62) {
-                    ubxFrameCounter++;
-                } else {
-                    ubxFrameCounter = 0;
-                }
-                break;
-            case 2:
-                // Class
-                if (c == requestedClass) {
-                    ubxFrameCounter++;
-                } else {
-                    ubxFrameCounter = 0;
-                }
-                break;
-            case 3:
-                // Message ID
-                if (c == requestedID) {
-                    ubxFrameCounter++;
-                } else {
-                    ubxFrameCounter = 0;
-                }
-                break;
-            case 4:
-                // Payload length lsb
-                needRead = c;
-                ubxFrameCounter++;
-                break;
-            case 5:
-                // Payload length msb
-                needRead |= (c << 8);
-                ubxFrameCounter++;
-                // Check for buffer overflow
-                if (needRead >= size) {
-                    ubxFrameCounter = 0;
-                    break;
-                }
-                if (_serial_gps->readBytes(buffer, needRead) != needRead) {
-                    ubxFrameCounter = 0;
-                } else {
-                    // return payload length
+
+    while (waitFrame(startTime, waitMillis)) {
+        const GNSSFrame &f = framer.frame();
+        // Skip other messages, and payloads that would overflow buffer
+        if (f.type != GNSS_FRAME_UBX || f.msgClass != requestedClass || f.msgId != requestedID || f.payloadLen >= size)
+            continue;
+
+        memcpy(buffer, f.payload, f.payloadLen);
+        // return payload length
 #ifdef GPS_DEBUG
-                    LOG_INFO("Got ACK for class %02X message %02X in %dms", requestedClass, requestedID, millis() - startTime);
+        LOG_INFO("Got ACK for class %02X message %02X in %dms", requestedClass, requestedID, millis() - startTime);
 #endif
-                    return needRead;
-                }
-                break;
-
-            default:
-                break;
-            }
-        }
+        return f.payloadLen;
     }
     return 0;
 }
@@ -660,6 +563,20 @@ bool GPS::setup()
             SEND_UBX_PACKET(0x06, 0x01, _message_RMC, "enable NMEA RMC", 500);
             SEND_UBX_PACKET(0x06, 0x01, _message_GGA, "enable NMEA GGA", 500);
 
+#if GPS_UBX_NAV_PVT
+            // Prefer NAV-PVT where the module has it, and only drop NMEA once it confirmed
+            if (ublox_info.protocol_version >= 15) {
+                msglen = makeUBXPacket(0x06, 0x01, sizeof(_message_NAV_PVT), _message_NAV_PVT);
+                _serial_gps->write(UBXscratch, msglen);
+                if (getACK(0x06, 0x01, 500) == GNSS_RESPONSE_OK) {
+                    navPvtEnabled = true;
+                    SEND_UBX_PACKET(0x06, 0x01, _message_DISABLE_RMC, "disable NMEA RMC", 500);
+                    SEND_UBX_PACKET(0x06, 0x01, _message_DISABLE_GGA, "disable NMEA GGA", 500);
+                    LOG_INFO("Use UBX-NAV-PVT instead of NMEA");
+                }
+            }
+#endif
+
             if (ublox_info.protocol_version >= 18) {
                 clearBuffer();
                 SEND_UBX_PACKET(0x06, 0x86, _message_PMS, "enable powersave for GPS", 500);
@@ -712,13 +629,27 @@ bool GPS::setup()
             SEND_UBX_PACKET(0x06, 0x8A, _message_VALSET_DISABLE_SBAS_BBR, "disable SBAS M10 GPS BBR", 300);
             delay(750); // will cause a receiver restart so wait a bit
 
-            // Done with initialization, Now enable wanted NMEA messages in BBR layer so they will survive a periodic
-            // sleep.
-            SEND_UBX_PACKET(0x06, 0x8A, _message_VALSET_ENABLE_NMEA_BBR, "enable messages for M10 GPS BBR", 300);
-            delay(750);
-            // Next enable wanted NMEA messages in RAM layer
-            SEND_UBX_PACKET(0x06, 0x8A, _message_VALSET_ENABLE_NMEA_RAM, "enable messages for M10 GPS RAM", 500);
-            delay(750);
+#if GPS_UBX_NAV_PVT
+            // Done with initialization, prefer NAV-PVT over NMEA, in RAM and in BBR so it survives a periodic sleep
+            msglen = makeUBXPacket(0x06, 0x8A, sizeof(_message_VALSET_ENABLE_NAV_PVT_RAM), _message_VALSET_ENABLE_NAV_PVT_RAM);
+            _serial_gps->write(UBXscratch, msglen);
+            if (getACK(0x06, 0x8A, 500) == GNSS_RESPONSE_OK) {
+                navPvtEnabled = true;
+                delay(750);
+                SEND_UBX_PACKET(0x06, 0x8A, _message_VALSET_ENABLE_NAV_PVT_BBR, "enable NAV-PVT for M10 GPS BBR", 300);
+                delay(750);
+                LOG_INFO("Use UBX-NAV-PVT instead of NMEA");
+            }
+#endif
+            if (!navPvtEnabled) {
+                // Done with initialization, Now enable wanted NMEA messages in BBR layer so they will survive a periodic
+                // sleep.
+                SEND_UBX_PACKET(0x06, 0x8A, _message_VALSET_ENABLE_NMEA_BBR, "enable messages for M10 GPS BBR", 300);
+                delay(750);
+                // Next enable wanted NMEA messages in RAM layer
+                SEND_UBX_PACKET(0x06, 0x8A, _message_VALSET_ENABLE_NMEA_RAM, "enable messages for M10 GPS RAM", 500);
+                delay(750);
+            }
 
             // As the M10 has no flash, the best we can do to preserve the config is to set it in RAM and BBR.
             // BBR will survive a restart, and power off for a while, but modules with small backup
@@ -1106,8 +1037,12 @@ int32_t GPS::runOnce()
         return disable(); // This should trigger when we have a fixed position, and get that first position
 
     // 9600bps is approx 1 byte per msec, so considering our buffer size we never need to wake more often than 200ms
-    // if not awake we can run super infrquently (once every 5 secs?) to see if we need to wake.
-    return (powerState == GPS_ACTIVE) ? GPS_THREAD_INTERVAL : 5000;
+    if (powerState == GPS_ACTIVE)
+        return GPS_THREAD_INTERVAL;
+    if (config.position.fixed_position)
+        return 5000;
+    // Between searches there's nothing to read, so sleep until the next one is due.  enable() reschedules us if need be
+    return std::min(std::max(scheduling.msUntilNextSearch(), (uint32_t)GPS_THREAD_INTERVAL), (uint32_t)INT32_MAX);
 }
 
 // clear the GPS rx buffer as quickly as possible
@@ -1116,6 +1051,7 @@ void GPS::clearBuffer()
     int x = _serial_gps->available();
     while (x--)
         _serial_gps->read();
+    framer.reset();
 }
 
 /// Prepare the GPS for the cpu entering deep or light sleep, expect to be gone for at least 100s of msecs
@@ -1457,6 +1393,22 @@ bool GPS::factoryReset()
  */
 bool GPS::lookForTime()
 {
+    if (navPvtEnabled) {
+        if (!navPvtUpdated || !navPvt.timeValid)
+            return false;
+        struct tm t;
+        t.tm_sec = navPvt.sec + round((millis() - navPvtMsec) / 1000);
+        t.tm_min = navPvt.min;
+        t.tm_hour = navPvt.hour;
+        t.tm_mday = navPvt.day;
+        t.tm_mon = navPvt.month - 1;
+        t.tm_year = navPvt.year - 1900;
+        t.tm_isdst = false;
+        LOG_DEBUG("UBX GPS time %02d-%02d-%02d %02d:%02d:%02d", navPvt.year, navPvt.month, t.tm_mday, t.tm_hour, t.tm_min,
+                  t.tm_sec);
+        perhapsSetRTC(RTCQualityGPS, t);
+        return true;
+    }
 
 #ifdef GNSS_AIROHA
     uint8_t fix = reader.fixQuality();
@@ -1509,6 +1461,9 @@ The Unix epoch (or Unix time or POSIX time or Unix timestamp) is the number of s
  */
 bool GPS::lookForLocation()
 {
+    if (navPvtEnabled)
+        return lookForNavPvtLocation();
+
 #ifdef GNSS_AIROHA
     if ((config.position.gps_update_interval * 1000) >= (GPS_FIX_HOLD_TIME * 2)) {
         uint8_t fix = reader.fixQuality();
@@ -1533,13 +1488,12 @@ bool GPS::lookForLocation()
     // At a minimum, use the fixQuality indicator in GPGGA (FIXME?)
     fixQual = reader.fixQuality();
 
-#ifndef TINYGPS_OPTION_NO_STATISTICS
-    if (reader.failedChecksum() > lastChecksumFailCount) {
-        LOG_WARN("%u new GPS checksum failures, for a total of %u", reader.failedChecksum() - lastChecksumFailCount,
-                 reader.failedChecksum());
-        lastChecksumFailCount = reader.failedChecksum();
+    // The framer drops broken sentences before TinyGPS sees them, so it keeps the count
+    if (framer.stats().badFrames > lastChecksumFailCount) {
+        LOG_WARN("%u new GPS checksum failures, for a total of %u", framer.stats().badFrames - lastChecksumFailCount,
+                 framer.stats().badFrames);
+        lastChecksumFailCount = framer.stats().badFrames;
     }
-#endif
 
 #ifndef TINYGPS_OPTION_NO_CUSTOM_FIELDS
     fixType = atoi(gsafixtype.value()); // will set to zero if no data
@@ -1655,6 +1609,62 @@ bool GPS::lookForLocation()
     return true;
 }
 
+bool GPS::lookForNavPvtLocation()
+{
+    // Is this a new point or are we re-reading the previous one?
+    if (!navPvtUpdated)
+        return false;
+    navPvtUpdated = false;
+
+    // Map the UBX fix onto the GPGGA fix quality and GPGSA fix type hasLock() understands
+    bool gnssFix = navPvt.fixOK && navPvt.fixType >= 2 && navPvt.fixType <= 4;
+    fixQual = gnssFix ? (navPvt.diffSoln ? 2 : 1) : (navPvt.fixType == 1 ? 6 : 0);
+#ifndef TINYGPS_OPTION_NO_CUSTOM_FIELDS
+    fixType = !gnssFix ? 1 : (navPvt.fixType == 2 ? 2 : 3);
+#endif
+
+    if (!hasLock() || !navPvt.timeValid)
+        return false;
+
+    p.location_source = meshtastic_Position_LocSource_LOC_INTERNAL;
+
+    // NAV-PVT only has PDOP, HDOP stays unset rather than guessed from it
+    p.PDOP = navPvt.pDOP;
+
+    // Same scale as our position, no conversion needed
+    p.latitude_i = navPvt.lat;
+    p.longitude_i = navPvt.lon;
+
+    p.altitude = navPvt.hMSL / 1000;
+    p.altitude_hae = navPvt.height / 1000;
+    p.altitude_geoidal_separation = (navPvt.height - navPvt.hMSL) / 1000;
+
+    p.fix_quality = fixQual;
+#ifndef TINYGPS_OPTION_NO_CUSTOM_FIELDS
+    p.fix_type = fixType;
+#endif
+
+    // positional timestamp
+    struct tm t;
+    t.tm_sec = navPvt.sec;
+    t.tm_min = navPvt.min;
+    t.tm_hour = navPvt.hour;
+    t.tm_mday = navPvt.day;
+    t.tm_mon = navPvt.month - 1;
+    t.tm_year = navPvt.year - 1900;
+    t.tm_isdst = false;
+    p.timestamp = gm_mktime(&t);
+
+    // Satellites used in the fix, like the GGA count the NMEA path puts here; NAV-PVT doesn't tell how many are in view
+    p.sats_in_view = navPvt.numSV;
+
+    if (navPvt.headMot >= 0 && navPvt.headMot < 36000000) // sanity check, already degrees * 10^-5
+        p.ground_track = navPvt.headMot;
+    p.ground_speed = navPvt.gSpeed * 36 / 10000; // mm/s to km/h
+
+    return true;
+}
+
 bool GPS::hasLock()
 {
     // Using GPGGA fix quality indicator
@@ -1671,12 +1681,12 @@ bool GPS::hasLock()
 
 bool GPS::hasFlow()
 {
-    return reader.passedChecksum() > 0;
+    const GNSSFramerStats &stats = framer.stats();
+    return stats.nmeaFrames + stats.nmeaNoSum + stats.ubxFrames + stats.casFrames > 0;
 }
 
 bool GPS::whileActive()
 {
-    unsigned int charsInBuf = 0;
     bool isValid = false;
 #ifdef GPS_DEBUG
     std::string debugmsg = "";
@@ -1691,21 +1701,17 @@ bool GPS::whileActive()
         clearBuffer();
     }
 #endif
-    // First consume any chars that have piled up at the receiver
-    while (_serial_gps->available() > 0) {
-        int c = _serial_gps->read();
-        UBXscratch[charsInBuf] = c;
+    // First consume any chars that have piled up at the receiver, a chunk at a time rather than a read() per char
+    uint8_t chunk[64];
+    int waiting;
+    while ((waiting = _serial_gps->available()) > 0) {
+        size_t n = _serial_gps->readBytes(chunk, min(waiting, (int)sizeof(chunk)));
+        for (size_t i = 0; i < n; i++) {
 #ifdef GPS_DEBUG
-        debugmsg += vformat("%c", (c >= 32 && c <= 126) ? c : '.');
+            debugmsg += vformat("%c", (chunk[i] >= 32 && chunk[i] <= 126) ? chunk[i] : '.');
 #endif
-        isValid |= reader.encode(c);
-        if (charsInBuf > sizeof(UBXscratch) - 10 || c == '\r') {
-            if (strnstr((char *)UBXscratch, "$GPTXT,01,01,02,u-blox ag - www.u-blox.com*50", charsInBuf)) {
-                rebootsSeen++;
-            }
-            charsInBuf = 0;
-        } else {
-            charsInBuf++;
+            if (framer.feed(chunk[i]))
+                isValid |= handleFrame(framer.frame());
         }
     }
 #ifdef GPS_DEBUG
@@ -1715,6 +1721,31 @@ bool GPS::whileActive()
 #endif
     return isValid;
 }
+
+bool GPS::handleFrame(const GNSSFrame &frame)
+{
+    bool isValid = false;
+    switch (frame.type) {
+    case GNSS_FRAME_NMEA:
+        // The framer already checked the sentence, TinyGPS only has to pick out the fields
+        for (uint16_t i = 0; i < frame.len; i++)
+            isValid |= reader.encode(frame.data[i]);
+        if (strnstr((const char *)frame.data, "$GPTXT,01,01,02,u-blox ag - www.u-blox.com*50", frame.len))
+            rebootsSeen++;
+        break;
+    case GNSS_FRAME_UBX:
+        if (parseUBXNavPvt(frame, navPvt)) {
+            navPvtUpdated = true;
+            navPvtMsec = millis();
+            isValid = true;
+        }
+        break;
+    default:
+        break;
+    }
+    return isValid;
+}
+
 void GPS::enable()
 {
     // Clear the old scheduling info (reset the lock-time prediction)
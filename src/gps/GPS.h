@@ -2,6 +2,7 @@
 #include "configuration.h"
 #if !MESHTASTIC_EXCLUDE_GPS
 
+#include "GNSSFramer.h"
 #include "GPSStatus.h"
 #include "GpioLogic.h"
 #include "Observer.h"
@@ -144,6 +145,7 @@ class GPS : private concurrency::OSThread
     GnssModel_t gnssModel = GNSS_MODEL_UNKNOWN;
 
     TinyGPSPlus reader;
+    GNSSFramer framer;
     uint8_t fixQual = 0; // fix quality from GPGGA
     uint32_t lastChecksumFailCount = 0;
 
@@ -155,6 +157,12 @@ class GPS : private concurrency::OSThread
     uint8_t fixType = 0;      // fix type from GPGSA
 #endif
 
+    /// Set when setup() switched the receiver from NMEA to UBX-NAV-PVT output
+    bool navPvtEnabled = false;
+    bool navPvtUpdated = false; // navPvt holds a solution we haven't looked at yet
+    uint32_t navPvtMsec = 0;    // millis() when navPvt was received
+    UBXNavPvt navPvt = {};
+
     uint32_t lastWakeStartMsec = 0, lastSleepStartMsec = 0, lastFixStartMsec = 0;
     uint32_t rx_gpio = 0;
     uint32_t tx_gpio = 0;
@@ -205,6 +213,27 @@ class GPS : private concurrency::OSThread
 
     GPS_RESPONSE getACKCas(uint8_t class_id, uint8_t msg_id, uint32_t waitMillis);
 
+    /**
+     * Feed the framer whatever the serial port has buffered, without waiting for more
+     * @return true if a frame was completed, read it with framer.frame()
+     */
+    bool readFrame();
+
+    /**
+     * Wait for the next frame, blocking in the serial driver (not polling) while there is nothing to read
+     * @return false if waitMillis passed since startTime without a frame
+     */
+    bool waitFrame(uint32_t startTime, uint32_t waitMillis);
+
+    /**
+     * Hand a frame received while active to the parser it belongs to
+     * @return true if it was a valid position/time message
+     */
+    bool handleFrame(const GNSSFrame &frame);
+
+    /** lookForLocation() for receivers sending UBX-NAV-PVT */
+    bool lookForNavPvtLocation();
+
     /// Prepare the GPS for the cpu entering deep sleep, expect to be gone for at least 100s of msecs
     /// always returns 0 to indicate okay to sleep
     int prepareDeepSleep(void *unused);
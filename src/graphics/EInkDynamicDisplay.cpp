@@ -3,11 +3,17 @@
 
 #if defined(USE_EINK) && defined(USE_EINK_DYNAMICDISPLAY)
 #include "EInkDynamicDisplay.h"
+#include "main.h"
 
 // Constructor
 EInkDynamicDisplay::EInkDynamicDisplay(uint8_t address, int sda, int scl, OLEDDISPLAY_GEOMETRY geometry, HW_I2C i2cBus)
     : EInkDisplay(address, sda, scl, geometry, i2cBus), NotifiedWorkerThread("EInkDynamicDisplay")
 {
+    // If limiting fast-refresh to the changed rows, grab memory to compare each new frame against the last one drawn
+#ifdef EINK_FAST_REFRESH_CHANGED_ROWS
+    previousImage = new uint8_t[EInkDisplay::displayBufferSize](); // Init with zeros
+#endif
+
     // If tracking ghost pixels, grab memory
 #ifdef EINK_LIMIT_GHOSTING_PX
     dirtyPixels = new uint8_t[EInkDisplay::displayBufferSize](); // Init with zeros
@@ -17,6 +23,10 @@ EInkDynamicDisplay::EInkDynamicDisplay(uint8_t address, int sda, int scl, OLEDDI
 // Destructor
 EInkDynamicDisplay::~EInkDynamicDisplay()
 {
+#ifdef EINK_FAST_REFRESH_CHANGED_ROWS
+    delete[] previousImage;
+#endif
+
     // If we were tracking ghost pixels, free the memory
 #ifdef EINK_LIMIT_GHOSTING_PX
     delete[] dirtyPixels;
@@ -49,6 +59,10 @@ void EInkDynamicDisplay::configForFastRefresh()
 {
     // Variant-specific code can go here
 #if defined(PRIVATE_HW)
+#elif defined(EINK_FAST_REFRESH_CHANGED_ROWS)
+    // Only refresh the rows which changed since the last update
+    uint16_t y = config.display.flip_screen ? (displayHeight - 1) - changedRowLast : changedRowFirst;
+    adafruitDisplay->setPartialWindow(0, y, adafruitDisplay->width(), (changedRowLast - changedRowFirst) + 1);
 #else
     // Otherwise:
     adafruitDisplay->setPartialWindow(0, 0, adafruitDisplay->width(), adafruitDisplay->height());
@@ -80,6 +94,12 @@ void EInkDynamicDisplay::applyRefreshMode()
         configForFullRefresh();
         currentConfig = FULL;
     }
+
+#ifdef EINK_FAST_REFRESH_CHANGED_ROWS
+    // Still FAST, but the partial window must follow this frame's changed rows
+    else if (currentConfig == FAST && refresh == FAST)
+        configForFastRefresh();
+#endif
 }
 
 // Update fastRefreshCount
@@ -156,7 +176,7 @@ bool EInkDynamicDisplay::determineMode()
     // -- New frame is due --
 
     resetRateLimiting(); // Once determineMode() ends, will have to wait again
-    hashImage();         // Generate here, so we can still copy it to previousImageHash, even if we skip the comparison check
+    findChangedRegion(); // Generate here, the changed rows are needed for fast refresh, even if we skip the comparison check
     LOG_DEBUG("determineMode(): "); // Begin log entry
 
     // Once mode determined, any remaining checks will bypass
@@ -298,7 +318,7 @@ void EInkDynamicDisplay::checkFrameMatchesPrevious()
         return;
 
     // If frame is *not* a duplicate, abort the check
-    if (imageHash != previousImageHash)
+    if (frameChanged)
         return;
 
 #if !defined(EINK_BACKGROUND_USES_FAST)
@@ -367,8 +387,50 @@ void EInkDynamicDisplay::resetRateLimiting()
     previousRunMs = millis();
 }
 
+// Read a word from a byte buffer, without assuming alignment
+static inline uint32_t readWord(const uint8_t *p)
+{
+    uint32_t w;
+    memcpy(&w, p, sizeof(w));
+    return w;
+}
+
+#ifdef EINK_FAST_REFRESH_CHANGED_ROWS
+// Compare this frame against the previous update's frame, word by word, and find which rows changed
+void EInkDynamicDisplay::findChangedRegion()
+{
+    const uint32_t size = displayBufferSize;
+
+    // Skip matching words from the start, then the remaining matching bytes
+    uint32_t first = 0;
+    while (first + sizeof(uint32_t) <= size && readWord(buffer + first) == readWord(previousImage + first))
+        first += sizeof(uint32_t);
+    while (first < size && buffer[first] == previousImage[first])
+        first++;
+
+    frameChanged = (first < size);
+    if (!frameChanged) {
+        // Nothing changed: if a refresh is forced anyway, redraw everything
+        changedRowFirst = 0;
+        changedRowLast = displayHeight - 1;
+        return;
+    }
+
+    // Same from the end. There is at least one differing byte, at index first
+    uint32_t end = size;
+    while (end >= first + sizeof(uint32_t) &&
+           readWord(buffer + end - sizeof(uint32_t)) == readWord(previousImage + end - sizeof(uint32_t)))
+        end -= sizeof(uint32_t);
+    while (buffer[end - 1] == previousImage[end - 1])
+        end--;
+
+    // Buffer is page-ordered: each run of displayWidth bytes holds 8 rows
+    changedRowFirst = (first / displayWidth) * 8;
+    changedRowLast = min((uint32_t)displayHeight - 1, ((end - 1) / displayWidth) * 8 + 7);
+}
+#else
 // Generate a hash of this frame, to compare against previous update
-void EInkDynamicDisplay::hashImage()
+void EInkDynamicDisplay::findChangedRegion()
 {
     imageHash = 0;
 
@@ -376,7 +438,9 @@ void EInkDynamicDisplay::hashImage()
     for (uint16_t b = 0; b < (displayWidth / 8) * displayHeight; b++) {
         imageHash ^= buffer[b] << b;
     }
+    frameChanged = (imageHash != previousImageHash);
 }
+#endif
 
 // Store the results of determineMode() for future use, and reset for next call
 void EInkDynamicDisplay::storeAndReset()
@@ -385,9 +449,13 @@ void EInkDynamicDisplay::storeAndReset()
     previousRefresh = refresh;
     previousReason = reason;
 
-    // Only store image hash if the display will update
+    // Only store the image (or its hash) if the display will update
     if (refresh != SKIPPED) {
+#ifdef EINK_FAST_REFRESH_CHANGED_ROWS
+        memcpy(previousImage, buffer, displayBufferSize);
+#else
         previousImageHash = imageHash;
+#endif
     }
 
     frameFlags = BACKGROUND;
@@ -405,21 +473,21 @@ void EInkDynamicDisplay::countGhostPixels()
     // Start a new count
     ghostPixelCount = 0;
 
-    // Check new image, bit by bit, for any white pixels at locations marked "dirty"
-    for (uint16_t i = 0; i < displayBufferSize; i++) {
-        for (uint8_t bit = 0; bit < 7; bit++) {
-
-            const bool dirty = (dirtyPixels[i] >> bit) & 1;       // Has pixel location been drawn to since full-refresh?
-            const bool shouldBeBlank = !((buffer[i] >> bit) & 1); // Is pixel location white in the new image?
-
-            // If pixel is (or has been) black since last full-refresh, and now is white: ghosting
-            if (dirty && shouldBeBlank)
-                ghostPixelCount++;
-
-            // Update the dirty status for this pixel - will this location become a ghost if set white in future?
-            if (!dirty && !shouldBeBlank)
-                dirtyPixels[i] |= (1 << bit);
-        }
+    // Ghost pixels are white in the new image, at locations marked "dirty" (black at some point since full-refresh)
+    // Compare a word at a time, then the remaining bytes
+    uint32_t i = 0;
+    for (; i + sizeof(uint32_t) <= displayBufferSize; i += sizeof(uint32_t)) {
+        uint32_t dirty = readWord(dirtyPixels + i);
+        const uint32_t image = readWord(buffer + i);
+        ghostPixelCount += __builtin_popcount(dirty & ~image);
+
+        // Any pixels black in the new image will become ghosts if set white in future
+        dirty |= image;
+        memcpy(dirtyPixels + i, &dirty, sizeof(dirty));
+    }
+    for (; i < displayBufferSize; i++) {
+        ghostPixelCount += __builtin_popcount(dirtyPixels[i] & ~buffer[i] & 0xFF);
+        dirtyPixels[i] |= buffer[i];
     }
 
     LOG_DEBUG("ghostPixels=%hu, ", ghostPixelCount);
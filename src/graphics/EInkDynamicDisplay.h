@@ -88,7 +88,7 @@ class EInkDynamicDisplay : public EInkDisplay, protected concurrency::NotifiedWo
     void checkFastRequested();            // Was the flag set for RESPONSIVE, or only BACKGROUND?
 
     void resetRateLimiting(); // Set previousRunMs - this now counts as an update, for rate-limiting
-    void hashImage();         // Generate a hashed version of this frame, to compare against previous update
+    void findChangedRegion(); // Compare this frame against the previous update's frame (or its hash), find which rows changed
     void storeAndReset();     // Keep results of determineMode() for later, tidy-up for next call
 
     // What we are determining for this frame
@@ -103,8 +103,15 @@ class EInkDynamicDisplay : public EInkDisplay, protected concurrency::NotifiedWo
 
     bool initialized = false;          // Have we drawn at least one frame yet?
     uint32_t previousRunMs = -1;       // When did determineMode() last run (rather than rejecting for rate-limiting)
-    uint32_t imageHash = 0;            // Hash of the current frame. Don't bother updating if nothing has changed!
+    bool frameChanged = true;          // Does the current frame differ from the previous update's? Don't bother updating if not!
+#ifdef EINK_FAST_REFRESH_CHANGED_ROWS
+    uint8_t *previousImage;            // Copy of the previous update's frame (dynamically allocated mem)
+    uint16_t changedRowFirst = 0;      // First row which differs from previousImage, fast-refresh is limited to these rows
+    uint16_t changedRowLast = 0;       // (for panels which handle a partial window well)
+#else
+    uint32_t imageHash = 0;            // Hash of the current frame
     uint32_t previousImageHash = 0;    // Hash of the previous update's frame
+#endif
     uint32_t fastRefreshCount = 0;     // How many fast-refreshes consecutively since last full refresh?
     refreshTypes currentConfig = FULL; // Which refresh type is GxEPD2 currently configured for
 
@@ -73,8 +73,13 @@ namespace graphics
 // This means the *visible* area (sh1106 can address 132, but shows 128 for example)
 #define IDLE_FRAMERATE 1 // in fps
 
+// Frames that don't call Screen::redrawWithin() are redrawn at the idle framerate, whether or not anything changed.  That is
+// left to the boot, alert and module frames: the boot and alert screens are timed out by runOnce(), and module frames draw
+// content the screen isn't told about
+#define IDLE_REDRAW_MSEC (1000 / IDLE_FRAMERATE)
+
 // DEBUG
-#define NUM_EXTRA_FRAMES 3 // text message and debug frame
+#define NUM_EXTRA_FRAMES 4 // text message and debug frames
 // if defined a pixel will blink to show redraws
 // #define SHOW_REDRAWS
 
@@ -411,6 +416,7 @@ static void drawCriticalFaultFrame(OLEDDisplay *display, OLEDDisplayUiState *sta
     display->setTextAlignment(TEXT_ALIGN_LEFT);
     display->setFont(FONT_SMALL);
     display->drawString(0 + x, FONT_HEIGHT_MEDIUM + y, "For help, please visit \nmeshtastic.org");
+    screen->redrawWithin(SCREEN_REDRAW_WHEN_DIRTY);
 }
 
 // Ignore messages originating from phone (from the current node 0x0) unless range test or store and forward module are enabled
@@ -498,6 +504,9 @@ void Screen::drawDigitalClockFrame(OLEDDisplay *display, OLEDDisplayUiState *sta
 
     drawWatchFaceToggleButton(display, display->getWidth() - 36, display->getHeight() - 36, screen->digitalWatchFace, 1);
 
+    // Both faces show seconds, and before the clock is set they wait for it every second
+    screen->redrawWithin(1000);
+
     display->setColor(OLEDDISPLAY_COLOR::WHITE);
 
     uint32_t rtc_sec = getValidTime(RTCQuality::RTCQualityDevice, true); // Display local timezone
@@ -730,6 +739,9 @@ void Screen::drawAnalogClockFrame(OLEDDisplay *display, OLEDDisplayUiState *stat
 
     drawWatchFaceToggleButton(display, display->getWidth() - 36, display->getHeight() - 36, screen->digitalWatchFace, 1);
 
+    // Both faces show seconds, and before the clock is set they wait for it every second
+    screen->redrawWithin(1000);
+
     // clock face center coordinates
     int16_t centerX = display->getWidth() / 2;
     int16_t centerY = display->getHeight() / 2;
@@ -976,6 +988,9 @@ static void drawTextMessageFrame(OLEDDisplay *display, OLEDDisplayUiState *state
     uint32_t hours = minutes / 60;
     uint32_t days = hours / 24;
 
+    // Seconds are only shown for the first minute, after that the text changes once per minute at most
+    screen->redrawWithin(minutes == 0 ? 1000 : (60 - seconds % 60) * 1000);
+
     // For timestamp
     uint8_t timestampHours, timestampMinutes;
     int32_t daysAgo;
@@ -1262,9 +1277,9 @@ static void drawGPScoordinates(OLEDDisplay *display, int16_t x, int16_t y, const
  * We keep a series of "after you've gone 10 meters, what is your heading since
  * the last reference point?"
  */
-float Screen::estimatedHeading(double lat, double lon)
+float Screen::estimatedHeading(int32_t lat, int32_t lon)
 {
-    static double oldLat, oldLon;
+    static int32_t oldLat, oldLon;
     static float b;
 
     if (oldLat == 0) {
@@ -1275,11 +1290,11 @@ float Screen::estimatedHeading(double lat, double lon)
         return b;
     }
 
-    float d = GeoCoord::latLongToMeter(oldLat, oldLon, lat, lon);
+    float d = GeoCoord::latLongToMeterFast(oldLat, oldLon, lat, lon);
     if (d < 10) // haven't moved enough, just keep current bearing
         return b;
 
-    b = GeoCoord::bearing(oldLat, oldLon, lat, lon);
+    b = GeoCoord::bearingFast(oldLat, oldLon, lat, lon);
     oldLat = lat;
     oldLon = lon;
 
@@ -1442,7 +1457,14 @@ static void drawNodeInfo(OLEDDisplay *display, OLEDDisplayUiState *state, int16_
     }
 
     static char lastStr[20];
-    screen->getTimeAgoStr(sinceLastSeen(node), lastStr, sizeof(lastStr));
+    uint32_t agoSecs = sinceLastSeen(node);
+    screen->getTimeAgoStr(agoSecs, lastStr, sizeof(lastStr));
+
+    // Seconds are only shown for the first two minutes (see getTimeAgoStr), and a compass moves continuously
+    if (agoSecs < 120 || screen->hasHeading())
+        screen->redrawWithin(1000);
+    else
+        screen->redrawWithin((60 - agoSecs % 60) * 1000);
 
     static char distStr[20];
     if (config.display.units == meshtastic_Config_DisplayConfig_DisplayUnits_IMPERIAL) {
@@ -1471,18 +1493,32 @@ static void drawNodeInfo(OLEDDisplay *display, OLEDDisplayUiState *state, int16_
         if (screen->hasHeading())
             myHeading = (screen->getHeading()) * PI / 180; // gotta convert compass degrees to Radians
         else
-            myHeading = screen->estimatedHeading(DegD(op.latitude_i), DegD(op.longitude_i));
+            myHeading = screen->estimatedHeading(op.latitude_i, op.longitude_i);
         screen->drawCompassNorth(display, compassX, compassY, myHeading);
 
         if (nodeDB->hasValidPosition(node)) {
             // display direction toward node
             hasNodeHeading = true;
             const meshtastic_PositionLite &p = node->position;
-            float d =
-                GeoCoord::latLongToMeter(DegD(p.latitude_i), DegD(p.longitude_i), DegD(op.latitude_i), DegD(op.longitude_i));
 
-            float bearingToOther =
-                GeoCoord::bearing(DegD(op.latitude_i), DegD(op.longitude_i), DegD(p.latitude_i), DegD(p.longitude_i));
+            // Distance and bearing only change when one of the positions does, not every time the frame is drawn
+            static struct {
+                NodeNum num;
+                int32_t lat, lon, ourLat, ourLon;
+                float distance, bearing;
+            } cached = {};
+            if (cached.num != node->num || cached.lat != p.latitude_i || cached.lon != p.longitude_i ||
+                cached.ourLat != op.latitude_i || cached.ourLon != op.longitude_i) {
+                cached.num = node->num;
+                cached.lat = p.latitude_i;
+                cached.lon = p.longitude_i;
+                cached.ourLat = op.latitude_i;
+                cached.ourLon = op.longitude_i;
+                cached.distance = GeoCoord::latLongToMeterFast(p.latitude_i, p.longitude_i, op.latitude_i, op.longitude_i);
+                cached.bearing = GeoCoord::bearingFast(op.latitude_i, op.longitude_i, p.latitude_i, p.longitude_i);
+            }
+            float d = cached.distance;
+            float bearingToOther = cached.bearing;
             // If the top of the compass is a static north then bearingToOther can be drawn on the compass directly
             // If the top of the compass is not a static north we need adjust bearingToOther based on heading
             if (!config.display.compass_north_top)
@@ -1632,9 +1668,8 @@ void Screen::handleSetOn(bool on, FrameCallback einkScreensaver)
             digitalWrite(VTFT_LEDA, TFT_BACKLIGHT_ON);
 #endif
 #endif
-            enabled = true;
-            setInterval(0); // Draw ASAP
-            runASAP = true;
+            enable();
+            markFrameDirty(); // Draw ASAP
         } else {
             powerMon->clearState(meshtastic_PowerMon_State_Screen_On);
 #ifdef USE_EINK
@@ -1937,9 +1972,31 @@ int32_t Screen::runOnce()
         return 0;
     }
 
-    // this must be before the frameState == FIXED check, because we always
-    // want to draw at least one FIXED frame before doing forceDisplay
-    ui->update();
+    // While idle, skip rendering entirely unless something on the current frame changed, or its content went stale
+    int32_t sleepMsec = 1000 / targetFramerate;
+    bool idle = targetFramerate == IDLE_FRAMERATE && ui->getUiState()->frameState == FIXED;
+    if (idle && !frameDirty && Throttle::isWithinTimespanMs(lastFrameRenderMsec, frameRedrawMsec)) {
+        sleepMsec = frameRedrawMsec - (millis() - lastFrameRenderMsec);
+    } else {
+        auto lastUpdate = ui->getUiState()->lastUpdate;
+        uint32_t redrawMsec = frameRedrawMsec;
+        frameRedrawMsec = UINT32_MAX; // Frames with time-dependent content lower this while drawing
+
+        // this must be before the frameState == FIXED check, because we always
+        // want to draw at least one FIXED frame before doing forceDisplay
+        ui->update();
+
+        if (ui->getUiState()->lastUpdate != lastUpdate) {
+            frameDirty = false;
+            lastFrameRenderMsec = millis();
+            if (frameRedrawMsec == UINT32_MAX)
+                frameRedrawMsec = IDLE_REDRAW_MSEC;
+            if (idle)
+                sleepMsec = frameRedrawMsec;
+        } else {
+            frameRedrawMsec = redrawMsec; // The UI decided it was too soon for another frame, nothing was drawn
+        }
+    }
 
     // Switch to a low framerate (to save CPU) when we are not in transition
     // but we should only call setTargetFPS when framestate changes, because
@@ -1967,15 +2024,18 @@ int32_t Screen::runOnce()
 
             LOG_DEBUG("LastScreenTransition exceeded %ums transition to next frame", (millis() - lastScreenTransition));
             handleOnPress();
+        } else if (config.display.auto_screen_carousel_secs > 0) {
+            // Don't sleep through the next carousel transition
+            int32_t carouselMsec = config.display.auto_screen_carousel_secs * 1000 - (millis() - lastScreenTransition);
+            sleepMsec = min(sleepMsec, carouselMsec);
         }
     }
 
     // LOG_DEBUG("want fps %d, fixed=%d", targetFramerate,
     // ui->getUiState()->frameState); If we are scrolling we need to be called
-    // soon, otherwise just 1 fps (to save CPU) We also ask to be called twice
-    // as fast as we really need so that any rounding errors still result with
-    // the correct framerate
-    return (1000 / targetFramerate);
+    // soon, otherwise just 1 fps (to save CPU), or not at all until the
+    // current frame changes or goes stale
+    return targetFramerate == IDLE_FRAMERATE ? sleepMsec : (1000 / targetFramerate);
 }
 
 void Screen::drawDebugInfoTrampoline(OLEDDisplay *display, OLEDDisplayUiState *state, int16_t x, int16_t y)
@@ -1996,6 +2056,14 @@ void Screen::drawDebugInfoWiFiTrampoline(OLEDDisplay *display, OLEDDisplayUiStat
     screen2->debugInfo.drawFrameWiFi(display, state, x, y);
 }
 
+#if !MESHTASTIC_EXCLUDE_THREAD_STATS
+void Screen::drawDebugInfoThreadsTrampoline(OLEDDisplay *display, OLEDDisplayUiState *state, int16_t x, int16_t y)
+{
+    Screen *screen2 = reinterpret_cast<Screen *>(state->userData);
+    screen2->debugInfo.drawFrameThreads(display, state, x, y);
+}
+#endif
+
 /* show a message that the SSL cert is being built
  * it is expected that this will be used during the boot phase */
 void Screen::setSSLFrames()
@@ -2151,6 +2219,8 @@ void Screen::setFrames(FrameFocus focus)
     // then all the nodes
     // We only show a few nodes in our scrolling list - because meshes with many nodes would have too many screens
     size_t numToShow = min(numMeshNodes, 4U);
+    fsi.positions.firstNodeInfo = numframes;
+    fsi.nodeInfoCount = numToShow;
     for (size_t i = 0; i < numToShow; i++)
         normalFrames[numframes++] = drawNodeInfo;
 
@@ -2173,6 +2243,10 @@ void Screen::setFrames(FrameFocus focus)
     }
 #endif
 
+#if !MESHTASTIC_EXCLUDE_THREAD_STATS
+    normalFrames[numframes++] = &Screen::drawDebugInfoThreadsTrampoline;
+#endif
+
     fsi.frameCount = numframes; // Total framecount is used to apply FOCUS_PRESERVE
     LOG_DEBUG("Finished build frames. numframes: %d", numframes);
 
@@ -2370,6 +2444,7 @@ void Screen::handlePrint(const char *text)
         return;
 
     dispdev->print(text);
+    markFrameDirty(); // The log frame shows it
 }
 
 void Screen::handleOnPress()
@@ -2414,6 +2489,20 @@ void Screen::handleShowNextFrame()
 #define SCREEN_TRANSITION_FRAMERATE 30 // fps
 #endif
 
+void Screen::markFrameDirty()
+{
+    frameDirty = true;
+    setInterval(0); // redraw at the next idle tick
+    runASAP = true;
+}
+
+bool Screen::isShowingNodeInfo()
+{
+    uint8_t frame = ui->getUiState()->currentFrame;
+    return showingNormalScreen && frame >= framesetInfo.positions.firstNodeInfo &&
+           frame < framesetInfo.positions.firstNodeInfo + framesetInfo.nodeInfoCount;
+}
+
 void Screen::setFastFramerate()
 {
     // We are about to start a transition so speed up fps
@@ -2428,6 +2517,9 @@ void DebugInfo::drawFrame(OLEDDisplay *display, OLEDDisplayUiState *state, int16
 {
     display->setFont(FONT_SMALL);
 
+    // Status changes and log lines mark this frame dirty, only the store and forward heartbeat goes stale on its own
+    screen->redrawWithin(moduleConfig.store_forward.enabled ? 60 * 1000 : SCREEN_REDRAW_WHEN_DIRTY);
+
     // The coordinates define the left starting point of the text
     display->setTextAlignment(TEXT_ALIGN_LEFT);
 
@@ -2542,6 +2634,9 @@ void DebugInfo::drawFrameWiFi(OLEDDisplay *display, OLEDDisplayUiState *state, i
 
     display->setFont(FONT_SMALL);
 
+    // Nothing tells us when the WiFi status or RSSI changes
+    screen->redrawWithin(5000);
+
     // The coordinates define the left starting point of the text
     display->setTextAlignment(TEXT_ALIGN_LEFT);
 
@@ -2690,6 +2785,8 @@ void DebugInfo::drawFrameSettings(OLEDDisplay *display, OLEDDisplayUiState *stat
     }
 
     display->drawString(x, y + FONT_HEIGHT_SMALL * 1, uptime.c_str());
+    // The uptime and the clock may show seconds, and channel utilization has no change event
+    screen->redrawWithin(1000);
 
     // Display Channel Utilization
     char chUtil[13];
@@ -2716,6 +2813,49 @@ void DebugInfo::drawFrameSettings(OLEDDisplay *display, OLEDDisplayUiState *stat
 #endif
 }
 
+#if !MESHTASTIC_EXCLUDE_THREAD_STATS
+void DebugInfo::drawFrameThreads(OLEDDisplay *display, OLEDDisplayUiState *state, int16_t x, int16_t y)
+{
+    display->setFont(FONT_SMALL);
+
+    // The coordinates define the left starting point of the text
+    display->setTextAlignment(TEXT_ALIGN_LEFT);
+
+    if (config.display.displaymode == meshtastic_Config_DisplayConfig_DisplayMode_INVERTED) {
+        display->fillRect(0 + x, 0 + y, x + display->getWidth(), y + FONT_HEIGHT_SMALL);
+        display->setColor(BLACK);
+    }
+
+    display->drawString(x, y, "Threads");
+    if (config.display.heading_bold)
+        display->drawString(x + 1, y, "Threads");
+    screen->redrawWithin(5000); // Long term averages, they barely move from one second to the next
+    const char *header = "busy  max ms";
+    display->drawString(x + SCREEN_WIDTH - display->getStringWidth(header), y, header);
+
+    display->setColor(WHITE);
+
+    // Share of the uptime spent in runOnce(), and the longest single run
+    auto threads = concurrency::mainController.getThreadsByRuntime();
+    uint32_t uptimeMs = millis();
+    for (size_t i = 0; i < threads.size() && i < 3; i++) {
+        const concurrency::OSThreadStats &s = threads[i]->getStats();
+        char line[32];
+        snprintf(line, sizeof(line), "%.12s", threads[i]->ThreadName.c_str());
+        display->drawString(x, y + FONT_HEIGHT_SMALL * (i + 1), line);
+        snprintf(line, sizeof(line), "%.1f%% %5u", uptimeMs ? s.totalUs / 10.0 / uptimeMs : 0.0, (unsigned)(s.maxUs / 1000));
+        display->drawString(x + SCREEN_WIDTH - display->getStringWidth(line), y + FONT_HEIGHT_SMALL * (i + 1), line);
+    }
+
+    /* Display a heartbeat pixel that blinks every time the frame is redrawn */
+#ifdef SHOW_REDRAWS
+    if (heartbeat)
+        display->setPixel(0, 0);
+    heartbeat = !heartbeat;
+#endif
+}
+#endif
+
 int Screen::handleStatusUpdate(const meshtastic::Status *arg)
 {
     // LOG_DEBUG("Screen got status update %d", arg->getStatusType());
@@ -2723,9 +2863,18 @@ int Screen::handleStatusUpdate(const meshtastic::Status *arg)
     case STATUS_TYPE_NODE:
         if (showingNormalScreen && nodeStatus->getLastNumTotal() != nodeStatus->getNumTotal()) {
             setFrames(FOCUS_PRESERVE); // Regen the list of screen frames (returning to same frame, if possible)
+        } else if (!isShowingNodeInfo() || nodeDB->updateGUI || nodeIndex >= nodeDB->getNumMeshNodes() ||
+                   nodeDB->updateGUIforNode == nodeDB->getMeshNodeByIndex(nodeIndex)) {
+            // A node frame only needs redrawing if it is showing the node that changed
+            markFrameDirty();
         }
         nodeDB->updateGUI = false;
         break;
+    case STATUS_TYPE_GPS:
+    case STATUS_TYPE_POWER:
+        // Position, heading and battery are shown on most frames
+        markFrameDirty();
+        break;
     }
 
     return 0;
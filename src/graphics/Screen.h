@@ -91,6 +91,9 @@ class Screen
 /// Convert an integer GPS coords to a floating point
 #define DegD(i) (i * 1e-7)
 
+/// For Screen::redrawWithin(): the frame has no time-dependent content, redraw it only when something marks it dirty
+#define SCREEN_REDRAW_WHEN_DIRTY INT32_MAX
+
 namespace
 {
 /// A basic 2D point class for drawing
@@ -150,6 +153,10 @@ class DebugInfo
     void drawFrame(OLEDDisplay *display, OLEDDisplayUiState *state, int16_t x, int16_t y);
     void drawFrameSettings(OLEDDisplay *display, OLEDDisplayUiState *state, int16_t x, int16_t y);
     void drawFrameWiFi(OLEDDisplay *display, OLEDDisplayUiState *state, int16_t x, int16_t y);
+#if !MESHTASTIC_EXCLUDE_THREAD_STATS
+    /// The threads that kept the main loop busiest
+    void drawFrameThreads(OLEDDisplay *display, OLEDDisplayUiState *state, int16_t x, int16_t y);
+#endif
 
     /// Protects all of internal state.
     concurrency::Lock lock;
@@ -223,12 +230,20 @@ class Screen : public concurrency::OSThread
 
     static uint16_t getCompassDiam(uint32_t displayWidth, uint32_t displayHeight);
 
-    float estimatedHeading(double lat, double lon);
+    float estimatedHeading(int32_t lat, int32_t lon);
 
     void drawNodeHeading(OLEDDisplay *display, int16_t compassX, int16_t compassY, uint16_t compassDiam, float headingRadian);
 
     void drawColumns(OLEDDisplay *display, int16_t x, int16_t y, const char **fields);
 
+    /// Called while drawing by frames with time-dependent content (clocks, "x minutes ago"...):
+    /// redraw the frame within msec, even if nothing was marked dirty
+    void redrawWithin(uint32_t msec)
+    {
+        if (msec < frameRedrawMsec)
+            frameRedrawMsec = msec;
+    }
+
     /// Handle button press, trackball or swipe action)
     void onPress() { enqueueCmd(ScreenCmd{.cmd = Cmd::ON_PRESS}); }
     void showPrevFrame() { enqueueCmd(ScreenCmd{.cmd = Cmd::SHOW_PREV_FRAME}); }
@@ -581,7 +596,7 @@ class Screen : public concurrency::OSThread
             return false; // not enqueued if our display is not in use
         else {
             bool success = cmdQueue.enqueue(cmd, 0);
-            enabled = true; // handle ASAP (we are the registered reader for cmdQueue, but might have been disabled)
+            enable(); // handle ASAP (we are the registered reader for cmdQueue, but might have been disabled)
             return success;
         }
     }
@@ -607,8 +622,10 @@ class Screen : public concurrency::OSThread
             uint8_t log = 0;
             uint8_t settings = 0;
             uint8_t wifi = 0;
+            uint8_t firstNodeInfo = 0;
         } positions;
 
+        uint8_t nodeInfoCount = 0;
         uint8_t frameCount = 0;
     } framesetInfo;
 
@@ -628,6 +645,12 @@ class Screen : public concurrency::OSThread
     /// Try to start drawing ASAP
     void setFastFramerate();
 
+    /// Something shown on the current frame changed, redraw it at the next idle tick
+    void markFrameDirty();
+
+    /// Is the current frame one of the drawNodeInfo frames?
+    bool isShowingNodeInfo();
+
     // Sets frame up for immediate drawing
     void setFrameImmediateDraw(FrameCallback *drawFrames);
 
@@ -638,6 +661,10 @@ class Screen : public concurrency::OSThread
 
     static void drawDebugInfoWiFiTrampoline(OLEDDisplay *display, OLEDDisplayUiState *state, int16_t x, int16_t y);
 
+#if !MESHTASTIC_EXCLUDE_THREAD_STATS
+    static void drawDebugInfoThreadsTrampoline(OLEDDisplay *display, OLEDDisplayUiState *state, int16_t x, int16_t y);
+#endif
+
 #if defined(DISPLAY_CLOCK_FRAME)
     static void drawAnalogClockFrame(OLEDDisplay *display, OLEDDisplayUiState *state, int16_t x, int16_t y);
 
@@ -672,6 +699,12 @@ class Screen : public concurrency::OSThread
     // Bluetooth PIN screen)
     bool showingNormalScreen = false;
 
+    // While idle (not in a transition), the current frame is only redrawn if something was marked dirty, or
+    // its time-dependent content went stale (see redrawWithin)
+    bool frameDirty = true;
+    uint32_t lastFrameRenderMsec = 0;
+    uint32_t frameRedrawMsec = 0; // How long the last render stays valid
+
     // Implementation to Adjust Brightness
     uint8_t brightness = BRIGHTNESS_DEFAULT; // H = 254, MH = 192, ML = 130 L = 103
 
@@ -684,6 +684,44 @@ TFTDisplay::TFTDisplay(uint8_t address, int sda, int scl, OLEDDISPLAY_GEOMETRY g
 #endif
 }
 
+TFTDisplay::~TFTDisplay()
+{
+    delete[] pagePixels;
+}
+
+static inline bool wordsEqual(const uint8_t *a, const uint8_t *b)
+{
+    uint32_t wa, wb;
+    memcpy(&wa, a, sizeof(wa)); // the OLED buffers are byte arrays, so don't assume alignment
+    memcpy(&wb, b, sizeof(wb));
+    return wa == wb;
+}
+
+/**
+ * Find the first and last byte that differ between a and b, comparing a word at a time
+ * @return false if they are identical
+ */
+static bool findChangedSpan(const uint8_t *a, const uint8_t *b, uint16_t len, uint16_t &first, uint16_t &last)
+{
+    uint16_t i = 0;
+    while (i + sizeof(uint32_t) <= len && wordsEqual(a + i, b + i))
+        i += sizeof(uint32_t);
+    while (i < len && a[i] == b[i])
+        i++;
+    if (i == len)
+        return false;
+
+    uint16_t j = len;
+    while (j >= i + sizeof(uint32_t) && wordsEqual(a + j - sizeof(uint32_t), b + j - sizeof(uint32_t)))
+        j -= sizeof(uint32_t);
+    while (a[j - 1] == b[j - 1])
+        j--;
+
+    first = i;
+    last = j - 1;
+    return true;
+}
+
 // Write the buffer to the display memory
 void TFTDisplay::display(bool fromBlank)
 {
@@ -692,29 +730,35 @@ void TFTDisplay::display(bool fromBlank)
     // tft->clear();
     concurrency::LockGuard g(spiLock);
 
-    uint16_t x, y;
-
-    for (y = 0; y < displayHeight; y++) {
-        for (x = 0; x < displayWidth; x++) {
-            auto isset = buffer[x + (y / 8) * displayWidth] & (1 << (y & 7));
-            if (!fromBlank) {
-                // get src pixel in the page based ordering the OLED lib uses FIXME, super inefficent
-                auto dblbuf_isset = buffer_back[x + (y / 8) * displayWidth] & (1 << (y & 7));
-                if (isset != dblbuf_isset) {
-                    tft->drawPixel(x, y, isset ? TFT_MESH : TFT_BLACK);
-                }
-            } else if (isset) {
-                tft->drawPixel(x, y, TFT_MESH);
-            }
+    // One page of the OLED buffer holds 8 rows, expanded to RGB565 here so we can push it in one go
+    if (!pagePixels)
+        pagePixels = new uint16_t[displayWidth * 8];
+
+    // pushImage() takes native RGB565, leave the byte order as we found it for everybody else drawing on tft
+    bool swapBytes = tft->getSwapBytes();
+    tft->setSwapBytes(true);
+    tft->startWrite();
+    // The last page is partial when the height isn't a multiple of 8 (e.g. 135 or 170 rows)
+    for (uint16_t page = 0; page < (displayHeight + 7) / 8; page++) {
+        const uint8_t *src = buffer + page * displayWidth;
+        uint16_t first = 0, last = displayWidth - 1;
+        if (!fromBlank && !findChangedSpan(src, buffer_back + page * displayWidth, displayWidth, first, last))
+            continue;
+
+        uint16_t w = last - first + 1;
+        uint8_t rows = min(8, displayHeight - page * 8);
+        for (uint16_t x = first; x <= last; x++) {
+            uint8_t bits = src[x];
+            for (uint8_t row = 0; row < rows; row++)
+                pagePixels[row * w + (x - first)] = (bits & (1 << row)) ? TFT_MESH : TFT_BLACK;
         }
+        tft->pushImage(first, page * 8, w, rows, pagePixels);
     }
+    tft->endWrite();
+    tft->setSwapBytes(swapBytes);
+
     // Copy the Buffer to the Back Buffer
-    for (y = 0; y < (displayHeight / 8); y++) {
-        for (x = 0; x < displayWidth; x++) {
-            uint16_t pos = x + y * displayWidth;
-            buffer_back[pos] = buffer[pos];
-        }
-    }
+    memcpy(buffer_back, buffer, displayBufferSize);
 }
 
 // Send a command to the display (low level function)
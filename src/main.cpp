@@ -88,6 +88,7 @@ NRF52Bluetooth *nrf52Bluetooth = nullptr;
 #endif
 
 #ifdef ARCH_PORTDUINO
+#include "concurrency/WorkerPool.h"
 #include "linux/LinuxHardwareI2C.h"
 #include "mesh/raspihttp/PiWebServer.h"
 #include "platform/portduino/PortduinoGlue.h"
@@ -440,36 +441,40 @@ void setup()
 #if HAS_WIRE
     LOG_INFO("Scan for i2c devices");
 #endif
+    uint32_t i2cScanStart = millis();
 
 #if defined(I2C_SDA1) && defined(ARCH_RP2040)
     Wire1.setSDA(I2C_SDA1);
     Wire1.setSCL(I2C_SCL1);
     Wire1.begin();
-    i2cScanner->scanPort(ScanI2C::I2CPort::WIRE1);
+    i2cScanner->scanPortCached(ScanI2C::I2CPort::WIRE1);
 #elif defined(I2C_SDA1) && !defined(ARCH_RP2040)
     Wire1.begin(I2C_SDA1, I2C_SCL1);
-    i2cScanner->scanPort(ScanI2C::I2CPort::WIRE1);
+    i2cScanner->scanPortCached(ScanI2C::I2CPort::WIRE1);
 #elif defined(NRF52840_XXAA) && (WIRE_INTERFACES_COUNT == 2)
-    i2cScanner->scanPort(ScanI2C::I2CPort::WIRE1);
+    i2cScanner->scanPortCached(ScanI2C::I2CPort::WIRE1);
 #endif
 
 #if defined(I2C_SDA) && defined(ARCH_RP2040)
     Wire.setSDA(I2C_SDA);
     Wire.setSCL(I2C_SCL);
     Wire.begin();
-    i2cScanner->scanPort(ScanI2C::I2CPort::WIRE);
+    i2cScanner->scanPortCached(ScanI2C::I2CPort::WIRE);
 #elif defined(I2C_SDA) && !defined(ARCH_RP2040)
     Wire.begin(I2C_SDA, I2C_SCL);
-    i2cScanner->scanPort(ScanI2C::I2CPort::WIRE);
+    i2cScanner->scanPortCached(ScanI2C::I2CPort::WIRE);
 #elif defined(ARCH_PORTDUINO)
     if (settingsStrings[i2cdev] != "") {
         LOG_INFO("Scan for i2c devices");
-        i2cScanner->scanPort(ScanI2C::I2CPort::WIRE);
+        i2cScanner->scanPortCached(ScanI2C::I2CPort::WIRE);
     }
 #elif HAS_WIRE
-    i2cScanner->scanPort(ScanI2C::I2CPort::WIRE);
+    i2cScanner->scanPortCached(ScanI2C::I2CPort::WIRE);
 #endif
 
+    i2cScanner->saveCache();
+    LOG_DEBUG("I2C scan took %u ms", millis() - i2cScanStart);
+
     auto i2cCount = i2cScanner->countDevices();
     if (i2cCount == 0) {
         LOG_INFO("No I2C devices found");
@@ -1096,6 +1101,10 @@ void setup()
 #endif
 
 #ifdef ARCH_PORTDUINO
+    if (settingsMap[workerthreads] > 0) {
+        concurrency::workerPool = new concurrency::WorkerPool(settingsMap[workerthreads]);
+        std::atexit([] { delete concurrency::workerPool; });
+    }
 #if __has_include(<ulfius.h>)
     if (settingsMap[webserverport] != -1) {
         piwebServerThread = new PiWebServerThread();
@@ -1112,6 +1121,7 @@ void setup()
         RECORD_CRITICALERROR(meshtastic_CriticalErrorCode_NO_RADIO);
     else {
         router->addInterface(rIf);
+        LOG_INFO("Radio ready %u ms after boot", millis());
 
         // Log bit rate to debug output
         LOG_DEBUG("LoRA bitrate = %f bytes / sec", (float(meshtastic_Constants_DATA_PAYLOAD_LEN) /
@@ -1119,10 +1129,16 @@ void setup()
                                                        1000);
     }
 
+    // The radio is listening, the nodes that aren't needed for that can come in now
+    nodeDB->startDeferredLoad();
+
     // This must be _after_ service.init because we need our preferences loaded from flash to have proper timeout values
     PowerFSM_setup(); // we will transition to ON in a couple of seconds, FIXME, only do this for cold boots, not waking from SDS
     powerFSMthread = new PowerFSMThread();
     setCPUFast(false); // 80MHz is fine for our slow peripherals
+
+    // From now on the log is written out by the main loop, not by whoever logged
+    DEBUG_PORT.setAsync(true);
 }
 #endif
 uint32_t rebootAtMsec;   // If not zero we will reboot at this time (used to reboot shortly after the update completes)
@@ -1214,6 +1230,9 @@ void loop()
 
     long delayMsec = mainController.runOrDelay();
 
+    // Write out what was logged during this pass, and by other tasks and interrupts since the last one
+    DEBUG_PORT.flushLog();
+
     // We want to sleep as long as possible here - because it saves power
     if (!runASAP && loopCanSleep()) {
         mainDelay.delay(delayMsec);
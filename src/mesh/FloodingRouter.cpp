@@ -23,11 +23,9 @@ bool FloodingRouter::shouldFilterReceived(const meshtastic_MeshPacket *p)
     if (wasSeenRecently(p)) { // Note: this will also add a recent packet record
         printPacket("Ignore dupe incoming msg", p);
         rxDupe++;
-        if (config.device.role != meshtastic_Config_DeviceConfig_Role_ROUTER &&
-            config.device.role != meshtastic_Config_DeviceConfig_Role_REPEATER &&
-            config.device.role != meshtastic_Config_DeviceConfig_Role_ROUTER_LATE) {
-            // cancel rebroadcast of this message *if* there was already one, unless we're a router/repeater!
-            if (Router::cancelSending(p->from, p->id))
+        if (shouldSuppressRelay(p)) {
+            // cancel rebroadcast of this message *if* there was already one, enough others have relayed it already
+            if (Router::cancelSending(p->from, p->id, RADIO_TRACE_CANCEL_RELAYED))
                 txRelayCanceled++;
         }
         if (config.device.role == meshtastic_Config_DeviceConfig_Role_ROUTER_LATE && iface) {
@@ -51,6 +49,40 @@ bool FloodingRouter::shouldFilterReceived(const meshtastic_MeshPacket *p)
     return Router::shouldFilterReceived(p);
 }
 
+RelaySuppressionPolicy FloodingRouter::getRelaySuppressionPolicy(meshtastic_Config_DeviceConfig_Role role)
+{
+    switch (role) {
+    case meshtastic_Config_DeviceConfig_Role_ROUTER:
+    case meshtastic_Config_DeviceConfig_Role_REPEATER:
+        // Infrastructure should relay unless the area around it is clearly covered already
+        return {ROUTER_RELAY_SUPPRESSION_THRESHOLD, true};
+    case meshtastic_Config_DeviceConfig_Role_ROUTER_LATE:
+        // Late routers are the backstop of the flood, they always relay
+        return {0, false};
+    default:
+        // Clients back off as soon as anybody else relayed
+        return {CLIENT_RELAY_SUPPRESSION_THRESHOLD, false};
+    }
+}
+
+bool FloodingRouter::shouldSuppressRelay(const meshtastic_MeshPacket *p)
+{
+    RelaySuppressionPolicy policy = getRelaySuppressionPolicy(config.device.role);
+    if (policy.threshold == 0)
+        return false;
+
+    // Older firmware doesn't fill in relay_node, so we can't tell relayers apart: treat any duplicate as one relayer
+    uint8_t heard = getNumRelayersHeard(p, policy.onlyBetterCoverage);
+    if (p->relay_node == NO_RELAY_NODE && !policy.onlyBetterCoverage)
+        heard = max(heard, (uint8_t)1);
+
+    if (heard < policy.threshold)
+        return false;
+
+    LOG_DEBUG("Heard %u relayers of 0x%x, suppress our relay", heard, p->id);
+    return true;
+}
+
 bool FloodingRouter::isRebroadcaster()
 {
     return config.device.role != meshtastic_Config_DeviceConfig_Role_CLIENT_MUTE &&
@@ -96,7 +128,7 @@ void FloodingRouter::sniffReceived(const meshtastic_MeshPacket *p, const meshtas
     if (isAckorReply && !isToUs(p) && !isBroadcast(p->to)) {
         // do not flood direct message that is ACKed or replied to
         LOG_DEBUG("Rxd an ACK/reply not for me, cancel rebroadcast");
-        Router::cancelSending(p->to, p->decoded.request_id); // cancel rebroadcast for this DM
+        Router::cancelSending(p->to, p->decoded.request_id, RADIO_TRACE_CANCEL_ACKED); // cancel rebroadcast for this DM
     }
 
     perhapsRebroadcast(p);
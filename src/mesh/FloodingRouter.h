@@ -3,6 +3,28 @@
 #include "PacketHistory.h"
 #include "Router.h"
 
+/// Number of distinct relayers a client role needs to hear before cancelling its own pending rebroadcast
+#ifndef CLIENT_RELAY_SUPPRESSION_THRESHOLD
+#define CLIENT_RELAY_SUPPRESSION_THRESHOLD 1
+#endif
+
+/// Number of distinct relayers, heard at least as well as the original copy, a router needs to hear before cancelling its own
+/// pending rebroadcast
+#ifndef ROUTER_RELAY_SUPPRESSION_THRESHOLD
+#define ROUTER_RELAY_SUPPRESSION_THRESHOLD 3
+#endif
+
+/**
+ * How a role decides to cancel its queued rebroadcast after overhearing others relay the same packet
+ */
+struct RelaySuppressionPolicy {
+    /** Number of distinct relayers we need to hear, 0 to never cancel */
+    uint8_t threshold;
+
+    /** Only count relayers we heard at least as well as the copy we are about to relay (see PacketHistory) */
+    bool onlyBetterCoverage;
+};
+
 /**
  * This is a mixin that extends Router with the ability to do Naive Flooding (in the standard mesh protocol sense)
  *
@@ -28,13 +50,6 @@
  */
 class FloodingRouter : public Router, protected PacketHistory
 {
-  private:
-    bool isRebroadcaster();
-
-    /** Check if we should rebroadcast this packet, and do so if needed
-     * @return true if rebroadcasted */
-    bool perhapsRebroadcast(const meshtastic_MeshPacket *p);
-
   public:
     /**
      * Constructor
@@ -50,6 +65,18 @@ class FloodingRouter : public Router, protected PacketHistory
     virtual ErrorCode send(meshtastic_MeshPacket *p) override;
 
   protected:
+    bool isRebroadcaster();
+
+    /** @return the relay suppression policy for the given role */
+    static RelaySuppressionPolicy getRelaySuppressionPolicy(meshtastic_Config_DeviceConfig_Role role);
+
+    /** Should we cancel our pending rebroadcast of p, because enough other nodes have relayed it already? */
+    bool shouldSuppressRelay(const meshtastic_MeshPacket *p);
+
+    /** Check if we should rebroadcast this packet, and do so if needed
+     * @return true if rebroadcasted */
+    virtual bool perhapsRebroadcast(const meshtastic_MeshPacket *p);
+
     /**
      * Should this incoming filter be dropped?
      *
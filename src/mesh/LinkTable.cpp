@@ -0,0 +1,102 @@
+#include "LinkTable.h"
+#include "Throttle.h"
+#include "configuration.h"
+
+LinkStats *LinkTable::find(NodeNum n)
+{
+    for (uint8_t i = 0; i < numLinks; i++) {
+        if (links[i].node == n)
+            return &links[i];
+    }
+    return NULL;
+}
+
+const LinkStats *LinkTable::get(NodeNum n) const
+{
+    for (uint8_t i = 0; i < numLinks; i++) {
+        if (links[i].node == n)
+            return &links[i];
+    }
+    return NULL;
+}
+
+const LinkStats *LinkTable::getRecent(NodeNum n, uint32_t maxAgeMsec) const
+{
+    const LinkStats *l = get(n);
+    if (l && Throttle::isWithinTimespanMs(l->lastHeardMsec, maxAgeMsec))
+        return l;
+    return NULL;
+}
+
+const LinkStats *LinkTable::findByLastByte(uint8_t lastByte, uint32_t maxAgeMsec) const
+{
+    const LinkStats *best = NULL;
+    uint32_t now = millis();
+    for (uint8_t i = 0; i < numLinks; i++) {
+        uint32_t age = now - links[i].lastHeardMsec;
+        if (getLastByteOfNodeNum(links[i].node) == lastByte && age < maxAgeMsec &&
+            (!best || age < now - best->lastHeardMsec))
+            best = &links[i];
+    }
+    return best;
+}
+
+LinkStats *LinkTable::allocate(NodeNum n)
+{
+    LinkStats *l;
+    if (numLinks < MAX_LINK_TABLE_SIZE) {
+        l = &links[numLinks++];
+    } else {
+        // Evict the least recently heard neighbour (compare ages rather than timestamps to survive millis() rollover)
+        uint32_t now = millis();
+        l = &links[0];
+        for (uint8_t i = 1; i < numLinks; i++) {
+            if (now - links[i].lastHeardMsec > now - l->lastHeardMsec)
+                l = &links[i];
+        }
+        LOG_DEBUG("Link table full, evict 0x%x", l->node);
+    }
+    memset(l, 0, sizeof(*l));
+    l->node = n;
+    return l;
+}
+
+void LinkTable::update(const meshtastic_MeshPacket *p)
+{
+    // Only packets we heard directly from the originator tell us something about the link to that node
+    if (isFromUs(p) || p->via_mqtt || p->hop_start == 0 || p->hop_start != p->hop_limit)
+        return;
+
+    int16_t snrX4 = (int16_t)(p->rx_snr * 4);
+    int16_t rssi = (int16_t)p->rx_rssi;
+    uint16_t seq = p->id & ID_COUNTER_MASK;
+
+    LinkStats *l = find(p->from);
+    if (!l) {
+        l = allocate(p->from);
+        l->snrX4 = snrX4;
+        l->rssi = rssi;
+        l->rxCount = 1;
+    } else {
+        uint16_t gap = (seq - l->lastSeq) & ID_COUNTER_MASK;
+        if (gap == 0) // Retransmission of the same packet id, nothing new to learn about loss
+            return;
+        if (gap <= LINK_MAX_SEQ_GAP)
+            l->lostCount += gap - 1;
+        l->rxCount++;
+        if (l->rxCount + l->lostCount >= LINK_COUNT_DECAY_THRESHOLD) {
+            l->rxCount /= 2;
+            l->lostCount /= 2;
+        }
+        l->snrX4 += (snrX4 - l->snrX4) / (1 << LINK_EWMA_SHIFT);
+        l->rssi += (rssi - l->rssi) / (1 << LINK_EWMA_SHIFT);
+    }
+    l->lastSeq = seq;
+    l->lastHeardMsec = millis();
+}
+
+void LinkTable::clear()
+{
+    memset(links, 0, sizeof(links));
+    numLinks = 0;
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "MeshTypes.h"
+
+/// Max number of neighbours we keep link statistics for, the least recently heard one is evicted when full
+#ifndef MAX_LINK_TABLE_SIZE
+#define MAX_LINK_TABLE_SIZE 32
+#endif
+
+/// EWMA weight for SNR/RSSI samples, as a shift (new = old + (sample - old) / 2^shift)
+#define LINK_EWMA_SHIFT 3
+
+/// Packet id counter gaps larger than this are treated as a reboot/resync of the neighbour instead of loss
+#define LINK_MAX_SEQ_GAP 32
+
+/// Once rxCount + lostCount reaches this we halve both, so the loss estimate follows recent conditions
+#define LINK_COUNT_DECAY_THRESHOLD 256
+
+/**
+ * Link statistics for one neighbour we hear directly (zero hops away)
+ */
+struct LinkStats {
+    NodeNum node;
+
+    /// millis() when we last heard this neighbour
+    uint32_t lastHeardMsec;
+
+    /// EWMA of the SNR in quarter dB
+    int16_t snrX4;
+
+    /// EWMA of the RSSI in dBm
+    int16_t rssi;
+
+    /// Number of packets heard directly from this neighbour (decays, see LINK_COUNT_DECAY_THRESHOLD)
+    uint16_t rxCount;
+
+    /// Estimated number of packets from this neighbour we missed, inferred from gaps in its packet id counter
+    uint16_t lostCount;
+
+    /// The counter portion (ID_COUNTER_MASK) of the last packet id we heard from this neighbour
+    uint16_t lastSeq;
+
+    float getSnr() const { return snrX4 / 4.0f; }
+
+    /// @return estimated packet loss rate between 0 and 1
+    float getLossRate() const { return (rxCount + lostCount) ? (float)lostCount / (rxCount + lostCount) : 0; }
+};
+
+/**
+ * A compact, bounded table of link quality for our direct neighbours.
+ *
+ * Fed by Router::sniffReceived() with every packet heard directly from its originator, so it can be used by the
+ * routing code and NeighborInfoModule instead of the last-packet-only SNR stored in the NodeDB.
+ */
+class LinkTable
+{
+  private:
+    LinkStats links[MAX_LINK_TABLE_SIZE] = {};
+    uint8_t numLinks = 0;
+
+    LinkStats *find(NodeNum n);
+
+    /// Return a free entry, evicting the least recently heard neighbour if the table is full
+    LinkStats *allocate(NodeNum n);
+
+  public:
+    /**
+     * Update the statistics for the node that transmitted p.  Only packets we heard directly from their originator are
+     * considered, because relayed packets do not tell us anything about the link to the original sender.
+     */
+    void update(const meshtastic_MeshPacket *p);
+
+    /// @return the stats for the given neighbour, or NULL if we don't have a link to it
+    const LinkStats *get(NodeNum n) const;
+
+    /// @return the stats for a neighbour we have heard within maxAgeMsec, or NULL
+    const LinkStats *getRecent(NodeNum n, uint32_t maxAgeMsec) const;
+
+    /// Find the most recently heard neighbour whose NodeNum ends with lastByte (see getLastByteOfNodeNum), or NULL
+    const LinkStats *findByLastByte(uint8_t lastByte, uint32_t maxAgeMsec) const;
+
+    size_t getNumLinks() const { return numLinks; }
+
+    /// Iterate over links, index is in [0, getNumLinks())
+    const LinkStats &getLink(size_t index) const { return links[index]; }
+
+    void clear();
+};
@@ -2,6 +2,7 @@
 
 #include "MeshTypes.h"
 
+#include <algorithm>
 #include <queue>
 
 /**
@@ -35,6 +36,9 @@ class MeshPacketQueue
 
     meshtastic_MeshPacket *getFront();
 
+    /** return true if pred is true for every packet in the queue */
+    template <typename Pred> bool allOf(Pred pred) const { return std::all_of(queue.begin(), queue.end(), pred); }
+
     /** Attempt to find and remove a packet from this queue.  Returns the packet which was removed from the queue */
     meshtastic_MeshPacket *remove(NodeNum from, PacketId id, bool tx_normal = true, bool tx_late = true);
 };
\ No newline at end of file
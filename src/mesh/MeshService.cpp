@@ -195,9 +195,9 @@ void MeshService::handleToRadio(meshtastic_MeshPacket &p)
 }
 
 /** Attempt to cancel a previously sent packet from this _local_ node.  Returns true if a packet was found we could cancel */
-bool MeshService::cancelSending(PacketId id)
+bool MeshService::cancelSending(PacketId id, RadioTraceCancelReason reason)
 {
-    return router->cancelSending(nodeDB->getNodeNum(), id);
+    return router->cancelSending(nodeDB->getNodeNum(), id, reason);
 }
 
 ErrorCode MeshService::sendQueueStatusToPhone(const meshtastic_QueueStatus &qs, ErrorCode res, uint32_t mesh_packet_id)
@@ -19,6 +19,9 @@ typedef uint32_t PacketId; // A packet sequence number
 #define ERRNO_SHOULD_RELEASE 35            // no error, but the packet should still be released
 #define ID_COUNTER_MASK (UINT32_MAX >> 22) // mask to select the counter portion of the ID
 
+#define NO_NEXT_HOP_PREFERENCE 0 // next_hop value in the header when the packet should be flooded
+#define NO_RELAY_NODE 0          // relay_node value in the header when the relayer is unknown (i.e. older firmware)
+
 /*
  * Source of a received message
  */
@@ -61,4 +64,7 @@ bool isToUs(const meshtastic_MeshPacket *p);
 /* Some clients might not properly set priority, therefore we fix it here. */
 void fixPriority(meshtastic_MeshPacket *p);
 
-bool isBroadcast(uint32_t dest);
\ No newline at end of file
+bool isBroadcast(uint32_t dest);
+
+/* The last byte of a NodeNum as used in the next_hop and relay_node header fields, never NO_RELAY_NODE */
+uint8_t getLastByteOfNodeNum(NodeNum num);
\ No newline at end of file
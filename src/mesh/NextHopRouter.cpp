@@ -0,0 +1,130 @@
+#include "NextHopRouter.h"
+#include "Throttle.h"
+#include "configuration.h"
+#include "mesh-pb-constants.h"
+
+bool NextHopRouter::isEnabled()
+{
+#if USERPREFS_NEXT_HOP_ROUTING
+    return true;
+#else
+    return false;
+#endif
+}
+
+/**
+ * Send a packet on a suitable interface.  This routine will
+ * later free() the packet to pool.  This routine is not allowed to stall.
+ * If the txmit queue is full it might return an error
+ */
+ErrorCode NextHopRouter::send(meshtastic_MeshPacket *p)
+{
+    // Clients are not supposed to pick the next hop, so always decide it ourselves for packets we originate
+    if (isFromUs(p)) {
+        p->next_hop = isBroadcast(p->to) ? NO_NEXT_HOP_PREFERENCE : getNextHop(p->to);
+        if (p->next_hop != NO_NEXT_HOP_PREFERENCE)
+            LOG_DEBUG("Send DM to 0x%x via next hop 0x%x", p->to, p->next_hop);
+    }
+
+    return FloodingRouter::send(p);
+}
+
+uint8_t NextHopRouter::getNextHop(NodeNum dest)
+{
+    if (!isEnabled())
+        return NO_NEXT_HOP_PREFERENCE;
+
+    auto found = routes.find(dest);
+    if (found == routes.end())
+        return NO_NEXT_HOP_PREFERENCE;
+
+    if (!Throttle::isWithinTimespanMs(found->second.learnedMsec, NEXT_HOP_EXPIRE_MSEC)) {
+        LOG_DEBUG("Next hop for 0x%x expired", dest);
+        routes.erase(found);
+        return NO_NEXT_HOP_PREFERENCE;
+    }
+
+    // We can only hand the packet to a neighbour we can still hear
+    if (!linkTable.findByLastByte(found->second.nextHop, NEXT_HOP_EXPIRE_MSEC))
+        return NO_NEXT_HOP_PREFERENCE;
+
+    return found->second.nextHop;
+}
+
+bool NextHopRouter::resetRoute(NodeNum dest)
+{
+    return routes.erase(dest) > 0;
+}
+
+void NextHopRouter::learnRoute(const meshtastic_MeshPacket *p, const meshtastic_Routing *c)
+{
+    // Only successful ACKs and replies prove that the path back to their sender works
+    if (p->which_payload_variant != meshtastic_MeshPacket_decoded_tag || p->decoded.request_id == 0 || isFromUs(p) ||
+        p->via_mqtt || p->relay_node == NO_RELAY_NODE || (c && c->error_reason != meshtastic_Routing_Error_NONE))
+        return;
+
+    // The relayer must be a neighbour we hear directly, otherwise we can't hand packets to it
+    if (!linkTable.findByLastByte(p->relay_node, NEXT_HOP_EXPIRE_MSEC))
+        return;
+
+    auto found = routes.find(p->from);
+    if (found == routes.end() && routes.size() >= NEXT_HOP_MAX_ROUTES) {
+        // Drop the oldest route to make room
+        uint32_t now = millis();
+        auto oldest = routes.begin();
+        for (auto it = routes.begin(); it != routes.end(); ++it) {
+            if (now - it->second.learnedMsec > now - oldest->second.learnedMsec)
+                oldest = it;
+        }
+        routes.erase(oldest);
+    }
+
+    if (found == routes.end() || found->second.nextHop != p->relay_node)
+        LOG_INFO("Learned next hop 0x%x for 0x%x", p->relay_node, p->from);
+
+    NextHopRoute &route = routes[p->from];
+    route.nextHop = p->relay_node;
+    route.learnedMsec = millis();
+}
+
+bool NextHopRouter::perhapsRebroadcast(const meshtastic_MeshPacket *p)
+{
+    if (!isEnabled() || p->next_hop == NO_NEXT_HOP_PREFERENCE)
+        return FloodingRouter::perhapsRebroadcast(p);
+
+    if (p->next_hop != getLastByteOfNodeNum(getNodeNum())) {
+        LOG_DEBUG("No rebroadcast: next hop is 0x%x, not us", p->next_hop);
+        return false;
+    }
+
+    if (isToUs(p) || isFromUs(p) || p->hop_limit == 0 || p->id == 0 || !isRebroadcaster())
+        return false;
+
+    meshtastic_MeshPacket *tosend = packetPool.allocCopy(*p); // keep a copy because we will be sending it
+
+    tosend->hop_limit--; // bump down the hop count
+#if USERPREFS_EVENT_MODE
+    if (tosend->hop_limit > 2) {
+        // Same clamp as a flooded rebroadcast, hop_start moves with it to keep hops away right
+        tosend->hop_start -= (tosend->hop_limit - 2);
+        tosend->hop_limit = 2;
+    }
+#endif
+
+    // Continue along our own route if we know one, otherwise flood from here on
+    tosend->next_hop = getNextHop(p->to);
+
+    LOG_INFO("Relay directed msg to 0x%x, next hop 0x%x", p->to, tosend->next_hop);
+    // We are careful not to call our hooked version of send() - because we don't want to check this again
+    Router::send(tosend);
+
+    return true;
+}
+
+void NextHopRouter::sniffReceived(const meshtastic_MeshPacket *p, const meshtastic_Routing *c)
+{
+    if (isEnabled())
+        learnRoute(p, c);
+
+    FloodingRouter::sniffReceived(p, c);
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "FloodingRouter.h"
+#include <unordered_map>
+
+/// How long a learned next hop stays valid without being confirmed by another ACK/reply
+#define NEXT_HOP_EXPIRE_MSEC (30 * 60 * 1000L)
+
+/// Max number of destinations we keep a next hop for, the oldest route is dropped when full
+#define NEXT_HOP_MAX_ROUTES 64
+
+/**
+ * A learned route towards a destination
+ */
+struct NextHopRoute {
+    /** Last byte of the NodeNum of the neighbour to hand the packet to (see getLastByteOfNodeNum) */
+    uint8_t nextHop;
+
+    /** millis() when this route was learned or last confirmed */
+    uint32_t learnedMsec;
+};
+
+/**
+ * This is a mixin that extends FloodingRouter with (opt-in) next-hop routing of direct messages.
+ *
+ * Whenever we hear a successful ACK or a reply (e.g. a traceroute response) that was relayed by one of our direct neighbours,
+ * we remember that neighbour as the next hop towards the sender of that ACK/reply.  DMs we send or relay to that destination
+ * then carry the next hop in the packet header, and only that neighbour relays them instead of the whole mesh flooding them.
+ *
+ * If we do not learn a route, the route expired, or a directed packet did not get through (ReliableRouter had to retransmit
+ * it) we fall back to regular flooding.  Nodes running older firmware ignore next_hop and keep flooding, so a mixed mesh still
+ * delivers.
+ *
+ * Enabled by building with USERPREFS_NEXT_HOP_ROUTING, otherwise this behaves exactly like FloodingRouter.
+ */
+class NextHopRouter : public FloodingRouter
+{
+  private:
+    std::unordered_map<NodeNum, NextHopRoute> routes;
+
+    /** Remember the relayer of a successful ACK/reply as the next hop towards its sender */
+    void learnRoute(const meshtastic_MeshPacket *p, const meshtastic_Routing *c);
+
+  public:
+    /** @return true if this node uses next-hop routing for DMs */
+    static bool isEnabled();
+
+    /**
+     * Send a packet on a suitable interface.  This routine will
+     * later free() the packet to pool.  This routine is not allowed to stall.
+     * If the txmit queue is full it might return an error
+     */
+    virtual ErrorCode send(meshtastic_MeshPacket *p) override;
+
+    /** @return the next hop towards dest, or NO_NEXT_HOP_PREFERENCE if the packet should be flooded */
+    uint8_t getNextHop(NodeNum dest);
+
+    /**
+     * Forget the route towards dest, so the next packet to it will be flooded
+     * @return true if we had a route
+     */
+    bool resetRoute(NodeNum dest);
+
+  protected:
+    /**
+     * Relay directed packets only if we are the chosen next hop, flood the rest as usual
+     */
+    virtual bool perhapsRebroadcast(const meshtastic_MeshPacket *p) override;
+
+    /**
+     * Look for ACKs and replies to learn routes from
+     */
+    virtual void sniffReceived(const meshtastic_MeshPacket *p, const meshtastic_Routing *c) override;
+};
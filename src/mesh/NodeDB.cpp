@@ -143,22 +143,86 @@ uint32_t get_st7789_id(uint8_t cs, uint8_t sck, uint8_t mosi, uint8_t dc, uint8_
 
 #endif
 
+#ifdef FSCom
+/// nanopb asks for a few bytes at a time, so read files in blocks instead of going to the filesystem for each of them
+struct BufferedFileReader {
+    File *file;
+    uint32_t offset; // file position of buf[0]
+    size_t pos, len;
+    uint8_t buf[256];
+
+    uint32_t tell() const { return offset + pos; }
+};
+
+static bool bufferedReadCb(pb_istream_t *stream, uint8_t *buf, size_t count)
+{
+    BufferedFileReader *r = (BufferedFileReader *)stream->state;
+    while (count) {
+        if (r->pos == r->len) {
+            r->offset += r->len;
+            r->pos = r->len = 0;
+            if (!buf && count > sizeof(r->buf)) {
+                // Skipping, no need to read what we'd throw away
+                r->offset += count;
+                return r->file->seek(r->offset);
+            }
+            int got = r->file->read(r->buf, sizeof(r->buf));
+            if (got <= 0)
+                return false;
+            r->len = got;
+        }
+        size_t n = std::min(count, r->len - r->pos);
+        if (buf) {
+            memcpy(buf, r->buf + r->pos, n);
+            buf += n;
+        }
+        r->pos += n;
+        count -= n;
+    }
+    return true;
+}
+
+/// Set while db.proto is decoded at boot, nodes past NODEDB_BOOT_NODES are left for loadDeferredNodes()
+static BufferedFileReader *bootNodeReader;
+static bool deferNodesAtBoot;
+#endif
+
+static uint32_t deferredNodesOffset; // file position of the first node not decoded yet, 0 if none
+static uint32_t deferredNodesLen;    // its encoded length
+
 bool meshtastic_DeviceState_callback(pb_istream_t *istream, pb_ostream_t *ostream, const pb_field_iter_t *field)
 {
     if (ostream) {
         std::vector<meshtastic_NodeInfoLite> const *vec = (std::vector<meshtastic_NodeInfoLite> *)field->pData;
-        for (auto item : *vec) {
+        for (auto &item : *vec) {
             if (!pb_encode_tag_for_field(ostream, field))
                 return false;
             pb_encode_submessage(ostream, meshtastic_NodeInfoLite_fields, &item);
         }
     }
     if (istream) {
-        meshtastic_NodeInfoLite node; // this gets good data
         std::vector<meshtastic_NodeInfoLite> *vec = (std::vector<meshtastic_NodeInfoLite> *)field->pData;
 
-        if (istream->bytes_left && pb_decode(istream, meshtastic_NodeInfoLite_fields, &node))
-            vec->push_back(node);
+#ifdef FSCom
+        if (bootNodeReader && vec->size() >= NODEDB_BOOT_NODES) {
+            if (!deferredNodesOffset) {
+                deferredNodesOffset = bootNodeReader->tell();
+                deferredNodesLen = istream->bytes_left;
+            }
+            return pb_read(istream, NULL, istream->bytes_left);
+        }
+#endif
+        if (vec->size() >= MAX_NUM_NODES) // loadFromDisk() would drop it anyway
+            return pb_read(istream, NULL, istream->bytes_left);
+
+        // Decode straight into the DB, growing it once rather than copying it around on every push_back()
+        if (vec->capacity() < MAX_NUM_NODES)
+            vec->reserve(MAX_NUM_NODES);
+        vec->emplace_back();
+        if (!istream->bytes_left || !pb_decode(istream, meshtastic_NodeInfoLite_fields, &vec->back())) {
+            vec->pop_back();
+            return pb_read(istream, NULL, istream->bytes_left);
+        }
     }
     return true;
 }
@@ -380,6 +444,12 @@ bool isBroadcast(uint32_t dest)
     return dest == NODENUM_BROADCAST || dest == NODENUM_BROADCAST_NO_LORA;
 }
 
+uint8_t getLastByteOfNodeNum(NodeNum num)
+{
+    // 0 is reserved to mean "no preference/unknown" in the header, so map it to 0xFF
+    return (uint8_t)((num & 0xFF) ? (num & 0xFF) : 0xFF);
+}
+
 bool NodeDB::resetRadioConfig(bool factory_reset)
 {
     bool didFactoryReset = false;
@@ -782,12 +852,15 @@ void NodeDB::resetNodes()
     if (!config.position.fixed_position)
         clearLocalPosition();
     numMeshNodes = 1;
+    deferredNodesOffset = 0;
     std::fill(devicestate.node_db_lite.begin() + 1, devicestate.node_db_lite.end(), meshtastic_NodeInfoLite());
     devicestate.has_rx_text_message = false;
     devicestate.has_rx_waypoint = false;
     saveDeviceStateToDisk();
     if (neighborInfoModule && moduleConfig.neighbor_info.enabled)
         neighborInfoModule->resetNeighbors();
+    if (router)
+        router->resetLinkTable();
 }
 
 void NodeDB::removeNodeByNum(NodeNum nodeNum)
@@ -803,7 +876,10 @@ void NodeDB::removeNodeByNum(NodeNum nodeNum)
     std::fill(devicestate.node_db_lite.begin() + numMeshNodes, devicestate.node_db_lite.begin() + numMeshNodes + 1,
               meshtastic_NodeInfoLite());
     LOG_DEBUG("NodeDB::removeNodeByNum purged %d entries. Save changes", removed);
-    saveDeviceStateToDisk();
+    if (deferredNodesOffset)
+        deferredRemovals.push_back(nodeNum);
+    journal.markRemoved(nodeNum);
+    journal.flush();
 }
 
 void NodeDB::clearLocalPosition()
@@ -843,6 +919,7 @@ void NodeDB::installDefaultDeviceState()
     // memset(&devicestate, 0, sizeof(meshtastic_DeviceState));
 
     numMeshNodes = 0;
+    deferredNodesOffset = 0;
     meshNodes = &devicestate.node_db_lite;
 
     // init our devicestate with valid flags so protobuf writing/reading will work
@@ -920,10 +997,15 @@ LoadFileResult NodeDB::loadProto(const char *filename, size_t protoSize, size_t
 
     if (f) {
         LOG_INFO("Load %s", filename);
-        pb_istream_t stream = {&readcb, &f, protoSize};
+        BufferedFileReader reader = {&f, 0, 0, 0};
+        pb_istream_t stream = {&bufferedReadCb, &reader, f.size()};
+        if (fields == &meshtastic_DeviceState_msg && deferNodesAtBoot)
+            bootNodeReader = &reader;
 
         memset(dest_struct, 0, objSize);
-        if (!pb_decode(&stream, fields, dest_struct)) {
+        bool decoded = pb_decode(&stream, fields, dest_struct);
+        bootNodeReader = NULL;
+        if (!decoded) {
             LOG_ERROR("Error: can't decode protobuf %s", PB_GET_ERROR(&stream));
             state = LoadFileResult::DECODE_FAILED;
         } else {
@@ -955,8 +1037,17 @@ void NodeDB::loadFromDisk()
 #endif
 
     // static DeviceState scratch; We no longer read into a tempbuf because this structure is 15KB of valuable RAM
+    uint32_t start = millis();
+#ifdef FSCom
+    deferNodesAtBoot = true;
+#endif
     auto state = loadProto(prefFileName, sizeof(meshtastic_DeviceState) + MAX_NUM_NODES_FS * meshtastic_NodeInfoLite_size,
                            sizeof(meshtastic_DeviceState), &meshtastic_DeviceState_msg, &devicestate);
+#ifdef FSCom
+    deferNodesAtBoot = false;
+#endif
+    LOG_DEBUG("Decoded %u nodes in %u ms%s", (unsigned)devicestate.node_db_lite.size(), millis() - start,
+              deferredNodesOffset ? ", more after radio init" : "");
 
     // See https://github.com/meshtastic/firmware/issues/4184#issuecomment-2269390786
     // It is very important to try and use the saved prefs even if we fail to read meshtastic_DeviceState.  Because most of our
@@ -979,6 +1070,7 @@ void NodeDB::loadFromDisk()
         numMeshNodes = MAX_NUM_NODES;
     }
     meshNodes->resize(MAX_NUM_NODES);
+    journal.replay(*meshNodes, numMeshNodes, deferredNodesOffset ? &deferredRemovals : NULL);
 
     state = loadProto(configFileName, meshtastic_LocalConfig_size, sizeof(meshtastic_LocalConfig), &meshtastic_LocalConfig_msg,
                       &config);
@@ -1097,6 +1189,92 @@ void NodeDB::loadFromDisk()
     }
 }
 
+/// Decodes the rest of db.proto in small steps once the radio is up, see NODEDB_BOOT_NODES
+class DeferredNodeLoader : public concurrency::OSThread
+{
+  public:
+    DeferredNodeLoader() : OSThread("DeferredNodes") {}
+
+  protected:
+    int32_t runOnce() override { return nodeDB->loadDeferredNodes(NODEDB_DEFERRED_NODES_PER_RUN) ? disable() : 0; }
+};
+
+void NodeDB::startDeferredLoad()
+{
+    if (deferredNodesOffset && !deferredNodeLoader)
+        deferredNodeLoader = new DeferredNodeLoader();
+}
+
+bool NodeDB::loadDeferredNodes(uint32_t maxNodes)
+{
+    if (!deferredNodesOffset)
+        return true;
+#ifdef FSCom
+    uint32_t start = millis();
+    uint32_t loaded = 0;
+    bool done = false;
+    {
+        concurrency::LockGuard g(spiLock);
+        auto f = FSCom.open(prefFileName, FILE_O_READ);
+        if (!f || !f.seek(deferredNodesOffset)) {
+            LOG_ERROR("Can't reopen %s for the remaining nodes", prefFileName);
+            done = true;
+        } else {
+            BufferedFileReader reader = {&f, deferredNodesOffset, 0, 0};
+            pb_istream_t stream = {&bufferedReadCb, &reader, f.size() - deferredNodesOffset};
+            uint32_t len = deferredNodesLen;
+            while (!done && loaded < maxNodes) {
+                if (len > stream.bytes_left) {
+                    LOG_WARN("%s is cut short", prefFileName);
+                    done = true;
+                    break;
+                }
+                meshtastic_NodeInfoLite node = meshtastic_NodeInfoLite_init_default;
+                pb_istream_t sub = stream;
+                sub.bytes_left = len;
+                bool decoded = pb_decode(&sub, meshtastic_NodeInfoLite_fields, &node);
+                if (!pb_read(&sub, NULL, sub.bytes_left)) {
+                    done = true;
+                    break;
+                }
+                stream.bytes_left -= len;
+                loaded++;
+
+                // Nodes heard or removed since boot are more recent than the snapshot
+                if (decoded && node.has_user && numMeshNodes < MAX_NUM_NODES && !getMeshNode(node.num) &&
+                    std::find(deferredRemovals.begin(), deferredRemovals.end(), node.num) == deferredRemovals.end())
+                    meshNodes->at(numMeshNodes++) = node;
+
+                // The next node, skipping any other fields the file may have after them
+                done = true;
+                pb_wire_type_t wireType;
+                uint32_t tag;
+                bool eof;
+                while (stream.bytes_left && pb_decode_tag(&stream, &wireType, &tag, &eof)) {
+                    if (tag == meshtastic_DeviceState_node_db_lite_tag && wireType == PB_WT_STRING) {
+                        done = !pb_decode_varint32(&stream, &len);
+                        break;
+                    }
+                    if (!pb_skip_field(&stream, wireType))
+                        break;
+                }
+            }
+            deferredNodesOffset = reader.tell();
+            deferredNodesLen = len;
+            f.close();
+        }
+    }
+    LOG_DEBUG("Decoded %u more nodes in %u ms, %u nodes now", loaded, millis() - start, numMeshNodes);
+    if (!done)
+        return false;
+#endif
+    deferredNodesOffset = 0;
+    deferredRemovals.clear();
+    cleanupMeshDB();
+    notifyObservers(true);
+    return true;
+}
+
 /** Save a protobuf from a file, return true for success */
 bool NodeDB::saveProto(const char *filename, size_t protoSize, const pb_msgdesc_t *fields, const void *dest_struct,
                        bool fullAtomic)
@@ -1142,11 +1320,22 @@ bool NodeDB::saveDeviceStateToDisk()
     FSCom.mkdir("/prefs");
     spiLock->unlock();
 #endif
+    // Don't leave out the nodes we haven't decoded yet
+    loadDeferredNodes(UINT32_MAX);
+
+    // Bring the journal up to date first, so if we die before emptying it, replaying it still ends up at this snapshot
+    journal.flush(false);
+
     // Note: if MAX_NUM_NODES=100 and meshtastic_NodeInfoLite_size=166, so will be approximately 17KB
     // Because so huge we _must_ not use fullAtomic, because the filesystem is probably too small to hold two copies of this
     size_t deviceStateSize;
     pb_get_encoded_size(&deviceStateSize, meshtastic_DeviceState_fields, &devicestate);
-    return saveProto(prefFileName, deviceStateSize, &meshtastic_DeviceState_msg, &devicestate, false);
+    uint32_t start = millis();
+    bool okay = saveProto(prefFileName, deviceStateSize, &meshtastic_DeviceState_msg, &devicestate, false);
+    LOG_DEBUG("Saved %u bytes of devicestate in %u ms", (unsigned)deviceStateSize, millis() - start);
+    if (okay)
+        journal.reset();
+    return okay;
 }
 
 bool NodeDB::saveToDiskNoRetry(int saveWhat)
@@ -1270,7 +1459,6 @@ size_t NodeDB::getNumOnlineMeshNodes(bool localOnly)
 }
 
 #include "MeshModule.h"
-#include "Throttle.h"
 
 /** Update position info for this node based on received position data
  */
@@ -1380,14 +1568,8 @@ bool NodeDB::updateUser(uint32_t nodeId, meshtastic_User &p, uint8_t channelInde
         powerFSM.trigger(EVENT_NODEDB_UPDATED);
         notifyObservers(true); // Force an update whether or not our node counts have changed
 
-        // We just changed something about a User,
-        // store our DB unless we just did so less than a minute ago
-        if (!Throttle::isWithinTimespanMs(lastNodeDbSave, ONE_MINUTE_MS)) {
-            saveToDisk(SEGMENT_DEVICESTATE);
-            lastNodeDbSave = millis();
-        } else {
-            LOG_DEBUG("Defer NodeDB saveToDisk for now");
-        }
+        // We just changed something about a User, the journal stores it within a minute
+        journal.markDirty(nodeId);
     }
 
     return changed;
@@ -1480,6 +1662,12 @@ meshtastic_NodeInfoLite *NodeDB::getOrCreateMeshNode(NodeNum n)
             }
 
             if (oldestIndex != -1) {
+                // Journal it like removeNodeByNum() does, or a replay would find the DB full and drop the new node instead
+                NodeNum evicted = meshNodes->at(oldestIndex).num;
+                if (deferredNodesOffset)
+                    deferredRemovals.push_back(evicted);
+                journal.markRemoved(evicted);
+
                 // Shove the remaining nodes down the chain
                 for (int i = oldestIndex; i < numMeshNodes - 1; i++) {
                     meshNodes->at(i) = meshNodes->at(i + 1);
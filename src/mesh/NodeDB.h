@@ -7,6 +7,7 @@
 #include <vector>
 
 #include "MeshTypes.h"
+#include "NodeDBJournal.h"
 #include "NodeStatus.h"
 #include "configuration.h"
 #include "mesh-pb-constants.h"
@@ -22,6 +23,14 @@ DeviceState versions used to be defined in the .proto file but really only this
 #define SEGMENT_DEVICESTATE 4
 #define SEGMENT_CHANNELS 8
 
+/// Nodes decoded from db.proto before the radio comes up, the rest are decoded in the background afterwards
+#ifndef NODEDB_BOOT_NODES
+#define NODEDB_BOOT_NODES 32
+#endif
+
+/// Nodes decoded per run of the background loader, so it doesn't hold up the main loop
+#define NODEDB_DEFERRED_NODES_PER_RUN 16
+
 #define DEVICESTATE_CUR_VER 23
 #define DEVICESTATE_MIN_VER 22
 
@@ -130,6 +139,15 @@ class NodeDB
 
     bool factoryReset(bool eraseBleBonds = false);
 
+    /// Decode the nodes left out at boot in the background, call once the radio is up
+    void startDeferredLoad();
+
+    /**
+     * Decode up to maxNodes of the nodes left out at boot
+     * @return true once all of them are in
+     */
+    bool loadDeferredNodes(uint32_t maxNodes);
+
     LoadFileResult loadProto(const char *filename, size_t protoSize, size_t objSize, const pb_msgdesc_t *fields,
                              void *dest_struct);
     bool saveProto(const char *filename, size_t protoSize, const pb_msgdesc_t *fields, const void *dest_struct,
@@ -169,7 +187,15 @@ class NodeDB
     bool hasValidPosition(const meshtastic_NodeInfoLite *n);
 
   private:
-    uint32_t lastNodeDbSave = 0; // when we last saved our db to flash
+    /// Small per-node writes between snapshots of the whole DB
+    NodeDBJournal journal;
+
+    /// Decodes the nodes left out at boot
+    concurrency::OSThread *deferredNodeLoader = NULL;
+
+    /// Nodes removed before the ones left out at boot were decoded, they mustn't come back
+    std::vector<NodeNum> deferredRemovals;
+
     /// Find a node in our DB, create an empty NodeInfoLite if missing
     meshtastic_NodeInfoLite *getOrCreateMeshNode(NodeNum n);
 
@@ -0,0 +1,253 @@
+#include "NodeDBJournal.h"
+
+#include "FSCommon.h"
+#include "NodeDB.h"
+#include "SPILock.h"
+#include "configuration.h"
+#include <ErriezCRC32.h>
+#include <pb_decode.h>
+#include <pb_encode.h>
+
+NodeDBJournal::NodeDBJournal() : concurrency::OSThread("NodeDBJournal")
+{
+    disable();
+}
+
+void NodeDBJournal::markDirty(NodeNum n)
+{
+    mark(n, false);
+}
+
+void NodeDBJournal::markRemoved(NodeNum n)
+{
+    mark(n, true);
+}
+
+void NodeDBJournal::mark(NodeNum n, bool removed)
+{
+    // Changes to one node coalesce, but a removal and a return stay in order: the slots they free and take up must replay
+    // in the same order as the other nodes' ones
+    for (auto it = pending.rbegin(); it != pending.rend(); ++it) {
+        if (it->num == n) {
+            if (it->removed == removed)
+                return;
+            break;
+        }
+    }
+    if (pending.empty()) {
+        enabled = true;
+        setIntervalFromNow(NODEDB_JOURNAL_FLUSH_MS);
+    }
+    pending.push_back({n, removed});
+}
+
+int32_t NodeDBJournal::runOnce()
+{
+    // Try again later if the flash is busy or full
+    return flush() ? disable() : NODEDB_JOURNAL_FLUSH_MS;
+}
+
+static void putRecordHeader(uint8_t *buf, NodeDBJournalRecordType type, size_t payloadLen)
+{
+    buf[0] = type;
+    buf[1] = payloadLen & 0xff;
+    buf[2] = payloadLen >> 8;
+}
+
+static size_t putRecordCRC(uint8_t *buf, size_t payloadLen)
+{
+    uint32_t crc = crc32Buffer(buf, 3 + payloadLen);
+    uint8_t *p = buf + 3 + payloadLen;
+    for (int i = 0; i < 4; i++)
+        p[i] = crc >> (8 * i);
+    return payloadLen + NODEDB_JOURNAL_RECORD_OVERHEAD;
+}
+
+size_t NodeDBJournal::encodeUpdate(const meshtastic_NodeInfoLite &node, uint8_t *buf, size_t bufLen)
+{
+    if (bufLen < NODEDB_JOURNAL_RECORD_OVERHEAD)
+        return 0;
+    pb_ostream_t stream = pb_ostream_from_buffer(buf + 3, bufLen - NODEDB_JOURNAL_RECORD_OVERHEAD);
+    if (!pb_encode(&stream, &meshtastic_NodeInfoLite_msg, &node)) {
+        LOG_ERROR("Can't encode journal record for node 0x%x: %s", node.num, PB_GET_ERROR(&stream));
+        return 0;
+    }
+    putRecordHeader(buf, NODEDB_JOURNAL_UPDATE, stream.bytes_written);
+    return putRecordCRC(buf, stream.bytes_written);
+}
+
+size_t NodeDBJournal::encodeRemove(NodeNum n, uint8_t *buf, size_t bufLen)
+{
+    if (bufLen < 4 + NODEDB_JOURNAL_RECORD_OVERHEAD)
+        return 0;
+    putRecordHeader(buf, NODEDB_JOURNAL_REMOVE, 4);
+    for (int i = 0; i < 4; i++)
+        buf[3 + i] = n >> (8 * i);
+    return putRecordCRC(buf, 4);
+}
+
+size_t NodeDBJournal::recordLength(const uint8_t *buf, size_t len)
+{
+    if (len < NODEDB_JOURNAL_RECORD_OVERHEAD)
+        return 0;
+    size_t payloadLen = buf[1] | (buf[2] << 8);
+    size_t total = payloadLen + NODEDB_JOURNAL_RECORD_OVERHEAD;
+    if (payloadLen > meshtastic_NodeInfoLite_size || total > len)
+        return 0;
+    const uint8_t *p = buf + 3 + payloadLen;
+    uint32_t crc = p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+    return crc == crc32Buffer(buf, 3 + payloadLen) ? total : 0;
+}
+
+bool NodeDBJournal::apply(const uint8_t *rec, std::vector<meshtastic_NodeInfoLite> &nodes, pb_size_t &numNodes)
+{
+    size_t payloadLen = rec[1] | (rec[2] << 8);
+    const uint8_t *payload = rec + 3;
+
+    if (rec[0] == NODEDB_JOURNAL_REMOVE && payloadLen == 4) {
+        NodeNum n = payload[0] | (payload[1] << 8) | (payload[2] << 16) | ((uint32_t)payload[3] << 24);
+        pb_size_t newPos = 0;
+        for (pb_size_t i = 0; i < numNodes; i++) {
+            if (nodes[i].num != n)
+                nodes[newPos++] = nodes[i];
+        }
+        for (pb_size_t i = newPos; i < numNodes; i++)
+            nodes[i] = meshtastic_NodeInfoLite_init_default;
+        numNodes = newPos;
+        return true;
+    }
+
+    if (rec[0] != NODEDB_JOURNAL_UPDATE)
+        return false;
+    meshtastic_NodeInfoLite node = meshtastic_NodeInfoLite_init_default;
+    pb_istream_t stream = pb_istream_from_buffer(payload, payloadLen);
+    if (!pb_decode(&stream, &meshtastic_NodeInfoLite_msg, &node))
+        return false;
+    for (pb_size_t i = 0; i < numNodes; i++) {
+        if (nodes[i].num == node.num) {
+            nodes[i] = node;
+            return true;
+        }
+    }
+    if (numNodes >= nodes.size())
+        return false; // Full, the snapshot would have evicted someone for it but we don't know whom
+    nodes[numNodes++] = node;
+    return true;
+}
+
+bool NodeDBJournal::flush(bool allowCompact)
+{
+    if (needsCompact || (allowCompact && fileSize >= NODEDB_JOURNAL_MAX_BYTES))
+        return allowCompact && compact();
+    if (pending.empty())
+        return true;
+
+#ifdef FSCom
+    uint32_t start = millis();
+    size_t numPending = pending.size();
+    size_t written;
+    {
+        concurrency::LockGuard g(spiLock);
+        FSCom.mkdir("/prefs");
+        auto f = FSCom.open(NODEDB_JOURNAL_FILE, FILE_O_APPEND);
+        if (!f) {
+            LOG_ERROR("Can't open %s", NODEDB_JOURNAL_FILE);
+            return false;
+        }
+        bool failed = false;
+        written = writePending(f, nodeDB->meshNodes->data(), nodeDB->getNumMeshNodes(), failed);
+        if (failed) {
+            LOG_ERROR("Can't append to %s", NODEDB_JOURNAL_FILE);
+            needsCompact = true; // A torn record would hide whatever comes after it
+        }
+        f.flush();
+        f.close();
+    }
+    fileSize += written;
+    LOG_DEBUG("Journaled %u nodes, %u bytes in %u ms (%u bytes since boot, journal %u bytes)", (unsigned)numPending,
+              (unsigned)written, millis() - start, bytesWritten, fileSize);
+    return !needsCompact;
+#else
+    return false;
+#endif
+}
+
+size_t NodeDBJournal::writePending(Print &out, const meshtastic_NodeInfoLite *nodes, size_t numNodes, bool &failed)
+{
+    size_t written = 0;
+    uint8_t buf[NODEDB_JOURNAL_MAX_RECORD];
+    failed = false;
+    for (auto &p : pending) {
+        const meshtastic_NodeInfoLite *node = NULL;
+        for (size_t i = 0; i < numNodes && !p.removed && !node; i++) {
+            if (nodes[i].num == p.num)
+                node = &nodes[i];
+        }
+        size_t len = node ? encodeUpdate(*node, buf, sizeof(buf)) : encodeRemove(p.num, buf, sizeof(buf));
+        if (len && out.write(buf, len) != len) {
+            failed = true;
+            break;
+        }
+        written += len;
+    }
+    bytesWritten += written;
+    pending.clear();
+    return written;
+}
+
+bool NodeDBJournal::compact()
+{
+    LOG_INFO("Fold node journal of %u bytes into a new snapshot", fileSize);
+    return nodeDB->saveToDisk(SEGMENT_DEVICESTATE);
+}
+
+void NodeDBJournal::reset()
+{
+    pending.clear();
+    disable();
+    fileSize = 0;
+    needsCompact = false;
+#ifdef FSCom
+    concurrency::LockGuard g(spiLock);
+    if (FSCom.exists(NODEDB_JOURNAL_FILE))
+        FSCom.remove(NODEDB_JOURNAL_FILE);
+#endif
+}
+
+void NodeDBJournal::replay(std::vector<meshtastic_NodeInfoLite> &nodes, pb_size_t &numNodes, std::vector<NodeNum> *removed)
+{
+#ifdef FSCom
+    concurrency::LockGuard g(spiLock);
+    auto f = FSCom.open(NODEDB_JOURNAL_FILE, FILE_O_READ);
+    if (!f)
+        return;
+
+    uint8_t buf[NODEDB_JOURNAL_MAX_RECORD];
+    size_t have = 0;
+    uint32_t records = 0;
+    fileSize = f.size();
+    for (uint32_t pos = 0; pos < fileSize;) {
+        have += f.read(buf + have, sizeof(buf) - have);
+        size_t len = recordLength(buf, have);
+        if (!len) {
+            LOG_WARN("Node journal is torn at byte %u, drop the rest", pos);
+            needsCompact = true;
+            break;
+        }
+        if (!apply(buf, nodes, numNodes))
+            LOG_WARN("Can't apply node journal record at byte %u", pos);
+        else if (removed && buf[0] == NODEDB_JOURNAL_REMOVE)
+            removed->push_back(buf[3] | (buf[4] << 8) | (buf[5] << 16) | ((uint32_t)buf[6] << 24));
+        records++;
+        pos += len;
+        have -= len;
+        memmove(buf, buf + len, have);
+    }
+    f.close();
+    LOG_INFO("Replayed %u node journal records, %u bytes", records, fileSize);
+    if (needsCompact) {
+        enabled = true;
+        setIntervalFromNow(0);
+    }
+#endif
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+#include "MeshTypes.h"
+#include "concurrency/OSThread.h"
+#include "mesh/generated/meshtastic/deviceonly.pb.h"
+#include <Print.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+/// Node changes since the last db.proto snapshot, replayed onto it at boot
+#define NODEDB_JOURNAL_FILE "/prefs/nodes.jnl"
+
+/// How long a changed node may wait in RAM before it is appended, changes within this window cost one record
+#ifndef NODEDB_JOURNAL_FLUSH_MS
+#define NODEDB_JOURNAL_FLUSH_MS (60 * 1000)
+#endif
+
+/// Once the journal grows past this it is folded into a new snapshot
+#ifndef NODEDB_JOURNAL_MAX_BYTES
+#define NODEDB_JOURNAL_MAX_BYTES (16 * 1024)
+#endif
+
+/// u8 type, u16 payload length, payload, u32 CRC32 of everything before it
+#define NODEDB_JOURNAL_RECORD_OVERHEAD 7
+#define NODEDB_JOURNAL_MAX_RECORD (meshtastic_NodeInfoLite_size + NODEDB_JOURNAL_RECORD_OVERHEAD)
+
+enum NodeDBJournalRecordType : uint8_t {
+    NODEDB_JOURNAL_UPDATE = 1, // payload is the whole NodeInfoLite
+    NODEDB_JOURNAL_REMOVE = 2, // payload is the u32 node number
+};
+
+/**
+ * Write-behind journal for the node DB.
+ *
+ * Rewriting db.proto means encoding, writing and reading back every node we know of, so instead of doing that for each
+ * changed user we append one small record per changed node, at most once per NODEDB_JOURNAL_FLUSH_MS.  At boot the records
+ * are replayed onto the snapshot, stopping at the first torn or corrupt one.  Whenever the snapshot is saved anyway, or the
+ * journal grows past NODEDB_JOURNAL_MAX_BYTES, the journal is emptied.
+ */
+class NodeDBJournal : private concurrency::OSThread
+{
+  public:
+    NodeDBJournal();
+
+    /// Append node at the next flush
+    void markDirty(NodeNum n);
+
+    /// Append a removal at the next flush
+    void markRemoved(NodeNum n);
+
+    /**
+     * Append the pending changes now
+     * @param allowCompact save a new snapshot instead if the journal got too big
+     */
+    bool flush(bool allowCompact = true);
+
+    /**
+     * Write a record for each pending change to out and forget them, the updates with the current contents from nodes
+     * @param failed set if out didn't take a whole record, nothing after it is written
+     * @return the bytes written
+     */
+    size_t writePending(Print &out, const meshtastic_NodeInfoLite *nodes, size_t numNodes, bool &failed);
+
+    /**
+     * Apply the journal file to a freshly loaded snapshot
+     * @param removed if not NULL, gets the nodes the journal removed (for a snapshot that isn't fully decoded yet)
+     */
+    void replay(std::vector<meshtastic_NodeInfoLite> &nodes, pb_size_t &numNodes, std::vector<NodeNum> *removed = NULL);
+
+    /// The snapshot now holds every change, start over
+    void reset();
+
+    uint32_t getBytesWritten() const { return bytesWritten; }
+
+    static size_t encodeUpdate(const meshtastic_NodeInfoLite &node, uint8_t *buf, size_t bufLen);
+    static size_t encodeRemove(NodeNum n, uint8_t *buf, size_t bufLen);
+
+    /// @return the length of the complete, intact record at the start of buf, 0 if it is torn or corrupt
+    static size_t recordLength(const uint8_t *buf, size_t len);
+
+    /// Apply one record that passed recordLength()
+    static bool apply(const uint8_t *rec, std::vector<meshtastic_NodeInfoLite> &nodes, pb_size_t &numNodes);
+
+  protected:
+    virtual int32_t runOnce() override;
+
+  private:
+    struct Pending {
+        NodeNum num;
+        bool removed;
+    };
+    std::vector<Pending> pending;
+
+    uint32_t fileSize = 0;
+    uint32_t bytesWritten = 0; // since boot
+    bool needsCompact = false; // the file ends in garbage, appending after it would be lost
+
+    void mark(NodeNum n, bool removed);
+    bool compact();
+};
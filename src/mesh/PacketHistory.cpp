@@ -23,10 +23,11 @@ bool PacketHistory::wasSeenRecently(const meshtastic_MeshPacket *p, bool withUpd
         return false; // Not a floodable message ID, so we don't care
     }
 
-    PacketRecord r;
+    PacketRecord r = {};
     r.id = p->id;
     r.sender = getFrom(p);
     r.rxTimeMsec = millis();
+    r.firstSnr = (int8_t)p->rx_snr;
 
     auto found = recentPackets.find(r);
     bool seenRecently = (found != recentPackets.end()); // found not equal to .end() means packet was seen recently
@@ -44,7 +45,13 @@ bool PacketHistory::wasSeenRecently(const meshtastic_MeshPacket *p, bool withUpd
 
     if (withUpdate) {
         if (found != recentPackets.end()) { // delete existing to updated timestamp (re-insert)
-            recentPackets.erase(found);     // as unsorted_set::iterator is const (can't update timestamp - so re-insert..)
+            // Keep what we knew about the first copy, and remember who relayed this duplicate
+            r.firstSnr = found->firstSnr;
+            r.numRelayers = found->numRelayers;
+            memcpy(r.relayers, found->relayers, sizeof(r.relayers));
+            memcpy(r.relayerSnr, found->relayerSnr, sizeof(r.relayerSnr));
+            addRelayer(r, p);
+            recentPackets.erase(found); // as unsorted_set::iterator is const (can't update timestamp - so re-insert..)
         }
         recentPackets.insert(r);
         printPacket("Add packet record", p);
@@ -59,6 +66,42 @@ bool PacketHistory::wasSeenRecently(const meshtastic_MeshPacket *p, bool withUpd
     return seenRecently;
 }
 
+void PacketHistory::addRelayer(PacketRecord &r, const meshtastic_MeshPacket *p)
+{
+    // Older firmware does not tell us who relayed, and we don't count our own transmissions
+    if (p->relay_node == NO_RELAY_NODE || isFromUs(p) || r.numRelayers >= PACKET_HISTORY_MAX_RELAYERS)
+        return;
+
+    for (uint8_t i = 0; i < r.numRelayers; i++) {
+        if (r.relayers[i] == p->relay_node)
+            return;
+    }
+    r.relayers[r.numRelayers] = p->relay_node;
+    r.relayerSnr[r.numRelayers] = (int8_t)p->rx_snr;
+    r.numRelayers++;
+}
+
+uint8_t PacketHistory::getNumRelayersHeard(const meshtastic_MeshPacket *p, bool onlyBetterCoverage)
+{
+    PacketRecord r = {};
+    r.id = p->id;
+    r.sender = getFrom(p);
+
+    auto found = recentPackets.find(r);
+    if (found == recentPackets.end())
+        return 0;
+
+    if (!onlyBetterCoverage)
+        return found->numRelayers;
+
+    uint8_t n = 0;
+    for (uint8_t i = 0; i < found->numRelayers; i++) {
+        if (found->relayerSnr[i] >= found->firstSnr)
+            n++;
+    }
+    return n;
+}
+
 /**
  * Iterate through all recent packets, and remove all older than FLOOD_EXPIRE_TIME
  */
@@ -10,6 +10,9 @@
 #define FLOOD_EXPIRE_TIME (10 * 60 * 1000L)
 #endif
 
+/// Max number of distinct relayers we remember per packet, enough for the relay suppression thresholds we use
+#define PACKET_HISTORY_MAX_RELAYERS 3
+
 /**
  * A record of a recent message broadcast
  */
@@ -18,6 +21,11 @@ struct PacketRecord {
     PacketId id;
     uint32_t rxTimeMsec; // Unix time in msecs - the time we received it
 
+    int8_t firstSnr;                                // SNR (rounded to dB) of the first copy we heard, the one we might relay
+    uint8_t numRelayers;                            // Number of distinct relayers of duplicate copies we heard
+    uint8_t relayers[PACKET_HISTORY_MAX_RELAYERS];  // relay_node of those duplicate copies
+    int8_t relayerSnr[PACKET_HISTORY_MAX_RELAYERS]; // SNR (rounded to dB) at which we heard each of those relayers
+
     bool operator==(const PacketRecord &p) const { return sender == p.sender && id == p.id; }
 };
 
@@ -37,6 +45,9 @@ class PacketHistory
 
     void clearExpiredRecentPackets(); // clear all recentPackets older than FLOOD_EXPIRE_TIME
 
+    /** Remember the relayer of the duplicate copy p in r, if it is one we didn't count yet */
+    void addRelayer(PacketRecord &r, const meshtastic_MeshPacket *p);
+
   public:
     PacketHistory();
 
@@ -46,4 +57,12 @@ class PacketHistory
      * @param withUpdate if true and not found we add an entry to recentPackets
      */
     bool wasSeenRecently(const meshtastic_MeshPacket *p, bool withUpdate = true);
+
+    /**
+     * @return the number of distinct nodes we heard relaying p after we received our first copy of it
+     *
+     * @param onlyBetterCoverage if true only count relayers we heard at least as well as that first copy.  Those are close
+     * enough to us that their transmission reaches most of the nodes our own relay would.
+     */
+    uint8_t getNumRelayersHeard(const meshtastic_MeshPacket *p, bool onlyBetterCoverage);
 };
@@ -295,58 +295,75 @@ uint32_t RadioInterface::getTxDelayMsecWeighted(float snr)
     return delay;
 }
 
+#if !MESHTASTIC_EXCLUDE_PACKET_LOGGING
+#if defined(DEBUG_PORT) && !defined(DEBUG_MUTE)
+/// Append to a fixed size buffer, silently truncating if it is full
+static void appendf(char *buf, size_t bufLen, size_t &pos, const char *format, ...) __attribute__((format(printf, 4, 5)));
+static void appendf(char *buf, size_t bufLen, size_t &pos, const char *format, ...)
+{
+    if (pos >= bufLen - 1)
+        return;
+    va_list arg;
+    va_start(arg, format);
+    int n = vsnprintf(buf + pos, bufLen - pos, format, arg);
+    va_end(arg);
+    if (n > 0)
+        pos = min(pos + n, bufLen - 1);
+}
+#endif
+
 void printPacket(const char *prefix, const meshtastic_MeshPacket *p)
 {
 #if defined(DEBUG_PORT) && !defined(DEBUG_MUTE)
-    std::string out = DEBUG_PORT.mt_sprintf("%s (id=0x%08x fr=0x%08x to=0x%08x, WantAck=%d, HopLim=%d Ch=0x%x", prefix, p->id,
-                                            p->from, p->to, p->want_ack, p->hop_limit, p->channel);
+    // This is called several times for every packet, so don't format anything nobody is going to read
+    if (!DEBUG_PORT.isLevelEnabled(MESHTASTIC_LOG_LEVEL_DEBUG))
+        return;
+
+    char out[PRINT_PACKET_BUF_SIZE];
+    size_t pos = 0;
+    appendf(out, sizeof(out), pos, "%s (id=0x%08x fr=0x%08x to=0x%08x, WantAck=%d, HopLim=%d Ch=0x%x", prefix, p->id, p->from,
+            p->to, p->want_ack, p->hop_limit, p->channel);
     if (p->which_payload_variant == meshtastic_MeshPacket_decoded_tag) {
         auto &s = p->decoded;
 
-        out += DEBUG_PORT.mt_sprintf(" Portnum=%d", s.portnum);
+        appendf(out, sizeof(out), pos, " Portnum=%d", s.portnum);
 
         if (s.want_response)
-            out += DEBUG_PORT.mt_sprintf(" WANTRESP");
+            appendf(out, sizeof(out), pos, " WANTRESP");
 
         if (p->pki_encrypted)
-            out += DEBUG_PORT.mt_sprintf(" PKI");
+            appendf(out, sizeof(out), pos, " PKI");
 
         if (s.source != 0)
-            out += DEBUG_PORT.mt_sprintf(" source=%08x", s.source);
+            appendf(out, sizeof(out), pos, " source=%08x", s.source);
 
         if (s.dest != 0)
-            out += DEBUG_PORT.mt_sprintf(" dest=%08x", s.dest);
+            appendf(out, sizeof(out), pos, " dest=%08x", s.dest);
 
         if (s.request_id)
-            out += DEBUG_PORT.mt_sprintf(" requestId=%0x", s.request_id);
-
-        /* now inside Data and therefore kinda opaque
-        if (s.which_ackVariant == SubPacket_success_id_tag)
-            out += DEBUG_PORT.mt_sprintf(" successId=%08x", s.ackVariant.success_id);
-        else if (s.which_ackVariant == SubPacket_fail_id_tag)
-            out += DEBUG_PORT.mt_sprintf(" failId=%08x", s.ackVariant.fail_id); */
+            appendf(out, sizeof(out), pos, " requestId=%0x", s.request_id);
     } else {
-        out += " encrypted";
-        out += DEBUG_PORT.mt_sprintf(" len=%d", p->encrypted.size + sizeof(PacketHeader));
+        appendf(out, sizeof(out), pos, " encrypted len=%d", p->encrypted.size + sizeof(PacketHeader));
     }
 
     if (p->rx_time != 0)
-        out += DEBUG_PORT.mt_sprintf(" rxtime=%u", p->rx_time);
+        appendf(out, sizeof(out), pos, " rxtime=%u", p->rx_time);
     if (p->rx_snr != 0.0)
-        out += DEBUG_PORT.mt_sprintf(" rxSNR=%g", p->rx_snr);
+        appendf(out, sizeof(out), pos, " rxSNR=%g", p->rx_snr);
     if (p->rx_rssi != 0)
-        out += DEBUG_PORT.mt_sprintf(" rxRSSI=%i", p->rx_rssi);
+        appendf(out, sizeof(out), pos, " rxRSSI=%i", p->rx_rssi);
     if (p->via_mqtt != 0)
-        out += DEBUG_PORT.mt_sprintf(" via MQTT");
+        appendf(out, sizeof(out), pos, " via MQTT");
     if (p->hop_start != 0)
-        out += DEBUG_PORT.mt_sprintf(" hopStart=%d", p->hop_start);
+        appendf(out, sizeof(out), pos, " hopStart=%d", p->hop_start);
     if (p->priority != 0)
-        out += DEBUG_PORT.mt_sprintf(" priority=%d", p->priority);
+        appendf(out, sizeof(out), pos, " priority=%d", p->priority);
 
-    out += ")";
-    LOG_DEBUG("%s", out.c_str());
+    appendf(out, sizeof(out), pos, ")");
+    LOG_DEBUG("%s", out);
 #endif
 }
+#endif
 
 RadioInterface::RadioInterface()
 {
@@ -620,8 +637,8 @@ size_t RadioInterface::beginSending(meshtastic_MeshPacket *p)
     radioBuffer.header.to = p->to;
     radioBuffer.header.id = p->id;
     radioBuffer.header.channel = p->channel;
-    radioBuffer.header.next_hop = 0;   // *** For future use ***
-    radioBuffer.header.relay_node = 0; // *** For future use ***
+    radioBuffer.header.next_hop = p->next_hop;
+    radioBuffer.header.relay_node = p->relay_node;
     if (p->hop_limit > HOP_MAX) {
         LOG_WARN("hop limit %d is too high, setting to %d", p->hop_limit, HOP_RELIABLE);
         p->hop_limit = HOP_RELIABLE;
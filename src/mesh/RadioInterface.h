@@ -4,6 +4,7 @@
 #include "MeshTypes.h"
 #include "Observer.h"
 #include "PointerQueue.h"
+#include "RadioTrace.h"
 #include "airtime.h"
 #include "error.h"
 
@@ -38,10 +39,10 @@ typedef struct {
     /** The channel hash - used as a hint for the decoder to limit which channels we consider */
     uint8_t channel;
 
-    // ***For future use*** Last byte of the NodeNum of the next-hop for this packet
+    // Last byte of the NodeNum of the next-hop for this packet, NO_NEXT_HOP_PREFERENCE to flood
     uint8_t next_hop;
 
-    // ***For future use*** Last byte of the NodeNum of the node that will relay/relayed this packet
+    // Last byte of the NodeNum of the node that will relay/relayed this packet
     uint8_t relay_node;
 } PacketHeader;
 
@@ -152,8 +153,12 @@ class RadioInterface
         return qs;
     }
 
-    /** Attempt to cancel a previously sent packet.  Returns true if a packet was found we could cancel */
-    virtual bool cancelSending(NodeNum from, PacketId id) { return false; }
+    /** Attempt to cancel a previously sent packet.  Returns true if a packet was found we could cancel
+     * @param reason why we cancel it, only used for the radio trace */
+    virtual bool cancelSending(NodeNum from, PacketId id, RadioTraceCancelReason reason = RADIO_TRACE_CANCEL_OTHER)
+    {
+        return false;
+    }
 
     // methods from radiohead
 
@@ -261,5 +266,12 @@ class RadioInterface
     }
 };
 
-/// Debug printing for packets
-void printPacket(const char *prefix, const meshtastic_MeshPacket *p);
\ No newline at end of file
+/// Max length of a printPacket() line, longer ones are truncated
+#define PRINT_PACKET_BUF_SIZE 256
+
+/// Debug printing for packets, build with MESHTASTIC_EXCLUDE_PACKET_LOGGING to compile it out completely
+#if MESHTASTIC_EXCLUDE_PACKET_LOGGING
+inline void printPacket(const char *prefix, const meshtastic_MeshPacket *p) {}
+#else
+void printPacket(const char *prefix, const meshtastic_MeshPacket *p);
+#endif
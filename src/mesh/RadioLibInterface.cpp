@@ -4,6 +4,7 @@
 #include "PowerMon.h"
 #include "SPILock.h"
 #include "Throttle.h"
+#include "TxBatch.h"
 #include "configuration.h"
 #include "error.h"
 #include "main.h"
@@ -40,6 +41,7 @@ RadioLibInterface::RadioLibInterface(LockingArduinoHal *hal, RADIOLIB_PIN_TYPE c
     : NotifiedWorkerThread("RadioIf"), module(hal, cs, irq, rst, busy), iface(_iface)
 {
     instance = this;
+    txBatch.setHoldMs(TxBatch::holdMsForRole(config.device.role, config.power.is_power_saving));
 #if defined(ARCH_STM32WL) && defined(USE_SX1262)
     module.setCb_digitalWrite(stm32wl_emulate_digitalWrite);
     module.setCb_digitalRead(stm32wl_emulate_digitalRead);
@@ -53,8 +55,11 @@ RadioLibInterface::RadioLibInterface(LockingArduinoHal *hal, RADIOLIB_PIN_TYPE c
 #define YIELD_FROM_ISR(x) portYIELD_FROM_ISR(x)
 #endif
 
+volatile uint32_t RadioLibInterface::isrUsec;
+
 void INTERRUPT_ATTR RadioLibInterface::isrLevel0Common(PendingISR cause)
 {
+    isrUsec = micros();
     instance->disableInterrupt();
 
     BaseType_t xHigherPriorityTaskWoken;
@@ -116,6 +121,7 @@ bool RadioLibInterface::receiveDetected(uint16_t irq, ulong syncWordHeaderValidF
     if (detected) {
         if (!activeReceiveStart) {
             activeReceiveStart = millis();
+            trace(RADIO_TRACE_RX_START);
         } else if (!Throttle::isWithinTimespanMs(activeReceiveStart, 2 * preambleTimeMsec) && !(irq & syncWordHeaderValidFlag)) {
             // The HEADER_VALID flag should be set by now if it was really a packet, so ignore PREAMBLE_DETECTED flag
             activeReceiveStart = 0;
@@ -179,6 +185,8 @@ ErrorCode RadioLibInterface::send(meshtastic_MeshPacket *p)
         return res;
     }
 
+    txBatch.queued(txBatch.canWait(p, isFromUs(p)), millis());
+
     // set (random) transmit delay to let others reconfigure their radio,
     // to avoid collisions and implement timing-based flooding
     setTransmitDelay();
@@ -211,13 +219,16 @@ bool RadioLibInterface::canSleep()
 }
 
 /** Attempt to cancel a previously sent packet.  Returns true if a packet was found we could cancel */
-bool RadioLibInterface::cancelSending(NodeNum from, PacketId id)
+bool RadioLibInterface::cancelSending(NodeNum from, PacketId id, RadioTraceCancelReason reason)
 {
     auto p = txQueue.remove(from, id);
     if (p)
         packetPool.release(p); // free the packet we just removed
+    if (txQueue.empty() && txBatch.isOpen())
+        txBatch.abandon(); // don't let the periodic senders join a batch that will never go out
 
     bool result = (p != NULL);
+    trace(RADIO_TRACE_TX_CANCEL, reason | (result ? RADIO_TRACE_CANCEL_REMOVED : 0), id);
     LOG_DEBUG("cancelSending id=0x%x, removed=%d", id, result);
     return result;
 }
@@ -233,11 +244,13 @@ void RadioLibInterface::onNotify(uint32_t notification)
 {
     switch (notification) {
     case ISR_TX:
+        trace(RADIO_TRACE_TX_ISR, 0, micros() - isrUsec);
         handleTransmitInterrupt();
         startReceive();
         setTransmitDelay();
         break;
     case ISR_RX:
+        trace(RADIO_TRACE_RX_ISR, 0, micros() - isrUsec);
         handleReceiveInterrupt();
         startReceive();
         setTransmitDelay();
@@ -247,6 +260,18 @@ void RadioLibInterface::onNotify(uint32_t notification)
         // If we are not currently in receive mode, then restart the random delay (this can happen if the main thread
         // has placed the unit into standby)  FIXME, how will this work if the chipset is in sleep mode?
         if (!txQueue.empty()) {
+            uint32_t hold = txBatch.holdFor(millis(), txQueue);
+            if (hold) {
+                // Our own broadcasts wait for the rest of their batch
+                notifyLater(hold, TRANSMIT_DELAY_COMPLETED, false);
+                break;
+            }
+            if (txBatch.isOpen()) {
+                uint32_t batched = txBatch.close();
+                trace(RADIO_TRACE_TX_BATCH, batched);
+                if (batched > 1)
+                    LOG_DEBUG("Send %u of our packets in one batch", batched);
+            }
             if (!canSendImmediately()) {
                 setTransmitDelay(); // currently Rx/Tx-ing: reset random delay
             } else {
@@ -258,6 +283,7 @@ void RadioLibInterface::onNotify(uint32_t notification)
                     notifyLater(delay_remaining, TRANSMIT_DELAY_COMPLETED, false);
                 } else {
                     if (isChannelActive()) { // check if there is currently a LoRa packet on the channel
+                        trace(RADIO_TRACE_CHANNEL_BUSY);
                         startReceive();      // try receiving this packet, afterwards we'll be trying to transmit again
                         setTransmitDelay();
                     } else {
@@ -275,8 +301,8 @@ void RadioLibInterface::onNotify(uint32_t notification)
                     }
                 }
             }
-        } else {
-            // Do nothing, because the queue is empty
+        } else if (txBatch.isOpen()) {
+            txBatch.abandon(); // everything it held was cancelled
         }
         break;
     default:
@@ -299,6 +325,7 @@ void RadioLibInterface::setTransmitDelay()
         unsigned long add_delay = p->rx_rssi ? getTxDelayMsecWeighted(p->rx_snr) : getTxDelayMsec();
         unsigned long now = millis();
         p->tx_after = min(max(p->tx_after + add_delay, now + add_delay), now + 2 * getTxDelayMsecWeightedWorst(p->rx_snr));
+        trace(RADIO_TRACE_TX_DELAY, p->tx_after - now, p->id);
         notifyLater(p->tx_after - now, TRANSMIT_DELAY_COMPLETED, false);
     } else if (p->rx_snr == 0 && p->rx_rssi == 0) {
         /* We assume if rx_snr = 0 and rx_rssi = 0, the packet was generated locally.
@@ -318,6 +345,7 @@ void RadioLibInterface::startTransmitTimer(bool withDelay)
     // If we have work to do and the timer wasn't already scheduled, schedule it now
     if (!txQueue.empty()) {
         uint32_t delay = !withDelay ? 1 : getTxDelayMsec();
+        trace(RADIO_TRACE_TX_DELAY, delay, txQueue.getFront()->id);
         notifyLater(delay, TRANSMIT_DELAY_COMPLETED, false); // This will implicitly enable
     }
 }
@@ -327,6 +355,7 @@ void RadioLibInterface::startTransmitTimerSNR(float snr)
     // If we have work to do and the timer wasn't already scheduled, schedule it now
     if (!txQueue.empty()) {
         uint32_t delay = getTxDelayMsecWeighted(snr);
+        trace(RADIO_TRACE_TX_DELAY, delay, txQueue.getFront()->id);
         notifyLater(delay, TRANSMIT_DELAY_COMPLETED, false); // This will implicitly enable
     }
 }
@@ -365,6 +394,7 @@ void RadioLibInterface::completeSending()
     sendingPacket = NULL;
 
     if (p) {
+        trace(RADIO_TRACE_TX_DONE, 0, p->id);
         txGood++;
         if (!isFromUs(p))
             txRelay++;
@@ -409,6 +439,7 @@ void RadioLibInterface::handleReceiveInterrupt()
 #endif
     if (state != RADIOLIB_ERR_NONE) {
         LOG_ERROR("Ignore received packet due to error=%d", state);
+        trace(RADIO_TRACE_RX_BAD, (uint16_t)state);
         rxBad++;
 
         airTime->logAirtime(RX_ALL_LOG, xmitMsec);
@@ -420,10 +451,12 @@ void RadioLibInterface::handleReceiveInterrupt()
         // check for short packets
         if (payloadLen < 0) {
             LOG_WARN("Ignore received packet too short");
+            trace(RADIO_TRACE_RX_BAD, length);
             rxBad++;
             airTime->logAirtime(RX_ALL_LOG, xmitMsec);
         } else {
             rxGood++;
+            trace(RADIO_TRACE_RX_DONE, length, radioBuffer.header.id);
             // altered packet with "from == 0" can do Remote Node Administration without permission
             if (radioBuffer.header.from == 0) {
                 LOG_WARN("Ignore received packet without sender");
@@ -445,6 +478,8 @@ void RadioLibInterface::handleReceiveInterrupt()
             mp->hop_start = (radioBuffer.header.flags & PACKET_FLAGS_HOP_START_MASK) >> PACKET_FLAGS_HOP_START_SHIFT;
             mp->want_ack = !!(radioBuffer.header.flags & PACKET_FLAGS_WANT_ACK_MASK);
             mp->via_mqtt = !!(radioBuffer.header.flags & PACKET_FLAGS_VIA_MQTT_MASK);
+            mp->next_hop = radioBuffer.header.next_hop;
+            mp->relay_node = radioBuffer.header.relay_node;
 
             addReceiveMetadata(mp);
 
@@ -509,6 +544,7 @@ bool RadioLibInterface::startSend(meshtastic_MeshPacket *txp)
             // bits
             enableInterrupt(isrTxLevel0);
             lastTxStart = millis();
+            trace(RADIO_TRACE_TX_START, getPacketTime(txp), txp->id);
             printPacket("Started Tx", txp);
         }
 
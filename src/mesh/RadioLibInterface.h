@@ -2,6 +2,7 @@
 
 #include "MeshPacketQueue.h"
 #include "RadioInterface.h"
+#include "RadioTrace.h"
 #include "concurrency/NotifiedWorkerThread.h"
 
 #include <RadioLib.h>
@@ -55,8 +56,17 @@ class RadioLibInterface : public RadioInterface, protected concurrency::Notified
      */
     static void isrTxLevel0(), isrLevel0Common(PendingISR code);
 
+    /// micros() of the last ISR, so the radio trace can tell how long it took us to handle it
+    static volatile uint32_t isrUsec;
+
     MeshPacketQueue txQueue = MeshPacketQueue(MAX_TX_QUEUE);
 
+    /** Add an event to the radio trace, tagged with the current depth of our TX queue */
+    void trace(RadioTraceEventType type, uint16_t arg16 = 0, uint32_t arg32 = 0)
+    {
+        radioTrace.record(type, txQueue.getMaxLen() - txQueue.getFree(), arg16, arg32);
+    }
+
   protected:
     /**
      * We use a meshtastic sync word, but hashed with the Channel name.  For releases before 1.2 we used 0x12 (or for very old
@@ -133,7 +143,8 @@ class RadioLibInterface : public RadioInterface, protected concurrency::Notified
     virtual bool isActivelyReceiving() = 0;
 
     /** Attempt to cancel a previously sent packet.  Returns true if a packet was found we could cancel */
-    virtual bool cancelSending(NodeNum from, PacketId id) override;
+    virtual bool cancelSending(NodeNum from, PacketId id,
+                               RadioTraceCancelReason reason = RADIO_TRACE_CANCEL_OTHER) override;
 
   private:
     /** if we have something waiting to send, start a short (random) timer so we can come check for collision before actually
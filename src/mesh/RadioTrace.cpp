@@ -0,0 +1,73 @@
+#include "RadioTrace.h"
+#include "FSCommon.h"
+#include "SPILock.h"
+
+RadioTrace radioTrace;
+
+RadioTraceHeader RadioTrace::makeHeader(uint32_t total, uint32_t numEvents)
+{
+    RadioTraceHeader header;
+    header.magic = RADIO_TRACE_MAGIC;
+    header.version = RADIO_TRACE_VERSION;
+    header.eventSize = sizeof(RadioTraceEvent);
+    header.numEvents = numEvents;
+    header.totalEvents = total;
+    header.nowUsec = micros();
+    return header;
+}
+
+size_t RadioTrace::exportTo(uint8_t *buf, size_t bufLen) const
+{
+    if (bufLen < sizeof(RadioTraceHeader))
+        return 0;
+
+    // Snapshot the counter once, the radio thread might keep recording while we copy
+    uint32_t total = totalEvents;
+    uint32_t numEvents = min(total, capacity);
+    numEvents = min(numEvents, (uint32_t)((bufLen - sizeof(RadioTraceHeader)) / sizeof(RadioTraceEvent)));
+
+    RadioTraceHeader header = makeHeader(total, numEvents);
+    memcpy(buf, &header, sizeof(header));
+
+    uint8_t *out = buf + sizeof(header);
+#if !MESHTASTIC_EXCLUDE_RADIO_TRACE
+    for (uint32_t i = total - numEvents; i != total; i++) {
+        memcpy(out, &events[i % RADIO_TRACE_SIZE], sizeof(RadioTraceEvent));
+        out += sizeof(RadioTraceEvent);
+    }
+#endif
+    return out - buf;
+}
+
+bool RadioTrace::saveToFile(const char *filename) const
+{
+#if defined(FSCom) && !MESHTASTIC_EXCLUDE_RADIO_TRACE
+    // Write in chunks, so we don't need a buffer for the whole trace
+    uint8_t buf[16 * sizeof(RadioTraceEvent)];
+    uint32_t total = totalEvents;
+    RadioTraceHeader header = makeHeader(total, min(total, capacity));
+
+    concurrency::LockGuard g(spiLock);
+    FSCom.remove(filename);
+    auto f = FSCom.open(filename, FILE_O_WRITE);
+    if (!f) {
+        LOG_ERROR("Can't write radio trace to %s", filename);
+        return false;
+    }
+    f.write((const uint8_t *)&header, sizeof(header));
+    for (uint32_t i = total - header.numEvents; i != total;) {
+        size_t len = 0;
+        for (; i != total && len + sizeof(RadioTraceEvent) <= sizeof(buf); i++) {
+            memcpy(buf + len, &events[i % RADIO_TRACE_SIZE], sizeof(RadioTraceEvent));
+            len += sizeof(RadioTraceEvent);
+        }
+        f.write(buf, len);
+    }
+    f.flush();
+    f.close();
+    LOG_DEBUG("Saved %u radio trace events to %s", header.numEvents, filename);
+    return true;
+#else
+    return false;
+#endif
+}
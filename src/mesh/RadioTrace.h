@@ -0,0 +1,118 @@
+#pragma once
+
+#include "configuration.h"
+#include <Arduino.h>
+
+/// Number of events kept in the ring, the oldest ones are overwritten
+#ifndef RADIO_TRACE_SIZE
+#define RADIO_TRACE_SIZE 256
+#endif
+
+/// Requesting this file over XModem returns a snapshot of the trace instead of a file from flash
+#define RADIO_TRACE_FILENAME "/radiotrace.bin"
+
+/// Magic at the start of an exported trace, followed by the format version
+#define RADIO_TRACE_MAGIC 0x5452544d // "MTRT" in little endian
+#define RADIO_TRACE_VERSION 2
+
+/**
+ * Kind of radio event, keep in sync with bin/radio-trace-decode.py
+ */
+enum RadioTraceEventType : uint8_t {
+    RADIO_TRACE_NONE = 0,
+    RADIO_TRACE_RX_ISR,       // at the time we handle it, arg32: usecs since the ISR fired
+    RADIO_TRACE_TX_ISR,       // at the time we handle it, arg32: usecs since the ISR fired
+    RADIO_TRACE_RX_START,     // preamble/header detected
+    RADIO_TRACE_RX_DONE,      // arg16: length, arg32: packet id
+    RADIO_TRACE_RX_BAD,       // arg16: RadioLib error (e.g. CRC), or the length if it was too short
+    RADIO_TRACE_TX_DELAY,     // arg16: delay chosen from the contention window in msec
+    RADIO_TRACE_CHANNEL_BUSY, // channel activity detected while we wanted to transmit
+    RADIO_TRACE_TX_START,     // arg16: airtime in msec, arg32: packet id
+    RADIO_TRACE_TX_DONE,      // arg32: packet id
+    RADIO_TRACE_TX_CANCEL,    // arg16: RadioTraceCancelReason, bit 7 set if the packet was still queued, arg32: packet id
+    RADIO_TRACE_TX_BATCH,     // a batch of our own packets is released (see TxBatch), arg16: packets in it
+};
+
+/**
+ * Why we tried to cancel a queued packet
+ */
+enum RadioTraceCancelReason : uint8_t {
+    RADIO_TRACE_CANCEL_OTHER = 0,
+    RADIO_TRACE_CANCEL_RELAYED,   // enough other nodes relayed it already
+    RADIO_TRACE_CANCEL_ACKED,     // it was acked or replied to
+    RADIO_TRACE_CANCEL_FILTERED,  // we decided to not handle it after decoding
+    RADIO_TRACE_CANCEL_SUPERSEDED // a newer packet of the same kind replaced it
+};
+
+#define RADIO_TRACE_CANCEL_REMOVED 0x80
+
+/**
+ * A single event, this is also the on-the-wire format of the export (little endian)
+ */
+struct __attribute__((packed)) RadioTraceEvent {
+    uint32_t timeUsec; // micros() when it happened
+    uint8_t type;      // RadioTraceEventType
+    uint8_t queueDepth;
+    uint16_t arg16;
+    uint32_t arg32;
+};
+
+/**
+ * Header of an exported trace, followed by numEvents RadioTraceEvents (oldest first)
+ */
+struct __attribute__((packed)) RadioTraceHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t eventSize;
+    uint32_t numEvents;
+    uint32_t totalEvents; // including the ones that were overwritten
+    uint32_t nowUsec;     // micros() at the time of the export
+};
+
+/**
+ * A fixed size ring of binary radio events.  Recording one costs a few instructions, but the ring takes RAM, so it is only
+ * compiled in on meshtasticd or when a build sets MESHTASTIC_EXCLUDE_RADIO_TRACE=0 (see configuration.h).
+ *
+ * Written only from the radio thread, so timestamps never go backwards, read by the exporters.
+ */
+class RadioTrace
+{
+#if !MESHTASTIC_EXCLUDE_RADIO_TRACE
+    RadioTraceEvent events[RADIO_TRACE_SIZE] = {};
+    static constexpr uint32_t capacity = RADIO_TRACE_SIZE;
+#else
+    // Nothing is recorded, exports are just a header
+    static constexpr uint32_t capacity = 0;
+#endif
+    volatile uint32_t totalEvents = 0;
+
+    static RadioTraceHeader makeHeader(uint32_t total, uint32_t numEvents);
+
+  public:
+    inline void record(RadioTraceEventType type, uint8_t queueDepth, uint16_t arg16 = 0, uint32_t arg32 = 0)
+    {
+#if !MESHTASTIC_EXCLUDE_RADIO_TRACE
+        RadioTraceEvent &e = events[totalEvents % RADIO_TRACE_SIZE];
+        e.timeUsec = micros();
+        e.type = type;
+        e.queueDepth = queueDepth;
+        e.arg16 = arg16;
+        e.arg32 = arg32;
+        totalEvents++;
+#endif
+    }
+
+    /**
+     * Copy a header and the recorded events (oldest first) to buf
+     * @return the number of bytes written
+     */
+    size_t exportTo(uint8_t *buf, size_t bufLen) const;
+
+    /** @return the size exportTo() needs for the whole trace */
+    static constexpr size_t exportSize() { return sizeof(RadioTraceHeader) + sizeof(RadioTraceEvent) * capacity; }
+
+    /** Write an export to a file on flash, so it can be fetched with XModem */
+    bool saveToFile(const char *filename) const;
+};
+
+extern RadioTrace radioTrace;
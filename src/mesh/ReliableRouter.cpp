@@ -35,7 +35,7 @@ ErrorCode ReliableRouter::send(meshtastic_MeshPacket *p)
         }
     }
 
-    return FloodingRouter::send(p);
+    return NextHopRouter::send(p);
 }
 
 bool ReliableRouter::shouldFilterReceived(const meshtastic_MeshPacket *p)
@@ -73,7 +73,7 @@ bool ReliableRouter::shouldFilterReceived(const meshtastic_MeshPacket *p)
         i->second.nextTxMsec += iface->getPacketTime(p);
     }
 
-    return FloodingRouter::shouldFilterReceived(p);
+    return NextHopRouter::shouldFilterReceived(p);
 }
 
 /**
@@ -138,7 +138,7 @@ void ReliableRouter::sniffReceived(const meshtastic_MeshPacket *p, const meshtas
     }
 
     // handle the packet as normal
-    FloodingRouter::sniffReceived(p, c);
+    NextHopRouter::sniffReceived(p, c);
 }
 
 #define NUM_RETRANSMISSIONS 3
@@ -175,7 +175,7 @@ bool ReliableRouter::stopRetransmission(GlobalPacketId key)
           to avoid canceling a transmission if it was ACKed super fast via MQTT */
         if (old->numRetransmissions < NUM_RETRANSMISSIONS - 1) {
             // remove the 'original' (identified by originator and packet->id) from the txqueue and free it
-            cancelSending(getFrom(p), p->id);
+            cancelSending(getFrom(p), p->id, RADIO_TRACE_CANCEL_ACKED);
         }
         // now free the pooled copy for retransmission too
         packetPool.release(p);
@@ -231,9 +231,13 @@ int32_t ReliableRouter::doRetransmissions()
                 LOG_DEBUG("Send reliable retransmission fr=0x%x,to=0x%x,id=0x%x, tries left=%d", p.packet->from, p.packet->to,
                           p.packet->id, p.numRetransmissions);
 
+                // If we sent this via a next hop and didn't hear it relayed, the route is probably stale: flood instead
+                if (isFromUs(p.packet) && resetRoute(p.packet->to))
+                    LOG_INFO("Next hop to 0x%x did not relay, fall back to flooding", p.packet->to);
+
                 // Note: we call the superclass version because we don't want to have our version of send() add a new
                 // retransmission record
-                FloodingRouter::send(packetPool.allocCopy(*p.packet));
+                NextHopRouter::send(packetPool.allocCopy(*p.packet));
 
                 // Queue again
                 --p.numRetransmissions;
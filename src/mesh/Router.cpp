@@ -253,6 +253,9 @@ ErrorCode Router::send(meshtastic_MeshPacket *p)
     if (isFromUs(p))
         p->hop_start = p->hop_limit;
 
+    // Whether we originate or relay this packet, we are the one putting it on the air
+    p->relay_node = getLastByteOfNodeNum(getNodeNum());
+
     // If the packet hasn't yet been encrypted, do so now (it might already be encrypted if we are just forwarding it)
 
     if (!(p->which_payload_variant == meshtastic_MeshPacket_encrypted_tag ||
@@ -288,9 +291,9 @@ ErrorCode Router::send(meshtastic_MeshPacket *p)
 }
 
 /** Attempt to cancel a previously sent packet.  Returns true if a packet was found we could cancel */
-bool Router::cancelSending(NodeNum from, PacketId id)
+bool Router::cancelSending(NodeNum from, PacketId id, RadioTraceCancelReason reason)
 {
-    return iface ? iface->cancelSending(from, id) : false;
+    return iface ? iface->cancelSending(from, id, reason) : false;
 }
 
 /**
@@ -300,6 +303,7 @@ bool Router::cancelSending(NodeNum from, PacketId id)
 void Router::sniffReceived(const meshtastic_MeshPacket *p, const meshtastic_Routing *c)
 {
     // FIXME, update nodedb here for any packet that passes through us
+    linkTable.update(p);
 }
 
 bool perhapsDecode(meshtastic_MeshPacket *p)
@@ -590,7 +594,7 @@ void Router::handleReceived(meshtastic_MeshPacket *p, RxSource src)
             p->decoded.portnum == meshtastic_PortNum_NEIGHBORINFO_APP &&
             (!moduleConfig.has_neighbor_info || !moduleConfig.neighbor_info.enabled)) {
             LOG_DEBUG("Neighbor info module is disabled, ignore neighbor packet");
-            cancelSending(p->from, p->id);
+            cancelSending(p->from, p->id, RADIO_TRACE_CANCEL_FILTERED);
             skipHandle = true;
         }
 
@@ -605,7 +609,7 @@ void Router::handleReceived(meshtastic_MeshPacket *p, RxSource src)
                       meshtastic_PortNum_PRIVATE_APP, meshtastic_PortNum_DETECTION_SENSOR_APP, meshtastic_PortNum_RANGE_TEST_APP,
                       meshtastic_PortNum_REMOTE_HARDWARE_APP)) {
             LOG_DEBUG("Ignore packet on blacklisted portnum for CORE_PORTNUMS_ONLY");
-            cancelSending(p->from, p->id);
+            cancelSending(p->from, p->id, RADIO_TRACE_CANCEL_FILTERED);
             skipHandle = true;
         }
     } else {
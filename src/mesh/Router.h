@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Channels.h"
+#include "LinkTable.h"
 #include "MemoryPool.h"
 #include "MeshTypes.h"
 #include "Observer.h"
@@ -21,6 +22,9 @@ class Router : protected concurrency::OSThread
   protected:
     RadioInterface *iface = NULL;
 
+    /// Link quality of our direct neighbours, updated for every packet we sniff
+    LinkTable linkTable;
+
   public:
     /**
      * Constructor
@@ -48,7 +52,7 @@ class Router : protected concurrency::OSThread
     ErrorCode sendLocal(meshtastic_MeshPacket *p, RxSource src = RX_SRC_RADIO);
 
     /** Attempt to cancel a previously sent packet.  Returns true if a packet was found we could cancel */
-    bool cancelSending(NodeNum from, PacketId id);
+    bool cancelSending(NodeNum from, PacketId id, RadioTraceCancelReason reason = RADIO_TRACE_CANCEL_OTHER);
 
     /** Allocate and return a meshpacket which defaults as send to broadcast from the current node.
      * The returned packet is guaranteed to have a unique packet ID already assigned
@@ -82,6 +86,12 @@ class Router : protected concurrency::OSThread
      */
     virtual ErrorCode send(meshtastic_MeshPacket *p);
 
+    /** Link quality statistics for our direct neighbours */
+    const LinkTable &getLinkTable() const { return linkTable; }
+
+    /** Forget all link statistics (i.e. after the NodeDB has been reset) */
+    void resetLinkTable() { linkTable.clear(); }
+
     /* Statistics for the amount of duplicate received packets and the amount of times we cancel a relay because someone did it
         before us */
     uint32_t rxDupe = 0, txRelayCanceled = 0;
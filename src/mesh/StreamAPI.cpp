@@ -24,7 +24,10 @@ int32_t StreamAPI::readStream()
     if (!stream->available()) {
         // Nothing available this time, if the computer has talked to us recently, poll often, otherwise let CPU sleep a long time
         bool recentRx = Throttle::isWithinTimespanMs(lastRxMsec, 2000);
-        return recentRx ? 5 : 250;
+        if (recentRx)
+            return 5;
+        // Without a client there's nothing to send, and if the stream wakes us for the first bytes of one, nothing to poll
+        return (rxWakes && !isConnected()) ? INT32_MAX : 250;
     } else {
         while (stream->available()) { // Currently we never want to block
             int cInt = stream->read();
@@ -119,22 +122,15 @@ void StreamAPI::emitRebooted()
     emitTxBuffer(pb_encode_to_bytes(txBuf + HEADER_LEN, meshtastic_FromRadio_size, &meshtastic_FromRadio_msg, &fromRadioScratch));
 }
 
-void StreamAPI::emitLogRecord(meshtastic_LogRecord_Level level, const char *src, const char *format, va_list arg)
+void StreamAPI::emitLogRecord(meshtastic_LogRecord_Level level, const char *src, uint32_t time, const char *message)
 {
     // In case we send a FromRadio packet
     memset(&fromRadioScratch, 0, sizeof(fromRadioScratch));
     fromRadioScratch.which_payload_variant = meshtastic_FromRadio_log_record_tag;
     fromRadioScratch.log_record.level = level;
-
-    uint32_t rtc_sec = getValidTime(RTCQuality::RTCQualityDevice, true);
-    fromRadioScratch.log_record.time = rtc_sec;
+    fromRadioScratch.log_record.time = time;
     strncpy(fromRadioScratch.log_record.source, src, sizeof(fromRadioScratch.log_record.source) - 1);
-
-    auto num_printed =
-        vsnprintf(fromRadioScratch.log_record.message, sizeof(fromRadioScratch.log_record.message) - 1, format, arg);
-    if (num_printed > 0 && fromRadioScratch.log_record.message[num_printed - 1] ==
-                               '\n') // Strip any ending newline, because we have records for framing instead.
-        fromRadioScratch.log_record.message[num_printed - 1] = '\0';
+    strncpy(fromRadioScratch.log_record.message, message, sizeof(fromRadioScratch.log_record.message) - 1);
     emitTxBuffer(pb_encode_to_bytes(txBuf + HEADER_LEN, meshtastic_FromRadio_size, &meshtastic_FromRadio_msg, &fromRadioScratch));
 }
 
@@ -81,9 +81,12 @@ class StreamAPI : public PhoneAPI
     /// Are we allowed to write packets to our output stream (subclasses can turn this off - i.e. SerialConsole)
     bool canWrite = true;
 
+    /// Set by subclasses whose thread is woken when bytes arrive, so runOncePart() needn't poll for a client to show up
+    bool rxWakes = false;
+
     /// Subclasses can use this scratch buffer if they wish
     uint8_t txBuf[MAX_STREAM_BUF_SIZE] = {0};
 
     /// Low level function to emit a protobuf encapsulated log record
-    void emitLogRecord(meshtastic_LogRecord_Level level, const char *src, const char *format, va_list arg);
+    void emitLogRecord(meshtastic_LogRecord_Level level, const char *src, uint32_t time, const char *message);
 };
\ No newline at end of file
@@ -0,0 +1,78 @@
+#include "TxBatch.h"
+#include "MeshTypes.h"
+
+TxBatch txBatch;
+
+uint32_t TxBatch::holdMsForRole(meshtastic_Config_DeviceConfig_Role role, bool powerSaving, uint32_t holdMs)
+{
+    switch (role) {
+    case meshtastic_Config_DeviceConfig_Role_TRACKER:
+    case meshtastic_Config_DeviceConfig_Role_TAK_TRACKER:
+    case meshtastic_Config_DeviceConfig_Role_SENSOR:
+        return holdMs;
+    case meshtastic_Config_DeviceConfig_Role_CLIENT:
+    case meshtastic_Config_DeviceConfig_Role_CLIENT_MUTE:
+    case meshtastic_Config_DeviceConfig_Role_TAK:
+        return powerSaving ? holdMs : 0;
+    default:
+        return 0;
+    }
+}
+
+bool TxBatch::canWait(const meshtastic_MeshPacket *p, bool fromUs) const
+{
+    // Late rebroadcasts already have their own timing
+    return holdMs && fromUs && p->to == NODENUM_BROADCAST && p->priority <= TX_BATCH_MAX_PRIORITY && !p->tx_after;
+}
+
+void TxBatch::queued(bool canWait, uint32_t now)
+{
+    if (!canWait) {
+        // The radio goes active for this one anyway, the held packets go with it
+        holdUntil = now;
+        return;
+    }
+    if (open) {
+        packets++;
+        return;
+    }
+    open = true;
+    batchGap = batches ? now - openedAt : UINT32_MAX;
+    openedAt = now;
+    packets = 1;
+    holdUntil = now + holdMs;
+    batchOpened.notifyObservers(holdMs);
+}
+
+uint32_t TxBatch::holdFor(uint32_t now) const
+{
+    int32_t left = (int32_t)(holdUntil - now);
+    return (open && left > 0) ? left : 0;
+}
+
+uint32_t TxBatch::holdFor(uint32_t now, const MeshPacketQueue &queue) const
+{
+    uint32_t left = holdFor(now);
+    if (left && !queue.allOf([this](const meshtastic_MeshPacket *p) { return canWait(p, isFromUs(p)); }))
+        return 0; // e.g. a relay queued before our broadcast opened the batch
+    return left;
+}
+
+uint32_t TxBatch::close()
+{
+    if (!open)
+        return 0;
+    open = false;
+    batches++;
+    batchedPackets += packets;
+    return packets;
+}
+
+bool TxBatch::isDue(uint32_t sinceLastMs, uint32_t intervalMs) const
+{
+    if (sinceLastMs >= intervalMs)
+        return true;
+    // Wait for the next batch if there is likely to be one before we are due
+    uint32_t dueInMs = intervalMs - sinceLastMs;
+    return open && holdMs && dueInMs <= intervalMs / 100 * leadPercent && dueInMs < batchGap;
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include "MeshPacketQueue.h"
+#include "Observer.h"
+#include "mesh/generated/meshtastic/config.pb.h"
+#include "mesh/generated/meshtastic/mesh.pb.h"
+#include <stdint.h>
+
+/// How long our own low priority broadcasts wait for others to join them, 0 to send each on its own.  Only nodes that save
+/// power get it, see holdMsForRole()
+#ifndef TX_BATCH_HOLD_MS
+#define TX_BATCH_HOLD_MS 2000
+#endif
+
+/// A periodic broadcast due within this percentage of its interval goes out early, with a batch that is already on its way
+#ifndef TX_BATCH_LEAD_PERCENT
+#define TX_BATCH_LEAD_PERCENT 25
+#endif
+
+/// Packets of this priority and below may be held for a batch
+#ifndef TX_BATCH_MAX_PRIORITY
+#define TX_BATCH_MAX_PRIORITY meshtastic_MeshPacket_Priority_BACKGROUND
+#endif
+
+/**
+ * Groups our own low priority broadcasts (position, telemetry, nodeinfo), so they go out back to back in one radio-active
+ * period instead of each waking the transmitter, and the CPU, on its own.
+ *
+ * The first such packet opens a batch: the TX queue is held for TX_BATCH_HOLD_MS and batchOpened tells the periodic senders.
+ * Those that would be due before the next batch, going by the time between the last two, send now if that is within
+ * TX_BATCH_LEAD_PERCENT of their interval (see isDue()).  That lines their schedules up for the next time: with the default
+ * intervals, each a multiple of the position interval, they stay together after one early send.
+ *
+ * Nothing is held while the TX queue has a packet that may not wait, such as a relayed packet or a message to a node, whether
+ * it was queued before or after the batch opened.
+ */
+class TxBatch
+{
+  public:
+    /// Tells the periodic senders a batch has opened, with the msecs it is held for
+    Observable<uint32_t> batchOpened;
+
+    TxBatch(uint32_t holdMs = TX_BATCH_HOLD_MS, uint32_t leadPercent = TX_BATCH_LEAD_PERCENT)
+        : holdMs(holdMs), leadPercent(leadPercent)
+    {
+    }
+
+    /**
+     * Trackers and sensors sleep between their broadcasts, and so do clients in power saving mode, so for them fewer wakeups
+     * are worth a little delay.  Routers and other nodes that are always on just send.
+     * @return the hold for a node with this role and power saving setting
+     */
+    static uint32_t holdMsForRole(meshtastic_Config_DeviceConfig_Role role, bool powerSaving,
+                                  uint32_t holdMs = TX_BATCH_HOLD_MS);
+
+    /// Change the hold, 0 to stop batching
+    void setHoldMs(uint32_t ms) { holdMs = ms; }
+
+    /// Is p one of ours that may wait for a batch
+    bool canWait(const meshtastic_MeshPacket *p, bool fromUs) const;
+
+    /// A packet was queued: it opens a batch, joins the open one, or ends the hold if it can't wait
+    void queued(bool canWait, uint32_t now);
+
+    /// @return msecs the TX queue still has to wait for the open batch, 0 if it may go
+    uint32_t holdFor(uint32_t now) const;
+
+    /// @return msecs queue still has to wait for the open batch, 0 if it may go now or holds a packet that can't wait
+    uint32_t holdFor(uint32_t now, const MeshPacketQueue &queue) const;
+
+    bool isOpen() const { return open; }
+
+    /// The TX queue goes out, @return the number of packets the batch collected, 0 if none was open
+    uint32_t close();
+
+    /// The TX queue emptied before the batch went out (its packets were cancelled), so there is no batch to join any more
+    void abandon() { open = false; }
+
+    /// Is a periodic broadcast, last sent sinceLastMs ago, due: because intervalMs has passed, or soon enough to join a batch
+    bool isDue(uint32_t sinceLastMs, uint32_t intervalMs) const;
+
+    /// Batches sent since boot, and the packets they took along
+    uint32_t getBatches() const { return batches; }
+    uint32_t getBatchedPackets() const { return batchedPackets; }
+
+  private:
+    uint32_t holdMs, leadPercent;
+    bool open = false;
+    uint32_t holdUntil = 0;
+    uint32_t openedAt = 0, batchGap = UINT32_MAX; // when the open batch started, and how long after the one before
+    uint32_t packets = 0; // in the open batch
+    uint32_t batches = 0, batchedPackets = 0;
+};
+
+extern TxBatch txBatch;
@@ -13,6 +13,7 @@
 #include "SPILock.h"
 #include "power.h"
 #include "serialization/JSON.h"
+#include "serialization/NodeListJson.h"
 #include <FSCommon.h>
 #include <HTTPBodyParser.hpp>
 #include <HTTPMultipartBodyParser.hpp>
@@ -178,7 +179,22 @@ void handleAPIv1FromRadio(HTTPRequest *req, HTTPResponse *res)
     uint8_t txBuf[MAX_STREAM_BUF_SIZE];
     uint32_t len = 1;
 
-    if (params->getQueryParameter("all", valueAll)) {
+    std::string valueStream;
+    if (params->getQueryParameter("stream", valueStream) && valueStream == "true") {
+        // Handlers run on the main loop here, so rather than hold the connection open until there is something to send
+        // this returns every FromRadio we have right now, framed like StreamAPI does so the client can split them
+        res->setHeader("Cache-Control", "no-cache");
+        do {
+            len = webAPI.getFromRadio(txBuf + 4);
+            if (len) {
+                txBuf[0] = 0x94;
+                txBuf[1] = 0xc3;
+                txBuf[2] = (len >> 8) & 0xff;
+                txBuf[3] = len & 0xff;
+                res->write(txBuf, len + 4);
+            }
+        } while (len);
+    } else if (params->getQueryParameter("all", valueAll)) {
 
         // If all is true, return all the buffers we have available
         //   to us at this point in time.
@@ -431,6 +447,19 @@ void handleStatic(HTTPRequest *req, HTTPResponse *res)
             }
         }
 
+        // Unchanged since the browser last fetched it, it can keep using its copy
+        char etag[40];
+        snprintf(etag, sizeof(etag), "\"%lx-%x\"", (unsigned long)file.getLastWrite(), (unsigned)file.size());
+        res->setHeader("ETag", etag);
+        // Pages (including the index.html sent for unknown paths) are revalidated every time, so a new web client shows up
+        bool isPage = has_set_content_type || filename.rfind(".html") != std::string::npos;
+        res->setHeader("Cache-Control", isPage ? "no-cache" : "public, max-age=86400");
+        if (req->getHeader("If-None-Match").find(etag) != std::string::npos) {
+            res->setStatusCode(304);
+            file.close();
+            return;
+        }
+
         res->setHeader("Content-Length", httpsserver::intToString(file.size()));
 
         // Content-Type is guessed using the definition of the contentTypes-table defined above
@@ -452,10 +481,9 @@ void handleStatic(HTTPRequest *req, HTTPResponse *res)
         // Read the file and write it to the HTTP response body
         size_t length = 0;
         do {
-            char buffer[256];
-            length = file.read((uint8_t *)buffer, 256);
-            std::string bufferString(buffer, length);
-            res->write((uint8_t *)bufferString.c_str(), bufferString.size());
+            uint8_t buffer[512];
+            length = file.read(buffer, sizeof(buffer));
+            res->write(buffer, length);
         } while (length > 0);
 
         file.close();
@@ -714,57 +742,22 @@ void handleNodes(HTTPRequest *req, HTTPResponse *res)
         res->println("<pre>");
     }
 
-    JSONArray nodesArray;
-
-    uint32_t readIndex = 0;
-    const meshtastic_NodeInfoLite *tempNodeInfo = nodeDB->readNextMeshNode(readIndex);
-    while (tempNodeInfo != NULL) {
-        if (tempNodeInfo->has_user) {
-            JSONObject node;
-
-            char id[16];
-            snprintf(id, sizeof(id), "!%08x", tempNodeInfo->num);
-
-            node["id"] = new JSONValue(id);
-            node["snr"] = new JSONValue(tempNodeInfo->snr);
-            node["via_mqtt"] = new JSONValue(BoolToString(tempNodeInfo->via_mqtt));
-            node["last_heard"] = new JSONValue((int)tempNodeInfo->last_heard);
-            node["position"] = new JSONValue();
-
-            if (nodeDB->hasValidPosition(tempNodeInfo)) {
-                JSONObject position;
-                position["latitude"] = new JSONValue((float)tempNodeInfo->position.latitude_i * 1e-7);
-                position["longitude"] = new JSONValue((float)tempNodeInfo->position.longitude_i * 1e-7);
-                position["altitude"] = new JSONValue((int)tempNodeInfo->position.altitude);
-                node["position"] = new JSONValue(position);
-            }
-
-            node["long_name"] = new JSONValue(tempNodeInfo->user.long_name);
-            node["short_name"] = new JSONValue(tempNodeInfo->user.short_name);
-            char macStr[18];
-            snprintf(macStr, sizeof(macStr), "%02X:%02X:%02X:%02X:%02X:%02X", tempNodeInfo->user.macaddr[0],
-                     tempNodeInfo->user.macaddr[1], tempNodeInfo->user.macaddr[2], tempNodeInfo->user.macaddr[3],
-                     tempNodeInfo->user.macaddr[4], tempNodeInfo->user.macaddr[5]);
-            node["mac_address"] = new JSONValue(macStr);
-            node["hw_model"] = new JSONValue(tempNodeInfo->user.hw_model);
-
-            nodesArray.push_back(new JSONValue(node));
-        }
-        tempNodeInfo = nodeDB->readNextMeshNode(readIndex);
-    }
-
-    // collect data to inner data object
-    JSONObject jsonObjInner;
-    jsonObjInner["nodes"] = new JSONValue(nodesArray);
-
-    // create json output structure
-    JSONObject jsonObjOuter;
-    jsonObjOuter["data"] = new JSONValue(jsonObjInner);
-    jsonObjOuter["status"] = new JSONValue("ok");
-    // serialize and write it to the stream
-    JSONValue *value = new JSONValue(jsonObjOuter);
-    res->print(value->Stringify().c_str());
-    delete value;
+    // ?cursor=, ?limit=, ?since_last_heard= and ?fields= pick the page, see NodeListJson
+    NodeListJson::Query query;
+    std::string value;
+    if (params->getQueryParameter("cursor", value))
+        query.cursor = strtoul(value.c_str(), NULL, 0);
+    if (params->getQueryParameter("limit", value))
+        query.limit = strtoul(value.c_str(), NULL, 10);
+    if (params->getQueryParameter("since_last_heard", value))
+        query.sinceLastHeard = strtoul(value.c_str(), NULL, 10);
+    if (params->getQueryParameter("fields", value))
+        query.fields = NodeListJson::parseFields(value.c_str());
+
+    // Straight to the socket a node at a time, rather than all of them as JSONValues first
+    NodeListJson nodeList(nodeDB->meshNodes->data(), nodeDB->getNumMeshNodes(), query);
+    while (nodeList.writeNext(*res, nodeDB->meshNodes->data(), nodeDB->getNumMeshNodes()))
+        ;
 }
 
 /*
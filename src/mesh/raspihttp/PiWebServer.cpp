@@ -41,10 +41,14 @@ mail:   marchammermann@googlemail.com
 #include "PhoneAPI.h"
 #include "PowerFSM.h"
 #include "RadioLibInterface.h"
+#include "RadioTrace.h"
 #include "airtime.h"
+#include "concurrency/OSThread.h"
 #include "graphics/Screen.h"
 #include "main.h"
 #include "mesh/wifi/WiFiAPClient.h"
+#include "serialization/JSON.h"
+#include "serialization/NodeListJson.h"
 #include "sleep.h"
 #include <openssl/bn.h>
 #include <openssl/evp.h>
@@ -56,7 +60,11 @@ mail:   marchammermann@googlemail.com
 #include <ulfius.h>
 #include <yder.h>
 
+#include <algorithm>
+#include <chrono>
 #include <cstring>
+#include <sys/stat.h>
+#include <vector>
 #include <string>
 
 #include "PortduinoFS.h"
@@ -126,15 +134,139 @@ static void callback_static_file_stream_free(void *cls)
     }
 }
 
+std::shared_ptr<const StaticFile> StaticFileCache::get(const std::string &path, const struct stat &st)
+{
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        auto found = index.find(path);
+        if (found != index.end()) {
+            std::shared_ptr<const StaticFile> file = found->second->second;
+            if (file->mtime == st.st_mtime && file->size == st.st_size) {
+                lru.splice(lru.begin(), lru, found->second);
+                return file;
+            }
+            // Changed on disk
+            bytes -= file->data.size();
+            lru.erase(found->second);
+            index.erase(found);
+        }
+    }
+
+    // Read it without holding the lock, if two requests race for the same file both read it
+    FILE *f = fopen(path.c_str(), "rb");
+    if (!f)
+        return nullptr;
+    auto file = std::make_shared<StaticFile>();
+    file->mtime = st.st_mtime;
+    file->size = st.st_size;
+    file->data.resize(st.st_size);
+    size_t got = fread(&file->data[0], 1, file->data.size(), f);
+    fclose(f);
+    if (got != file->data.size())
+        return nullptr;
+
+    std::lock_guard<std::mutex> guard(lock);
+    if (index.find(path) == index.end()) {
+        lru.emplace_front(path, file);
+        index[path] = lru.begin();
+        bytes += file->data.size();
+        while (bytes > STATIC_CACHE_BYTES && lru.size() > 1) {
+            bytes -= lru.back().second->data.size();
+            index.erase(lru.back().first);
+            lru.pop_back();
+        }
+    }
+    return file;
+}
+
+static StaticFileCache staticFileCache;
+
+// Best first, the precompressed ones are only used if the client says it can take them
+static const StaticVariant staticVariants[] = {{".br", "br"}, {".gz", "gzip"}, {"", NULL}};
+
+/**
+ * @return the variant of file_path to send, NULL if there is none.  A file that only exists compressed is sent
+ * compressed anyway, like the ESP32 web server does.
+ */
+static const StaticVariant *pickStaticVariant(const struct _u_request *request, const char *file_path)
+{
+    const char *accept = u_map_get_case(request->map_header, "Accept-Encoding");
+    const StaticVariant *fallback = NULL;
+    for (const StaticVariant &v : staticVariants) {
+        struct stat st;
+        if (stat((std::string(file_path) + v.suffix).c_str(), &st) != 0 || !S_ISREG(st.st_mode))
+            continue;
+        if (!v.encoding || (accept && strstr(accept, v.encoding)))
+            return &v;
+        if (!fallback)
+            fallback = &v;
+    }
+    return fallback;
+}
+
+/**
+ * Send one file, from memory if it is small enough.  Revalidation with If-None-Match gets a 304 without the file being
+ * touched at all.
+ */
+static void sendStaticFile(const struct _u_request *request, struct _u_response *response, const std::string &path,
+                           const StaticVariant &variant, const char *file_requested)
+{
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0) {
+        ulfius_set_string_body_response(response, 404, "File not found");
+        return;
+    }
+
+    const char *content_type = u_map_get_case(&configWeb.mime_types, get_filename_ext(file_requested));
+    if (content_type == NULL) {
+        content_type = u_map_get(&configWeb.mime_types, "*");
+        LOG_DEBUG("Static File Server - Unknown mime type for extension %s ", get_filename_ext(file_requested));
+    }
+    char etag[64];
+    snprintf(etag, sizeof(etag), "\"%lx-%lx%s\"", (unsigned long)st.st_mtime, (unsigned long)st.st_size, variant.suffix);
+    // The page itself is checked every time, so a new web client shows up on the next reload
+    bool isPage = strcmp(get_filename_ext(file_requested), ".html") == 0;
+
+    u_map_put(response->map_header, "Content-Type", content_type);
+    u_map_put(response->map_header, "ETag", etag);
+    u_map_put(response->map_header, "Cache-Control", isPage ? "no-cache" : STATIC_CACHE_CONTROL);
+    u_map_put(response->map_header, "Vary", "Accept-Encoding");
+    if (variant.encoding)
+        u_map_put(response->map_header, "Content-Encoding", variant.encoding);
+    u_map_copy_into(response->map_header, &configWeb.map_header);
+
+    const char *ifNoneMatch = u_map_get_case(request->map_header, "If-None-Match");
+    if (ifNoneMatch && strstr(ifNoneMatch, etag)) {
+        response->status = 304;
+        return;
+    }
+
+    if (st.st_size <= STATIC_CACHE_MAX_FILE) {
+        std::shared_ptr<const StaticFile> file = staticFileCache.get(path, st);
+        if (file) {
+            ulfius_set_binary_body_response(response, 200, file->data.data(), file->data.size());
+            return;
+        }
+    } else {
+        FILE *f = fopen(path.c_str(), "rb");
+        if (f) {
+            if (ulfius_set_stream_response(response, 200, callback_static_file_stream, callback_static_file_stream_free,
+                                           st.st_size, STATIC_FILE_CHUNK, f) != U_OK) {
+                LOG_DEBUG("callback_static_file - Error ulfius_set_stream_response");
+                fclose(f);
+            }
+            return;
+        }
+    }
+    ulfius_set_string_body_response(response, 404, "File not found");
+}
+
 /**
  * static file callback endpoint that delivers the content for WebServer calls
  */
 int callback_static_file(const struct _u_request *request, struct _u_response *response, void *user_data)
 {
-    size_t length;
-    FILE *f;
     char *file_requested, *file_path, *url_dup_save, *real_path = NULL;
-    const char *content_type;
 
     /*
      * Comment this if statement if you don't access static files url from root dir, like /app
@@ -167,36 +299,11 @@ int callback_static_file(const struct _u_request *request, struct _u_response *r
         }
 
         file_path = msprintf("%s/%s", configWeb.files_path, file_requested);
-        real_path = realpath(file_path, NULL);
-        if (0 == o_strncmp(configWeb.files_path, real_path, o_strlen(configWeb.files_path))) {
-            if (access(file_path, F_OK) != -1) {
-                f = fopen(file_path, "rb");
-                if (f) {
-                    fseek(f, 0, SEEK_END);
-                    length = ftell(f);
-                    fseek(f, 0, SEEK_SET);
-
-                    content_type = u_map_get_case(&configWeb.mime_types, get_filename_ext(file_requested));
-                    if (content_type == NULL) {
-                        content_type = u_map_get(&configWeb.mime_types, "*");
-                        LOG_DEBUG("Static File Server - Unknown mime type for extension %s ", get_filename_ext(file_requested));
-                    }
-                    u_map_put(response->map_header, "Content-Type", content_type);
-                    u_map_copy_into(response->map_header, &configWeb.map_header);
-
-                    if (ulfius_set_stream_response(response, 200, callback_static_file_stream, callback_static_file_stream_free,
-                                                   length, STATIC_FILE_CHUNK, f) != U_OK) {
-                        LOG_DEBUG("callback_static_file - Error ulfius_set_stream_response");
-                    }
-                }
-            } else {
-                if (configWeb.redirect_on_404 == NULL) {
-                    ulfius_set_string_body_response(response, 404, "File not found");
-                } else {
-                    ulfius_add_header_to_response(response, "Location", configWeb.redirect_on_404);
-                    response->status = 302;
-                }
-            }
+        const StaticVariant *variant = pickStaticVariant(request, file_path);
+        std::string variant_path = std::string(file_path) + (variant ? variant->suffix : "");
+        real_path = realpath(variant_path.c_str(), NULL);
+        if (variant && 0 == o_strncmp(configWeb.files_path, real_path, o_strlen(configWeb.files_path))) {
+            sendStaticFile(request, response, variant_path, *variant, file_requested);
         } else {
             if (configWeb.redirect_on_404 == NULL) {
                 ulfius_set_string_body_response(response, 404, "File not found");
@@ -218,6 +325,132 @@ int callback_static_file(const struct _u_request *request, struct _u_response *r
 
 static void handleWebResponse() {}
 
+bool MainLoopCalls::call(const std::function<void()> &fn, uint32_t timeoutMs)
+{
+    Call c = {&fn, false};
+    std::unique_lock<std::mutex> guard(lock);
+    calls.push_back(&c);
+    wake();
+    if (!callDone.wait_for(guard, std::chrono::milliseconds(timeoutMs), [&] { return c.done; })) {
+        calls.erase(std::find(calls.begin(), calls.end(), &c));
+        LOG_WARN("Main loop busy, web request gave up after %u ms", timeoutMs);
+        return false;
+    }
+    return true;
+}
+
+int32_t MainLoopCalls::runOnce()
+{
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        for (Call *c : calls) {
+            (*c->fn)();
+            c->done = true;
+        }
+        calls.clear();
+    }
+    callDone.notify_all();
+    return INT32_MAX;
+}
+
+bool HttpAPI::handleToRadio(const uint8_t *buf, size_t len)
+{
+    bool result = PhoneAPI::handleToRadio(buf, len);
+    wake();
+    return result;
+}
+
+void HttpAPI::onNowHasData(uint32_t fromRadioNum)
+{
+    wake();
+}
+
+void HttpAPI::wake()
+{
+    {
+        std::lock_guard<std::mutex> lock(dataLock);
+        wakeups++;
+    }
+    dataReady.notify_all();
+}
+
+uint32_t HttpAPI::startStream()
+{
+    uint32_t stream;
+    {
+        std::lock_guard<std::mutex> lock(dataLock);
+        stream = ++currentStream;
+        wakeups++;
+    }
+    dataReady.notify_all();
+    return stream;
+}
+
+bool HttpAPI::isCurrentStream(uint32_t stream)
+{
+    std::lock_guard<std::mutex> lock(dataLock);
+    return stream == currentStream;
+}
+
+uint32_t HttpAPI::dataSeq()
+{
+    std::lock_guard<std::mutex> lock(dataLock);
+    return wakeups;
+}
+
+bool HttpAPI::waitForData(uint32_t &seq, uint32_t timeoutMs)
+{
+    std::unique_lock<std::mutex> lock(dataLock);
+    bool woken = dataReady.wait_for(lock, std::chrono::milliseconds(timeoutMs), [&] { return wakeups != seq; });
+    seq = wakeups;
+    return woken;
+}
+
+/// One open /api/v1/fromradio?stream=true
+struct FromRadioStream {
+    HttpAPI *api;
+    uint32_t id;
+    uint8_t frame[MAX_STREAM_BUF_SIZE]; // the frame being sent, with the same header as StreamAPI
+    size_t frameLen = 0, framePos = 0;
+};
+
+/**
+ * Called by the connection's own thread whenever the client can take more, so a slow client just leaves packets in the
+ * PhoneAPI queue.  Blocks while there is nothing to send, but the frames themselves are taken on the main loop.
+ */
+static ssize_t callback_fromradio_stream(void *cls, uint64_t pos, char *buf, size_t max)
+{
+    (void)(pos);
+    FromRadioStream *s = (FromRadioStream *)cls;
+    while (s->framePos == s->frameLen) {
+        if (!s->api->isCurrentStream(s->id))
+            return U_STREAM_END;
+        uint32_t seq = s->api->dataSeq();
+        // During the config download PhoneAPI reads NodeDB, which only the main loop may touch
+        size_t len = 0;
+        if (!piwebServerThread->mainLoop.call([s, &len]() { len = s->api->getFromRadio(s->frame + 4); }))
+            return U_STREAM_ERROR;
+        if (len == 0 && s->api->waitForData(seq, FROMRADIO_STREAM_KEEPALIVE_MS))
+            continue;
+        // An empty frame if we timed out, to keep the connection alive
+        s->frame[0] = 0x94;
+        s->frame[1] = 0xc3;
+        s->frame[2] = (len >> 8) & 0xff;
+        s->frame[3] = len & 0xff;
+        s->frameLen = len + 4;
+        s->framePos = 0;
+    }
+    size_t n = std::min(max, s->frameLen - s->framePos);
+    memcpy(buf, s->frame + s->framePos, n);
+    s->framePos += n;
+    return n;
+}
+
+static void callback_fromradio_stream_free(void *cls)
+{
+    delete (FromRadioStream *)cls;
+}
+
 /*
  * Adapt the radioapi to the Webservice handleAPIv1ToRadio
  * Trigger : WebGui(SAVE)->WebServcice->phoneApi
@@ -275,6 +508,22 @@ int handleAPIv1FromRadio(const struct _u_request *req, struct _u_response *res,
         return U_CALLBACK_COMPLETE;
     }
 
+    // Keep the connection open and send every FromRadio as soon as there is one, framed like StreamAPI does
+    const char *stream = u_map_get(req->map_url, "stream");
+    if (stream && strcmp(stream, "true") == 0) {
+        FromRadioStream *s = new FromRadioStream();
+        s->api = static_cast<HttpAPI *>(user_data);
+        s->id = s->api->startStream();
+        ulfius_add_header_to_response(res, "Cache-Control", "no-cache");
+        if (ulfius_set_stream_response(res, 200, callback_fromradio_stream, callback_fromradio_stream_free,
+                                       U_STREAM_SIZE_UNKNOWN, MAX_STREAM_BUF_SIZE, s) != U_OK) {
+            LOG_ERROR("handleAPIv1FromRadio - Error ulfius_set_stream_response");
+            delete s;
+            ulfius_set_string_body_response(res, 500, "Can't stream");
+        }
+        return U_CALLBACK_COMPLETE;
+    }
+
     uint8_t txBuf[MAX_STREAM_BUF_SIZE];
     uint32_t len = 1;
 
@@ -302,6 +551,166 @@ int handleAPIv1FromRadio(const struct _u_request *req, struct _u_response *res,
     return U_CALLBACK_COMPLETE;
 }
 
+/*
+ * Snapshot of the radio event trace, decode it with bin/radio-trace-decode.py
+ */
+int handleAPIv1RadioTrace(const struct _u_request *req, struct _u_response *res, void *user_data)
+{
+    std::vector<uint8_t> buf(RadioTrace::exportSize());
+    size_t len = radioTrace.exportTo(buf.data(), buf.size());
+
+    ulfius_add_header_to_response(res, "Content-Type", "application/octet-stream");
+    ulfius_add_header_to_response(res, "Content-Disposition", "attachment; filename=\"radiotrace.bin\"");
+    ulfius_set_binary_body_response(res, 200, (const char *)buf.data(), len);
+    return U_CALLBACK_COMPLETE;
+}
+
+/*
+ * Runtime and wakeups of every OSThread, busiest first, ?reset=true starts counting from zero afterwards
+ */
+int handleJsonThreads(const struct _u_request *req, struct _u_response *res, void *user_data)
+{
+    struct ThreadSnapshot {
+        std::string name;
+        bool enabled;
+        concurrency::OSThreadStats stats;
+    };
+    std::vector<ThreadSnapshot> threads;
+    uint32_t statsMs = 0;
+    const char *reset = u_map_get(req->map_url, "reset");
+    bool doReset = reset && strcmp(reset, "true") == 0;
+
+    // The main loop writes the stats as its threads run, copy and reset them between two of its passes
+    bool copied = piwebServerThread->mainLoop.call([&]() {
+        statsMs = concurrency::mainController.getStatsMs();
+        for (auto t : concurrency::mainController.getThreadsByRuntime())
+            threads.push_back({t->ThreadName.c_str(), t->enabled, t->getStats()});
+        if (doReset)
+            concurrency::mainController.resetStats();
+    });
+    if (!copied) {
+        ulfius_set_string_body_response(res, 503, "Main loop busy");
+        return U_CALLBACK_COMPLETE;
+    }
+
+    JSONArray threadsArray;
+    for (auto &t : threads) {
+        const concurrency::OSThreadStats &s = t.stats;
+        JSONObject jsonObjThread;
+        jsonObjThread["name"] = new JSONValue(t.name.c_str());
+        jsonObjThread["enabled"] = new JSONValue(t.enabled);
+        jsonObjThread["runs"] = new JSONValue((unsigned int)s.runs);
+        jsonObjThread["total_ms"] = new JSONValue((double)(s.totalUs / 1000));
+        jsonObjThread["max_us"] = new JSONValue((unsigned int)s.maxUs);
+        jsonObjThread["avg_late_ms"] = new JSONValue((unsigned int)(s.runs ? s.totalLateMs / s.runs : 0));
+        jsonObjThread["max_late_ms"] = new JSONValue((unsigned int)s.maxLateMs);
+        jsonObjThread["wakeups"] = new JSONValue((unsigned int)s.wakeups);
+        jsonObjThread["wakeups_per_hour"] = new JSONValue(statsMs ? (double)s.wakeups * 3600000 / statsMs : 0.0);
+        threadsArray.push_back(new JSONValue(jsonObjThread));
+    }
+
+    JSONObject jsonObjOuter;
+    jsonObjOuter["data"] = new JSONValue(threadsArray);
+    jsonObjOuter["uptime_ms"] = new JSONValue((double)millis());
+    jsonObjOuter["stats_ms"] = new JSONValue((double)statsMs);
+    jsonObjOuter["status"] = new JSONValue("ok");
+    JSONValue *value = new JSONValue(jsonObjOuter);
+    std::string json = value->Stringify();
+    delete value;
+
+    ulfius_add_header_to_response(res, "Content-Type", "application/json");
+    ulfius_add_header_to_response(res, "Access-Control-Allow-Origin", "*");
+    ulfius_set_string_body_response(res, 200, json.c_str());
+    return U_CALLBACK_COMPLETE;
+}
+
+/// Collects what NodeListJson writes until the connection takes it
+class StringPrint : public Print
+{
+  public:
+    std::string out;
+    virtual size_t write(uint8_t c) override
+    {
+        out += (char)c;
+        return 1;
+    }
+    virtual size_t write(const uint8_t *buf, size_t len) override
+    {
+        out.append((const char *)buf, len);
+        return len;
+    }
+};
+
+/// One /json/nodes response on its way out
+struct NodesStream {
+    NodeListJson list;
+    StringPrint pending;
+    size_t pendingPos = 0;
+    bool complete = false;
+
+    NodesStream(const NodeListJson::Query &query) : list(nodeDB->meshNodes->data(), nodeDB->getNumMeshNodes(), query) {}
+};
+
+static ssize_t callback_nodes_stream(void *cls, uint64_t pos, char *buf, size_t max)
+{
+    (void)(pos);
+    NodesStream *s = (NodesStream *)cls;
+    if (s->pendingPos == s->pending.out.size()) {
+        s->pending.out.clear();
+        s->pendingPos = 0;
+        // NodeDB only changes on the main loop, so that is where the nodes of the next chunk get written
+        bool called = piwebServerThread->mainLoop.call([s, max]() {
+            while (!s->complete && s->pending.out.size() < max)
+                s->complete = !s->list.writeNext(s->pending, nodeDB->meshNodes->data(), nodeDB->getNumMeshNodes());
+        });
+        if (!called)
+            return U_STREAM_ERROR;
+        if (s->pending.out.empty())
+            return U_STREAM_END;
+    }
+    size_t n = std::min(max, s->pending.out.size() - s->pendingPos);
+    memcpy(buf, s->pending.out.data() + s->pendingPos, n);
+    s->pendingPos += n;
+    return n;
+}
+
+static void callback_nodes_stream_free(void *cls)
+{
+    delete (NodesStream *)cls;
+}
+
+/*
+ * The nodes we know, a node at a time as the connection takes them, see NodeListJson for the parameters
+ */
+int handleJsonNodes(const struct _u_request *req, struct _u_response *res, void *user_data)
+{
+    NodeListJson::Query query;
+    const char *value;
+    if ((value = u_map_get(req->map_url, "cursor")) != NULL)
+        query.cursor = strtoul(value, NULL, 0);
+    if ((value = u_map_get(req->map_url, "limit")) != NULL)
+        query.limit = strtoul(value, NULL, 10);
+    if ((value = u_map_get(req->map_url, "since_last_heard")) != NULL)
+        query.sinceLastHeard = strtoul(value, NULL, 10);
+    if ((value = u_map_get(req->map_url, "fields")) != NULL)
+        query.fields = NodeListJson::parseFields(value);
+
+    ulfius_add_header_to_response(res, "Content-Type", "application/json");
+    ulfius_add_header_to_response(res, "Access-Control-Allow-Origin", "*");
+    NodesStream *s = NULL;
+    if (!piwebServerThread->mainLoop.call([&]() { s = new NodesStream(query); })) {
+        ulfius_set_string_body_response(res, 503, "Main loop busy");
+        return U_CALLBACK_COMPLETE;
+    }
+    if (ulfius_set_stream_response(res, 200, callback_nodes_stream, callback_nodes_stream_free, U_STREAM_SIZE_UNKNOWN,
+                                   STATIC_FILE_CHUNK, s) != U_OK) {
+        LOG_ERROR("handleJsonNodes - Error ulfius_set_stream_response");
+        delete s;
+        ulfius_set_string_body_response(res, 500, "Can't stream");
+    }
+    return U_CALLBACK_COMPLETE;
+}
+
 /*
 OpenSSL RSA Key Gen
 */
@@ -503,6 +912,9 @@ PiWebServerThread::PiWebServerThread()
         ulfius_add_endpoint_by_val(&instanceWeb, "OPTIONS", PREFIX, "/api/v1/fromradio/*", 1, &handleAPIv1FromRadio, &webAPI);
         ulfius_add_endpoint_by_val(&instanceWeb, "PUT", PREFIX, "/api/v1/toradio/*", 1, &handleAPIv1ToRadio, &webAPI);
         ulfius_add_endpoint_by_val(&instanceWeb, "OPTIONS", PREFIX, "/api/v1/toradio/*", 1, &handleAPIv1ToRadio, &webAPI);
+        ulfius_add_endpoint_by_val(&instanceWeb, "GET", PREFIX, "/api/v1/radiotrace", 1, &handleAPIv1RadioTrace, NULL);
+        ulfius_add_endpoint_by_val(&instanceWeb, "GET", PREFIX, "/json/threads", 1, &handleJsonThreads, NULL);
+        ulfius_add_endpoint_by_val(&instanceWeb, "GET", PREFIX, "/json/nodes", 1, &handleJsonNodes, NULL);
 
         // Add callback function to all endpoints for the Web Server
         ulfius_add_endpoint_by_val(&instanceWeb, "GET", NULL, "/*", 2, &callback_static_file, &configWeb);
@@ -526,6 +938,8 @@ PiWebServerThread::~PiWebServerThread()
 {
     u_map_clean(&configWeb.mime_types);
 
+    webAPI.startStream(); // ends the open FromRadio stream, rather than waiting for its keepalive
+
     ulfius_stop_framework(&instanceWeb);
     ulfius_clean_instance(&instanceWeb);
     free(configWeb.rootPath);
@@ -2,18 +2,67 @@
 #ifdef PORTDUINO_LINUX_HARDWARE
 #if __has_include(<ulfius.h>)
 #include "PhoneAPI.h"
+#include "concurrency/OSThread.h"
 #include "ulfius-cfg.h"
 #include "ulfius.h"
 #include <Arduino.h>
+#include <condition_variable>
+#include <deque>
 #include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <sys/stat.h>
+#include <unordered_map>
 
-#define STATIC_FILE_CHUNK 256
+/// Block size for static files too big to cache, streamed from disk
+#define STATIC_FILE_CHUNK 65536
+
+/// Static files up to this size are served from memory, least recently used go first once they add up to STATIC_CACHE_BYTES
+#define STATIC_CACHE_MAX_FILE (1024 * 1024)
+#define STATIC_CACHE_BYTES (16 * 1024 * 1024)
+
+/// Everything but .html pages, those are revalidated every time
+#define STATIC_CACHE_CONTROL "public, max-age=86400"
+
+/// An idle /api/v1/fromradio?stream=true gets an empty frame this often, so proxies and clients know it is still alive
+#define FROMRADIO_STREAM_KEEPALIVE_MS 15000
+
+/// How long a web server thread waits for the main loop to run its call
+#define MAIN_LOOP_CALL_TIMEOUT_MS 5000
 
 void initWebServer();
 void createSSLCert();
 int callback_static_file(const struct _u_request *request, struct _u_response *response, void *user_data);
 const char *get_filename_ext(const char *path);
 
+/// A static file as it was read from disk, shared with the responses still using it
+struct StaticFile {
+    std::string data;
+    time_t mtime;
+    off_t size;
+};
+
+/// A precompressed copy of a static file, next to it with suffix appended
+struct StaticVariant {
+    const char *suffix;
+    const char *encoding; // for Content-Encoding, NULL for the file itself
+};
+
+class StaticFileCache
+{
+  public:
+    /// @return the file at path, read again only if st says it changed, NULL if it can't be read
+    std::shared_ptr<const StaticFile> get(const std::string &path, const struct stat &st);
+
+  private:
+    std::mutex lock;
+    std::list<std::pair<std::string, std::shared_ptr<const StaticFile>>> lru; // most recently used first
+    std::unordered_map<std::string, decltype(lru)::iterator> index;
+    size_t bytes = 0;
+};
+
 struct _file_config {
     char *files_path;
     char *url_prefix;
@@ -27,14 +76,63 @@ class HttpAPI : public PhoneAPI
 {
 
   public:
-    // Nothing here yet
+    /// Wakes the stream too, the reply (or the config a client asked for) is ready right away
+    virtual bool handleToRadio(const uint8_t *buf, size_t len) override;
+
+    /// Start streaming FromRadio to a new client, any stream that was already open ends
+    uint32_t startStream();
+
+    /// @return false once a newer stream has taken over from this one
+    bool isCurrentStream(uint32_t stream);
+
+    /// @return a token for waitForData(), take it before checking for data so no wakeup is missed
+    uint32_t dataSeq();
+
+    /**
+     * Block the calling web server thread until there may be new data since seq, or timeoutMs passes
+     * @return false on timeout
+     */
+    bool waitForData(uint32_t &seq, uint32_t timeoutMs);
 
   private:
-    // Nothing here yet
+    std::mutex dataLock;
+    std::condition_variable dataReady;
+    uint32_t wakeups = 0;
+    uint32_t currentStream = 0;
+
+    void wake();
 
   protected:
     /// Check the current underlying physical link to see if the client is currently connected
     virtual bool checkIsConnected() override { return true; } // FIXME, be smarter about this
+
+    /// Called from the main thread, wakes the stream
+    virtual void onNowHasData(uint32_t fromRadioNum) override;
+};
+
+/**
+ * Runs a function on the main loop for a web server thread, and waits for it.  NodeDB, PhoneAPI and the thread stats are
+ * only changed by the main loop, so that is where a connection thread can read them without catching them half updated.
+ */
+class MainLoopCalls : private concurrency::OSThread
+{
+  public:
+    MainLoopCalls() : concurrency::OSThread("WebMainLoop") {}
+
+    /** @return false if the main loop didn't get to fn within timeoutMs, it won't run then */
+    bool call(const std::function<void()> &fn, uint32_t timeoutMs = MAIN_LOOP_CALL_TIMEOUT_MS);
+
+  protected:
+    virtual int32_t runOnce() override;
+
+  private:
+    struct Call {
+        const std::function<void()> *fn;
+        bool done;
+    };
+    std::mutex lock; // held while a call runs, so a caller that times out never leaves one running on its stack
+    std::condition_variable callDone;
+    std::deque<Call *> calls;
 };
 
 class PiWebServerThread
@@ -53,6 +151,7 @@ class PiWebServerThread
     int CheckSSLandLoad();
     uint32_t requestRestart = 0;
     struct _u_instance instanceWeb;
+    MainLoopCalls mainLoop;
 };
 
 extern PiWebServerThread *piwebServerThread;
@@ -471,7 +471,7 @@ void AdminModule::handleSetConfig(const meshtastic_Config &c)
         if (config.device.double_tap_as_button_press == false && c.payload_variant.device.double_tap_as_button_press == true &&
             accelerometerThread->enabled == false) {
             config.device.double_tap_as_button_press = c.payload_variant.device.double_tap_as_button_press;
-            accelerometerThread->enabled = true;
+            accelerometerThread->enable();
             accelerometerThread->start();
         }
 #endif
@@ -565,7 +565,7 @@ void AdminModule::handleSetConfig(const meshtastic_Config &c)
         if (config.display.wake_on_tap_or_motion == false && c.payload_variant.display.wake_on_tap_or_motion == true &&
             accelerometerThread->enabled == false) {
             config.display.wake_on_tap_or_motion = c.payload_variant.display.wake_on_tap_or_motion;
-            accelerometerThread->enabled = true;
+            accelerometerThread->enable();
             accelerometerThread->start();
         }
 #endif
@@ -39,6 +39,9 @@
 #endif
 #include "modules/RoutingModule.h"
 #include "modules/TextMessageModule.h"
+#if !MESHTASTIC_EXCLUDE_THREAD_STATS
+#include "modules/ThreadStatsModule.h"
+#endif
 #if !MESHTASTIC_EXCLUDE_TRACEROUTE
 #include "modules/TraceRouteModule.h"
 #endif
@@ -63,6 +66,9 @@
 #if HAS_TELEMETRY && !MESHTASTIC_EXCLUDE_POWER_TELEMETRY
 #include "modules/Telemetry/PowerTelemetry.h"
 #endif
+#if HAS_TELEMETRY && !MESHTASTIC_EXCLUDE_TELEMETRY_HISTORY
+#include "modules/Telemetry/TelemetryHistoryModule.h"
+#endif
 #ifdef ARCH_ESP32
 #if defined(USE_SX1280) && !MESHTASTIC_EXCLUDE_AUDIO
 #include "modules/esp32/AudioModule.h"
@@ -205,6 +211,9 @@ void setupModules()
 #if HAS_TELEMETRY && !MESHTASTIC_EXCLUDE_POWER_TELEMETRY && !MESHTASTIC_EXCLUDE_ENVIRONMENTAL_SENSOR
         new PowerTelemetryModule();
 #endif
+#if HAS_TELEMETRY && !MESHTASTIC_EXCLUDE_TELEMETRY_HISTORY
+        telemetryHistoryModule = new TelemetryHistoryModule();
+#endif
 #if (defined(ARCH_ESP32) || defined(ARCH_NRF52) || defined(ARCH_RP2040)) && !defined(CONFIG_IDF_TARGET_ESP32S2) &&               \
     !defined(CONFIG_IDF_TARGET_ESP32C3)
 #if !MESHTASTIC_EXCLUDE_SERIAL
@@ -244,6 +253,10 @@ void setupModules()
         traceRouteModule = new TraceRouteModule();
 #endif
     }
+#if !MESHTASTIC_EXCLUDE_THREAD_STATS
+    // Repeaters too, they are the ones we can't watch
+    new ThreadStatsModule();
+#endif
     // NOTE! This module must be added LAST because it likes to check for replies from other modules and avoid sending extra
     // acks
     routingModule = new RoutingModule();
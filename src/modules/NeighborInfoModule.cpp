@@ -3,6 +3,7 @@
 #include "MeshService.h"
 #include "NodeDB.h"
 #include "RTC.h"
+#include "Router.h"
 #include <Throttle.h>
 
 NeighborInfoModule *neighborInfoModule;
@@ -70,7 +71,9 @@ uint32_t NeighborInfoModule::collectNeighborInfo(meshtastic_NeighborInfo *neighb
     for (auto nbr : neighbors) {
         if ((neighborInfo->neighbors_count < MAX_NUM_NEIGHBORS) && (nbr.node_id != my_node_id)) {
             neighborInfo->neighbors[neighborInfo->neighbors_count].node_id = nbr.node_id;
-            neighborInfo->neighbors[neighborInfo->neighbors_count].snr = nbr.snr;
+            // Prefer the smoothed SNR from the router's link table over the SNR of the last packet we happened to hear
+            const LinkStats *link = router ? router->getLinkTable().get(nbr.node_id) : NULL;
+            neighborInfo->neighbors[neighborInfo->neighbors_count].snr = link ? link->getSnr() : nbr.snr;
             // Note: we don't set the last_rx_time and node_broadcast_intervals_secs here, because we don't want to send this over
             // the mesh
             neighborInfo->neighbors_count++;
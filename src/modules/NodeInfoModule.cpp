@@ -37,7 +37,7 @@ void NodeInfoModule::sendOurNodeInfo(NodeNum dest, bool wantReplies, uint8_t cha
 {
     // cancel any not yet sent (now stale) position packets
     if (prevPacketId) // if we wrap around to zero, we'll simply fail to cancel in that rare case (no big deal)
-        service->cancelSending(prevPacketId);
+        service->cancelSending(prevPacketId, RADIO_TRACE_CANCEL_SUPERSEDED);
     shorterTimeout = _shorterTimeout;
     meshtastic_MeshPacket *p = allocReply();
     if (p) { // Check whether we didn't ignore it
@@ -100,17 +100,35 @@ NodeInfoModule::NodeInfoModule()
 
     setIntervalFromNow(setStartDelay()); // Send our initial owner announcement 30 seconds
                                          // after we start (to give network time to setup)
+    txBatchObserver.observe(&txBatch.batchOpened);
+}
+
+// Not before the first broadcast, that one waits for the network to settle
+int NodeInfoModule::onTxBatch(uint32_t holdMs)
+{
+    if (lastBroadcast)
+        wake();
+    return 0;
 }
 
 int32_t NodeInfoModule::runOnce()
 {
+    uint32_t intervalMs =
+        Default::getConfiguredOrDefaultMs(config.device.node_info_broadcast_secs, default_node_info_broadcast_secs);
+
     // If we changed channels, ask everyone else for their latest info
     bool requestReplies = currentGeneration != radioGeneration;
+
+    // Woken for a batch that isn't ours to join yet
+    uint32_t sinceLast = millis() - lastBroadcast;
+    if (!requestReplies && lastBroadcast && !txBatch.isDue(sinceLast, intervalMs))
+        return intervalMs - sinceLast;
     currentGeneration = radioGeneration;
+    lastBroadcast = millis();
 
     if (airTime->isTxAllowedAirUtil() && config.device.role != meshtastic_Config_DeviceConfig_Role_CLIENT_HIDDEN) {
         LOG_INFO("Send our nodeinfo to mesh (wantReplies=%d)", requestReplies);
         sendOurNodeInfo(NODENUM_BROADCAST, requestReplies); // Send our info (don't request replies)
     }
-    return Default::getConfiguredOrDefaultMs(config.device.node_info_broadcast_secs, default_node_info_broadcast_secs);
+    return intervalMs;
 }
\ No newline at end of file
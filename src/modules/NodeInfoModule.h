@@ -1,5 +1,6 @@
 #pragma once
 #include "ProtobufModule.h"
+#include "TxBatch.h"
 
 /**
  * NodeInfo module for sending/receiving NodeInfos into the mesh
@@ -11,6 +12,9 @@ class NodeInfoModule : public ProtobufModule<meshtastic_User>, private concurren
 
     uint32_t currentGeneration = 0;
 
+    CallbackObserver<NodeInfoModule, uint32_t> txBatchObserver =
+        CallbackObserver<NodeInfoModule, uint32_t>(this, &NodeInfoModule::onTxBatch);
+
   public:
     /** Constructor
      * name is for debugging output
@@ -39,7 +43,10 @@ class NodeInfoModule : public ProtobufModule<meshtastic_User>, private concurren
 
   private:
     uint32_t lastSentToMesh = 0; // Last time we sent our NodeInfo to the mesh
+    uint32_t lastBroadcast = 0;  // Last periodic broadcast
     bool shorterTimeout = false;
+
+    int onTxBatch(uint32_t holdMs);
 };
 
 extern NodeInfoModule *nodeInfoModule;
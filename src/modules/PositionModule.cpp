@@ -26,6 +26,7 @@ PositionModule::PositionModule()
     precision = 0;        // safe starting value
     isPromiscuous = true; // We always want to update our nodedb, even if we are sniffing on others
     nodeStatusObserver.observe(&nodeStatus->onNewStatus);
+    txBatchObserver.observe(&txBatch.batchOpened);
 
     if (config.device.role != meshtastic_Config_DeviceConfig_Role_TRACKER &&
         config.device.role != meshtastic_Config_DeviceConfig_Role_TAK_TRACKER) {
@@ -335,7 +336,7 @@ void PositionModule::sendOurPosition(NodeNum dest, bool wantReplies, uint8_t cha
 {
     // cancel any not yet sent (now stale) position packets
     if (prevPacketId) // if we wrap around to zero, we'll simply fail to cancel in that rare case (no big deal)
-        service->cancelSending(prevPacketId);
+        service->cancelSending(prevPacketId, RADIO_TRACE_CANCEL_SUPERSEDED);
 
     // Set's the class precision value for this particular packet
     if (channels.getByIndex(channel).settings.has_module_settings) {
@@ -378,6 +379,14 @@ void PositionModule::sendOurPosition(NodeNum dest, bool wantReplies, uint8_t cha
 
 #define RUNONCE_INTERVAL 5000;
 
+// Check early whether our position can go out with the batch
+int PositionModule::onTxBatch(uint32_t holdMs)
+{
+    if (lastGpsSend)
+        wake();
+    return 0;
+}
+
 int32_t PositionModule::runOnce()
 {
     if (sleepOnNextExecution == true) {
@@ -402,7 +411,7 @@ int32_t PositionModule::runOnce()
         return RUNONCE_INTERVAL;
     }
 
-    if (lastGpsSend == 0 || msSinceLastSend >= intervalMs) {
+    if (lastGpsSend == 0 || txBatch.isDue(msSinceLastSend, intervalMs)) {
         if (nodeDB->hasValidPosition(node)) {
             lastGpsSend = now;
 
@@ -465,8 +474,8 @@ struct SmartPosition PositionModule::getDistanceTraveledSinceLastSend(meshtastic
         Default::getConfiguredOrDefault(config.position.broadcast_smart_minimum_distance, 100);
 
     // Determine the distance in meters between two points on the globe
-    float distanceTraveledSinceLastSend = GeoCoord::latLongToMeter(
-        lastGpsLatitude * 1e-7, lastGpsLongitude * 1e-7, currentPosition.latitude_i * 1e-7, currentPosition.longitude_i * 1e-7);
+    float distanceTraveledSinceLastSend = GeoCoord::latLongToMeterFast(lastGpsLatitude, lastGpsLongitude,
+                                                                       currentPosition.latitude_i, currentPosition.longitude_i);
 
     return SmartPosition{.distanceTraveled = abs(distanceTraveledSinceLastSend),
                          .distanceThreshold = distanceTravelThreshold,
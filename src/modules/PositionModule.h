@@ -1,6 +1,7 @@
 #pragma once
 #include "Default.h"
 #include "ProtobufModule.h"
+#include "TxBatch.h"
 #include "concurrency/OSThread.h"
 
 /**
@@ -10,6 +11,8 @@ class PositionModule : public ProtobufModule<meshtastic_Position>, private concu
 {
     CallbackObserver<PositionModule, const meshtastic::Status *> nodeStatusObserver =
         CallbackObserver<PositionModule, const meshtastic::Status *>(this, &PositionModule::handleStatusUpdate);
+    CallbackObserver<PositionModule, uint32_t> txBatchObserver =
+        CallbackObserver<PositionModule, uint32_t>(this, &PositionModule::onTxBatch);
 
     /// The id of the last packet we sent, to allow us to cancel it if we make something fresher
     PacketId prevPacketId = 0;
@@ -63,6 +66,7 @@ class PositionModule : public ProtobufModule<meshtastic_Position>, private concu
     void sendLostAndFoundText();
     bool hasQualityTimesource();
     bool hasGPS();
+    int onTxBatch(uint32_t holdMs);
     uint32_t lastSentToMesh = 0; // Last time we sent our position to the mesh
 
     const uint32_t minimumTimeThreshold =
@@ -0,0 +1,23 @@
+#pragma once
+
+#include "mesh/generated/meshtastic/portnums.pb.h"
+
+/*
+ * Ports of firmware modules that don't have a PortNum in the protobufs yet.
+ *
+ * They are taken from the private app range (PRIVATE_APP = 256 up to MAX = 511), which is also where users put their own
+ * apps.  A private app on the same number would get our payloads, and we would try to decode theirs: both modules below
+ * drop payloads that don't parse as theirs, but the app might not.  If your mesh already uses one of these numbers, build
+ * with a different one (e.g. -DTELEMETRY_HISTORY_PORTNUM=400), the same on all nodes that should talk to each other.
+ * Move a module to a real PortNum once one is assigned.
+ */
+
+/// Telemetry history batches and requests, see TelemetryHistoryModule
+#ifndef TELEMETRY_HISTORY_PORTNUM
+#define TELEMETRY_HISTORY_PORTNUM ((meshtastic_PortNum)300)
+#endif
+
+/// Thread stats requests and reports, see ThreadStatsModule
+#ifndef THREAD_STATS_PORTNUM
+#define THREAD_STATS_PORTNUM ((meshtastic_PortNum)301)
+#endif
@@ -120,7 +120,7 @@ bool RemoteHardwareModule::handleReceivedProtobuf(const meshtastic_MeshPacket &r
             lastWatchMsec = 0; // Force a new publish soon
             previousWatch =
                 ~watchGpios;   // generate a 'previous' value which is guaranteed to not match (to force an initial publish)
-            enabled = true;    // Let our thread run at least once
+            enable();          // Let our thread run at least once
             setInterval(2000); // Set a new interval so we'll run soon
             LOG_INFO("Now watching GPIOs 0x%llx", watchGpios);
             break;
@@ -7,6 +7,7 @@
 #include "RTC.h"
 #include "RadioLibInterface.h"
 #include "Router.h"
+#include "TelemetryHistoryModule.h"
 #include "configuration.h"
 #include "main.h"
 #include <OLEDDisplay.h>
@@ -18,18 +19,20 @@
 int32_t DeviceTelemetryModule::runOnce()
 {
     refreshUptime();
+    bool batchOnly = wokenForBatch;
+    wokenForBatch = false;
     bool isImpoliteRole =
         IS_ONE_OF(config.device.role, meshtastic_Config_DeviceConfig_Role_SENSOR, meshtastic_Config_DeviceConfig_Role_ROUTER);
     if (((lastSentToMesh == 0) ||
-         ((uptimeLastMs - lastSentToMesh) >=
-          Default::getConfiguredOrDefaultMsScaled(moduleConfig.telemetry.device_update_interval,
-                                                  default_telemetry_broadcast_interval_secs, numOnlineNodes))) &&
+         txBatch.isDue(uptimeLastMs - lastSentToMesh,
+                       Default::getConfiguredOrDefaultMsScaled(moduleConfig.telemetry.device_update_interval,
+                                                               default_telemetry_broadcast_interval_secs, numOnlineNodes))) &&
         airTime->isTxAllowedChannelUtil(!isImpoliteRole) && airTime->isTxAllowedAirUtil() &&
         config.device.role != meshtastic_Config_DeviceConfig_Role_REPEATER &&
         config.device.role != meshtastic_Config_DeviceConfig_Role_CLIENT_HIDDEN) {
         sendTelemetry();
         lastSentToMesh = uptimeLastMs;
-    } else if (service->isToPhoneQueueEmpty()) {
+    } else if (!batchOnly && service->isToPhoneQueueEmpty()) {
         // Just send to phone when it's not our time to send to mesh yet
         // Only send while queue is empty (phone assumed connected)
         sendTelemetry(NODENUM_BROADCAST, true);
@@ -38,6 +41,12 @@ int32_t DeviceTelemetryModule::runOnce()
             lastSentStatsToPhone = uptimeLastMs;
         }
     }
+    if (batchOnly) {
+        // Woken early for a batch, the phone still gets its update when it was going to
+        uint32_t sinceLastRun = uptimeLastMs - lastRunForPhone;
+        return sinceLastRun < sendToPhoneIntervalMs ? sendToPhoneIntervalMs - sinceLastRun : 0;
+    }
+    lastRunForPhone = uptimeLastMs;
     return sendToPhoneIntervalMs;
 }
 
@@ -172,12 +181,17 @@ bool DeviceTelemetryModule::sendTelemetry(NodeNum dest, bool phoneOnly)
              telemetry.variant.device_metrics.battery_level, telemetry.variant.device_metrics.voltage,
              telemetry.variant.device_metrics.uptime_seconds);
 
+    nodeDB->updateTelemetry(nodeDB->getNodeNum(), telemetry, RX_SRC_LOCAL);
+#if !MESHTASTIC_EXCLUDE_TELEMETRY_HISTORY
+    if (TelemetryHistoryModule::record(telemetry, phoneOnly))
+        return true;
+#endif
+
     meshtastic_MeshPacket *p = allocDataProtobuf(telemetry);
     p->to = dest;
     p->decoded.want_response = false;
     p->priority = meshtastic_MeshPacket_Priority_BACKGROUND;
 
-    nodeDB->updateTelemetry(nodeDB->getNodeNum(), telemetry, RX_SRC_LOCAL);
     if (phoneOnly) {
         LOG_INFO("Send packet to phone");
         service->sendToPhone(p);
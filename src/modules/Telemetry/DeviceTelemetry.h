@@ -2,6 +2,7 @@
 #include "../mesh/generated/meshtastic/telemetry.pb.h"
 #include "NodeDB.h"
 #include "ProtobufModule.h"
+#include "TxBatch.h"
 #include <OLEDDisplay.h>
 #include <OLEDDisplayUi.h>
 
@@ -9,6 +10,8 @@ class DeviceTelemetryModule : private concurrency::OSThread, public ProtobufModu
 {
     CallbackObserver<DeviceTelemetryModule, const meshtastic::Status *> nodeStatusObserver =
         CallbackObserver<DeviceTelemetryModule, const meshtastic::Status *>(this, &DeviceTelemetryModule::handleStatusUpdate);
+    CallbackObserver<DeviceTelemetryModule, uint32_t> txBatchObserver =
+        CallbackObserver<DeviceTelemetryModule, uint32_t>(this, &DeviceTelemetryModule::onTxBatch);
 
   public:
     DeviceTelemetryModule()
@@ -18,6 +21,7 @@ class DeviceTelemetryModule : private concurrency::OSThread, public ProtobufModu
         uptimeWrapCount = 0;
         uptimeLastMs = millis();
         nodeStatusObserver.observe(&nodeStatus->onNewStatus);
+        txBatchObserver.observe(&txBatch.batchOpened);
         setIntervalFromNow(setStartDelay()); // Wait until NodeInfo is sent
     }
     virtual bool wantUIFrame() { return false; }
@@ -45,10 +49,23 @@ class DeviceTelemetryModule : private concurrency::OSThread, public ProtobufModu
     meshtastic_Telemetry getLocalStatsTelemetry();
 
     void sendLocalStatsToPhone();
+
+    // runOnce() decides if our telemetry is due soon enough to join the batch, the phone keeps its own schedule
+    int onTxBatch(uint32_t holdMs)
+    {
+        if (lastSentToMesh) {
+            wokenForBatch = true;
+            wake();
+        }
+        return 0;
+    }
+
     uint32_t sendToPhoneIntervalMs = SECONDS_IN_MINUTE * 1000;           // Send to phone every minute
     uint32_t sendStatsToPhoneIntervalMs = 15 * SECONDS_IN_MINUTE * 1000; // Send stats to phone every 15 minutes
     uint32_t lastSentStatsToPhone = 0;
     uint32_t lastSentToMesh = 0;
+    uint32_t lastRunForPhone = 0;
+    bool wokenForBatch = false;
 
     void refreshUptime()
     {
@@ -10,6 +10,7 @@
 #include "PowerFSM.h"
 #include "RTC.h"
 #include "Router.h"
+#include "TelemetryHistoryModule.h"
 #include "UnitConversions.h"
 #include "main.h"
 #include "power.h"
@@ -70,6 +71,7 @@ T1000xSensor t1000xSensor;
 #include "Sensor/IndicatorSensor.h"
 IndicatorSensor indicatorSensor;
 #endif
+#include "Sensor/TelemetrySampler.h"
 #define FAILED_STATE_SENSOR_READ_MULTIPLIER 10
 #define DISPLAY_RECEIVEID_MEASUREMENTS_ON_SCREEN true
 
@@ -183,20 +185,32 @@ int32_t EnvironmentTelemetryModule::runOnce()
 #endif
         }
 
-        if (((lastSentToMesh == 0) ||
-             !Throttle::isWithinTimespanMs(lastSentToMesh, Default::getConfiguredOrDefaultMsScaled(
-                                                               moduleConfig.telemetry.environment_update_interval,
-                                                               default_telemetry_broadcast_interval_secs, numOnlineNodes))) &&
-            airTime->isTxAllowedChannelUtil(config.device.role != meshtastic_Config_DeviceConfig_Role_SENSOR) &&
-            airTime->isTxAllowedAirUtil()) {
-            sendTelemetry();
+        if (sampler.isBusy()) {
+            // Collect whatever finished converting, and come back when the next sensor should be ready
+            int32_t wait = sampler.step();
+            if (sampler.isBusy())
+                return min(result, (uint32_t)wait);
+            if (sampler.isValid()) {
+                sendMeasurement(sample, NODENUM_BROADCAST, samplePhoneOnly);
+                lastSample = sample;
+                hasLastSample = true;
+            }
+        } else if (((lastSentToMesh == 0) ||
+                    !Throttle::isWithinTimespanMs(lastSentToMesh, Default::getConfiguredOrDefaultMsScaled(
+                                                                      moduleConfig.telemetry.environment_update_interval,
+                                                                      default_telemetry_broadcast_interval_secs, numOnlineNodes))) &&
+                   airTime->isTxAllowedChannelUtil(config.device.role != meshtastic_Config_DeviceConfig_Role_SENSOR) &&
+                   airTime->isTxAllowedAirUtil()) {
+            startSample(false);
             lastSentToMesh = millis();
+            return 0;
         } else if (((lastSentToPhone == 0) || !Throttle::isWithinTimespanMs(lastSentToPhone, sendToPhoneIntervalMs)) &&
                    (service->isToPhoneQueueEmpty())) {
             // Just send to phone when it's not our time to send to mesh yet
             // Only send while queue is empty (phone assumed connected)
-            sendTelemetry(NODENUM_BROADCAST, true);
+            startSample(true);
             lastSentToPhone = millis();
+            return 0;
         }
     }
     return min(sendToPhoneIntervalMs, result);
@@ -358,140 +372,48 @@ bool EnvironmentTelemetryModule::handleReceivedProtobuf(const meshtastic_MeshPac
     return false; // Let others look at this message also if they want
 }
 
-bool EnvironmentTelemetryModule::getEnvironmentTelemetry(meshtastic_Telemetry *m)
+void EnvironmentTelemetryModule::addSensors(TelemetrySampler &s)
 {
-    bool valid = true;
-    bool hasSensor = false;
-    m->time = getTime();
-    m->which_variant = meshtastic_Telemetry_environment_metrics_tag;
-    m->variant.environment_metrics = meshtastic_EnvironmentMetrics_init_zero;
-
+    s.clear();
 #ifdef SENSECAP_INDICATOR
-    valid = valid && indicatorSensor.getMetrics(m);
-    hasSensor = true;
+    s.add(&indicatorSensor);
 #endif
 #ifdef T1000X_SENSOR_EN // add by WayenWeng
-    valid = valid && t1000xSensor.getMetrics(m);
-    hasSensor = true;
+    s.add(&t1000xSensor);
 #else
-    if (dfRobotLarkSensor.hasSensor()) {
-        valid = valid && dfRobotLarkSensor.getMetrics(m);
-        hasSensor = true;
-    }
-    if (dfRobotGravitySensor.hasSensor()) {
-        valid = valid && dfRobotGravitySensor.getMetrics(m);
-        hasSensor = true;
-    }
-    if (sht31Sensor.hasSensor()) {
-        valid = valid && sht31Sensor.getMetrics(m);
-        hasSensor = true;
-    }
-    if (sht4xSensor.hasSensor()) {
-        valid = valid && sht4xSensor.getMetrics(m);
-        hasSensor = true;
-    }
-    if (lps22hbSensor.hasSensor()) {
-        valid = valid && lps22hbSensor.getMetrics(m);
-        hasSensor = true;
-    }
-    if (shtc3Sensor.hasSensor()) {
-        valid = valid && shtc3Sensor.getMetrics(m);
-        hasSensor = true;
-    }
-    if (bmp085Sensor.hasSensor()) {
-        valid = valid && bmp085Sensor.getMetrics(m);
-        hasSensor = true;
-    }
-    if (bmp280Sensor.hasSensor()) {
-        valid = valid && bmp280Sensor.getMetrics(m);
-        hasSensor = true;
-    }
-    if (bme280Sensor.hasSensor()) {
-        valid = valid && bme280Sensor.getMetrics(m);
-        hasSensor = true;
-    }
-    if (bmp3xxSensor.hasSensor()) {
-        valid = valid && bmp3xxSensor.getMetrics(m);
-        hasSensor = true;
-    }
-    if (bme680Sensor.hasSensor()) {
-        valid = valid && bme680Sensor.getMetrics(m);
-        hasSensor = true;
-    }
-    if (mcp9808Sensor.hasSensor()) {
-        valid = valid && mcp9808Sensor.getMetrics(m);
-        hasSensor = true;
-    }
-    if (ina219Sensor.hasSensor()) {
-        valid = valid && ina219Sensor.getMetrics(m);
-        hasSensor = true;
-    }
-    if (ina260Sensor.hasSensor()) {
-        valid = valid && ina260Sensor.getMetrics(m);
-        hasSensor = true;
-    }
-    if (ina3221Sensor.hasSensor()) {
-        valid = valid && ina3221Sensor.getMetrics(m);
-        hasSensor = true;
-    }
-    if (veml7700Sensor.hasSensor()) {
-        valid = valid && veml7700Sensor.getMetrics(m);
-        hasSensor = true;
-    }
-    if (tsl2591Sensor.hasSensor()) {
-        valid = valid && tsl2591Sensor.getMetrics(m);
-        hasSensor = true;
-    }
-    if (opt3001Sensor.hasSensor()) {
-        valid = valid && opt3001Sensor.getMetrics(m);
-        hasSensor = true;
-    }
-    if (mlx90632Sensor.hasSensor()) {
-        valid = valid && mlx90632Sensor.getMetrics(m);
-        hasSensor = true;
-    }
-    if (rcwl9620Sensor.hasSensor()) {
-        valid = valid && rcwl9620Sensor.getMetrics(m);
-        hasSensor = true;
-    }
-    if (nau7802Sensor.hasSensor()) {
-        valid = valid && nau7802Sensor.getMetrics(m);
-        hasSensor = true;
+    TelemetrySensor *sensors[] = {&dfRobotLarkSensor, &dfRobotGravitySensor, &sht31Sensor,    &sht4xSensor,    &lps22hbSensor,
+                                  &shtc3Sensor,       &bmp085Sensor,         &bmp280Sensor,   &bme280Sensor,   &bmp3xxSensor,
+                                  &bme680Sensor,      &mcp9808Sensor,        &ina219Sensor,   &ina260Sensor,   &ina3221Sensor,
+                                  &veml7700Sensor,    &tsl2591Sensor,        &opt3001Sensor,  &mlx90632Sensor, &rcwl9620Sensor,
+                                  &nau7802Sensor};
+    for (TelemetrySensor *sensor : sensors) {
+        if (sensor->hasSensor())
+            s.add(sensor);
     }
     if (aht10Sensor.hasSensor()) {
-        if (!bmp280Sensor.hasSensor() && !bmp3xxSensor.hasSensor()) {
-            valid = valid && aht10Sensor.getMetrics(m);
-            hasSensor = true;
-        } else if (bmp280Sensor.hasSensor()) {
-            // prefer bmp280 temp if both sensors are present, fetch only humidity
-            meshtastic_Telemetry m_ahtx = meshtastic_Telemetry_init_zero;
-            LOG_INFO("AHTX0+BMP280 module detected: using temp from BMP280 and humy from AHTX0");
-            aht10Sensor.getMetrics(&m_ahtx);
-            m->variant.environment_metrics.relative_humidity = m_ahtx.variant.environment_metrics.relative_humidity;
-            m->variant.environment_metrics.has_relative_humidity = m_ahtx.variant.environment_metrics.has_relative_humidity;
-        } else {
-            // prefer bmp3xx temp if both sensors are present, fetch only humidity
-            meshtastic_Telemetry m_ahtx = meshtastic_Telemetry_init_zero;
-            LOG_INFO("AHTX0+BMP3XX module detected: using temp from BMP3XX and humy from AHTX0");
-            aht10Sensor.getMetrics(&m_ahtx);
-            m->variant.environment_metrics.relative_humidity = m_ahtx.variant.environment_metrics.relative_humidity;
-            m->variant.environment_metrics.has_relative_humidity = m_ahtx.variant.environment_metrics.has_relative_humidity;
-        }
-    }
-    if (max17048Sensor.hasSensor()) {
-        valid = valid && max17048Sensor.getMetrics(m);
-        hasSensor = true;
-    }
-    if (cgRadSens.hasSensor()) {
-        valid = valid && cgRadSens.getMetrics(m);
-        hasSensor = true;
+        // prefer bmp280/bmp3xx temp if both sensors are present, fetch only humidity
+        if (bmp280Sensor.hasSensor() || bmp3xxSensor.hasSensor())
+            s.add(&aht10Sensor, TelemetrySampler::SAMPLE_HUMIDITY_ONLY);
+        else
+            s.add(&aht10Sensor);
     }
+    if (max17048Sensor.hasSensor())
+        s.add(&max17048Sensor);
+    if (cgRadSens.hasSensor())
+        s.add(&cgRadSens);
 #ifdef HAS_RAKPROT
-    valid = valid && rak9154Sensor.getMetrics(m);
-    hasSensor = true;
+    s.add(&rak9154Sensor);
 #endif
 #endif
-    return valid && hasSensor;
+}
+
+bool EnvironmentTelemetryModule::getEnvironmentTelemetry(meshtastic_Telemetry *m)
+{
+    // Sampling right away would block the reply on the conversions, and could restart one the sampler is waiting for
+    if (!hasLastSample)
+        return false;
+    *m = lastSample; // keeps the time it was sent with
+    return true;
 }
 
 meshtastic_MeshPacket *EnvironmentTelemetryModule::allocReply()
@@ -525,55 +447,71 @@ meshtastic_MeshPacket *EnvironmentTelemetryModule::allocReply()
 bool EnvironmentTelemetryModule::sendTelemetry(NodeNum dest, bool phoneOnly)
 {
     meshtastic_Telemetry m = meshtastic_Telemetry_init_zero;
-    m.which_variant = meshtastic_Telemetry_environment_metrics_tag;
-    m.time = getTime();
-#ifdef T1000X_SENSOR_EN
-    if (t1000xSensor.getMetrics(&m)) {
-#else
-    if (getEnvironmentTelemetry(&m)) {
-#endif
-        LOG_INFO("Send: barometric_pressure=%f, current=%f, gas_resistance=%f, relative_humidity=%f, temperature=%f",
-                 m.variant.environment_metrics.barometric_pressure, m.variant.environment_metrics.current,
-                 m.variant.environment_metrics.gas_resistance, m.variant.environment_metrics.relative_humidity,
-                 m.variant.environment_metrics.temperature);
-        LOG_INFO("Send: voltage=%f, IAQ=%d, distance=%f, lux=%f", m.variant.environment_metrics.voltage,
-                 m.variant.environment_metrics.iaq, m.variant.environment_metrics.distance, m.variant.environment_metrics.lux);
+    return getEnvironmentTelemetry(&m) && sendMeasurement(m, dest, phoneOnly);
+}
 
-        LOG_INFO("Send: wind speed=%fm/s, direction=%d degrees, weight=%fkg", m.variant.environment_metrics.wind_speed,
-                 m.variant.environment_metrics.wind_direction, m.variant.environment_metrics.weight);
+void EnvironmentTelemetryModule::startSample(bool phoneOnly)
+{
+    sample = meshtastic_Telemetry_init_zero;
+    sample.which_variant = meshtastic_Telemetry_environment_metrics_tag;
+    samplePhoneOnly = phoneOnly;
+    addSensors(sampler);
+    sampler.start(&sample);
+}
 
-        LOG_INFO("Send: radiation=%fµR/h", m.variant.environment_metrics.radiation);
+bool EnvironmentTelemetryModule::sendMeasurement(meshtastic_Telemetry &m, NodeNum dest, bool phoneOnly)
+{
+    m.time = getTime();
+    LOG_INFO("Send: barometric_pressure=%f, current=%f, gas_resistance=%f, relative_humidity=%f, temperature=%f",
+             m.variant.environment_metrics.barometric_pressure, m.variant.environment_metrics.current,
+             m.variant.environment_metrics.gas_resistance, m.variant.environment_metrics.relative_humidity,
+             m.variant.environment_metrics.temperature);
+    LOG_INFO("Send: voltage=%f, IAQ=%d, distance=%f, lux=%f", m.variant.environment_metrics.voltage,
+             m.variant.environment_metrics.iaq, m.variant.environment_metrics.distance, m.variant.environment_metrics.lux);
 
-        sensor_read_error_count = 0;
+    LOG_INFO("Send: wind speed=%fm/s, direction=%d degrees, weight=%fkg", m.variant.environment_metrics.wind_speed,
+             m.variant.environment_metrics.wind_direction, m.variant.environment_metrics.weight);
 
-        meshtastic_MeshPacket *p = allocDataProtobuf(m);
-        p->to = dest;
-        p->decoded.want_response = false;
-        if (config.device.role == meshtastic_Config_DeviceConfig_Role_SENSOR)
-            p->priority = meshtastic_MeshPacket_Priority_RELIABLE;
-        else
-            p->priority = meshtastic_MeshPacket_Priority_BACKGROUND;
-        // release previous packet before occupying a new spot
-        if (lastMeasurementPacket != nullptr)
-            packetPool.release(lastMeasurementPacket);
+    LOG_INFO("Send: radiation=%fµR/h", m.variant.environment_metrics.radiation);
 
-        lastMeasurementPacket = packetPool.allocCopy(*p);
-        if (phoneOnly) {
-            LOG_INFO("Send packet to phone");
-            service->sendToPhone(p);
-        } else {
-            LOG_INFO("Send packet to mesh");
-            service->sendToMesh(p, RX_SRC_LOCAL, true);
+    sensor_read_error_count = 0;
+#if !MESHTASTIC_EXCLUDE_TELEMETRY_HISTORY
+    bool batched = TelemetryHistoryModule::record(m, phoneOnly);
+#endif
 
-            if (config.device.role == meshtastic_Config_DeviceConfig_Role_SENSOR && config.power.is_power_saving) {
-                LOG_DEBUG("Start next execution in 5s, then sleep");
-                sleepOnNextExecution = true;
-                setIntervalFromNow(5000);
-            }
-        }
+    meshtastic_MeshPacket *p = allocDataProtobuf(m);
+    p->to = dest;
+    p->decoded.want_response = false;
+    if (config.device.role == meshtastic_Config_DeviceConfig_Role_SENSOR)
+        p->priority = meshtastic_MeshPacket_Priority_RELIABLE;
+    else
+        p->priority = meshtastic_MeshPacket_Priority_BACKGROUND;
+    // release previous packet before occupying a new spot
+    if (lastMeasurementPacket != nullptr)
+        packetPool.release(lastMeasurementPacket);
+
+    lastMeasurementPacket = packetPool.allocCopy(*p);
+#if !MESHTASTIC_EXCLUDE_TELEMETRY_HISTORY
+    if (batched) {
+        // Only kept for the screen, the next batch carries it to the mesh
+        packetPool.release(p);
         return true;
     }
-    return false;
+#endif
+    if (phoneOnly) {
+        LOG_INFO("Send packet to phone");
+        service->sendToPhone(p);
+    } else {
+        LOG_INFO("Send packet to mesh");
+        service->sendToMesh(p, RX_SRC_LOCAL, true);
+
+        if (config.device.role == meshtastic_Config_DeviceConfig_Role_SENSOR && config.power.is_power_saving) {
+            LOG_DEBUG("Start next execution in 5s, then sleep");
+            sleepOnNextExecution = true;
+            setIntervalFromNow(5000);
+        }
+    }
+    return true;
 }
 
 AdminMessageHandleResult EnvironmentTelemetryModule::handleAdminMessageForModule(const meshtastic_MeshPacket &mp,
@@ -6,6 +6,7 @@
 #include "../mesh/generated/meshtastic/telemetry.pb.h"
 #include "NodeDB.h"
 #include "ProtobufModule.h"
+#include "Sensor/TelemetrySampler.h"
 #include <OLEDDisplay.h>
 #include <OLEDDisplayUi.h>
 
@@ -37,15 +38,20 @@ class EnvironmentTelemetryModule : private concurrency::OSThread, public Protobu
     */
     virtual bool handleReceivedProtobuf(const meshtastic_MeshPacket &mp, meshtastic_Telemetry *p) override;
     virtual int32_t runOnce() override;
-    /** Called to get current Environment telemetry data
-    @return true if it contains valid data
+    /** Called to get the last completed sample of Environment telemetry data
+    @return true if there is one
     */
     bool getEnvironmentTelemetry(meshtastic_Telemetry *m);
+    /** Queue every sensor we found into s, in the order their values take precedence */
+    void addSensors(TelemetrySampler &s);
     virtual meshtastic_MeshPacket *allocReply() override;
     /**
      * Send our Telemetry into the mesh
      */
     bool sendTelemetry(NodeNum dest = NODENUM_BROADCAST, bool wantReplies = false);
+    /** Start sampling all sensors in the background, runOnce sends the result once it's in */
+    void startSample(bool phoneOnly);
+    bool sendMeasurement(meshtastic_Telemetry &m, NodeNum dest, bool phoneOnly);
 
     virtual AdminMessageHandleResult handleAdminMessageForModule(const meshtastic_MeshPacket &mp,
                                                                  meshtastic_AdminMessage *request,
@@ -58,6 +64,11 @@ class EnvironmentTelemetryModule : private concurrency::OSThread, public Protobu
     uint32_t lastSentToMesh = 0;
     uint32_t lastSentToPhone = 0;
     uint32_t sensor_read_error_count = 0;
+    TelemetrySampler sampler;
+    meshtastic_Telemetry sample = meshtastic_Telemetry_init_zero;
+    bool samplePhoneOnly = false;
+    meshtastic_Telemetry lastSample = meshtastic_Telemetry_init_zero; // what we reply to requests with
+    bool hasLastSample = false;
 };
 
 #endif
\ No newline at end of file
@@ -10,6 +10,7 @@
 #include "PowerTelemetry.h"
 #include "RTC.h"
 #include "Router.h"
+#include "TelemetryHistoryModule.h"
 #include "main.h"
 #include "power.h"
 #include "sleep.h"
@@ -227,6 +228,9 @@ bool PowerTelemetryModule::sendTelemetry(NodeNum dest, bool phoneOnly)
                  m.variant.power_metrics.ch2_current, m.variant.power_metrics.ch3_voltage, m.variant.power_metrics.ch3_current);
 
         sensor_read_error_count = 0;
+#if !MESHTASTIC_EXCLUDE_TELEMETRY_HISTORY
+        bool batched = TelemetryHistoryModule::record(m, phoneOnly);
+#endif
 
         meshtastic_MeshPacket *p = allocDataProtobuf(m);
         p->to = dest;
@@ -240,6 +244,13 @@ bool PowerTelemetryModule::sendTelemetry(NodeNum dest, bool phoneOnly)
             packetPool.release(lastMeasurementPacket);
 
         lastMeasurementPacket = packetPool.allocCopy(*p);
+#if !MESHTASTIC_EXCLUDE_TELEMETRY_HISTORY
+        if (batched) {
+            // Only kept for the screen, the next batch carries it to the mesh
+            packetPool.release(p);
+            return true;
+        }
+#endif
         if (phoneOnly) {
             LOG_INFO("Send packet to phone");
             service->sendToPhone(p);
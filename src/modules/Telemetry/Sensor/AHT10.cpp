@@ -7,6 +7,7 @@
 #include "TelemetrySensor.h"
 
 #include <Adafruit_AHTX0.h>
+#include <Wire.h>
 #include <typeinfo>
 
 AHT10Sensor::AHT10Sensor() : TelemetrySensor(meshtastic_TelemetrySensorType_AHT10, "AHT10") {}
@@ -41,4 +42,47 @@ bool AHT10Sensor::getMetrics(meshtastic_Telemetry *measurement)
     return true;
 }
 
+// Adafruit_AHTX0 polls the busy bit inside getEvent(), so talk to the sensor directly for the split version
+uint32_t AHT10Sensor::startConversion()
+{
+    TwoWire *wire = nodeTelemetrySensorsMap[sensorType].second;
+    wire->beginTransmission(nodeTelemetrySensorsMap[sensorType].first);
+    wire->write((uint8_t)AHTX0_CMD_TRIGGER);
+    wire->write((uint8_t)0x33);
+    wire->write((uint8_t)0x00);
+    wire->endTransmission();
+    return AHT10_CONVERSION_MS;
+}
+
+bool AHT10Sensor::isConversionReady()
+{
+    TwoWire *wire = nodeTelemetrySensorsMap[sensorType].second;
+    if (wire->requestFrom(nodeTelemetrySensorsMap[sensorType].first, (uint8_t)1) != 1)
+        return false;
+    return !(wire->read() & AHTX0_STATUS_BUSY);
+}
+
+bool AHT10Sensor::readMetrics(meshtastic_Telemetry *measurement)
+{
+    TwoWire *wire = nodeTelemetrySensorsMap[sensorType].second;
+    uint8_t buf[6];
+    if (wire->requestFrom(nodeTelemetrySensorsMap[sensorType].first, (uint8_t)sizeof(buf)) != sizeof(buf))
+        return false;
+    for (size_t i = 0; i < sizeof(buf); i++)
+        buf[i] = wire->read();
+    if (buf[0] & AHTX0_STATUS_BUSY)
+        return false;
+
+    // 20 bits of humidity followed by 20 bits of temperature
+    uint32_t rawHumidity = ((uint32_t)buf[1] << 12) | ((uint32_t)buf[2] << 4) | (buf[3] >> 4);
+    uint32_t rawTemperature = ((uint32_t)(buf[3] & 0x0f) << 16) | ((uint32_t)buf[4] << 8) | buf[5];
+
+    measurement->variant.environment_metrics.has_temperature = true;
+    measurement->variant.environment_metrics.has_relative_humidity = true;
+    measurement->variant.environment_metrics.temperature = rawTemperature * 200.0f / 0x100000 - 50;
+    measurement->variant.environment_metrics.relative_humidity = rawHumidity * 100.0f / 0x100000;
+
+    return true;
+}
+
 #endif
\ No newline at end of file
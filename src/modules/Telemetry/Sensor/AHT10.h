@@ -6,6 +6,8 @@
 #include "TelemetrySensor.h"
 #include <Adafruit_AHTX0.h>
 
+#define AHT10_CONVERSION_MS 80 // from the datasheet, the sensor reports busy until then
+
 class AHT10Sensor : public TelemetrySensor
 {
   private:
@@ -18,6 +20,9 @@ class AHT10Sensor : public TelemetrySensor
     AHT10Sensor();
     virtual int32_t runOnce() override;
     virtual bool getMetrics(meshtastic_Telemetry *measurement) override;
+    virtual uint32_t startConversion() override;
+    virtual bool isConversionReady() override;
+    virtual bool readMetrics(meshtastic_Telemetry *measurement) override;
 };
 
 #endif
\ No newline at end of file
@@ -17,12 +17,7 @@ int32_t BME280Sensor::runOnce()
         return DEFAULT_SENSOR_MINIMUM_WAIT_TIME_BETWEEN_READS;
     }
     status = bme280.begin(nodeTelemetrySensorsMap[sensorType].first, nodeTelemetrySensorsMap[sensorType].second);
-
-    bme280.setSampling(Adafruit_BME280::MODE_FORCED,
-                       Adafruit_BME280::SAMPLING_X1, // Temp. oversampling
-                       Adafruit_BME280::SAMPLING_X1, // Pressure oversampling
-                       Adafruit_BME280::SAMPLING_X1, // Humidity oversampling
-                       Adafruit_BME280::FILTER_OFF, Adafruit_BME280::STANDBY_MS_1000);
+    startConversion();
 
     return initI2CSensor();
 }
@@ -43,4 +38,29 @@ bool BME280Sensor::getMetrics(meshtastic_Telemetry *measurement)
 
     return true;
 }
+
+uint32_t BME280Sensor::startConversion()
+{
+    // Writing the control register in forced mode starts a single measurement, the library only does it blocking
+    bme280.setSampling(Adafruit_BME280::MODE_FORCED,
+                       Adafruit_BME280::SAMPLING_X1, // Temp. oversampling
+                       Adafruit_BME280::SAMPLING_X1, // Pressure oversampling
+                       Adafruit_BME280::SAMPLING_X1, // Humidity oversampling
+                       Adafruit_BME280::FILTER_OFF, Adafruit_BME280::STANDBY_MS_1000);
+    return BME280_CONVERSION_MS;
+}
+
+bool BME280Sensor::readMetrics(meshtastic_Telemetry *measurement)
+{
+    measurement->variant.environment_metrics.has_temperature = true;
+    measurement->variant.environment_metrics.has_relative_humidity = true;
+    measurement->variant.environment_metrics.has_barometric_pressure = true;
+
+    measurement->variant.environment_metrics.temperature = bme280.readTemperature();
+    measurement->variant.environment_metrics.relative_humidity = bme280.readHumidity();
+    measurement->variant.environment_metrics.barometric_pressure = bme280.readPressure() / 100.0F;
+
+    return true;
+}
+
 #endif
\ No newline at end of file
@@ -6,6 +6,8 @@
 #include "TelemetrySensor.h"
 #include <Adafruit_BME280.h>
 
+#define BME280_CONVERSION_MS 10 // worst case with 1x oversampling of all three values
+
 class BME280Sensor : public TelemetrySensor
 {
   private:
@@ -18,6 +20,8 @@ class BME280Sensor : public TelemetrySensor
     BME280Sensor();
     virtual int32_t runOnce() override;
     virtual bool getMetrics(meshtastic_Telemetry *measurement) override;
+    virtual uint32_t startConversion() override;
+    virtual bool readMetrics(meshtastic_Telemetry *measurement) override;
 };
 
 #endif
\ No newline at end of file
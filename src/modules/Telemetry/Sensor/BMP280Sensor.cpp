@@ -18,11 +18,7 @@ int32_t BMP280Sensor::runOnce()
     }
     bmp280 = Adafruit_BMP280(nodeTelemetrySensorsMap[sensorType].second);
     status = bmp280.begin(nodeTelemetrySensorsMap[sensorType].first);
-
-    bmp280.setSampling(Adafruit_BMP280::MODE_FORCED,
-                       Adafruit_BMP280::SAMPLING_X1, // Temp. oversampling
-                       Adafruit_BMP280::SAMPLING_X1, // Pressure oversampling
-                       Adafruit_BMP280::FILTER_OFF, Adafruit_BMP280::STANDBY_MS_1000);
+    startConversion();
 
     return initI2CSensor();
 }
@@ -42,4 +38,25 @@ bool BMP280Sensor::getMetrics(meshtastic_Telemetry *measurement)
     return true;
 }
 
+uint32_t BMP280Sensor::startConversion()
+{
+    // Writing the control register in forced mode starts a single measurement, the library only does it blocking
+    bmp280.setSampling(Adafruit_BMP280::MODE_FORCED,
+                       Adafruit_BMP280::SAMPLING_X1, // Temp. oversampling
+                       Adafruit_BMP280::SAMPLING_X1, // Pressure oversampling
+                       Adafruit_BMP280::FILTER_OFF, Adafruit_BMP280::STANDBY_MS_1000);
+    return BMP280_CONVERSION_MS;
+}
+
+bool BMP280Sensor::readMetrics(meshtastic_Telemetry *measurement)
+{
+    measurement->variant.environment_metrics.has_temperature = true;
+    measurement->variant.environment_metrics.has_barometric_pressure = true;
+
+    measurement->variant.environment_metrics.temperature = bmp280.readTemperature();
+    measurement->variant.environment_metrics.barometric_pressure = bmp280.readPressure() / 100.0F;
+
+    return true;
+}
+
 #endif
\ No newline at end of file
@@ -6,6 +6,8 @@
 #include "TelemetrySensor.h"
 #include <Adafruit_BMP280.h>
 
+#define BMP280_CONVERSION_MS 7 // worst case with 1x oversampling of temperature and pressure
+
 class BMP280Sensor : public TelemetrySensor
 {
   private:
@@ -18,6 +20,8 @@ class BMP280Sensor : public TelemetrySensor
     BMP280Sensor();
     virtual int32_t runOnce() override;
     virtual bool getMetrics(meshtastic_Telemetry *measurement) override;
+    virtual uint32_t startConversion() override;
+    virtual bool readMetrics(meshtastic_Telemetry *measurement) override;
 };
 
 #endif
\ No newline at end of file
@@ -6,6 +6,7 @@
 #include "SHT31Sensor.h"
 #include "TelemetrySensor.h"
 #include <Adafruit_SHT31.h>
+#include <Wire.h>
 
 SHT31Sensor::SHT31Sensor() : TelemetrySensor(meshtastic_TelemetrySensorType_SHT31, "SHT31") {}
 
@@ -35,4 +36,45 @@ bool SHT31Sensor::getMetrics(meshtastic_Telemetry *measurement)
     return true;
 }
 
+// Adafruit_SHT31 waits for the conversion inside readTemperature(), so talk to the sensor directly for the split version
+uint32_t SHT31Sensor::startConversion()
+{
+    TwoWire *wire = nodeTelemetrySensorsMap[sensorType].second;
+    wire->beginTransmission(nodeTelemetrySensorsMap[sensorType].first);
+    wire->write((uint8_t)(SHT31_MEAS_HIGHREP >> 8));
+    wire->write((uint8_t)(SHT31_MEAS_HIGHREP & 0xff));
+    wire->endTransmission();
+    return SHT31_CONVERSION_MS;
+}
+
+static uint8_t sht31Crc(const uint8_t *data)
+{
+    uint8_t crc = 0xff;
+    for (int i = 0; i < 2; i++) {
+        crc ^= data[i];
+        for (int bit = 0; bit < 8; bit++)
+            crc = (crc & 0x80) ? (crc << 1) ^ 0x31 : crc << 1;
+    }
+    return crc;
+}
+
+bool SHT31Sensor::readMetrics(meshtastic_Telemetry *measurement)
+{
+    TwoWire *wire = nodeTelemetrySensorsMap[sensorType].second;
+    uint8_t buf[6];
+    if (wire->requestFrom(nodeTelemetrySensorsMap[sensorType].first, (uint8_t)sizeof(buf)) != sizeof(buf))
+        return false;
+    for (size_t i = 0; i < sizeof(buf); i++)
+        buf[i] = wire->read();
+    if (sht31Crc(buf) != buf[2] || sht31Crc(buf + 3) != buf[5])
+        return false;
+
+    measurement->variant.environment_metrics.has_temperature = true;
+    measurement->variant.environment_metrics.has_relative_humidity = true;
+    measurement->variant.environment_metrics.temperature = -45 + 175 * ((buf[0] << 8) | buf[1]) / 65535.0f;
+    measurement->variant.environment_metrics.relative_humidity = 100 * ((buf[3] << 8) | buf[4]) / 65535.0f;
+
+    return true;
+}
+
 #endif
\ No newline at end of file
@@ -6,6 +6,8 @@
 #include "TelemetrySensor.h"
 #include <Adafruit_SHT31.h>
 
+#define SHT31_CONVERSION_MS 16 // single shot, high repeatability
+
 class SHT31Sensor : public TelemetrySensor
 {
   private:
@@ -18,6 +20,8 @@ class SHT31Sensor : public TelemetrySensor
     SHT31Sensor();
     virtual int32_t runOnce() override;
     virtual bool getMetrics(meshtastic_Telemetry *measurement) override;
+    virtual uint32_t startConversion() override;
+    virtual bool readMetrics(meshtastic_Telemetry *measurement) override;
 };
 
 #endif
\ No newline at end of file
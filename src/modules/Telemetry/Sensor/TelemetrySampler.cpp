@@ -0,0 +1,111 @@
+#include "configuration.h"
+
+#if !MESHTASTIC_EXCLUDE_ENVIRONMENTAL_SENSOR
+
+#include "TelemetrySampler.h"
+
+void TelemetrySampler::clear()
+{
+    assert(!busy);
+    numEntries = 0;
+    numBuses = 0;
+}
+
+bool TelemetrySampler::add(TelemetrySensor *sensor, uint8_t flags)
+{
+    if (busy || numEntries >= TELEMETRY_SAMPLER_MAX_SENSORS)
+        return false;
+
+    // Sensors that aren't on I2C share the queue of the nullptr bus
+    TwoWire *bus = sensor->getBus();
+    uint8_t b = 0;
+    while (b < numBuses && buses[b] != bus)
+        b++;
+    if (b == numBuses) {
+        if (numBuses >= TELEMETRY_SAMPLER_MAX_BUSES)
+            return false;
+        buses[b] = bus;
+        heads[b] = tails[b] = NONE;
+        numBuses++;
+    }
+
+    uint8_t i = numEntries++;
+    entries[i].sensor = sensor;
+    entries[i].flags = flags;
+    entries[i].next = NONE;
+    if (tails[b] == NONE)
+        heads[b] = i;
+    else
+        entries[tails[b]].next = i;
+    tails[b] = i;
+    return true;
+}
+
+void TelemetrySampler::start(meshtastic_Telemetry *m)
+{
+    measurement = m;
+    valid = true;
+    numCounted = 0;
+    busy = numEntries > 0;
+
+    // Each start is a short register write, after this the conversions run in parallel
+    for (uint8_t i = 0; i < numEntries; i++)
+        entries[i].readyAt = millis() + entries[i].sensor->startConversion();
+
+    for (uint8_t b = 0; b < numBuses; b++)
+        cursors[b] = heads[b];
+}
+
+int32_t TelemetrySampler::step()
+{
+    if (!busy)
+        return 0;
+
+    uint32_t now = millis();
+    int32_t wait = INT32_MAX;
+    bool pending = false;
+    for (uint8_t b = 0; b < numBuses; b++) {
+        if (cursors[b] == NONE)
+            continue;
+        Entry &e = entries[cursors[b]];
+        int32_t left = (int32_t)(e.readyAt - now);
+        if (left > 0) {
+            wait = min(wait, left);
+        } else if (e.sensor->isConversionReady()) {
+            read(e);
+            cursors[b] = e.next;
+            // Yield before the next read on this bus, but come right back
+            if (e.next != NONE)
+                wait = 0;
+        } else if (-left > TELEMETRY_SAMPLER_TIMEOUT_MS) {
+            LOG_WARN("Sensor conversion timed out, skip it");
+            valid = false;
+            cursors[b] = e.next;
+            if (e.next != NONE)
+                wait = 0;
+        } else {
+            // Later than we expected, poll it again soon
+            wait = min(wait, (int32_t)5);
+        }
+        pending |= cursors[b] != NONE;
+    }
+    busy = pending;
+    return busy ? wait : 0;
+}
+
+void TelemetrySampler::read(Entry &e)
+{
+    if (e.flags & SAMPLE_HUMIDITY_ONLY) {
+        meshtastic_Telemetry scratch = meshtastic_Telemetry_init_zero;
+        e.sensor->readMetrics(&scratch);
+        measurement->variant.environment_metrics.relative_humidity = scratch.variant.environment_metrics.relative_humidity;
+        measurement->variant.environment_metrics.has_relative_humidity =
+            scratch.variant.environment_metrics.has_relative_humidity;
+        return;
+    }
+    if (!e.sensor->readMetrics(measurement))
+        valid = false;
+    numCounted++;
+}
+
+#endif
@@ -0,0 +1,83 @@
+#include "configuration.h"
+
+#if !MESHTASTIC_EXCLUDE_ENVIRONMENTAL_SENSOR
+
+#pragma once
+#include "../mesh/generated/meshtastic/telemetry.pb.h"
+#include "TelemetrySensor.h"
+
+/// Most sensors a single sample can include
+#ifndef TELEMETRY_SAMPLER_MAX_SENSORS
+#define TELEMETRY_SAMPLER_MAX_SENSORS 32
+#endif
+
+/// Wire, Wire1 and one queue for sensors that aren't on I2C
+#define TELEMETRY_SAMPLER_MAX_BUSES 3
+
+/// Give up on a sensor whose conversion isn't ready this long after it was expected
+#define TELEMETRY_SAMPLER_TIMEOUT_MS 1000
+
+/**
+ * Takes one measurement from a set of sensors without blocking the main loop on their conversion times.
+ *
+ * start() kicks off the conversions of all sensors at once, so they run in parallel.  step() is then called from the
+ * owning thread: on each bus it reads at most the next sensor in line, once that sensor is ready, and returns how long to
+ * wait before the next step.  Sensors on one bus are read in the order they were added, so when two of them report the
+ * same value the one added last wins.
+ */
+class TelemetrySampler
+{
+  public:
+    enum SampleFlags : uint8_t {
+        SAMPLE_ALL = 0,
+        SAMPLE_HUMIDITY_ONLY = 1 // only take the humidity, and don't let this sensor decide whether the sample is valid
+    };
+
+    /** Forget all sensors, only allowed while not busy */
+    void clear();
+
+    /** @return false if there is no room for sensor */
+    bool add(TelemetrySensor *sensor, uint8_t flags = SAMPLE_ALL);
+
+    /** Start the conversions of all added sensors, the results are collected into m which must stay valid until done */
+    void start(meshtastic_Telemetry *m);
+
+    /**
+     * Read the sensors that finished converting
+     * @return msec until step() should be called again, only meaningful while isBusy()
+     */
+    int32_t step();
+
+    bool isBusy() const { return busy; }
+
+    /** @return true if the finished sample has data from at least one sensor and none of them failed */
+    bool isValid() const { return valid && numCounted > 0; }
+
+  private:
+    static constexpr uint8_t NONE = 0xff;
+
+    struct Entry {
+        TelemetrySensor *sensor;
+        uint32_t readyAt; // millis() when its conversion should be done
+        uint8_t flags;
+        uint8_t next; // next entry on the same bus
+    };
+
+    Entry entries[TELEMETRY_SAMPLER_MAX_SENSORS];
+    uint8_t numEntries = 0;
+
+    TwoWire *buses[TELEMETRY_SAMPLER_MAX_BUSES] = {};
+    uint8_t heads[TELEMETRY_SAMPLER_MAX_BUSES]; // first entry of each bus
+    uint8_t tails[TELEMETRY_SAMPLER_MAX_BUSES];
+    uint8_t cursors[TELEMETRY_SAMPLER_MAX_BUSES]; // next entry to read on each bus while busy
+    uint8_t numBuses = 0;
+
+    meshtastic_Telemetry *measurement = nullptr;
+    bool busy = false;
+    bool valid = true;
+    uint8_t numCounted = 0;
+
+    void read(Entry &e);
+};
+
+#endif
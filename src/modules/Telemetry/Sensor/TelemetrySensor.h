@@ -56,6 +56,24 @@ class TelemetrySensor
     virtual bool isRunning() { return status > 0; }
 
     virtual bool getMetrics(meshtastic_Telemetry *measurement) = 0;
+
+    /** The I2C bus the sensor was found on, nullptr if it isn't an I2C sensor */
+    TwoWire *getBus() { return nodeTelemetrySensorsMap[sensorType].second; }
+
+    /**
+     * Sensors that can measure in the background override these three, so TelemetrySampler can overlap their
+     * conversions instead of waiting for them inside getMetrics().
+     *
+     * Start a measurement without waiting for it
+     * @return msec until the result is expected, 0 if readMetrics() does all the work itself
+     */
+    virtual uint32_t startConversion() { return 0; }
+
+    /** @return true once the measurement started by startConversion() can be read */
+    virtual bool isConversionReady() { return true; }
+
+    /** Read the finished measurement, by default a blocking getMetrics() */
+    virtual bool readMetrics(meshtastic_Telemetry *measurement) { return getMetrics(measurement); }
 };
 
 #endif
\ No newline at end of file
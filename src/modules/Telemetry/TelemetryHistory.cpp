@@ -0,0 +1,266 @@
+#include "TelemetryHistory.h"
+
+#if !MESHTASTIC_EXCLUDE_TELEMETRY_HISTORY
+
+#include <math.h>
+
+TelemetryHistory telemetryHistory;
+
+// Multiplier to get from the Telemetry float to the integer we keep, indexed by TelemetryHistoryMetric
+static const float metricScales[TELEMETRY_HISTORY_NUM_METRICS] = {
+    1,    // battery level
+    1000, // voltage
+    100,  // channel utilization
+    100,  // air util tx
+    100,  // temperature
+    100,  // relative humidity
+    100,  // pressure
+    100,  // gas resistance
+    1,    // iaq
+    100,  // lux
+    1000, // env voltage
+    100,  // env current
+    1000, 100, 1000, 100, 1000, 100 // ch1..ch3 voltage, current
+};
+
+static size_t putVarint(uint8_t *buf, size_t bufLen, size_t pos, uint32_t v)
+{
+    do {
+        if (pos >= bufLen)
+            return bufLen + 1; // sticky overflow
+        uint8_t b = v & 0x7f;
+        v >>= 7;
+        buf[pos++] = v ? (b | 0x80) : b;
+    } while (v);
+    return pos;
+}
+
+static bool getVarint(const uint8_t *buf, size_t len, size_t &pos, uint32_t &v)
+{
+    v = 0;
+    for (int shift = 0; shift < 35; shift += 7) {
+        if (pos >= len)
+            return false;
+        uint8_t b = buf[pos++];
+        v |= (uint32_t)(b & 0x7f) << shift;
+        if (!(b & 0x80))
+            return true;
+    }
+    return false;
+}
+
+static inline uint32_t zigzag(int32_t v)
+{
+    return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31);
+}
+
+TelemetryHistory::~TelemetryHistory()
+{
+    clear();
+}
+
+void TelemetryHistory::clear()
+{
+    for (auto &r : rings) {
+        delete r;
+        r = nullptr;
+    }
+}
+
+void TelemetryHistory::close(Ring &r)
+{
+    if (!r.samples)
+        return;
+    r.open.avg = (int32_t)(r.sum / r.samples);
+    r.buckets[r.head] = r.open;
+    r.head = (r.head + 1) % TELEMETRY_HISTORY_BUCKETS;
+    if (r.count < TELEMETRY_HISTORY_BUCKETS)
+        r.count++;
+    r.samples = 0;
+    r.sum = 0;
+}
+
+void TelemetryHistory::add(TelemetryHistoryMetric metric, float value, uint32_t now)
+{
+    if (isnan(value))
+        return;
+    Ring *&r = rings[metric];
+    if (!r)
+        r = new Ring();
+
+    int32_t v = (int32_t)lroundf(value * metricScales[metric]);
+    uint32_t number = now / TELEMETRY_HISTORY_BUCKET_SECS;
+    if (r->samples && r->open.number != number)
+        close(*r);
+    if (!r->samples) {
+        r->open.number = number;
+        r->open.min = r->open.max = v;
+    } else {
+        if (v < r->open.min)
+            r->open.min = v;
+        if (v > r->open.max)
+            r->open.max = v;
+    }
+    r->sum += v;
+    r->samples++;
+}
+
+void TelemetryHistory::record(const meshtastic_Telemetry &t, uint32_t now)
+{
+    switch (t.which_variant) {
+    case meshtastic_Telemetry_device_metrics_tag: {
+        const meshtastic_DeviceMetrics &m = t.variant.device_metrics;
+        if (m.has_battery_level)
+            add(TELEMETRY_HISTORY_BATTERY_LEVEL, m.battery_level, now);
+        if (m.has_voltage)
+            add(TELEMETRY_HISTORY_VOLTAGE, m.voltage, now);
+        if (m.has_channel_utilization)
+            add(TELEMETRY_HISTORY_CHANNEL_UTIL, m.channel_utilization, now);
+        if (m.has_air_util_tx)
+            add(TELEMETRY_HISTORY_AIR_UTIL_TX, m.air_util_tx, now);
+        break;
+    }
+    case meshtastic_Telemetry_environment_metrics_tag: {
+        const meshtastic_EnvironmentMetrics &m = t.variant.environment_metrics;
+        if (m.has_temperature)
+            add(TELEMETRY_HISTORY_TEMPERATURE, m.temperature, now);
+        if (m.has_relative_humidity)
+            add(TELEMETRY_HISTORY_RELATIVE_HUMIDITY, m.relative_humidity, now);
+        if (m.has_barometric_pressure)
+            add(TELEMETRY_HISTORY_PRESSURE, m.barometric_pressure, now);
+        if (m.has_gas_resistance)
+            add(TELEMETRY_HISTORY_GAS_RESISTANCE, m.gas_resistance, now);
+        if (m.has_iaq)
+            add(TELEMETRY_HISTORY_IAQ, m.iaq, now);
+        if (m.has_lux)
+            add(TELEMETRY_HISTORY_LUX, m.lux, now);
+        if (m.has_voltage)
+            add(TELEMETRY_HISTORY_ENV_VOLTAGE, m.voltage, now);
+        if (m.has_current)
+            add(TELEMETRY_HISTORY_ENV_CURRENT, m.current, now);
+        break;
+    }
+    case meshtastic_Telemetry_power_metrics_tag: {
+        const meshtastic_PowerMetrics &m = t.variant.power_metrics;
+        if (m.has_ch1_voltage)
+            add(TELEMETRY_HISTORY_CH1_VOLTAGE, m.ch1_voltage, now);
+        if (m.has_ch1_current)
+            add(TELEMETRY_HISTORY_CH1_CURRENT, m.ch1_current, now);
+        if (m.has_ch2_voltage)
+            add(TELEMETRY_HISTORY_CH2_VOLTAGE, m.ch2_voltage, now);
+        if (m.has_ch2_current)
+            add(TELEMETRY_HISTORY_CH2_CURRENT, m.ch2_current, now);
+        if (m.has_ch3_voltage)
+            add(TELEMETRY_HISTORY_CH3_VOLTAGE, m.ch3_voltage, now);
+        if (m.has_ch3_current)
+            add(TELEMETRY_HISTORY_CH3_CURRENT, m.ch3_current, now);
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+uint8_t TelemetryHistory::numBuckets(TelemetryHistoryMetric metric) const
+{
+    return rings[metric] ? rings[metric]->count : 0;
+}
+
+size_t TelemetryHistory::encodeBatch(uint8_t *buf, size_t bufLen, uint32_t sinceTime, uint32_t metrics, uint32_t *left,
+                                     uint32_t now) const
+{
+    uint32_t sinceNumber = (sinceTime + TELEMETRY_HISTORY_BUCKET_SECS - 1) / TELEMETRY_HISTORY_BUCKET_SECS;
+    uint32_t nowNumber = now / TELEMETRY_HISTORY_BUCKET_SECS;
+    *left = 0;
+
+    if (bufLen < 2)
+        return 0;
+    buf[0] = TELEMETRY_HISTORY_VERSION;
+    buf[1] = TELEMETRY_HISTORY_BATCH;
+    size_t pos = putVarint(buf, bufLen, 2, TELEMETRY_HISTORY_BUCKET_SECS);
+    if (pos > bufLen)
+        return 0;
+    size_t header = pos;
+
+    for (uint8_t metric = 0; metric < TELEMETRY_HISTORY_NUM_METRICS; metric++) {
+        const Ring *r = rings[metric];
+        if (!(metrics & (1UL << metric)) || !r)
+            continue;
+
+        // Collect the matching buckets oldest first, a bucket that can't get any more samples counts as closed
+        TelemetryHistoryBucket selected[TELEMETRY_HISTORY_BUCKETS + 1];
+        uint8_t n = 0;
+        for (uint8_t i = 0; i < r->count; i++) {
+            const TelemetryHistoryBucket &b =
+                r->buckets[(r->head + TELEMETRY_HISTORY_BUCKETS - r->count + i) % TELEMETRY_HISTORY_BUCKETS];
+            if (b.number >= sinceNumber)
+                selected[n++] = b;
+        }
+        if (r->samples && r->open.number >= sinceNumber && r->open.number < nowNumber) {
+            selected[n] = r->open;
+            selected[n++].avg = (int32_t)(r->sum / r->samples);
+        }
+        if (!n)
+            continue;
+
+        size_t start = pos;
+        if (pos < bufLen)
+            buf[pos++] = metric;
+        else
+            pos = bufLen + 1;
+        pos = putVarint(buf, bufLen, pos, selected[0].number);
+        pos = putVarint(buf, bufLen, pos, n);
+        uint32_t prevNumber = selected[0].number;
+        int32_t prevAvg = 0;
+        for (uint8_t i = 0; i < n; i++) {
+            const TelemetryHistoryBucket &b = selected[i];
+            // A bucket with a single sample (or a constant value) leaves out min and max
+            bool spread = b.min != b.max;
+            pos = putVarint(buf, bufLen, pos, ((b.number - prevNumber - (i ? 1 : 0)) << 1) | spread);
+            pos = putVarint(buf, bufLen, pos, zigzag(b.avg - prevAvg));
+            if (spread) {
+                pos = putVarint(buf, bufLen, pos, b.avg - b.min);
+                pos = putVarint(buf, bufLen, pos, b.max - b.avg);
+            }
+            prevNumber = b.number;
+            prevAvg = b.avg;
+        }
+        if (pos > bufLen) {
+            // Doesn't fit anymore, leave this one and the rest for another batch
+            pos = start;
+            *left |= 1UL << metric;
+        }
+    }
+
+    if (pos == header)
+        return 0;
+    if (*left)
+        buf[1] |= TELEMETRY_HISTORY_MORE;
+    return pos;
+}
+
+size_t TelemetryHistory::encodeRequest(uint8_t *buf, size_t bufLen, uint32_t sinceTime, uint32_t metrics)
+{
+    if (bufLen < 2)
+        return 0;
+    buf[0] = TELEMETRY_HISTORY_VERSION;
+    buf[1] = TELEMETRY_HISTORY_REQUEST;
+    size_t pos = putVarint(buf, bufLen, 2, sinceTime);
+    pos = putVarint(buf, bufLen, pos, metrics);
+    return pos > bufLen ? 0 : pos;
+}
+
+bool TelemetryHistory::decodeRequest(const uint8_t *buf, size_t len, uint32_t *sinceTime, uint32_t *metrics)
+{
+    size_t pos = 2;
+    if (len < 2 || buf[0] != TELEMETRY_HISTORY_VERSION || buf[1] != TELEMETRY_HISTORY_REQUEST)
+        return false;
+    if (!getVarint(buf, len, pos, *sinceTime))
+        return false;
+    // The mask is optional, everything if left out
+    if (!getVarint(buf, len, pos, *metrics))
+        *metrics = TELEMETRY_HISTORY_ALL_METRICS;
+    return true;
+}
+
+#endif
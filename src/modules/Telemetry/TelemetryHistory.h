@@ -0,0 +1,126 @@
+#pragma once
+
+#include "configuration.h"
+
+#if !MESHTASTIC_EXCLUDE_TELEMETRY_HISTORY
+
+#include "mesh/generated/meshtastic/telemetry.pb.h"
+#include <stddef.h>
+#include <stdint.h>
+
+/// Length of one downsampled bucket
+#ifndef TELEMETRY_HISTORY_BUCKET_SECS
+#define TELEMETRY_HISTORY_BUCKET_SECS 300
+#endif
+
+/// Buckets kept per metric, the oldest ones are overwritten
+#ifndef TELEMETRY_HISTORY_BUCKETS
+#define TELEMETRY_HISTORY_BUCKETS 24
+#endif
+
+/// Format version of batches and requests
+#define TELEMETRY_HISTORY_VERSION 1
+
+/**
+ * The metrics we keep a history of, keep in sync with bin/telemetry-history-decode.py
+ */
+enum TelemetryHistoryMetric : uint8_t {
+    TELEMETRY_HISTORY_BATTERY_LEVEL = 0, // %
+    TELEMETRY_HISTORY_VOLTAGE,           // mV
+    TELEMETRY_HISTORY_CHANNEL_UTIL,      // % * 100
+    TELEMETRY_HISTORY_AIR_UTIL_TX,       // % * 100
+    TELEMETRY_HISTORY_TEMPERATURE,       // °C * 100
+    TELEMETRY_HISTORY_RELATIVE_HUMIDITY, // % * 100
+    TELEMETRY_HISTORY_PRESSURE,          // hPa * 100
+    TELEMETRY_HISTORY_GAS_RESISTANCE,    // MOhm * 100
+    TELEMETRY_HISTORY_IAQ,               // index
+    TELEMETRY_HISTORY_LUX,               // lx * 100
+    TELEMETRY_HISTORY_ENV_VOLTAGE,       // mV
+    TELEMETRY_HISTORY_ENV_CURRENT,       // mA * 100
+    TELEMETRY_HISTORY_CH1_VOLTAGE,       // mV
+    TELEMETRY_HISTORY_CH1_CURRENT,       // mA * 100
+    TELEMETRY_HISTORY_CH2_VOLTAGE,       // mV
+    TELEMETRY_HISTORY_CH2_CURRENT,       // mA * 100
+    TELEMETRY_HISTORY_CH3_VOLTAGE,       // mV
+    TELEMETRY_HISTORY_CH3_CURRENT,       // mA * 100
+    TELEMETRY_HISTORY_NUM_METRICS
+};
+
+#define TELEMETRY_HISTORY_ALL_METRICS ((1UL << TELEMETRY_HISTORY_NUM_METRICS) - 1)
+
+/**
+ * First byte after the version of every history payload
+ */
+enum TelemetryHistoryPayloadType : uint8_t {
+    TELEMETRY_HISTORY_BATCH = 1,   // varint period, then metric blocks
+    TELEMETRY_HISTORY_REQUEST = 2, // varint sinceTime (0 for everything), varint metric mask
+};
+
+/// Set in the type byte of a batch if it had to leave out metrics, ask again for the rest
+#define TELEMETRY_HISTORY_MORE 0x80
+
+/**
+ * min/max/avg of the samples that fell into one bucket
+ */
+struct TelemetryHistoryBucket {
+    uint32_t number; // time / TELEMETRY_HISTORY_BUCKET_SECS
+    int32_t min, max, avg;
+};
+
+/**
+ * Keeps a downsampled history of our own telemetry, and packs it into compact batches.
+ *
+ * Every measurement the telemetry modules take is recorded, each metric is scaled to an integer and reduced to min/max/avg
+ * per bucket.  A batch holds one block per metric:
+ *     u8 metric, varint first bucket number, varint count,
+ *     then per bucket: varint (buckets skipped since the previous one << 1 | min != max),
+ *     zigzag varint avg delta to the previous avg, and only if min != max: varint avg - min, varint max - avg
+ * so a slowly changing value costs two to four bytes per bucket, instead of a whole Telemetry packet per sample.
+ */
+class TelemetryHistory
+{
+  public:
+    ~TelemetryHistory();
+
+    /** Add every metric t carries to the bucket of now (seconds) */
+    void record(const meshtastic_Telemetry &t, uint32_t now);
+
+    /**
+     * Pack the closed buckets that started at or after sinceTime into a batch
+     * @param metrics bitmask of TelemetryHistoryMetric to include
+     * @param left set to the metrics that didn't fit, if any
+     * @param now buckets still collecting samples at this time are left out
+     * @return bytes written, 0 if there was nothing to send
+     */
+    size_t encodeBatch(uint8_t *buf, size_t bufLen, uint32_t sinceTime, uint32_t metrics, uint32_t *left, uint32_t now) const;
+
+    /** @return the number of closed buckets kept for metric */
+    uint8_t numBuckets(TelemetryHistoryMetric metric) const;
+
+    /** Forget everything */
+    void clear();
+
+    static size_t encodeRequest(uint8_t *buf, size_t bufLen, uint32_t sinceTime, uint32_t metrics);
+    static bool decodeRequest(const uint8_t *buf, size_t len, uint32_t *sinceTime, uint32_t *metrics);
+
+  private:
+    struct Ring {
+        TelemetryHistoryBucket buckets[TELEMETRY_HISTORY_BUCKETS];
+        uint8_t head; // next slot to write
+        uint8_t count;
+        // The bucket still collecting samples
+        TelemetryHistoryBucket open;
+        int64_t sum;
+        uint16_t samples;
+    };
+
+    // Allocated on the first sample, most nodes only have a handful of these metrics
+    Ring *rings[TELEMETRY_HISTORY_NUM_METRICS] = {};
+
+    void add(TelemetryHistoryMetric metric, float value, uint32_t now);
+    static void close(Ring &r);
+};
+
+extern TelemetryHistory telemetryHistory;
+
+#endif
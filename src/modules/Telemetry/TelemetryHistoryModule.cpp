@@ -0,0 +1,104 @@
+#include "TelemetryHistoryModule.h"
+
+#if !MESHTASTIC_EXCLUDE_TELEMETRY_HISTORY
+
+#include "MeshService.h"
+#include "NodeDB.h"
+#include "RTC.h"
+#include "Router.h"
+#include "airtime.h"
+#include "main.h"
+
+TelemetryHistoryModule *telemetryHistoryModule;
+
+#define BATCH_INTERVAL_MS (USERPREFS_TELEMETRY_HISTORY_BATCH_BUCKETS * TELEMETRY_HISTORY_BUCKET_SECS * 1000UL)
+
+TelemetryHistoryModule::TelemetryHistoryModule()
+    : SinglePortModule("TelemetryHistory", TELEMETRY_HISTORY_PORTNUM), concurrency::OSThread("TelemetryHistory")
+{
+    if (isBatching())
+        setIntervalFromNow(BATCH_INTERVAL_MS);
+    else
+        disable();
+}
+
+bool TelemetryHistoryModule::record(const meshtastic_Telemetry &t, bool phoneOnly)
+{
+    // Before we have the time, uptime would put the measurement into a bucket decades in the past
+    uint32_t now = getValidTime(RTCQualityFromNet);
+    if (!now)
+        return false;
+
+    telemetryHistory.record(t, now);
+    if (phoneOnly || !isBatching() || !telemetryHistoryModule)
+        return false;
+    LOG_DEBUG("Telemetry recorded for the next batch");
+    return true;
+}
+
+meshtastic_MeshPacket *TelemetryHistoryModule::allocBatch(uint32_t sinceTime, uint32_t metrics, uint32_t *left)
+{
+    uint32_t now = getValidTime(RTCQualityFromNet);
+    if (!now)
+        return NULL;
+
+    meshtastic_MeshPacket *p = allocDataPacket();
+    p->decoded.payload.size = telemetryHistory.encodeBatch(p->decoded.payload.bytes, sizeof(p->decoded.payload.bytes),
+                                                           sinceTime, metrics, left, now);
+    if (!p->decoded.payload.size) {
+        packetPool.release(p);
+        return NULL;
+    }
+    p->priority = meshtastic_MeshPacket_Priority_BACKGROUND;
+    return p;
+}
+
+int32_t TelemetryHistoryModule::runOnce()
+{
+    if (!airTime->isTxAllowedChannelUtil(config.device.role != meshtastic_Config_DeviceConfig_Role_SENSOR) ||
+        !airTime->isTxAllowedAirUtil()) {
+        // Nothing is lost by waiting, the buckets stay in the history
+        return TELEMETRY_HISTORY_PART_DELAY_MS;
+    }
+
+    if (!pendingMetrics) {
+        // Nothing was recorded without the time, so there is nothing to send either
+        uint32_t now = getValidTime(RTCQualityFromNet);
+        if (!now)
+            return BATCH_INTERVAL_MS;
+
+        // Start a new batch, with everything that closed since the last one
+        pendingMetrics = TELEMETRY_HISTORY_ALL_METRICS;
+        batchEnd = now / TELEMETRY_HISTORY_BUCKET_SECS * TELEMETRY_HISTORY_BUCKET_SECS;
+    }
+
+    uint32_t left = 0;
+    meshtastic_MeshPacket *p = allocBatch(sentThrough, pendingMetrics, &left);
+    if (p) {
+        LOG_INFO("Send telemetry batch of %u bytes to mesh", p->decoded.payload.size);
+        p->to = NODENUM_BROADCAST;
+        service->sendToMesh(p, RX_SRC_LOCAL, true);
+    }
+
+    pendingMetrics = left;
+    if (pendingMetrics)
+        return TELEMETRY_HISTORY_PART_DELAY_MS;
+    sentThrough = batchEnd;
+    return BATCH_INTERVAL_MS;
+}
+
+meshtastic_MeshPacket *TelemetryHistoryModule::allocReply()
+{
+    uint32_t sinceTime, metrics;
+    const meshtastic_Data &d = currentRequest->decoded;
+    if (!isToUs(currentRequest) || !TelemetryHistory::decodeRequest(d.payload.bytes, d.payload.size, &sinceTime, &metrics))
+        return NULL;
+
+    uint32_t left = 0;
+    meshtastic_MeshPacket *p = allocBatch(sinceTime, metrics, &left);
+    if (p)
+        LOG_INFO("Telemetry history reply of %u bytes, metrics 0x%x left out", p->decoded.payload.size, left);
+    return p;
+}
+
+#endif
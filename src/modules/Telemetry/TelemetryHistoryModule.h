@@ -0,0 +1,56 @@
+#pragma once
+
+#include "configuration.h"
+
+#if !MESHTASTIC_EXCLUDE_TELEMETRY_HISTORY
+
+#include "SinglePortModule.h"
+#include "TelemetryHistory.h"
+#include "concurrency/OSThread.h"
+#include "modules/PrivatePortNums.h"
+
+/// Send a batch every this many buckets (6 is every 30 minutes, the default telemetry interval), 0 keeps sending every
+/// measurement on its own (the history can still be pulled)
+#ifndef USERPREFS_TELEMETRY_HISTORY_BATCH_BUCKETS
+#define USERPREFS_TELEMETRY_HISTORY_BATCH_BUCKETS 6
+#endif
+
+/// Wait between the parts of a batch that didn't fit one packet
+#define TELEMETRY_HISTORY_PART_DELAY_MS (10 * 1000)
+
+/**
+ * Sends our telemetry history (see TelemetryHistory) in batches, and answers requests for it.
+ *
+ * With batching enabled the telemetry modules stop broadcasting each measurement and only record it, this module then
+ * broadcasts all metrics every USERPREFS_TELEMETRY_HISTORY_BATCH_BUCKETS buckets.  A client (phone or another node) can
+ * always pull the history with a TELEMETRY_HISTORY_REQUEST with want_response set.
+ */
+class TelemetryHistoryModule : public SinglePortModule, private concurrency::OSThread
+{
+  public:
+    TelemetryHistoryModule();
+
+    /** @return true if measurements should only be recorded, because a batch will carry them to the mesh */
+    static bool isBatching() { return USERPREFS_TELEMETRY_HISTORY_BATCH_BUCKETS > 0; }
+
+    /**
+     * Record a measurement a telemetry module took, measurements taken before we know the time aren't recorded
+     * @return true if the module shouldn't send it to the mesh by itself
+     */
+    static bool record(const meshtastic_Telemetry &t, bool phoneOnly);
+
+  protected:
+    virtual int32_t runOnce() override;
+    virtual meshtastic_MeshPacket *allocReply() override;
+
+  private:
+    uint32_t sentThrough = 0;    // buckets starting before this time went out already
+    uint32_t batchEnd = 0;       // sentThrough once the batch in progress is complete
+    uint32_t pendingMetrics = 0; // metrics of the batch in progress that didn't fit yet
+
+    meshtastic_MeshPacket *allocBatch(uint32_t sinceTime, uint32_t metrics, uint32_t *left);
+};
+
+extern TelemetryHistoryModule *telemetryHistoryModule;
+
+#endif
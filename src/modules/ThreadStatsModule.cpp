@@ -0,0 +1,86 @@
+#include "ThreadStatsModule.h"
+
+#if !MESHTASTIC_EXCLUDE_THREAD_STATS
+
+#include "MeshService.h"
+#include "NodeDB.h"
+#include "concurrency/OSThread.h"
+#include "main.h"
+#include <algorithm>
+#include <pb_encode.h>
+#include <string.h>
+
+size_t ThreadStatsModule::encodeReport(uint8_t *buf, size_t bufLen)
+{
+    auto threads = concurrency::mainController.getThreadsByRuntime();
+
+    pb_ostream_t stream = pb_ostream_from_buffer(buf, bufLen);
+    const uint8_t header[2] = {THREAD_STATS_VERSION, THREAD_STATS_REPORT};
+    if (!pb_write(&stream, header, sizeof(header)) ||
+        !pb_encode_varint(&stream, concurrency::mainController.getStatsMs() / 1000) ||
+        !pb_encode_varint(&stream, threads.size()))
+        return 0;
+
+    for (auto t : threads) {
+        const concurrency::OSThreadStats &s = t->getStats();
+        size_t start = stream.bytes_written;
+        size_t nameLen = std::min((size_t)t->ThreadName.length(), (size_t)THREAD_STATS_NAME_LEN);
+        const uint8_t nul = 0;
+        if (!pb_write(&stream, (const uint8_t *)t->ThreadName.c_str(), nameLen) || !pb_write(&stream, &nul, 1) ||
+            !pb_encode_varint(&stream, s.runs) || !pb_encode_varint(&stream, s.totalUs / 1000) ||
+            !pb_encode_varint(&stream, s.maxUs) || !pb_encode_varint(&stream, s.runs ? s.totalLateMs / s.runs : 0) ||
+            !pb_encode_varint(&stream, s.maxLateMs) || !pb_encode_varint(&stream, s.wakeups)) {
+            buf[1] |= THREAD_STATS_MORE;
+            return start;
+        }
+    }
+    return stream.bytes_written;
+}
+
+size_t ThreadStatsModule::encodeRequest(uint8_t *buf, size_t bufLen, uint8_t flags)
+{
+    if (bufLen < 3)
+        return 0;
+    buf[0] = THREAD_STATS_VERSION;
+    buf[1] = THREAD_STATS_REQUEST;
+    buf[2] = flags;
+    return 3;
+}
+
+bool ThreadStatsModule::isAuthorized(const meshtastic_MeshPacket &mp)
+{
+    if (isFromUs(&mp))
+        return !config.security.is_managed;
+    if (!mp.pki_encrypted)
+        return false;
+    // The same keys AdminModule accepts
+    for (int i = 0; i < 3; i++) {
+        if (config.security.admin_key[i].size == 32 && memcmp(mp.public_key.bytes, config.security.admin_key[i].bytes, 32) == 0)
+            return true;
+    }
+    return false;
+}
+
+meshtastic_MeshPacket *ThreadStatsModule::allocReply()
+{
+    const meshtastic_MeshPacket &req = *currentRequest;
+    const meshtastic_Data &d = req.decoded;
+    if (!isToUs(&req) || d.payload.size < 2 || d.payload.bytes[0] != THREAD_STATS_VERSION ||
+        d.payload.bytes[1] != THREAD_STATS_REQUEST)
+        return NULL;
+    if (!isAuthorized(req)) {
+        LOG_INFO("Ignore unauthorized thread stats request from 0x%x", req.from);
+        return allocErrorResponse(meshtastic_Routing_Error_NOT_AUTHORIZED, &req);
+    }
+
+    meshtastic_MeshPacket *p = allocDataPacket();
+    p->decoded.payload.size = encodeReport(p->decoded.payload.bytes, sizeof(p->decoded.payload.bytes));
+    p->priority = meshtastic_MeshPacket_Priority_BACKGROUND;
+    LOG_INFO("Thread stats reply of %u bytes", p->decoded.payload.size);
+
+    if (d.payload.size > 2 && (d.payload.bytes[2] & THREAD_STATS_RESET))
+        concurrency::mainController.resetStats();
+    return p;
+}
+
+#endif
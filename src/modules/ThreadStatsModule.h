@@ -0,0 +1,58 @@
+#pragma once
+
+#include "configuration.h"
+
+#if !MESHTASTIC_EXCLUDE_THREAD_STATS
+
+#include "SinglePortModule.h"
+#include "modules/PrivatePortNums.h"
+
+/// Format version of reports and requests
+#define THREAD_STATS_VERSION 2
+
+/// Thread names are cut to this many characters in reports
+#define THREAD_STATS_NAME_LEN 12
+
+/**
+ * First byte after the version of every thread stats payload, keep in sync with bin/thread-stats-decode.py
+ */
+enum ThreadStatsPayloadType : uint8_t {
+    THREAD_STATS_REPORT = 1,  // varint secs counted, varint number of threads, then the busiest threads that fit
+    THREAD_STATS_REQUEST = 2, // u8 flags
+};
+
+/// Set in the type byte of a report if the least busy threads were left out
+#define THREAD_STATS_MORE 0x80
+
+/// Request flag: start counting from zero once the report is made
+#define THREAD_STATS_RESET 0x01
+
+/**
+ * Answers requests for the OSThread runtime stats (see OSThreadStats), so a node in the field can tell us which thread keeps
+ * the main loop busy.
+ *
+ * Like an admin message, a request is only answered if it comes from our own client, or PKI encrypted from one of the admin
+ * keys.  Each thread in a report is:
+ *     name (NUL terminated), varint runs, varint total ms in runOnce(), varint max us in runOnce(),
+ *     varint average ms late, varint max ms late, varint wakeups
+ * busiest first, until the packet is full.  The counts are since boot or the last reset, which was secs counted ago, so
+ * wakeups over that is the thread's share of the wakeup budget: how often it keeps the CPU from sleeping.
+ */
+class ThreadStatsModule : public SinglePortModule
+{
+  public:
+    ThreadStatsModule() : SinglePortModule("ThreadStats", THREAD_STATS_PORTNUM) {}
+
+    /** @return bytes written */
+    static size_t encodeReport(uint8_t *buf, size_t bufLen);
+
+    static size_t encodeRequest(uint8_t *buf, size_t bufLen, uint8_t flags);
+
+  protected:
+    virtual meshtastic_MeshPacket *allocReply() override;
+
+  private:
+    static bool isAuthorized(const meshtastic_MeshPacket &mp);
+};
+
+#endif
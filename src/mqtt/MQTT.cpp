@@ -3,6 +3,7 @@
 #include "NodeDB.h"
 #include "PowerFSM.h"
 #include "ServiceEnvelope.h"
+#include "concurrency/WorkerPool.h"
 #include "configuration.h"
 #include "main.h"
 #include "mesh/Channels.h"
@@ -26,6 +27,7 @@
 #endif
 #include <Throttle.h>
 #include <assert.h>
+#include <memory>
 #include <utility>
 
 #include <IPAddress.h>
@@ -335,7 +337,7 @@ MQTT::MQTT() : concurrency::OSThread("mqtt"), mqttQueue(MAX_MQTT_QUEUE)
 
         if (moduleConfig.mqtt.proxy_to_client_enabled) {
             LOG_INFO("MQTT configured to use client proxy");
-            enabled = true;
+            enable();
             runASAP = true;
             reconnectCount = 0;
             publishNodeInfo();
@@ -399,7 +401,7 @@ void MQTT::reconnect()
     if (wantsLink()) {
         if (moduleConfig.mqtt.proxy_to_client_enabled) {
             LOG_INFO("MQTT connect via client proxy instead");
-            enabled = true;
+            enable();
             runASAP = true;
             reconnectCount = 0;
 
@@ -454,7 +456,7 @@ void MQTT::reconnect()
         bool connected = pubSub.connect(owner.id, mqttUsername, mqttPassword);
         if (connected) {
             LOG_INFO("MQTT connected");
-            enabled = true; // Start running background process again
+            enable(); // Start running background process again
             runASAP = true;
             reconnectCount = 0;
             isMqttServerAddressPrivate = isPrivateIpAddress(mqttClient->remoteIP());
@@ -592,21 +594,46 @@ void MQTT::publishQueuedMessages()
     if (!env.validDecode || env.packet == NULL || env.channel_id == NULL)
         return;
 
-    auto jsonString = MeshPacketSerializer::JsonSerialize(env.packet);
-    if (jsonString.length() == 0)
-        return;
-
     std::string topicJson;
     if (env.packet->pki_encrypted) {
         topicJson = jsonTopic + "PKI/" + owner.id;
     } else {
         topicJson = jsonTopic + env.channel_id + "/" + owner.id;
     }
-    LOG_INFO("JSON publish message to %s, %u bytes: %s", topicJson.c_str(), jsonString.length(), jsonString.c_str());
-    publish(topicJson.c_str(), jsonString.c_str(), false);
+    publishJson(*env.packet, std::move(topicJson));
 #endif // ARCH_NRF52 NRF52_USE_JSON
 }
 
+#if !defined(ARCH_NRF52) || defined(NRF52_USE_JSON)
+void MQTT::publishJson(const meshtastic_MeshPacket &mp, std::string topicJson)
+{
+    auto publishString = [topicJson](const std::string &jsonString) {
+        if (jsonString.length() == 0 || !mqtt)
+            return;
+        LOG_INFO("JSON publish message to %s, %u bytes: %s", topicJson.c_str(), jsonString.length(), jsonString.c_str());
+        mqtt->publish(topicJson.c_str(), jsonString.c_str(), false);
+    };
+
+    // Traceroutes are serialized with the names from the NodeDB, which only the main loop may read
+    if (mp.which_payload_variant == meshtastic_MeshPacket_decoded_tag &&
+        mp.decoded.portnum == meshtastic_PortNum_TRACEROUTE_APP) {
+        publishString(MeshPacketSerializer::JsonSerialize(&mp));
+        return;
+    }
+
+    // On a busy mesh this is the most expensive thing we do per packet, build the JSON on a worker if there is one.  The job
+    // gets copies of everything the serializer would read from globals, and doesn't log
+    auto packet = std::make_shared<meshtastic_MeshPacket>(mp);
+    auto jsonString = std::make_shared<std::string>();
+    std::string sender = owner.id;
+    concurrency::WorkerPool::submit(
+        [packet, jsonString, sender]() {
+            *jsonString = MeshPacketSerializer::JsonSerialize(packet.get(), false, sender.c_str());
+        },
+        [jsonString, publishString]() { publishString(*jsonString); });
+}
+#endif
+
 void MQTT::onSend(const meshtastic_MeshPacket &mp_encrypted, const meshtastic_MeshPacket &mp_decoded, ChannelIndex chIndex)
 {
     if (mp_encrypted.via_mqtt)
@@ -671,12 +698,7 @@ void MQTT::onSend(const meshtastic_MeshPacket &mp_encrypted, const meshtastic_Me
         if (!moduleConfig.mqtt.json_enabled)
             return;
         // handle json topic
-        auto jsonString = MeshPacketSerializer::JsonSerialize(&mp_decoded);
-        if (jsonString.length() == 0)
-            return;
-        std::string topicJson = jsonTopic + channelId + "/" + owner.id;
-        LOG_INFO("JSON publish message to %s, %u bytes: %s", topicJson.c_str(), jsonString.length(), jsonString.c_str());
-        publish(topicJson.c_str(), jsonString.c_str(), false);
+        publishJson(mp_decoded, jsonTopic + channelId + "/" + owner.id);
 #endif // ARCH_NRF52 NRF52_USE_JSON
     } else {
         LOG_INFO("MQTT not connected, queue packet");
@@ -127,6 +127,11 @@ class MQTT : private concurrency::OSThread
 
     void publishQueuedMessages();
 
+#if !defined(ARCH_NRF52) || defined(NRF52_USE_JSON)
+    /// Publish mp as JSON, serialized on a worker thread if there is one
+    void publishJson(const meshtastic_MeshPacket &mp, std::string topicJson);
+#endif
+
     void publishNodeInfo();
 
     // Check if we should report unencrypted information about our node for consumption by a map
@@ -30,6 +30,7 @@
 std::map<configNames, int> settingsMap;
 std::map<configNames, std::string> settingsStrings;
 std::ofstream traceFile;
+std::ofstream binaryLogFile;
 Ch341Hal *ch341Hal = nullptr;
 char *configPath = nullptr;
 char *optionMac = nullptr;
@@ -304,6 +305,14 @@ void portduinoSetup()
             exit(EXIT_FAILURE);
         }
     }
+    if (settingsStrings[binaryLogFilename] != "") {
+        try {
+            binaryLogFile.open(settingsStrings[binaryLogFilename], std::ios::out | std::ios::app | std::ios::binary);
+        } catch (std::ofstream::failure &e) {
+            std::cout << "*** binaryLogFile Exception " << e.what() << std::endl;
+            exit(EXIT_FAILURE);
+        }
+    }
 
     return;
 }
@@ -346,6 +355,7 @@ bool loadConfig(const char *configPath)
                 settingsMap[logoutputlevel] = level_error;
             }
             settingsStrings[traceFilename] = yamlConfig["Logging"]["TraceFile"].as<std::string>("");
+            settingsStrings[binaryLogFilename] = yamlConfig["Logging"]["BinaryLogFile"].as<std::string>("");
             if (yamlConfig["Logging"]["AsciiLogs"]) {
                 // Default is !isatty(1) but can be set explicitly in config.yaml
                 settingsMap[ascii_logs] = yamlConfig["Logging"]["AsciiLogs"].as<bool>();
@@ -535,6 +545,7 @@ bool loadConfig(const char *configPath)
         if (yamlConfig["General"]) {
             settingsMap[maxnodes] = (yamlConfig["General"]["MaxNodes"]).as<int>(200);
             settingsMap[maxtophone] = (yamlConfig["General"]["MaxMessageQueue"]).as<int>(100);
+            settingsMap[workerthreads] = (yamlConfig["General"]["WorkerThreads"]).as<int>(0);
             settingsStrings[config_directory] = (yamlConfig["General"]["ConfigDirectory"]).as<std::string>("");
             if ((yamlConfig["General"]["MACAddress"]).as<std::string>("") != "" &&
                 (yamlConfig["General"]["MACAddressSource"]).as<std::string>("") != "") {
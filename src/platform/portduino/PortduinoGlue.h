@@ -78,6 +78,7 @@ enum configNames {
     pointerDevice,
     logoutputlevel,
     traceFilename,
+    binaryLogFilename,
     webserver,
     webserverport,
     webserverrootpath,
@@ -85,6 +86,7 @@ enum configNames {
     websslcertpath,
     maxtophone,
     maxnodes,
+    workerthreads,
     ascii_logs,
     config_directory,
     mac_address
@@ -96,6 +98,7 @@ enum { level_error, level_warn, level_info, level_debug, level_trace };
 extern std::map<configNames, int> settingsMap;
 extern std::map<configNames, std::string> settingsStrings;
 extern std::ofstream traceFile;
+extern std::ofstream binaryLogFile;
 extern Ch341Hal *ch341Hal;
 int initGPIOPin(int pinNum, std::string gpioChipname, int line);
 bool loadConfig(const char *configPath);
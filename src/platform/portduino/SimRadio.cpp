@@ -87,6 +87,7 @@ void SimRadio::completeSending()
     sendingPacket = NULL;
 
     if (p) {
+        trace(RADIO_TRACE_TX_DONE, 0, p->id);
         txGood++;
         if (!isFromUs(p))
             txRelay++;
@@ -128,13 +129,14 @@ bool SimRadio::isChannelActive()
 }
 
 /** Attempt to cancel a previously sent packet.  Returns true if a packet was found we could cancel */
-bool SimRadio::cancelSending(NodeNum from, PacketId id)
+bool SimRadio::cancelSending(NodeNum from, PacketId id, RadioTraceCancelReason reason)
 {
     auto p = txQueue.remove(from, id);
     if (p)
         packetPool.release(p); // free the packet we just removed
 
     bool result = (p != NULL);
+    trace(RADIO_TRACE_TX_CANCEL, reason | (result ? RADIO_TRACE_CANCEL_REMOVED : 0), id);
     LOG_DEBUG("cancelSending id=0x%x, removed=%d", id, result);
     return result;
 }
@@ -169,14 +171,16 @@ void SimRadio::onNotify(uint32_t notification)
             } else {
                 if (isChannelActive()) { // check if there is currently a LoRa packet on the channel
                     // LOG_DEBUG("Channel is active: set random delay");
+                    trace(RADIO_TRACE_CHANNEL_BUSY);
                     setTransmitDelay(); // reset random delay
                 } else {
                     // Send any outgoing packets we have ready
                     meshtastic_MeshPacket *txp = txQueue.dequeue();
                     assert(txp);
+                    uint32_t xmitMsec = getPacketTime(txp);
+                    trace(RADIO_TRACE_TX_START, xmitMsec, txp->id);
                     startSend(txp);
                     // Packet has been sent, count it toward our TX airtime utilization.
-                    uint32_t xmitMsec = getPacketTime(txp);
                     airTime->logAirtime(TX_LOG, xmitMsec);
 
                     notifyLater(xmitMsec, ISR_TX, false); // Model the time it is busy sending
@@ -298,6 +302,7 @@ void SimRadio::handleReceiveInterrupt()
 
     LOG_DEBUG("HANDLE RECEIVE INTERRUPT");
     rxGood++;
+    trace(RADIO_TRACE_RX_DONE, getPacketLength(receivingPacket), receivingPacket->id);
 
     meshtastic_MeshPacket *mp = packetPool.allocCopy(*receivingPacket); // keep a copy in packetPool
     packetPool.release(receivingPacket);                                // release the original
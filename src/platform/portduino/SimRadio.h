@@ -2,6 +2,7 @@
 
 #include "MeshPacketQueue.h"
 #include "RadioInterface.h"
+#include "RadioTrace.h"
 #include "api/WiFiServerAPI.h"
 #include "concurrency/NotifiedWorkerThread.h"
 
@@ -13,6 +14,12 @@ class SimRadio : public RadioInterface, protected concurrency::NotifiedWorkerThr
 
     MeshPacketQueue txQueue = MeshPacketQueue(MAX_TX_QUEUE);
 
+    /** Add an event to the radio trace, tagged with the current depth of our TX queue */
+    void trace(RadioTraceEventType type, uint16_t arg16 = 0, uint32_t arg32 = 0)
+    {
+        radioTrace.record(type, txQueue.getMaxLen() - txQueue.getFree(), arg16, arg32);
+    }
+
   public:
     SimRadio();
 
@@ -31,7 +38,8 @@ class SimRadio : public RadioInterface, protected concurrency::NotifiedWorkerThr
     virtual bool isActivelyReceiving();
 
     /** Attempt to cancel a previously sent packet.  Returns true if a packet was found we could cancel */
-    virtual bool cancelSending(NodeNum from, PacketId id) override;
+    virtual bool cancelSending(NodeNum from, PacketId id,
+                               RadioTraceCancelReason reason = RADIO_TRACE_CANCEL_OTHER) override;
 
     /**
      * Start waiting to receive a message
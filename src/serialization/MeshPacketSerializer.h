@@ -6,7 +6,11 @@ static const char hexChars[16] = {'0', '1', '2', '3', '4', '5', '6', '7', '8', '
 class MeshPacketSerializer
 {
   public:
-    static std::string JsonSerialize(const meshtastic_MeshPacket *mp, bool shouldLog = true);
+    /**
+     * @param sender our node id for the "sender" field, owner.id if NULL.  Pass a copy (and shouldLog false) when serializing
+     * off the main loop
+     */
+    static std::string JsonSerialize(const meshtastic_MeshPacket *mp, bool shouldLog = true, const char *sender = NULL);
     static std::string JsonSerializeEncrypted(const meshtastic_MeshPacket *mp);
 
   private:
@@ -14,7 +14,7 @@
 StaticJsonDocument<1024> jsonObj;
 StaticJsonDocument<1024> arrayObj;
 
-std::string MeshPacketSerializer::JsonSerialize(const meshtastic_MeshPacket *mp, bool shouldLog)
+std::string MeshPacketSerializer::JsonSerialize(const meshtastic_MeshPacket *mp, bool shouldLog, const char *sender)
 {
     // the created jsonObj is immutable after creation, so
     // we need to do the heavy lifting before assembling it.
@@ -297,7 +297,7 @@ std::string MeshPacketSerializer::JsonSerialize(const meshtastic_MeshPacket *mp,
     jsonObj["from"] = (unsigned int)mp->from;
     jsonObj["channel"] = (unsigned int)mp->channel;
     jsonObj["type"] = msgType.c_str();
-    jsonObj["sender"] = owner.id;
+    jsonObj["sender"] = sender ? sender : owner.id;
     if (mp->rx_rssi != 0)
         jsonObj["rssi"] = (int)mp->rx_rssi;
     if (mp->rx_snr != 0)
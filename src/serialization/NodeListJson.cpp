@@ -0,0 +1,209 @@
+#include "NodeListJson.h"
+#include <algorithm>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+// Same as JSONValue::Stringify() does for numbers
+static void appendNumber(std::string &json, double value)
+{
+    if (isinf(value) || isnan(value)) {
+        json += "null";
+        return;
+    }
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%.15g", value);
+    json += buf;
+}
+
+// Escaped like JSONValue::StringifyString(), without building a std::string for it
+static void appendString(std::string &json, const char *str)
+{
+    static const char hex[] = "0123456789ABCDEF";
+    json += '"';
+    for (; *str; str++) {
+        char chr = *str;
+        if (chr == '"' || chr == '\\' || chr == '/') {
+            json += '\\';
+            json += chr;
+        } else if (chr == '\b') {
+            json += "\\b";
+        } else if (chr == '\f') {
+            json += "\\f";
+        } else if (chr == '\n') {
+            json += "\\n";
+        } else if (chr == '\r') {
+            json += "\\r";
+        } else if (chr == '\t') {
+            json += "\\t";
+        } else if (chr < ' ' || chr > 126) {
+            json += "\\u";
+            for (int i = 0; i < 4; i++) {
+                json += hex[(chr >> 12) & 0xf];
+                chr <<= 4;
+            }
+        } else {
+            json += chr;
+        }
+    }
+    json += '"';
+}
+
+/// Add "name": with a comma before it if it isn't the first in the object
+static void appendKey(std::string &json, const char *name)
+{
+    if (json.back() != '{')
+        json += ',';
+    json += '"';
+    json += name;
+    json += "\":";
+}
+
+NodeListJson::NodeListJson(const meshtastic_NodeInfoLite *nodes, size_t numNodes, const Query &query) : fields(query.fields)
+{
+    for (size_t i = 0; i < numNodes; i++) {
+        const meshtastic_NodeInfoLite &n = nodes[i];
+        if (n.has_user && n.num > query.cursor && n.last_heard >= query.sinceLastHeard)
+            page.push_back({n.num, (uint32_t)i});
+    }
+    auto byNum = [](const Entry &a, const Entry &b) { return a.num < b.num; };
+    if (query.limit && page.size() > query.limit) {
+        std::partial_sort(page.begin(), page.begin() + query.limit, page.end(), byNum);
+        page.resize(query.limit);
+        page.shrink_to_fit();
+        more = true;
+    } else {
+        std::sort(page.begin(), page.end(), byNum);
+    }
+}
+
+uint16_t NodeListJson::parseFields(const char *list)
+{
+    static const struct {
+        const char *name;
+        uint16_t field;
+    } names[] = {{"hw_model", NODE_FIELD_HW_MODEL},       {"id", NODE_FIELD_ID},
+                 {"last_heard", NODE_FIELD_LAST_HEARD},   {"long_name", NODE_FIELD_LONG_NAME},
+                 {"mac_address", NODE_FIELD_MAC_ADDRESS}, {"position", NODE_FIELD_POSITION},
+                 {"short_name", NODE_FIELD_SHORT_NAME},   {"snr", NODE_FIELD_SNR},
+                 {"via_mqtt", NODE_FIELD_VIA_MQTT}};
+
+    uint16_t fields = 0;
+    while (list && *list) {
+        const char *end = strchr(list, ',');
+        size_t len = end ? (size_t)(end - list) : strlen(list);
+        for (auto &n : names) {
+            if (strlen(n.name) == len && strncmp(n.name, list, len) == 0)
+                fields |= n.field;
+        }
+        list = end ? end + 1 : NULL;
+    }
+    return fields ? fields : NODE_FIELD_ALL;
+}
+
+// The keys in the order JSONValue puts them, so the document is the same as it always was
+void NodeListJson::writeNode(std::string &json, const meshtastic_NodeInfoLite &node)
+{
+    json += '{';
+    if (fields & NODE_FIELD_HW_MODEL) {
+        appendKey(json, "hw_model");
+        appendNumber(json, node.user.hw_model);
+    }
+    if (fields & NODE_FIELD_ID) {
+        char id[16];
+        snprintf(id, sizeof(id), "\"!%08x\"", node.num);
+        appendKey(json, "id");
+        json += id;
+    }
+    if (fields & NODE_FIELD_LAST_HEARD) {
+        appendKey(json, "last_heard");
+        appendNumber(json, (int)node.last_heard);
+    }
+    if (fields & NODE_FIELD_LONG_NAME) {
+        appendKey(json, "long_name");
+        appendString(json, node.user.long_name);
+    }
+    if (fields & NODE_FIELD_MAC_ADDRESS) {
+        char macStr[20];
+        snprintf(macStr, sizeof(macStr), "\"%02X:%02X:%02X:%02X:%02X:%02X\"", node.user.macaddr[0], node.user.macaddr[1],
+                 node.user.macaddr[2], node.user.macaddr[3], node.user.macaddr[4], node.user.macaddr[5]);
+        appendKey(json, "mac_address");
+        json += macStr;
+    }
+    if (fields & NODE_FIELD_POSITION) {
+        appendKey(json, "position");
+        // Like NodeDB::hasValidPosition()
+        if (node.has_position && (node.position.latitude_i != 0 || node.position.longitude_i != 0)) {
+            json += "{\"altitude\":";
+            appendNumber(json, (int)node.position.altitude);
+            json += ",\"latitude\":";
+            appendNumber(json, (float)node.position.latitude_i * 1e-7);
+            json += ",\"longitude\":";
+            appendNumber(json, (float)node.position.longitude_i * 1e-7);
+            json += '}';
+        } else {
+            json += "null";
+        }
+    }
+    if (fields & NODE_FIELD_SHORT_NAME) {
+        appendKey(json, "short_name");
+        appendString(json, node.user.short_name);
+    }
+    if (fields & NODE_FIELD_SNR) {
+        appendKey(json, "snr");
+        appendNumber(json, node.snr);
+    }
+    if (fields & NODE_FIELD_VIA_MQTT) {
+        appendKey(json, "via_mqtt");
+        json += node.via_mqtt ? "\"true\"" : "\"false\"";
+    }
+    json += '}';
+}
+
+bool NodeListJson::writeNext(Print &out, const meshtastic_NodeInfoLite *nodes, size_t numNodes)
+{
+    std::string json;
+    switch (state) {
+    case START:
+        json = "{\"data\":{\"nodes\":[";
+        state = page.empty() ? END : NODES;
+        break;
+
+    case NODES: {
+        const Entry &e = page[next++];
+        const meshtastic_NodeInfoLite *node = NULL;
+        if (e.index < numNodes && nodes[e.index].num == e.num) {
+            node = &nodes[e.index];
+        } else {
+            for (size_t i = 0; i < numNodes && !node; i++) {
+                if (nodes[i].num == e.num)
+                    node = &nodes[i];
+            }
+        }
+        if (node) {
+            if (wroteNode)
+                json += ',';
+            writeNode(json, *node);
+            wroteNode = true;
+        }
+        if (next == page.size())
+            state = END;
+        break;
+    }
+
+    case END:
+        json = "]";
+        if (more) {
+            json += ",\"next_cursor\":";
+            appendNumber(json, page.back().num);
+        }
+        json += "},\"status\":\"ok\"}";
+        state = DONE;
+        break;
+
+    case DONE:
+        return false;
+    }
+    out.write((const uint8_t *)json.data(), json.size());
+    return true;
+}
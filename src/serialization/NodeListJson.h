@@ -0,0 +1,67 @@
+#pragma once
+
+#include "mesh/generated/meshtastic/deviceonly.pb.h"
+#include <Print.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+/// Fields of a node in /json/nodes, for ?fields=
+enum NodeListJsonField : uint16_t {
+    NODE_FIELD_HW_MODEL = 1 << 0,
+    NODE_FIELD_ID = 1 << 1,
+    NODE_FIELD_LAST_HEARD = 1 << 2,
+    NODE_FIELD_LONG_NAME = 1 << 3,
+    NODE_FIELD_MAC_ADDRESS = 1 << 4,
+    NODE_FIELD_POSITION = 1 << 5,
+    NODE_FIELD_SHORT_NAME = 1 << 6,
+    NODE_FIELD_SNR = 1 << 7,
+    NODE_FIELD_VIA_MQTT = 1 << 8,
+    NODE_FIELD_ALL = (1 << 9) - 1,
+};
+
+/**
+ * The /json/nodes document, written a node at a time so a big NodeDB never has to be in RAM as JSONValues.
+ *
+ * Nodes come in order of node number.  A page ends with next_cursor, the number of its last node; asking again with
+ * ?cursor= set to it continues after that node, however NodeDB has reordered itself in between.  Without a limit every
+ * node is sent, in the same document the web client always got.
+ */
+class NodeListJson
+{
+  public:
+    struct Query {
+        uint32_t cursor = 0;         // only nodes with a higher number
+        uint32_t limit = 0;          // at most this many, 0 for all of them
+        uint32_t sinceLastHeard = 0; // only nodes heard at or after this time
+        uint16_t fields = NODE_FIELD_ALL;
+    };
+
+    /// Pick the nodes of the page, costs 8 bytes of RAM for each
+    NodeListJson(const meshtastic_NodeInfoLite *nodes, size_t numNodes, const Query &query);
+
+    /**
+     * Write the next part of the document: its start, one node or its end.  Pass the nodes again, they may have moved;
+     * a node that has gone since the page was picked is left out.
+     * @return false once the document is complete
+     */
+    bool writeNext(Print &out, const meshtastic_NodeInfoLite *nodes, size_t numNodes);
+
+    /// @return the fields named in a comma separated list, NODE_FIELD_ALL if it names none we know
+    static uint16_t parseFields(const char *list);
+
+  private:
+    struct Entry {
+        uint32_t num;
+        uint32_t index; // where it was when the page was picked
+    };
+    std::vector<Entry> page;
+    bool more = false; // there are nodes after this page
+    uint16_t fields;
+    size_t next = 0;
+    enum { START, NODES, END, DONE } state = START;
+    bool wroteNode = false;
+
+    void writeNode(std::string &json, const meshtastic_NodeInfoLite &node);
+};
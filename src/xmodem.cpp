@@ -50,6 +50,7 @@
 
 #include "xmodem.h"
 #include "SPILock.h"
+#include "mesh/RadioTrace.h"
 
 #ifdef FSCom
 
@@ -136,6 +137,11 @@ void XModemAdapter::handlePacket(meshtastic_XModem xmodemPacket)
                 break;
             } else { // Transmit this file from Flash
                 LOG_INFO("XModem: Transmit file %s", filename);
+#if !MESHTASTIC_EXCLUDE_RADIO_TRACE
+                // The radio trace lives in RAM, take a fresh snapshot of it to send
+                if (strcmp(filename, RADIO_TRACE_FILENAME) == 0)
+                    radioTrace.saveToFile(filename);
+#endif
                 spiLock->lock();
                 file = FSCom.open(filename, FILE_O_READ);
                 spiLock->unlock();
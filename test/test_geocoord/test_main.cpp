@@ -0,0 +1,136 @@
+#include "gps/GeoCoord.h"
+
+#include "TestUtil.h"
+#include <Arduino.h>
+#include <unity.h>
+
+#define NUM_PAIRS 2000
+
+struct PointPair {
+    int32_t latA, lngA, latB, lngB;
+};
+
+static PointPair pairs[NUM_PAIRS];
+
+/// Small deterministic PRNG, so every run checks the same points
+static uint32_t nextRandom()
+{
+    static uint32_t state = 0x12345678;
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+static int32_t randomIn(int32_t lo, int32_t hi)
+{
+    return lo + (int32_t)(nextRandom() % (uint32_t)(hi - lo + 1));
+}
+
+/// Haversine in double precision, stable for short distances unlike the acos() form of latLongToMeter()
+static double referenceMeters(const PointPair &p)
+{
+    double a = p.latA * 1e-7 / DEG_CONVERT, b = p.latB * 1e-7 / DEG_CONVERT;
+    double dLat = b - a, dLng = (p.lngB - (double)p.lngA) * 1e-7 / DEG_CONVERT;
+    double h = sin(dLat / 2) * sin(dLat / 2) + cos(a) * cos(b) * sin(dLng / 2) * sin(dLng / 2);
+    return 2 * 6366000 * asin(sqrt(h));
+}
+
+static double angleDiffDegrees(double a, double b)
+{
+    double d = fmod((a - b) * DEG_CONVERT + 540, 360) - 180;
+    return fabs(d);
+}
+
+void setUp(void)
+{
+    // Pairs within the fast range, up to GEO_FAST_MAX_LAT_I and anywhere in longitude (incl. across the antimeridian)
+    for (int i = 0; i < NUM_PAIRS; i++) {
+        PointPair &p = pairs[i];
+        p.latA = randomIn(-GEO_FAST_MAX_LAT_I + GEO_FAST_MAX_SPAN_I, GEO_FAST_MAX_LAT_I - GEO_FAST_MAX_SPAN_I);
+        p.lngA = randomIn(-1799999999, 1799999999);
+        // Mostly mesh-sized distances, some up to the limit
+        int32_t span = (i % 4) ? 100000 : GEO_FAST_MAX_SPAN_I;
+        p.latB = p.latA + randomIn(-span, span);
+        int64_t lngB = (int64_t)p.lngA + randomIn(-span, span);
+        if (lngB > 1800000000)
+            lngB -= 3600000000LL;
+        else if (lngB < -1800000000)
+            lngB += 3600000000LL;
+        p.lngB = (int32_t)lngB;
+    }
+}
+
+void tearDown(void) {}
+
+void test_sin_cos(void)
+{
+    double worst = 0;
+    for (int32_t deg_i = -1800000000; deg_i < 1800000000; deg_i += 1234567) {
+        double rad = deg_i * 1e-7 / DEG_CONVERT;
+        worst = fmax(worst, fabs(GeoCoord::cosFixed(deg_i) / 65536.0 - cos(rad)));
+        worst = fmax(worst, fabs(GeoCoord::sinFixed(deg_i) / 65536.0 - sin(rad)));
+    }
+    TEST_ASSERT_TRUE(worst < 2e-5);
+    TEST_ASSERT_EQUAL(0, GeoCoord::cosFixed(900000000));
+    TEST_ASSERT_EQUAL(-65536, GeoCoord::cosFixed(1800000000));
+    TEST_ASSERT_EQUAL(65536, GeoCoord::sinFixed(900000000));
+}
+
+void test_distance_accuracy(void)
+{
+    double worstRel = 0, worstAbs = 0;
+    for (int i = 0; i < NUM_PAIRS; i++) {
+        const PointPair &p = pairs[i];
+        double ref = referenceMeters(p);
+        double err = fabs(GeoCoord::latLongToMeterFast(p.latA, p.lngA, p.latB, p.lngB) - ref);
+        worstAbs = fmax(worstAbs, err);
+        if (ref > 100)
+            worstRel = fmax(worstRel, err / ref);
+    }
+
+    TEST_ASSERT_TRUE(worstRel < 1e-4);
+    TEST_ASSERT_TRUE(worstAbs < 2);
+
+    // Same point, and points outside the fast range use the exact version
+    TEST_ASSERT_EQUAL_FLOAT(0, GeoCoord::latLongToMeterFast(473974000, 85000000, 473974000, 85000000));
+    TEST_ASSERT_EQUAL_FLOAT(GeoCoord::latLongToMeter(47.3974, 8.5, 40.7128, -74.006),
+                            GeoCoord::latLongToMeterFast(473974000, 85000000, 407128000, -740060000));
+}
+
+void test_bearing_accuracy(void)
+{
+    double worst = 0;
+    for (int i = 0; i < NUM_PAIRS; i++) {
+        const PointPair &p = pairs[i];
+        if (referenceMeters(p) < 100)
+            continue;
+        float exact = GeoCoord::bearing(p.latA * 1e-7, p.lngA * 1e-7, p.latB * 1e-7, p.lngB * 1e-7);
+        worst = fmax(worst, angleDiffDegrees(GeoCoord::bearingFast(p.latA, p.lngA, p.latB, p.lngB), exact));
+    }
+
+    TEST_ASSERT_TRUE(worst < 0.3);
+
+    // The four main directions
+    TEST_ASSERT_FLOAT_WITHIN(0.001, 0, GeoCoord::bearingFast(0, 0, 100000, 0));
+    TEST_ASSERT_FLOAT_WITHIN(0.001, PI / 2, GeoCoord::bearingFast(0, 0, 0, 100000));
+    TEST_ASSERT_FLOAT_WITHIN(0.001, PI, fabs(GeoCoord::bearingFast(0, 0, -100000, 0)));
+    TEST_ASSERT_FLOAT_WITHIN(0.001, -PI / 2, GeoCoord::bearingFast(0, 0, 0, -100000));
+}
+
+void setup()
+{
+    // NOTE!!! Wait for >2 secs
+    // if board doesn't support software reset via Serial.DTR/RTS
+    delay(10);
+    delay(2000);
+
+    initializeTestEnvironment();
+    UNITY_BEGIN(); // IMPORTANT LINE!
+    RUN_TEST(test_sin_cos);
+    RUN_TEST(test_distance_accuracy);
+    RUN_TEST(test_bearing_accuracy);
+    exit(UNITY_END()); // stop unit testing
+}
+
+void loop() {}
@@ -0,0 +1,208 @@
+#include "gps/GNSSFramer.h"
+
+#include "TestUtil.h"
+#include <Arduino.h>
+#include <string.h>
+#include <unity.h>
+
+// One epoch of a u-blox M8 configured like GPS::setup() does for NMEA: RMC, GGA and GSA
+static const char nmeaEpoch[] = "$GNRMC,123519.00,A,4807.03800,N,01131.00000,E,0.022,,230394,,,A,V*14\r\n"
+                                "$GNGGA,123519.00,4807.03800,N,01131.00000,E,1,08,0.94,545.4,M,46.9,M,,*43\r\n"
+                                "$GNGSA,A,3,10,23,12,25,32,31,,,,,,,1.63,0.94,1.33,1*0E\r\n";
+
+// The same epoch as UBX-NAV-PVT
+static const uint8_t navPvtEpoch[] = {
+    0xB5, 0x62, 0x01, 0x07, 0x5C, 0x00, 0xA8, 0xB3, 0xD4, 0x01, 0xE8, 0x07, 0x03, 0x17, 0x0C, 0x23, 0x13, 0x07, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03, 0x01, 0x00, 0x08, 0xCB, 0x4D, 0xDD, 0x06, 0x08, 0x1E, 0xAE, 0x1C, 0xAC, 0x09,
+    0x09, 0x00, 0x78, 0x52, 0x08, 0x00, 0xDC, 0x05, 0x00, 0x00, 0xC4, 0x09, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x63, 0x02, 0x00, 0x00, 0x80, 0x36, 0x8B, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0xA3, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x64, 0xBA};
+
+// UBX-ACK-ACK for UBX-CFG-RATE
+static const uint8_t ubxAck[] = {0xB5, 0x62, 0x05, 0x01, 0x02, 0x00, 0x06, 0x08, 0x16, 0x3F};
+
+// CAS-ACK-ACK for CAS-CFG-NAVX
+static const uint8_t casAck[] = {0xBA, 0xCE, 0x04, 0x00, 0x05, 0x01, 0x06, 0x07, 0x00, 0x00, 0x0A, 0x07, 0x05, 0x01};
+
+static GNSSFramer *framer;
+
+/// Feed buf and return the number of frames completed, the last one is left in framer->frame()
+static int feedAll(const void *buf, size_t len)
+{
+    int frames = 0;
+    for (size_t i = 0; i < len; i++)
+        frames += framer->feed(((const uint8_t *)buf)[i]);
+    return frames;
+}
+
+void setUp(void)
+{
+    framer = new GNSSFramer();
+}
+
+void tearDown(void)
+{
+    delete framer;
+}
+
+void test_nmea_sentences(void)
+{
+    const char *rmc = "$GNRMC,123519.00,A,4807.03800,N,01131.00000,E,0.022,,230394,,,A,V*14\r\n";
+    TEST_ASSERT_EQUAL(1, feedAll(rmc, strlen(rmc)));
+    const GNSSFrame &f = framer->frame();
+    TEST_ASSERT_EQUAL(GNSS_FRAME_NMEA, f.type);
+    TEST_ASSERT_EQUAL(strlen(rmc), f.len);
+    TEST_ASSERT_EQUAL_MEMORY(rmc, f.data, f.len);
+    TEST_ASSERT_EQUAL_MEMORY("GNRMC,", f.payload, 6);
+    TEST_ASSERT_EQUAL('*', f.payload[f.payloadLen]);
+
+    TEST_ASSERT_EQUAL(3, feedAll(nmeaEpoch, strlen(nmeaEpoch)));
+    TEST_ASSERT_EQUAL(4, framer->stats().nmeaFrames);
+    TEST_ASSERT_EQUAL(0, framer->stats().badFrames);
+    TEST_ASSERT_EQUAL(0, framer->stats().discarded);
+}
+
+void test_nmea_bad_checksum(void)
+{
+    const char *corrupted = "$GNGGA,123519.00,4807.03800,N,01131.00000,E,1,09,0.94,545.4,M,46.9,M,,*43\r\n";
+    const char *cutShort = "$GNGGA,123519.00,4807.0$GNRMC";
+    TEST_ASSERT_EQUAL(0, feedAll(corrupted, strlen(corrupted)));
+    TEST_ASSERT_EQUAL(0, feedAll(cutShort, strlen(cutShort)));
+    TEST_ASSERT_EQUAL(2, framer->stats().badFrames);
+}
+
+void test_nmea_no_checksum(void)
+{
+    // UC6580 answers its probe without a checksum, that's not a bad line
+    const char *noChecksum = "$PDTINFO,UC6580\r\n";
+    TEST_ASSERT_EQUAL(1, feedAll(noChecksum, strlen(noChecksum)));
+    const GNSSFrame &f = framer->frame();
+    TEST_ASSERT_EQUAL(GNSS_FRAME_NMEA, f.type);
+    TEST_ASSERT_FALSE(f.hasChecksum);
+    TEST_ASSERT_EQUAL(strlen(noChecksum), f.len);
+    TEST_ASSERT_EQUAL_MEMORY(noChecksum, f.data, f.len);
+    TEST_ASSERT_EQUAL(strlen("PDTINFO,UC6580"), f.payloadLen);
+    TEST_ASSERT_EQUAL(1, framer->stats().nmeaNoSum);
+    TEST_ASSERT_EQUAL(0, framer->stats().nmeaFrames);
+    TEST_ASSERT_EQUAL(0, framer->stats().badFrames);
+}
+
+void test_ubx_nav_pvt(void)
+{
+    TEST_ASSERT_EQUAL(1, feedAll(navPvtEpoch, sizeof(navPvtEpoch)));
+    const GNSSFrame &f = framer->frame();
+    TEST_ASSERT_EQUAL(GNSS_FRAME_UBX, f.type);
+    TEST_ASSERT_EQUAL(UBX_CLASS_NAV, f.msgClass);
+    TEST_ASSERT_EQUAL(UBX_NAV_PVT, f.msgId);
+    TEST_ASSERT_EQUAL(92, f.payloadLen);
+
+    UBXNavPvt pvt;
+    TEST_ASSERT_TRUE(parseUBXNavPvt(f, pvt));
+    TEST_ASSERT_EQUAL(2024, pvt.year);
+    TEST_ASSERT_EQUAL(3, pvt.month);
+    TEST_ASSERT_EQUAL(23, pvt.day);
+    TEST_ASSERT_EQUAL(12, pvt.hour);
+    TEST_ASSERT_EQUAL(35, pvt.min);
+    TEST_ASSERT_EQUAL(19, pvt.sec);
+    TEST_ASSERT_TRUE(pvt.timeValid);
+    TEST_ASSERT_EQUAL(3, pvt.fixType);
+    TEST_ASSERT_TRUE(pvt.fixOK);
+    TEST_ASSERT_FALSE(pvt.diffSoln);
+    TEST_ASSERT_EQUAL(8, pvt.numSV);
+    TEST_ASSERT_EQUAL(481173000, pvt.lat);
+    TEST_ASSERT_EQUAL(115166667, pvt.lon);
+    TEST_ASSERT_EQUAL(592300, pvt.height);
+    TEST_ASSERT_EQUAL(545400, pvt.hMSL);
+    TEST_ASSERT_EQUAL(1500, pvt.hAcc);
+    TEST_ASSERT_EQUAL(611, pvt.gSpeed);
+    TEST_ASSERT_EQUAL(9123456, pvt.headMot);
+    TEST_ASSERT_EQUAL(163, pvt.pDOP);
+
+    // An ACK is a valid frame, but not a NAV-PVT
+    TEST_ASSERT_EQUAL(1, feedAll(ubxAck, sizeof(ubxAck)));
+    TEST_ASSERT_FALSE(parseUBXNavPvt(framer->frame(), pvt));
+}
+
+void test_cas_ack(void)
+{
+    TEST_ASSERT_EQUAL(1, feedAll(casAck, sizeof(casAck)));
+    const GNSSFrame &f = framer->frame();
+    TEST_ASSERT_EQUAL(GNSS_FRAME_CAS, f.type);
+    TEST_ASSERT_EQUAL(0x05, f.msgClass);
+    TEST_ASSERT_EQUAL(0x01, f.msgId);
+    TEST_ASSERT_EQUAL(4, f.payloadLen);
+    TEST_ASSERT_EQUAL(0x06, f.payload[0]);
+    TEST_ASSERT_EQUAL(0x07, f.payload[1]);
+}
+
+void test_resync(void)
+{
+    // Line noise, a sentence cut short by a binary frame, and a binary frame with a flipped bit
+    uint8_t corrupted[sizeof(ubxAck)];
+    memcpy(corrupted, ubxAck, sizeof(ubxAck));
+    corrupted[7] ^= 0x01;
+
+    TEST_ASSERT_EQUAL(0, feedAll("\x00\xff junk", 7));
+    TEST_ASSERT_EQUAL(0, feedAll("$GNGGA,123519.00,48", 19));
+    TEST_ASSERT_EQUAL(1, feedAll(ubxAck, sizeof(ubxAck)));
+    TEST_ASSERT_EQUAL(GNSS_FRAME_UBX, framer->frame().type);
+    TEST_ASSERT_EQUAL(0, feedAll(corrupted, sizeof(corrupted)));
+    TEST_ASSERT_EQUAL(3, feedAll(nmeaEpoch, strlen(nmeaEpoch)));
+
+    TEST_ASSERT_EQUAL(7, framer->stats().discarded);
+    TEST_ASSERT_EQUAL(2, framer->stats().badFrames);
+    TEST_ASSERT_EQUAL(1, framer->stats().ubxFrames);
+    TEST_ASSERT_EQUAL(3, framer->stats().nmeaFrames);
+}
+
+void test_oversized_frame(void)
+{
+    // A UBX header claiming a payload bigger than we can hold must not stop us from finding the next frame
+    const uint8_t huge[] = {0xB5, 0x62, 0x0A, 0x04, 0xFF, 0xFF};
+    TEST_ASSERT_EQUAL(0, feedAll(huge, sizeof(huge)));
+    TEST_ASSERT_EQUAL(1, framer->stats().overflows);
+    TEST_ASSERT_EQUAL(1, feedAll(navPvtEpoch, sizeof(navPvtEpoch)));
+}
+
+/// Replay the captured epochs many times, the framer must neither lose nor invent frames across them
+void test_replay(void)
+{
+    const int epochs = 1000;
+    const size_t nmeaLen = strlen(nmeaEpoch);
+
+    int frames = 0;
+    for (int i = 0; i < epochs; i++)
+        frames += feedAll(nmeaEpoch, nmeaLen);
+    TEST_ASSERT_EQUAL(3 * epochs, frames);
+
+    frames = 0;
+    UBXNavPvt pvt;
+    for (int i = 0; i < epochs; i++) {
+        frames += feedAll(navPvtEpoch, sizeof(navPvtEpoch));
+        TEST_ASSERT_TRUE(parseUBXNavPvt(framer->frame(), pvt));
+    }
+    TEST_ASSERT_EQUAL(epochs, frames);
+    TEST_ASSERT_EQUAL(0, framer->stats().badFrames);
+}
+
+void setup()
+{
+    // NOTE!!! Wait for >2 secs
+    // if board doesn't support software reset via Serial.DTR/RTS
+    delay(10);
+    delay(2000);
+
+    initializeTestEnvironment();
+    UNITY_BEGIN(); // IMPORTANT LINE!
+    RUN_TEST(test_nmea_sentences);
+    RUN_TEST(test_nmea_bad_checksum);
+    RUN_TEST(test_nmea_no_checksum);
+    RUN_TEST(test_ubx_nav_pvt);
+    RUN_TEST(test_cas_ack);
+    RUN_TEST(test_resync);
+    RUN_TEST(test_oversized_frame);
+    RUN_TEST(test_replay);
+    exit(UNITY_END()); // stop unit testing
+}
+
+void loop() {}
@@ -0,0 +1,247 @@
+#include "BinaryLog.h"
+#include "RedirectablePrint.h"
+
+#include "TestUtil.h"
+#include <Arduino.h>
+#include <stdio.h>
+#include <string.h>
+#include <unity.h>
+
+#ifdef ARCH_PORTDUINO
+#include "platform/portduino/PortduinoGlue.h"
+#include <string>
+
+/// Stands in for the serial port, keeps what it was sent
+class CapturePrint : public Print
+{
+  public:
+    std::string out;
+    virtual size_t write(uint8_t c) override
+    {
+        out += (char)c;
+        return 1;
+    }
+};
+
+/// What vsnprintf makes of the arguments, and what rendering them after a round trip through the encoding makes
+static void checkRender(const char *format, ...)
+{
+    char expected[200], actual[200];
+    uint8_t args[200];
+    size_t argsLen;
+    uint32_t id;
+    TEST_ASSERT_TRUE(BinaryLog::formatId(format, id));
+
+    va_list arg;
+    va_start(arg, format);
+    vsnprintf(expected, sizeof(expected), format, arg);
+    va_end(arg);
+    va_start(arg, format);
+    TEST_ASSERT_TRUE(BinaryLog::encodeArgs(args, sizeof(args), format, arg, argsLen));
+    va_end(arg);
+    BinaryLog::render(actual, sizeof(actual), format, args, argsLen);
+    TEST_ASSERT_EQUAL_STRING(expected, actual);
+}
+
+/// @return whether the arguments fit in bufLen bytes of args
+static bool encodeInto(uint8_t *args, size_t bufLen, size_t &argsLen, const char *format, ...)
+{
+    va_list arg;
+    va_start(arg, format);
+    bool ok = BinaryLog::encodeArgs(args, bufLen, format, arg, argsLen);
+    va_end(arg);
+    return ok;
+}
+
+static uint64_t getVarint(const uint8_t *buf, size_t &pos)
+{
+    uint64_t v = 0;
+    for (int shift = 0;; shift += 7) {
+        uint8_t b = buf[pos++];
+        v |= (uint64_t)(b & 0x7f) << shift;
+        if (!(b & 0x80))
+            return v;
+    }
+}
+
+/// Split frames like bin/log-decode.py does, @return the number found
+static int splitFrames(const uint8_t *buf, size_t len, uint8_t *types, size_t *payloads, int maxFrames)
+{
+    int n = 0;
+    size_t pos = 0;
+    while (pos < len) {
+        TEST_ASSERT_EQUAL(BINARY_LOG_START1, buf[pos]);
+        TEST_ASSERT_EQUAL(BINARY_LOG_START2, buf[pos + 1]);
+        pos += 2;
+        size_t payloadLen = getVarint(buf, pos);
+        TEST_ASSERT_LESS_THAN(maxFrames, n);
+        types[n] = buf[pos] >> 4;
+        payloads[n++] = pos;
+        pos += payloadLen;
+    }
+    TEST_ASSERT_EQUAL(len, pos);
+    return n;
+}
+
+void setUp(void)
+{
+    settingsMap[logoutputlevel] = level_debug;
+    settingsMap[ascii_logs] = true;
+}
+
+void tearDown(void) {}
+
+void test_render_matches_printf(void)
+{
+    checkRender("no arguments at all");
+    checkRender("%d %i %u %x %X %o %c %%", -42, 7, 3000000000u, 0xbeef, 0xbeef, 8, 'm');
+    checkRender("%08x|%-6d|%+d|% d|%#x|%5.3d", 0x1234, 12, 5, 5, 255, 7);
+    checkRender("%hhu %hd %ld %lu %lld %llu %zu %jd %td", 300, 70000, -5L, 4000000000UL, -1234567890123LL,
+                18446744073709551615ULL, (size_t)12345, (intmax_t)-9, (ptrdiff_t)-3);
+    checkRender("%f %.2f %e %g %10.4f %F", 3.14159, -0.005, 1e-12, 123456789.0, 2.5f, 1.0 / 3);
+    checkRender("[%s] [%10s] [%-4s] [%.3s] [%.*s] [%*d]", "hello", "right", "l", "truncated", 2, "xyz", 6, 42);
+    checkRender("%s %p", (const char *)NULL, (void *)0x1234);
+    checkRender("ends with a newline %d\n", 1);
+
+    // A string that doesn't need to be terminated, with a precision
+    char notTerminated[4] = {'a', 'b', 'c', 'd'};
+    checkRender("%.4s!", notTerminated);
+
+    // The caller falls back to vsnprintf for these
+    uint8_t args[8];
+    size_t argsLen;
+    TEST_ASSERT_FALSE(encodeInto(args, sizeof(args), argsLen, "%s", "longer than eight bytes"));
+    TEST_ASSERT_FALSE(encodeInto(args, sizeof(args), argsLen, "%w", 1));
+    TEST_ASSERT_TRUE(encodeInto(args, sizeof(args), argsLen, "%s", "fits"));
+    TEST_ASSERT_EQUAL(5, argsLen);
+}
+
+void test_frames(void)
+{
+    BinaryLog binaryLog;
+    LogLine line;
+    line.level = MESHTASTIC_LOG_LEVEL_INFO;
+    line.millis = 5000;
+    line.rtcSec = 1700000000;
+    strcpy(line.thread, "Router");
+    line.format = "Packet from 0x%08x, hops %d";
+    uint32_t id;
+    TEST_ASSERT_TRUE(BinaryLog::formatId(line.format, id));
+
+    uint8_t frames[BINARY_LOG_MAX_FRAMES];
+    uint8_t types[8];
+    size_t payloads[8];
+
+    size_t argsLen;
+    TEST_ASSERT_TRUE(encodeInto(line.args, sizeof(line.args), argsLen, line.format, 0x12345678, 3));
+    line.argsLen = argsLen;
+
+    // The first line needs a sync, and the decoder has to be told about the thread
+    size_t len = binaryLog.encode(line, frames, sizeof(frames));
+    TEST_ASSERT_EQUAL(3, splitFrames(frames, len, types, payloads, 8));
+    TEST_ASSERT_EQUAL(BINARY_LOG_SYNC, types[0]);
+    TEST_ASSERT_EQUAL(BINARY_LOG_THREAD, types[1]);
+    TEST_ASSERT_EQUAL(BINARY_LOG_FORMAT, types[2]);
+    TEST_ASSERT_EQUAL(MESHTASTIC_LOG_LEVEL_INFO, frames[payloads[2]] & 0x0f);
+    size_t pos = payloads[2] + 1;
+    TEST_ASSERT_EQUAL(0, getVarint(frames, pos)); // ms since the sync
+    TEST_ASSERT_EQUAL(0, frames[pos++]);          // thread index
+    TEST_ASSERT_EQUAL(id, getVarint(frames, pos));
+
+    char text[64];
+    BinaryLog::render(text, sizeof(text), line.format, line.args, line.argsLen);
+    TEST_ASSERT_EQUAL_STRING("Packet from 0x12345678, hops 3", text);
+
+    // After that only the record, with the time since the previous one
+    line.millis = 5250;
+    len = binaryLog.encode(line, frames, sizeof(frames));
+    TEST_ASSERT_EQUAL(1, splitFrames(frames, len, types, payloads, 8));
+    pos = payloads[0] + 1;
+    TEST_ASSERT_EQUAL(500, getVarint(frames, pos)); // zigzag 250
+
+    // A format built at runtime goes out as text
+    line.format = NULL;
+    strcpy(line.text, "built at runtime");
+    len = binaryLog.encode(line, frames, sizeof(frames));
+    TEST_ASSERT_EQUAL(1, splitFrames(frames, len, types, payloads, 8));
+    TEST_ASSERT_EQUAL(BINARY_LOG_TEXT, types[0]);
+    TEST_ASSERT_EQUAL(0, memcmp(frames + len - strlen(line.text), line.text, strlen(line.text)));
+
+    // Every so often a sync, for decoders that join late
+    for (int i = 3; i < BINARY_LOG_SYNC_RECORDS; i++)
+        TEST_ASSERT_EQUAL(1, splitFrames(frames, binaryLog.encode(line, frames, sizeof(frames)), types, payloads, 8));
+    len = binaryLog.encode(line, frames, sizeof(frames));
+    TEST_ASSERT_EQUAL(3, splitFrames(frames, len, types, payloads, 8));
+    TEST_ASSERT_EQUAL(BINARY_LOG_SYNC, types[0]);
+}
+
+/// A few typical messages
+static void logSome(RedirectablePrint &rp, int rounds)
+{
+    for (int i = 0; i < rounds; i++) {
+        rp.log(MESHTASTIC_LOG_LEVEL_DEBUG, "Received packet from 0x%08x id=0x%08x hops %d/%d rssi=%d snr=%.2f", 0xdeadbeef,
+               i, 3, 3, -97, 6.25);
+        rp.log(MESHTASTIC_LOG_LEVEL_INFO, "Enter state: %s", "ON");
+        rp.log(MESHTASTIC_LOG_LEVEL_DEBUG, "Battery: usbPower=%d, isCharging=%d, batMv=%d, batPct=%d", 0, 0, 4012, 87);
+        rp.log(MESHTASTIC_LOG_LEVEL_DEBUG, "Node status update: %d online, %d total", 12, 214);
+        rp.log(MESHTASTIC_LOG_LEVEL_DEBUG, "Packet RX: %u ms", 123);
+    }
+}
+
+void test_bytes(void)
+{
+    CapturePrint textSink, binarySink;
+    RedirectablePrint textLog(&textSink), binaryLog(&binarySink);
+    binaryLog.setBinary(true);
+
+    logSome(textLog, 200);
+    logSome(binaryLog, 200);
+    TEST_ASSERT_LESS_THAN(textSink.out.length() / 3, binarySink.out.length());
+}
+
+static char writableFormat[] = "Changed at runtime: %d";
+
+void test_format_id(void)
+{
+    uint32_t id;
+    TEST_ASSERT_TRUE(BinaryLog::formatId("A literal: %d", id));
+    // Writable data is part of the executable too, but the decoder can't know what it holds by then
+    TEST_ASSERT_FALSE(BinaryLog::formatId(writableFormat, id));
+    char onStack[] = "On the stack: %d";
+    TEST_ASSERT_FALSE(BinaryLog::formatId(onStack, id));
+    std::string onHeap = "On the heap: %d";
+    TEST_ASSERT_FALSE(BinaryLog::formatId(onHeap.c_str(), id));
+
+    // Sent as text instead
+    CapturePrint sink;
+    RedirectablePrint rp(&sink);
+    rp.setBinary(true);
+    rp.log(MESHTASTIC_LOG_LEVEL_INFO, writableFormat, 42);
+    uint8_t types[8];
+    size_t payloads[8];
+    int n = splitFrames((const uint8_t *)sink.out.data(), sink.out.length(), types, payloads, 8);
+    TEST_ASSERT_TRUE(n > 0);
+    TEST_ASSERT_EQUAL(BINARY_LOG_TEXT, types[n - 1]);
+}
+
+void setup()
+{
+    initializeTestEnvironment();
+    UNITY_BEGIN();
+    RUN_TEST(test_render_matches_printf);
+    RUN_TEST(test_frames);
+    RUN_TEST(test_bytes);
+    RUN_TEST(test_format_id);
+    exit(UNITY_END());
+}
+#else
+void setup()
+{
+    initializeTestEnvironment();
+    LOG_WARN("This test requires ARCH_PORTDUINO");
+    UNITY_BEGIN();
+    UNITY_END();
+}
+#endif
+
+void loop() {}
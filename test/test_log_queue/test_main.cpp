@@ -0,0 +1,171 @@
+#include "LogQueue.h"
+#include "RedirectablePrint.h"
+
+#include "TestUtil.h"
+#include <Arduino.h>
+#include <stdio.h>
+#include <string.h>
+#include <unity.h>
+
+#ifdef ARCH_PORTDUINO
+#include "platform/portduino/PortduinoGlue.h"
+#include <atomic>
+#include <string>
+#include <thread>
+
+#define NUM_PRODUCERS 4
+#define LINES_PER_PRODUCER 5000
+
+/// Stands in for the serial port, keeps what it was sent
+class CapturePrint : public Print
+{
+  public:
+    std::string out;
+    virtual size_t write(uint8_t c) override
+    {
+        out += (char)c;
+        return 1;
+    }
+};
+
+static LogQueue *queue;
+
+void setUp(void)
+{
+    queue = new LogQueue();
+    settingsMap[logoutputlevel] = level_debug;
+    settingsMap[ascii_logs] = true;
+}
+
+void tearDown(void)
+{
+    delete queue;
+}
+
+void test_order_and_drops(void)
+{
+    uint32_t ticket;
+    for (int i = 0; i < LOG_QUEUE_SLOTS + 3; i++) {
+        LogLine *line = queue->reserve(ticket);
+        if (i >= LOG_QUEUE_SLOTS) {
+            TEST_ASSERT_NULL(line);
+            continue;
+        }
+        TEST_ASSERT_NOT_NULL(line);
+        snprintf(line->text, sizeof(line->text), "line %d", i);
+        queue->commit(ticket);
+    }
+    TEST_ASSERT_EQUAL(3, queue->takeDrops());
+    TEST_ASSERT_EQUAL(0, queue->takeDrops());
+
+    // A reserved line only shows up once it is committed
+    TEST_ASSERT_EQUAL_STRING("line 0", queue->peek()->text);
+    queue->pop();
+    uint32_t late;
+    TEST_ASSERT_NOT_NULL(queue->reserve(late));
+    for (int i = 1; i < LOG_QUEUE_SLOTS; i++) {
+        char expected[16];
+        snprintf(expected, sizeof(expected), "line %d", i);
+        TEST_ASSERT_EQUAL_STRING(expected, queue->peek()->text);
+        queue->pop();
+    }
+    TEST_ASSERT_NULL(queue->peek());
+    queue->commit(late);
+    TEST_ASSERT_NOT_NULL(queue->peek());
+}
+
+void test_producers(void)
+{
+    std::atomic<bool> go(false);
+    std::thread producers[NUM_PRODUCERS];
+    for (int p = 0; p < NUM_PRODUCERS; p++) {
+        producers[p] = std::thread([p, &go]() {
+            while (!go)
+                ;
+            for (int i = 0; i < LINES_PER_PRODUCER; i++) {
+                uint32_t ticket;
+                LogLine *line = queue->reserve(ticket);
+                if (line) {
+                    line->millis = i;
+                    line->thread[0] = p;
+                    queue->commit(ticket);
+                }
+            }
+        });
+    }
+
+    // Each producer's lines must come out in order, and every line either comes out or is counted as dropped
+    int last[NUM_PRODUCERS];
+    for (int p = 0; p < NUM_PRODUCERS; p++)
+        last[p] = -1;
+    uint32_t received = 0, dropped = 0;
+    go = true;
+    while (received + dropped < NUM_PRODUCERS * LINES_PER_PRODUCER) {
+        LogLine *line = queue->peek();
+        if (line) {
+            int p = line->thread[0];
+            TEST_ASSERT_GREATER_THAN(last[p], (int)line->millis);
+            last[p] = line->millis;
+            queue->pop();
+            received++;
+        }
+        dropped += queue->takeDrops();
+    }
+    for (auto &t : producers)
+        t.join();
+    TEST_ASSERT_NULL(queue->peek());
+    TEST_ASSERT_EQUAL(0, queue->takeDrops());
+    TEST_ASSERT_GREATER_THAN(0, received);
+}
+
+void test_formatting(void)
+{
+    CapturePrint sink;
+    RedirectablePrint rp(&sink);
+    rp.log(MESHTASTIC_LOG_LEVEL_INFO, "hello %s\tworld\n", "mesh");
+    TEST_ASSERT_TRUE(sink.out.find("INFO  | ") == 0);
+    TEST_ASSERT_TRUE(sink.out.find(" hello mesh#world\n") != std::string::npos);
+
+    // Filtered out before anything gets formatted
+    sink.out.clear();
+    rp.log(MESHTASTIC_LOG_LEVEL_TRACE, "not shown");
+    TEST_ASSERT_EQUAL(0, sink.out.length());
+
+    // Once async only errors go out right away
+    rp.setAsync(true);
+    for (int i = 0; i < LOG_QUEUE_SLOTS + 2; i++)
+        rp.log(MESHTASTIC_LOG_LEVEL_DEBUG, "queued %d", i);
+    TEST_ASSERT_EQUAL(0, sink.out.length());
+    rp.flushLog();
+    TEST_ASSERT_TRUE(sink.out.find("WARN  | ") == 0);
+    TEST_ASSERT_TRUE(sink.out.find("2 log messages dropped") != std::string::npos);
+    char expected[32];
+    snprintf(expected, sizeof(expected), "queued %d\n", LOG_QUEUE_SLOTS - 1);
+    TEST_ASSERT_TRUE(sink.out.find(expected) != std::string::npos);
+    snprintf(expected, sizeof(expected), "queued %d\n", LOG_QUEUE_SLOTS);
+    TEST_ASSERT_TRUE(sink.out.find(expected) == std::string::npos);
+    sink.out.clear();
+    rp.log(MESHTASTIC_LOG_LEVEL_ERROR, "went wrong");
+    TEST_ASSERT_TRUE(sink.out.find("ERROR | ") == 0);
+}
+
+void setup()
+{
+    initializeTestEnvironment();
+    UNITY_BEGIN();
+    RUN_TEST(test_order_and_drops);
+    RUN_TEST(test_producers);
+    RUN_TEST(test_formatting);
+    exit(UNITY_END());
+}
+#else
+void setup()
+{
+    initializeTestEnvironment();
+    LOG_WARN("This test requires ARCH_PORTDUINO");
+    UNITY_BEGIN();
+    UNITY_END();
+}
+#endif
+
+void loop() {}
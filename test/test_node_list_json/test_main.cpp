@@ -0,0 +1,253 @@
+#include "serialization/JSON.h"
+#include "serialization/NodeListJson.h"
+
+#include "TestUtil.h"
+#include <Arduino.h>
+#include <algorithm>
+#include <malloc.h>
+#include <new>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unity.h>
+
+#define NUM_NODES 1000
+
+// Count heap use, to compare the peak of both ways of building the document
+static size_t heapNow, heapPeak;
+
+void *operator new(size_t size)
+{
+    void *p = malloc(size);
+    if (!p)
+        throw std::bad_alloc();
+    heapNow += malloc_usable_size(p);
+    heapPeak = std::max(heapPeak, heapNow);
+    return p;
+}
+
+void operator delete(void *ptr) noexcept
+{
+    if (!ptr)
+        return;
+    heapNow -= malloc_usable_size(ptr);
+    free(ptr);
+}
+
+void operator delete(void *ptr, size_t) noexcept
+{
+    operator delete(ptr);
+}
+
+/// Stands in for the socket
+class StringPrint : public Print
+{
+  public:
+    std::string out;
+    size_t biggestWrite = 0;
+    virtual size_t write(uint8_t c) override
+    {
+        out += (char)c;
+        return 1;
+    }
+    virtual size_t write(const uint8_t *buf, size_t len) override
+    {
+        out.append((const char *)buf, len);
+        biggestWrite = std::max(biggestWrite, len);
+        return len;
+    }
+};
+
+static std::vector<meshtastic_NodeInfoLite> nodes;
+
+static meshtastic_NodeInfoLite makeNode(uint32_t num)
+{
+    meshtastic_NodeInfoLite n = meshtastic_NodeInfoLite_init_default;
+    n.num = num;
+    n.has_user = num % 7 != 0;
+    snprintf(n.user.long_name, sizeof(n.user.long_name), "Node \"%u\" \\ %c", (unsigned)num, 'a' + num % 26);
+    snprintf(n.user.short_name, sizeof(n.user.short_name), "%04x", (unsigned)(num & 0xffff));
+    n.user.macaddr[5] = num & 0xff;
+    n.user.hw_model = (meshtastic_HardwareModel)(num % 50);
+    n.snr = (num % 40) * 0.25f - 5;
+    n.last_heard = 1700000000 + num * 60;
+    n.via_mqtt = num % 3 == 0;
+    if (num % 2) {
+        n.has_position = true;
+        n.position.latitude_i = 520000000 + num * 1234;
+        n.position.longitude_i = -1000000 - num * 4321;
+        n.position.altitude = num % 300;
+    }
+    return n;
+}
+
+/// How handleNodes built the document before, to check nothing changed for existing clients
+static std::string jsonValueDocument()
+{
+    JSONArray nodesArray;
+    for (const meshtastic_NodeInfoLite &n : nodes) {
+        if (!n.has_user)
+            continue;
+        JSONObject node;
+        char id[16];
+        snprintf(id, sizeof(id), "!%08x", n.num);
+        node["id"] = new JSONValue(id);
+        node["snr"] = new JSONValue(n.snr);
+        node["via_mqtt"] = new JSONValue(n.via_mqtt ? "true" : "false");
+        node["last_heard"] = new JSONValue((int)n.last_heard);
+        node["position"] = new JSONValue();
+        if (n.has_position && (n.position.latitude_i != 0 || n.position.longitude_i != 0)) {
+            JSONObject position;
+            position["latitude"] = new JSONValue((float)n.position.latitude_i * 1e-7);
+            position["longitude"] = new JSONValue((float)n.position.longitude_i * 1e-7);
+            position["altitude"] = new JSONValue((int)n.position.altitude);
+            delete node["position"];
+            node["position"] = new JSONValue(position);
+        }
+        node["long_name"] = new JSONValue(n.user.long_name);
+        node["short_name"] = new JSONValue(n.user.short_name);
+        char macStr[18];
+        snprintf(macStr, sizeof(macStr), "%02X:%02X:%02X:%02X:%02X:%02X", n.user.macaddr[0], n.user.macaddr[1],
+                 n.user.macaddr[2], n.user.macaddr[3], n.user.macaddr[4], n.user.macaddr[5]);
+        node["mac_address"] = new JSONValue(macStr);
+        node["hw_model"] = new JSONValue(n.user.hw_model);
+        nodesArray.push_back(new JSONValue(node));
+    }
+    JSONObject jsonObjInner;
+    jsonObjInner["nodes"] = new JSONValue(nodesArray);
+    JSONObject jsonObjOuter;
+    jsonObjOuter["data"] = new JSONValue(jsonObjInner);
+    jsonObjOuter["status"] = new JSONValue("ok");
+    JSONValue *value = new JSONValue(jsonObjOuter);
+    std::string json = value->Stringify();
+    delete value;
+    return json;
+}
+
+static std::string streamedDocument(const NodeListJson::Query &query, StringPrint &out)
+{
+    NodeListJson list(nodes.data(), nodes.size(), query);
+    while (list.writeNext(out, nodes.data(), nodes.size()))
+        ;
+    return out.out;
+}
+
+void setUp(void)
+{
+    nodes.clear();
+    // Not in order of node number, like NodeDB keeps them
+    for (uint32_t i = 0; i < NUM_NODES; i++)
+        nodes.push_back(makeNode(((i * 7919) % NUM_NODES) + 1));
+}
+
+void tearDown(void) {}
+
+void test_same_document(void)
+{
+    // The old document was in NodeDB order, the new one is by node number
+    std::sort(nodes.begin(), nodes.end(),
+              [](const meshtastic_NodeInfoLite &a, const meshtastic_NodeInfoLite &b) { return a.num < b.num; });
+    StringPrint out;
+    TEST_ASSERT_EQUAL_STRING(jsonValueDocument().c_str(), streamedDocument(NodeListJson::Query(), out).c_str());
+    TEST_ASSERT_LESS_THAN(400, out.biggestWrite);
+}
+
+void test_pages(void)
+{
+    NodeListJson::Query query;
+    query.limit = 64;
+    std::vector<bool> seen(NUM_NODES + 1);
+    int pages = 0, total = 0;
+    while (true) {
+        StringPrint out;
+        JSONValue *doc = JSON::Parse(streamedDocument(query, out).c_str());
+        TEST_ASSERT_NOT_NULL(doc);
+        JSONValue *data = doc->Child("data");
+        JSONArray page = data->Child("nodes")->AsArray();
+        TEST_ASSERT_TRUE(page.size() <= query.limit);
+        for (JSONValue *node : page) {
+            uint32_t num = strtoul(node->Child("id")->AsString().c_str() + 1, NULL, 16);
+            TEST_ASSERT_GREATER_THAN(query.cursor, num);
+            TEST_ASSERT_FALSE(seen[num]);
+            seen[num] = true;
+            query.cursor = num;
+            total++;
+        }
+        pages++;
+        bool more = data->HasChild("next_cursor");
+        if (more)
+            TEST_ASSERT_EQUAL((double)query.cursor, data->Child("next_cursor")->AsNumber());
+        delete doc;
+        if (!more)
+            break;
+
+        // NodeDB moves recently heard nodes around, the cursor doesn't care
+        std::rotate(nodes.begin(), nodes.begin() + 17, nodes.end());
+    }
+    // Every node with a user, exactly once
+    TEST_ASSERT_EQUAL(NUM_NODES - NUM_NODES / 7, total);
+    TEST_ASSERT_EQUAL((total + 63) / 64, pages);
+}
+
+void test_filter_and_fields(void)
+{
+    NodeListJson::Query query;
+    query.sinceLastHeard = 1700000000 + 901 * 60;
+    query.fields = NodeListJson::parseFields("id,last_heard,bogus");
+    StringPrint out;
+    JSONValue *doc = JSON::Parse(streamedDocument(query, out).c_str());
+    TEST_ASSERT_NOT_NULL(doc);
+    JSONArray page = doc->Child("data")->Child("nodes")->AsArray();
+    int expected = 0;
+    for (uint32_t num = 901; num <= NUM_NODES; num++)
+        expected += num % 7 != 0;
+    TEST_ASSERT_EQUAL(expected, page.size());
+    for (JSONValue *node : page) {
+        TEST_ASSERT_EQUAL(2, node->AsObject().size());
+        TEST_ASSERT_TRUE(node->Child("last_heard")->AsNumber() >= query.sinceLastHeard);
+    }
+    delete doc;
+
+    TEST_ASSERT_EQUAL(NODE_FIELD_ALL, NodeListJson::parseFields(""));
+    TEST_ASSERT_EQUAL(NODE_FIELD_POSITION | NODE_FIELD_SNR, NodeListJson::parseFields("snr,position"));
+}
+
+void test_peak_heap(void)
+{
+    size_t before = heapNow;
+    heapPeak = heapNow;
+    std::string old = jsonValueDocument();
+    size_t oldPeak = heapPeak - before;
+
+    // What the web server holds, the socket takes the bytes as they come
+    class Discard : public Print
+    {
+      public:
+        size_t bytes = 0;
+        virtual size_t write(uint8_t c) override { return ++bytes, 1; }
+        virtual size_t write(const uint8_t *buf, size_t len) override { return bytes += len, len; }
+    } socket;
+    before = heapNow;
+    heapPeak = heapNow;
+    NodeListJson *list = new NodeListJson(nodes.data(), nodes.size(), NodeListJson::Query());
+    while (list->writeNext(socket, nodes.data(), nodes.size()))
+        ;
+    delete list;
+    size_t streamedPeak = heapPeak - before;
+
+    TEST_ASSERT_EQUAL(old.size(), socket.bytes);
+    TEST_ASSERT_LESS_THAN(oldPeak / 10, streamedPeak);
+}
+
+void setup()
+{
+    initializeTestEnvironment();
+    UNITY_BEGIN();
+    RUN_TEST(test_same_document);
+    RUN_TEST(test_pages);
+    RUN_TEST(test_filter_and_fields);
+    RUN_TEST(test_peak_heap);
+    exit(UNITY_END());
+}
+
+void loop() {}
@@ -0,0 +1,214 @@
+#include "mesh/NodeDBJournal.h"
+
+#include "TestUtil.h"
+#include <Arduino.h>
+#include <pb_encode.h>
+#include <stdio.h>
+#include <string.h>
+#include <unity.h>
+#include <vector>
+
+#define NUM_NODES 1000
+
+static std::vector<meshtastic_NodeInfoLite> nodes;
+static pb_size_t numNodes;
+
+static meshtastic_NodeInfoLite makeNode(NodeNum num, const char *name)
+{
+    meshtastic_NodeInfoLite n = meshtastic_NodeInfoLite_init_default;
+    n.num = num;
+    n.has_user = true;
+    strncpy(n.user.long_name, name, sizeof(n.user.long_name) - 1);
+    strncpy(n.user.short_name, name, 4);
+    n.user.public_key.size = 32;
+    memset(n.user.public_key.bytes, num & 0xff, 32);
+    n.last_heard = 1700000000 + num;
+    n.snr = 5.25f;
+    return n;
+}
+
+/// Stands in for the journal file
+class BufferPrint : public Print
+{
+  public:
+    std::vector<uint8_t> bytes;
+    virtual size_t write(uint8_t c) override
+    {
+        bytes.push_back(c);
+        return 1;
+    }
+    virtual size_t write(const uint8_t *buf, size_t len) override
+    {
+        bytes.insert(bytes.end(), buf, buf + len);
+        return len;
+    }
+};
+
+/// Apply every record in buf, like NodeDBJournal::replay() does with the file
+static size_t replayBuffer(const uint8_t *buf, size_t len)
+{
+    size_t pos = 0;
+    while (pos < len) {
+        size_t recLen = NodeDBJournal::recordLength(buf + pos, len - pos);
+        if (!recLen)
+            break;
+        TEST_ASSERT_TRUE(NodeDBJournal::apply(buf + pos, nodes, numNodes));
+        pos += recLen;
+    }
+    return pos;
+}
+
+void setUp(void)
+{
+    nodes.assign(NUM_NODES, meshtastic_NodeInfoLite_init_default);
+    numNodes = 0;
+    for (NodeNum i = 1; i <= 10; i++)
+        nodes[numNodes++] = makeNode(i, "node");
+}
+
+void tearDown(void) {}
+
+void test_update_and_remove(void)
+{
+    uint8_t buf[4 * NODEDB_JOURNAL_MAX_RECORD];
+    size_t len = 0;
+    len += NodeDBJournal::encodeUpdate(makeNode(3, "renamed"), buf + len, sizeof(buf) - len);
+    len += NodeDBJournal::encodeUpdate(makeNode(42, "new"), buf + len, sizeof(buf) - len);
+    len += NodeDBJournal::encodeRemove(5, buf + len, sizeof(buf) - len);
+
+    TEST_ASSERT_EQUAL(len, replayBuffer(buf, len));
+    TEST_ASSERT_EQUAL(10, numNodes);
+    TEST_ASSERT_EQUAL(3, nodes[2].num);
+    TEST_ASSERT_EQUAL_STRING("renamed", nodes[2].user.long_name);
+    for (pb_size_t i = 0; i < numNodes; i++)
+        TEST_ASSERT_NOT_EQUAL(5, nodes[i].num);
+    TEST_ASSERT_EQUAL(42, nodes[numNodes - 1].num);
+    TEST_ASSERT_EQUAL_STRING("new", nodes[numNodes - 1].user.long_name);
+    TEST_ASSERT_EQUAL(0, nodes[numNodes].num);
+}
+
+void test_torn_record(void)
+{
+    uint8_t buf[2 * NODEDB_JOURNAL_MAX_RECORD];
+    size_t first = NodeDBJournal::encodeUpdate(makeNode(3, "first"), buf, sizeof(buf));
+    size_t len = first + NodeDBJournal::encodeUpdate(makeNode(4, "second"), buf + first, sizeof(buf) - first);
+
+    // Power lost halfway through the second record
+    TEST_ASSERT_EQUAL(first, replayBuffer(buf, len - 5));
+    TEST_ASSERT_EQUAL_STRING("first", nodes[2].user.long_name);
+    TEST_ASSERT_EQUAL_STRING("node", nodes[3].user.long_name);
+
+    // A flipped bit fails the CRC
+    buf[first + 10] ^= 0x04;
+    TEST_ASSERT_EQUAL(0, NodeDBJournal::recordLength(buf + first, len - first));
+}
+
+/// Like NodeDB: close the gap, the nodes after it move down
+static void removeAt(pb_size_t index)
+{
+    for (pb_size_t i = index; i < numNodes - 1; i++)
+        nodes[i] = nodes[i + 1];
+    nodes[--numNodes] = meshtastic_NodeInfoLite_init_default;
+}
+
+void test_evict_and_replay(void)
+{
+    // A full DB, as the last snapshot saved it
+    numNodes = 0;
+    for (NodeNum i = 1; i <= NUM_NODES; i++)
+        nodes[numNodes++] = makeNode(i, "node");
+    std::vector<meshtastic_NodeInfoLite> snapshot = nodes;
+    NodeDBJournal journal;
+
+    // What NodeDB::getOrCreateMeshNode() does for a new node: evict the oldest, journal that, add the new one at the end
+    journal.markRemoved(1);
+    removeAt(0);
+    nodes[numNodes++] = makeNode(5000, "new");
+    journal.markDirty(5000);
+
+    // Node 2 is removed, its place taken, then it is heard again and evicts node 3 to get back in
+    journal.markRemoved(2);
+    removeAt(0);
+    nodes[numNodes++] = makeNode(6000, "other");
+    journal.markDirty(6000);
+    journal.markRemoved(3);
+    removeAt(0);
+    nodes[numNodes++] = makeNode(2, "back");
+    journal.markDirty(2);
+
+    BufferPrint file;
+    bool failed;
+    size_t len = journal.writePending(file, nodes.data(), numNodes, failed);
+    TEST_ASSERT_FALSE(failed);
+    TEST_ASSERT_EQUAL(file.bytes.size(), len);
+
+    std::vector<meshtastic_NodeInfoLite> live = nodes;
+    nodes = snapshot;
+    numNodes = NUM_NODES;
+    TEST_ASSERT_EQUAL(len, replayBuffer(file.bytes.data(), len));
+    TEST_ASSERT_EQUAL(NUM_NODES, numNodes);
+    for (pb_size_t i = 0; i < numNodes; i++)
+        TEST_ASSERT_EQUAL(live[i].num, nodes[i].num);
+    TEST_ASSERT_EQUAL_STRING("back", nodes[numNodes - 1].user.long_name);
+}
+
+void test_bytes_per_hour(void)
+{
+    // 1000 nodes, 60 of them changing their user each hour
+    numNodes = 0;
+    for (NodeNum i = 1; i <= NUM_NODES; i++)
+        nodes[numNodes++] = makeNode(i, "Meshtastic node");
+
+    size_t snapshot = 0;
+    for (pb_size_t i = 0; i < numNodes; i++) {
+        size_t size;
+        TEST_ASSERT_TRUE(pb_get_encoded_size(&size, meshtastic_NodeInfoLite_fields, &nodes[i]));
+        snapshot += size + 3; // tag and length of the repeated field
+    }
+
+    // One change a minute, each seen a few times before the flush writes it
+    class CountingPrint : public Print
+    {
+      public:
+        size_t bytes = 0;
+        virtual size_t write(uint8_t c) override { return ++bytes, 1; }
+        virtual size_t write(const uint8_t *buf, size_t len) override { return bytes += len, len; }
+    } file;
+    NodeDBJournal journal;
+    for (int minute = 0; minute < 60; minute++) {
+        NodeNum changed = nodes[minute * 16].num;
+        for (int i = 0; i < 3; i++) {
+            snprintf(nodes[minute * 16].user.long_name, sizeof(nodes[0].user.long_name), "Renamed %d", i);
+            journal.markDirty(changed);
+        }
+        bool failed;
+        journal.writePending(file, nodes.data(), numNodes, failed);
+        TEST_ASSERT_FALSE(failed);
+    }
+    TEST_ASSERT_EQUAL(file.bytes, journal.getBytesWritten());
+
+    // Before: the whole DB written once a minute at most, then read back to verify
+    size_t before = 60 * 2 * snapshot;
+    // After: the records, plus their share of the snapshot saved each time they pass the compaction limit
+    size_t after = file.bytes + (uint64_t)file.bytes * 2 * snapshot / NODEDB_JOURNAL_MAX_BYTES;
+
+    TEST_ASSERT_LESS_THAN(before / 100, after);
+}
+
+void setup()
+{
+    // NOTE!!! Wait for >2 secs
+    // if board doesn't support software reset via Serial.DTR/RTS
+    delay(10);
+    delay(2000);
+
+    initializeTestEnvironment();
+    UNITY_BEGIN(); // IMPORTANT LINE!
+    RUN_TEST(test_update_and_remove);
+    RUN_TEST(test_torn_record);
+    RUN_TEST(test_evict_and_replay);
+    RUN_TEST(test_bytes_per_hour);
+    exit(UNITY_END()); // stop unit testing
+}
+
+void loop() {}
@@ -0,0 +1,240 @@
+#include "concurrency/OSThread.h"
+
+#include "TestUtil.h"
+#include <Arduino.h>
+#include <unity.h>
+#include <vector>
+
+using namespace concurrency;
+
+static OSThreadController *scheduler;
+static std::vector<int> ran;
+
+class TestThread : public OSThread
+{
+  public:
+    int id;
+    int32_t next;
+    TestThread *victim = NULL;
+    uint32_t busyUs = 0;
+    TestThread *wakeDuringRun = NULL; // like an interrupt that comes in while we run
+
+    TestThread(int _id, uint32_t period, int32_t _next = RUN_SAME)
+        : OSThread("Test", period, scheduler), id(_id), next(_next)
+    {
+    }
+
+  protected:
+    virtual int32_t runOnce() override
+    {
+        ran.push_back(id);
+        if (busyUs)
+            delayMicroseconds(busyUs);
+        if (victim) {
+            delete victim;
+            victim = NULL;
+        }
+        if (wakeDuringRun) {
+            wakeDuringRun->wake();
+            wakeDuringRun = NULL;
+        }
+        return next;
+    }
+};
+
+/// Run the scheduler until it wants to sleep longer than maxDelay, or for at most ms
+static void runFor(uint32_t ms, long maxDelay = 0)
+{
+    uint32_t start = millis();
+    while (millis() - start < ms) {
+        long d = scheduler->runOrDelay();
+        if (d > maxDelay)
+            break;
+        if (d > 0)
+            delay(d);
+    }
+}
+
+void setUp(void)
+{
+    scheduler = new OSThreadController();
+    ran.clear();
+}
+
+void tearDown(void)
+{
+    delete scheduler;
+}
+
+void test_deadline_order(void)
+{
+    TestThread a(1, 30, 100000), b(2, 10, 100000), c(3, 20, 100000);
+    runFor(200, 50);
+    TEST_ASSERT_EQUAL(3, ran.size());
+    TEST_ASSERT_EQUAL(2, ran[0]);
+    TEST_ASSERT_EQUAL(3, ran[1]);
+    TEST_ASSERT_EQUAL(1, ran[2]);
+}
+
+void test_wake(void)
+{
+    TestThread a(1, 0, 100000);
+    scheduler->runOrDelay();
+    TEST_ASSERT_EQUAL(1, ran.size());
+
+    // Sleeping for a long time, until something (an ISR, another task) wakes us
+    long d = scheduler->runOrDelay();
+    TEST_ASSERT_TRUE(d > 0);
+    a.setInterval(0);
+    scheduler->runOrDelay();
+    TEST_ASSERT_EQUAL(2, ran.size());
+
+    a.disable();
+    scheduler->runOrDelay();
+    TEST_ASSERT_EQUAL(2, ran.size());
+    // Nothing left to run, the main loop may sleep until an interrupt
+    TEST_ASSERT_EQUAL(INT32_MAX, scheduler->runOrDelay());
+}
+
+void test_enable(void)
+{
+    TestThread a(1, 0, 10);
+    scheduler->runOrDelay();
+    TEST_ASSERT_EQUAL(1, ran.size());
+
+    // Turned off behind the scheduler's back, it finds out when the thread comes due
+    a.enabled = false;
+    runFor(50, 20);
+    TEST_ASSERT_EQUAL(1, ran.size());
+    TEST_ASSERT_EQUAL(INT32_MAX, scheduler->runOrDelay());
+
+    a.enable();
+    runFor(50, 20);
+    TEST_ASSERT_TRUE(ran.size() >= 2);
+
+    a.disable();
+    scheduler->runOrDelay();
+    size_t runs = ran.size();
+    a.enable();
+    a.setInterval(0);
+    scheduler->runOrDelay();
+    TEST_ASSERT_EQUAL(runs + 1, ran.size());
+}
+
+void test_wake_while_running(void)
+{
+    // Waits for events only
+    TestThread a(1, 0, INT32_MAX);
+    scheduler->runOrDelay();
+    TEST_ASSERT_EQUAL(1, ran.size());
+
+    a.wake();
+    scheduler->runOrDelay();
+    TEST_ASSERT_EQUAL(2, ran.size());
+    // The wake came before runOnce() returned INT32_MAX, it must not be lost
+    a.wakeDuringRun = &a;
+    a.wake();
+    TEST_ASSERT_EQUAL(0, scheduler->runOrDelay());
+    TEST_ASSERT_EQUAL(3, ran.size());
+    scheduler->runOrDelay();
+    TEST_ASSERT_EQUAL(4, ran.size());
+    TEST_ASSERT_TRUE(scheduler->runOrDelay() > 0);
+    TEST_ASSERT_EQUAL(4, ran.size());
+}
+
+void test_delete_while_due(void)
+{
+    TestThread *a = new TestThread(1, 0, 100000);
+    TestThread *b = new TestThread(2, 0, 100000);
+    // Whichever runs first deletes the other
+    a->victim = b;
+    b->victim = a;
+    scheduler->runOrDelay();
+    TEST_ASSERT_EQUAL(1, ran.size());
+    delete (ran[0] == 1 ? a : b);
+    TEST_ASSERT_EQUAL(0, scheduler->size(false));
+}
+
+void test_many_threads(void)
+{
+    std::vector<TestThread *> threads;
+    for (int i = 0; i < 30; i++)
+        threads.push_back(new TestThread(i, 1000 + i * 100, 100000));
+    TestThread fast(100, 0, 5);
+
+    runFor(100, 5);
+    // Only the fast one was due
+    for (auto id : ran)
+        TEST_ASSERT_EQUAL(100, id);
+    TEST_ASSERT_TRUE(ran.size() >= 2);
+
+    for (auto t : threads)
+        delete t;
+}
+
+void test_stats(void)
+{
+    TestThread busy(1, 0, 0), idle(2, 0, 0);
+    busy.busyUs = 3000;
+    runFor(50);
+
+    const OSThreadStats &b = busy.getStats();
+    const OSThreadStats &i = idle.getStats();
+    TEST_ASSERT_TRUE(b.runs > 0);
+    TEST_ASSERT_TRUE(b.maxUs >= 3000);
+    TEST_ASSERT_TRUE(b.totalUs >= 3000ULL * b.runs);
+    TEST_ASSERT_TRUE(i.maxUs < 3000);
+    // The idle thread had to wait for the busy one
+    TEST_ASSERT_TRUE(i.maxLateMs >= 2);
+
+    std::vector<const OSThread *> byRuntime = scheduler->getThreadsByRuntime();
+    TEST_ASSERT_EQUAL(2, byRuntime.size());
+    TEST_ASSERT_TRUE(byRuntime[0] == &busy);
+
+    scheduler->resetStats();
+    TEST_ASSERT_EQUAL(0, busy.getStats().runs);
+    TEST_ASSERT_TRUE(scheduler->getStatsMs() < 10);
+}
+
+void test_wakeups(void)
+{
+    TestThread polled(1, 0, 10), woken(2, 0, INT32_MAX), tagAlong(3, 0, 10);
+    scheduler->runOrDelay();
+    scheduler->resetStats();
+
+    // Woken 10 times in between the runs of one polling every 10 ms, which wakes the CPU about 10 times.  The third thread is
+    // always due in the same passes as the polled one, the two cost one wakeup
+    for (int i = 0; i < 10; i++) {
+        runFor(15, 20);
+        woken.wake();
+        scheduler->runOrDelay();
+    }
+    const OSThreadStats &p = polled.getStats(), &w = woken.getStats(), &t = tagAlong.getStats();
+    TEST_ASSERT_EQUAL(10, w.runs);
+    TEST_ASSERT_EQUAL(0, w.wakeups);
+    TEST_ASSERT_TRUE(p.wakeups + t.wakeups >= 5);
+    TEST_ASSERT_TRUE(p.wakeups + t.wakeups <= p.runs + 1);
+    TEST_ASSERT_TRUE(scheduler->getStatsMs() >= 100);
+}
+
+void setup()
+{
+    // NOTE!!! Wait for >2 secs
+    // if board doesn't support software reset via Serial.DTR/RTS
+    delay(10);
+    delay(2000);
+
+    initializeTestEnvironment();
+    UNITY_BEGIN(); // IMPORTANT LINE!
+    RUN_TEST(test_deadline_order);
+    RUN_TEST(test_wake);
+    RUN_TEST(test_enable);
+    RUN_TEST(test_wake_while_running);
+    RUN_TEST(test_delete_while_due);
+    RUN_TEST(test_many_threads);
+    RUN_TEST(test_stats);
+    RUN_TEST(test_wakeups);
+    exit(UNITY_END()); // stop unit testing
+}
+
+void loop() {}
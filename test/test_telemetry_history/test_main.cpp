@@ -0,0 +1,224 @@
+#include "modules/Telemetry/TelemetryHistory.h"
+
+#include "TestUtil.h"
+#include <Arduino.h>
+#include <pb_encode.h>
+#include <unity.h>
+
+// Radio header and Data wrapper of every packet, not counting the LoRa preamble
+#define PACKET_OVERHEAD 20
+
+static TelemetryHistory *history;
+
+static meshtastic_Telemetry environment(float temperature, float humidity)
+{
+    meshtastic_Telemetry t = meshtastic_Telemetry_init_zero;
+    t.which_variant = meshtastic_Telemetry_environment_metrics_tag;
+    t.variant.environment_metrics.has_temperature = true;
+    t.variant.environment_metrics.temperature = temperature;
+    t.variant.environment_metrics.has_relative_humidity = true;
+    t.variant.environment_metrics.relative_humidity = humidity;
+    return t;
+}
+
+struct DecodedBucket {
+    uint8_t metric;
+    uint32_t number;
+    int32_t min, avg, max;
+};
+
+static uint32_t getVarint(const uint8_t *buf, size_t &pos)
+{
+    uint32_t v = 0;
+    for (int shift = 0;; shift += 7) {
+        uint8_t b = buf[pos++];
+        v |= (uint32_t)(b & 0x7f) << shift;
+        if (!(b & 0x80))
+            return v;
+    }
+}
+
+/// The same as bin/telemetry-history-decode.py
+static int decodeBatch(const uint8_t *buf, size_t len, DecodedBucket *out, int maxOut)
+{
+    TEST_ASSERT_EQUAL(TELEMETRY_HISTORY_VERSION, buf[0]);
+    TEST_ASSERT_EQUAL(TELEMETRY_HISTORY_BATCH, buf[1] & ~TELEMETRY_HISTORY_MORE);
+    size_t pos = 2;
+    TEST_ASSERT_EQUAL(TELEMETRY_HISTORY_BUCKET_SECS, getVarint(buf, pos));
+    int n = 0;
+    while (pos < len) {
+        uint8_t metric = buf[pos++];
+        uint32_t number = getVarint(buf, pos);
+        uint32_t count = getVarint(buf, pos);
+        int32_t avg = 0;
+        for (uint32_t i = 0; i < count; i++) {
+            uint32_t skip = getVarint(buf, pos);
+            number += (skip >> 1) + (i ? 1 : 0);
+            uint32_t z = getVarint(buf, pos);
+            avg += (int32_t)(z >> 1) ^ -(int32_t)(z & 1);
+            TEST_ASSERT_LESS_THAN(maxOut, n);
+            out[n].metric = metric;
+            out[n].number = number;
+            out[n].avg = avg;
+            out[n].min = (skip & 1) ? avg - (int32_t)getVarint(buf, pos) : avg;
+            out[n].max = (skip & 1) ? avg + (int32_t)getVarint(buf, pos) : avg;
+            n++;
+        }
+    }
+    TEST_ASSERT_EQUAL(len, pos);
+    return n;
+}
+
+void setUp(void)
+{
+    history = new TelemetryHistory();
+}
+
+void tearDown(void)
+{
+    delete history;
+}
+
+void test_downsampling(void)
+{
+    const uint32_t start = 1700000000 / TELEMETRY_HISTORY_BUCKET_SECS * TELEMETRY_HISTORY_BUCKET_SECS;
+    // Three samples in the first bucket, one in the second, none in the third, one in the fourth
+    history->record(environment(20.0f, 50.0f), start);
+    history->record(environment(21.0f, 50.0f), start + 60);
+    history->record(environment(22.5f, 50.0f), start + 120);
+    history->record(environment(19.0f, 51.0f), start + TELEMETRY_HISTORY_BUCKET_SECS);
+    history->record(environment(18.0f, 52.0f), start + 3 * TELEMETRY_HISTORY_BUCKET_SECS);
+
+    uint8_t buf[233];
+    uint32_t left;
+    DecodedBucket b[16];
+
+    // The fourth bucket is still open
+    size_t len = history->encodeBatch(buf, sizeof(buf), 0, TELEMETRY_HISTORY_ALL_METRICS, &left,
+                                      start + 3 * TELEMETRY_HISTORY_BUCKET_SECS + 10);
+    TEST_ASSERT_EQUAL(0, left);
+    TEST_ASSERT_EQUAL(4, decodeBatch(buf, len, b, 16));
+    TEST_ASSERT_EQUAL(TELEMETRY_HISTORY_TEMPERATURE, b[0].metric);
+    TEST_ASSERT_EQUAL(start / TELEMETRY_HISTORY_BUCKET_SECS, b[0].number);
+    TEST_ASSERT_EQUAL(2000, b[0].min);
+    TEST_ASSERT_EQUAL(2116, b[0].avg);
+    TEST_ASSERT_EQUAL(2250, b[0].max);
+    TEST_ASSERT_EQUAL(1900, b[1].avg);
+    TEST_ASSERT_EQUAL(b[0].number + 1, b[1].number);
+    TEST_ASSERT_EQUAL(TELEMETRY_HISTORY_RELATIVE_HUMIDITY, b[2].metric);
+    TEST_ASSERT_EQUAL(5000, b[2].avg);
+    TEST_ASSERT_EQUAL(5100, b[3].avg);
+
+    // Once it can't get more samples the fourth bucket goes out too, after the gap
+    len = history->encodeBatch(buf, sizeof(buf), start + TELEMETRY_HISTORY_BUCKET_SECS, 1UL << TELEMETRY_HISTORY_TEMPERATURE,
+                               &left, start + 4 * TELEMETRY_HISTORY_BUCKET_SECS);
+    TEST_ASSERT_EQUAL(2, decodeBatch(buf, len, b, 16));
+    TEST_ASSERT_EQUAL(1900, b[0].avg);
+    TEST_ASSERT_EQUAL(b[0].number + 2, b[1].number);
+    TEST_ASSERT_EQUAL(1800, b[1].avg);
+
+    // Nothing new since then
+    TEST_ASSERT_EQUAL(0, history->encodeBatch(buf, sizeof(buf), start + 4 * TELEMETRY_HISTORY_BUCKET_SECS,
+                                              TELEMETRY_HISTORY_ALL_METRICS, &left, start + 5 * TELEMETRY_HISTORY_BUCKET_SECS));
+}
+
+void test_ring_wraps(void)
+{
+    for (uint32_t i = 0; i < TELEMETRY_HISTORY_BUCKETS + 10; i++)
+        history->record(environment(i, 40), i * TELEMETRY_HISTORY_BUCKET_SECS);
+    TEST_ASSERT_EQUAL(TELEMETRY_HISTORY_BUCKETS, history->numBuckets(TELEMETRY_HISTORY_TEMPERATURE));
+
+    uint8_t buf[233];
+    uint32_t left;
+    DecodedBucket b[TELEMETRY_HISTORY_BUCKETS + 1];
+    size_t len = history->encodeBatch(buf, sizeof(buf), 0, 1UL << TELEMETRY_HISTORY_TEMPERATURE, &left,
+                                      (TELEMETRY_HISTORY_BUCKETS + 10) * TELEMETRY_HISTORY_BUCKET_SECS);
+    // The oldest buckets were overwritten, the last open one counts as closed by now
+    TEST_ASSERT_EQUAL(TELEMETRY_HISTORY_BUCKETS + 1, decodeBatch(buf, len, b, TELEMETRY_HISTORY_BUCKETS + 1));
+    TEST_ASSERT_EQUAL(9, b[0].number);
+    TEST_ASSERT_EQUAL(900, b[0].avg);
+    TEST_ASSERT_EQUAL((TELEMETRY_HISTORY_BUCKETS + 9) * 100, b[TELEMETRY_HISTORY_BUCKETS].avg);
+}
+
+void test_split_batch(void)
+{
+    for (uint32_t i = 0; i < TELEMETRY_HISTORY_BUCKETS; i++)
+        history->record(environment(i * 1.37f, i * 2.1f), i * TELEMETRY_HISTORY_BUCKET_SECS);
+
+    // Only room for one metric, the other one is left for a second batch
+    uint8_t buf[90];
+    uint32_t left;
+    DecodedBucket b[2 * TELEMETRY_HISTORY_BUCKETS];
+    size_t len = history->encodeBatch(buf, sizeof(buf), 0, TELEMETRY_HISTORY_ALL_METRICS, &left,
+                                      TELEMETRY_HISTORY_BUCKETS * TELEMETRY_HISTORY_BUCKET_SECS);
+    TEST_ASSERT_TRUE(buf[1] & TELEMETRY_HISTORY_MORE);
+    TEST_ASSERT_EQUAL(1UL << TELEMETRY_HISTORY_RELATIVE_HUMIDITY, left);
+    TEST_ASSERT_EQUAL(TELEMETRY_HISTORY_BUCKETS, decodeBatch(buf, len, b, 2 * TELEMETRY_HISTORY_BUCKETS));
+
+    len = history->encodeBatch(buf, sizeof(buf), 0, left, &left, TELEMETRY_HISTORY_BUCKETS * TELEMETRY_HISTORY_BUCKET_SECS);
+    TEST_ASSERT_EQUAL(0, left);
+    TEST_ASSERT_EQUAL(TELEMETRY_HISTORY_BUCKETS, decodeBatch(buf, len, b, 2 * TELEMETRY_HISTORY_BUCKETS));
+    TEST_ASSERT_EQUAL(TELEMETRY_HISTORY_RELATIVE_HUMIDITY, b[0].metric);
+}
+
+void test_request(void)
+{
+    uint8_t buf[16];
+    size_t len = TelemetryHistory::encodeRequest(buf, sizeof(buf), 1700000000, 0x30);
+    uint32_t since, metrics;
+    TEST_ASSERT_TRUE(TelemetryHistory::decodeRequest(buf, len, &since, &metrics));
+    TEST_ASSERT_EQUAL(1700000000, since);
+    TEST_ASSERT_EQUAL(0x30, metrics);
+
+    // The mask may be left out
+    TEST_ASSERT_TRUE(TelemetryHistory::decodeRequest(buf, len - 1, &since, &metrics));
+    TEST_ASSERT_EQUAL(TELEMETRY_HISTORY_ALL_METRICS, metrics);
+
+    buf[1] = TELEMETRY_HISTORY_BATCH;
+    TEST_ASSERT_FALSE(TelemetryHistory::decodeRequest(buf, len, &since, &metrics));
+}
+
+void test_airtime_saving(void)
+{
+    // A weather station sampling every 5 minutes for an hour
+    const uint32_t samples = 12;
+    size_t single = 0;
+    for (uint32_t i = 0; i < samples; i++) {
+        meshtastic_Telemetry t = environment(15.0f + i * 0.1f, 60.0f - i * 0.2f);
+        t.time = 1700000000 + i * TELEMETRY_HISTORY_BUCKET_SECS;
+        t.variant.environment_metrics.has_barometric_pressure = true;
+        t.variant.environment_metrics.barometric_pressure = 1013.25f - i * 0.05f;
+        history->record(t, t.time);
+        size_t size;
+        TEST_ASSERT_TRUE(pb_get_encoded_size(&size, meshtastic_Telemetry_fields, &t));
+        single += size + PACKET_OVERHEAD;
+    }
+
+    uint8_t buf[233];
+    uint32_t left;
+    size_t batched = history->encodeBatch(buf, sizeof(buf), 0, TELEMETRY_HISTORY_ALL_METRICS, &left,
+                                          1700000000 + (samples + 1) * TELEMETRY_HISTORY_BUCKET_SECS);
+    TEST_ASSERT_EQUAL(0, left);
+    batched += PACKET_OVERHEAD;
+
+    TEST_ASSERT_LESS_THAN(single / 3, batched);
+}
+
+void setup()
+{
+    // NOTE!!! Wait for >2 secs
+    // if board doesn't support software reset via Serial.DTR/RTS
+    delay(10);
+    delay(2000);
+
+    initializeTestEnvironment();
+    UNITY_BEGIN(); // IMPORTANT LINE!
+    RUN_TEST(test_downsampling);
+    RUN_TEST(test_ring_wraps);
+    RUN_TEST(test_split_batch);
+    RUN_TEST(test_request);
+    RUN_TEST(test_airtime_saving);
+    exit(UNITY_END()); // stop unit testing
+}
+
+void loop() {}
@@ -0,0 +1,286 @@
+#include "NodeDB.h"
+#include "mesh/MeshPacketQueue.h"
+#include "mesh/MeshTypes.h"
+#include "mesh/TxBatch.h"
+
+#include "TestUtil.h"
+#include <stdlib.h>
+#include <unity.h>
+#include <vector>
+
+#define HOURS 24
+#define RUNS 20
+#define GAP_MS 10000 // transmissions closer than this share one active period
+
+static meshtastic_MeshPacket makePacket(NodeNum to, meshtastic_MeshPacket_Priority priority)
+{
+    meshtastic_MeshPacket p = meshtastic_MeshPacket_init_default;
+    p.to = to;
+    p.priority = priority;
+    return p;
+}
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+void test_can_wait(void)
+{
+    TxBatch batch;
+    meshtastic_MeshPacket p = makePacket(NODENUM_BROADCAST, meshtastic_MeshPacket_Priority_BACKGROUND);
+    TEST_ASSERT_TRUE(batch.canWait(&p, true));
+    TEST_ASSERT_FALSE(batch.canWait(&p, false)); // relayed
+
+    p.tx_after = 1234;
+    TEST_ASSERT_FALSE(batch.canWait(&p, true));
+
+    p = makePacket(0x1234, meshtastic_MeshPacket_Priority_BACKGROUND);
+    TEST_ASSERT_FALSE(batch.canWait(&p, true));
+
+    // A text message to the channel may not wait behind telemetry
+    p = makePacket(NODENUM_BROADCAST, meshtastic_MeshPacket_Priority_DEFAULT);
+    TEST_ASSERT_FALSE(batch.canWait(&p, true));
+
+    TxBatch off(0);
+    p = makePacket(NODENUM_BROADCAST, meshtastic_MeshPacket_Priority_BACKGROUND);
+    TEST_ASSERT_FALSE(off.canWait(&p, true));
+}
+
+static int openedHoldMs;
+
+class Listener
+{
+  public:
+    CallbackObserver<Listener, uint32_t> observer = CallbackObserver<Listener, uint32_t>(this, &Listener::onBatch);
+    int onBatch(uint32_t holdMs)
+    {
+        openedHoldMs = holdMs;
+        return 0;
+    }
+};
+
+void test_hold(void)
+{
+    TxBatch batch(2000, 25);
+    Listener listener;
+    listener.observer.observe(&batch.batchOpened);
+    openedHoldMs = 0;
+
+    TEST_ASSERT_EQUAL(0, batch.holdFor(1000));
+    batch.queued(true, 1000);
+    TEST_ASSERT_TRUE(batch.isOpen());
+    TEST_ASSERT_EQUAL(2000, openedHoldMs);
+    TEST_ASSERT_EQUAL(2000, batch.holdFor(1000));
+
+    // Joining doesn't move the end of the hold
+    openedHoldMs = 0;
+    batch.queued(true, 2500);
+    TEST_ASSERT_EQUAL(0, openedHoldMs);
+    TEST_ASSERT_EQUAL(500, batch.holdFor(2500));
+    TEST_ASSERT_EQUAL(0, batch.holdFor(3000));
+
+    TEST_ASSERT_EQUAL(2, batch.close());
+    TEST_ASSERT_FALSE(batch.isOpen());
+    TEST_ASSERT_EQUAL(0, batch.close());
+
+    // Something that can't wait takes the held packets with it
+    batch.queued(true, 10000);
+    batch.queued(false, 10500);
+    TEST_ASSERT_EQUAL(0, batch.holdFor(10500));
+    TEST_ASSERT_EQUAL(1, batch.close());
+
+    TEST_ASSERT_EQUAL(2, batch.getBatches());
+    TEST_ASSERT_EQUAL(3, batch.getBatchedPackets());
+}
+
+void test_relay_queued_first(void)
+{
+    TxBatch batch(2000, 25);
+    MeshPacketQueue queue(16);
+    meshtastic_MeshPacket relay = makePacket(NODENUM_BROADCAST, meshtastic_MeshPacket_Priority_BACKGROUND);
+    relay.from = nodeDB->getNodeNum() + 1;
+    meshtastic_MeshPacket ours = makePacket(NODENUM_BROADCAST, meshtastic_MeshPacket_Priority_BACKGROUND);
+
+    queue.enqueue(&relay);
+    batch.queued(false, 0);
+    queue.enqueue(&ours);
+    batch.queued(true, 1000);
+    TEST_ASSERT_TRUE(batch.isOpen());
+    // The relay was queued before the batch opened, it doesn't wait for it, and ours go along
+    TEST_ASSERT_EQUAL(0, batch.holdFor(1000, queue));
+
+    queue.remove(relay.from, relay.id);
+    TEST_ASSERT_EQUAL(2000, batch.holdFor(1000, queue));
+    TEST_ASSERT_EQUAL(1, batch.close());
+}
+
+void test_abandon(void)
+{
+    TxBatch batch(2000, 25);
+    batch.queued(true, 0);
+    TEST_ASSERT_TRUE(batch.isDue(850000, 900000));
+
+    // Its packets were cancelled: nothing goes out, so nothing may send early to join it
+    batch.abandon();
+    TEST_ASSERT_FALSE(batch.isOpen());
+    TEST_ASSERT_EQUAL(0, batch.holdFor(1000));
+    TEST_ASSERT_FALSE(batch.isDue(850000, 900000));
+    TEST_ASSERT_EQUAL(0, batch.close());
+    TEST_ASSERT_EQUAL(0, batch.getBatches());
+}
+
+void test_is_due(void)
+{
+    TxBatch batch(2000, 25);
+    TEST_ASSERT_TRUE(batch.isDue(900000, 900000));
+    TEST_ASSERT_FALSE(batch.isDue(850000, 900000));
+
+    batch.queued(true, 0);
+    TEST_ASSERT_TRUE(batch.isDue(850000, 900000));
+    TEST_ASSERT_TRUE(batch.isDue(675000, 900000));
+    TEST_ASSERT_FALSE(batch.isDue(674000, 900000));
+    batch.close();
+    TEST_ASSERT_FALSE(batch.isDue(850000, 900000));
+
+    // Batches come every 15 minutes: an hourly broadcast waits for the last one before it is due
+    batch.queued(true, 900000);
+    TEST_ASSERT_FALSE(batch.isDue(2700000, 3600000));
+    TEST_ASSERT_TRUE(batch.isDue(2800000, 3600000));
+    batch.close();
+
+    TxBatch off(0);
+    off.queued(true, 0);
+    TEST_ASSERT_FALSE(off.isDue(850000, 900000));
+}
+
+/// A periodic sender like PositionModule, DeviceTelemetryModule or NodeInfoModule
+struct Sender {
+    uint32_t intervalMs;
+    uint32_t pollMs; // how often runOnce() looks, 0 if it sleeps until due
+    uint32_t lastSend;
+    uint32_t nextRun;
+    bool sent;
+};
+
+class Simulation
+{
+  public:
+    TxBatch batch;
+    std::vector<Sender> senders;
+    bool woken = false;
+    uint32_t queued = 0, lastTx = 0;
+    uint32_t transmissions = 0, activePeriods = 0;
+
+    CallbackObserver<Simulation, uint32_t> observer = CallbackObserver<Simulation, uint32_t>(this, &Simulation::onBatch);
+
+    Simulation(uint32_t holdMs) : batch(holdMs)
+    {
+        observer.observe(&batch.batchOpened);
+        // Default intervals, each starting at a random time after boot
+        senders.push_back({900000, 5000, 0, (uint32_t)(rand() % 900) * 1000, false});
+        senders.push_back({3600000, 60000, 0, (uint32_t)(rand() % 3600) * 1000, false});
+        senders.push_back({10800000, 0, 0, (uint32_t)(rand() % 10800) * 1000, false});
+    }
+
+    int onBatch(uint32_t)
+    {
+        woken = true;
+        return 0;
+    }
+
+    void run(Sender &s, uint32_t now)
+    {
+        uint32_t since = now - s.lastSend;
+        if (!s.sent || batch.isDue(since, s.intervalMs)) {
+            s.sent = true;
+            s.lastSend = now;
+            since = 0;
+            meshtastic_MeshPacket p = makePacket(NODENUM_BROADCAST, meshtastic_MeshPacket_Priority_BACKGROUND);
+            queued++;
+            batch.queued(batch.canWait(&p, true), now);
+        }
+        s.nextRun = now + (s.pollMs ? s.pollMs : s.intervalMs - since);
+    }
+
+    void step(uint32_t now)
+    {
+        for (Sender &s : senders) {
+            if ((int32_t)(now - s.nextRun) >= 0)
+                run(s, now);
+        }
+        while (woken) {
+            woken = false;
+            for (Sender &s : senders) {
+                if (s.sent)
+                    run(s, now);
+            }
+        }
+        if (queued && batch.holdFor(now) == 0) {
+            batch.close();
+            if (!transmissions || now - lastTx > GAP_MS)
+                activePeriods++;
+            transmissions += queued;
+            queued = 0;
+            lastTx = now;
+        }
+    }
+};
+
+static float activePerHour(uint32_t holdMs, float *txPerHour)
+{
+    srand(1);
+    uint32_t periods = 0, tx = 0;
+    for (int i = 0; i < RUNS; i++) {
+        Simulation sim(holdMs);
+        for (uint32_t now = 0; now < HOURS * 3600000UL; now += 100)
+            sim.step(now);
+        periods += sim.activePeriods;
+        tx += sim.transmissions;
+    }
+    *txPerHour = (float)tx / RUNS / HOURS;
+    return (float)periods / RUNS / HOURS;
+}
+
+void test_fewer_active_periods(void)
+{
+    float txAlone, txBatched;
+    float alone = activePerHour(0, &txAlone);
+    float batched = activePerHour(TX_BATCH_HOLD_MS, &txBatched);
+
+    // Sending a little early shouldn't add more than one broadcast in twenty
+    TEST_ASSERT_TRUE(txBatched < txAlone * 1.05f);
+    TEST_ASSERT_TRUE(batched < alone * 0.85f);
+}
+
+void test_hold_for_role(void)
+{
+    TEST_ASSERT_EQUAL(2000, TxBatch::holdMsForRole(meshtastic_Config_DeviceConfig_Role_TRACKER, false, 2000));
+    TEST_ASSERT_EQUAL(2000, TxBatch::holdMsForRole(meshtastic_Config_DeviceConfig_Role_SENSOR, false, 2000));
+    TEST_ASSERT_EQUAL(0, TxBatch::holdMsForRole(meshtastic_Config_DeviceConfig_Role_CLIENT, false, 2000));
+    TEST_ASSERT_EQUAL(2000, TxBatch::holdMsForRole(meshtastic_Config_DeviceConfig_Role_CLIENT, true, 2000));
+    TEST_ASSERT_EQUAL(0, TxBatch::holdMsForRole(meshtastic_Config_DeviceConfig_Role_ROUTER, true, 2000));
+    TEST_ASSERT_EQUAL(0, TxBatch::holdMsForRole(meshtastic_Config_DeviceConfig_Role_REPEATER, true, 2000));
+
+    // Nothing is held once the hold is 0
+    TxBatch batch(2000, 25);
+    batch.setHoldMs(0);
+    meshtastic_MeshPacket p = makePacket(NODENUM_BROADCAST, meshtastic_MeshPacket_Priority_BACKGROUND);
+    TEST_ASSERT_FALSE(batch.canWait(&p, true));
+}
+
+void setup()
+{
+    initializeTestEnvironment();
+    nodeDB = new NodeDB(); // for isFromUs()
+    UNITY_BEGIN();
+    RUN_TEST(test_can_wait);
+    RUN_TEST(test_hold);
+    RUN_TEST(test_relay_queued_first);
+    RUN_TEST(test_abandon);
+    RUN_TEST(test_is_due);
+    RUN_TEST(test_fewer_active_periods);
+    RUN_TEST(test_hold_for_role);
+    exit(UNITY_END());
+}
+
+void loop() {}
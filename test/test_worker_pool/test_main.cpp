@@ -0,0 +1,125 @@
+#include "concurrency/WorkerPool.h"
+#include "serialization/MeshPacketSerializer.h"
+
+#include "TestUtil.h"
+#include <Arduino.h>
+#include <stdio.h>
+#include <string.h>
+#include <unity.h>
+
+#ifdef ARCH_PORTDUINO
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace concurrency;
+
+#define NUM_WORKERS 2
+
+/// Run the main loop until cond holds, or for at most ms
+template <typename F> static bool loopUntil(F cond, uint32_t ms = 2000)
+{
+    uint32_t start = millis();
+    while (millis() - start < ms) {
+        long delayMsec = mainController.runOrDelay();
+        if (cond())
+            return true;
+        mainDelay.delay(std::min(delayMsec, 5L));
+    }
+    return cond();
+}
+
+static meshtastic_MeshPacket textPacket(uint32_t id)
+{
+    meshtastic_MeshPacket p = meshtastic_MeshPacket_init_default;
+    p.id = id;
+    p.from = 0x11223344;
+    p.to = 0xffffffff;
+    p.which_payload_variant = meshtastic_MeshPacket_decoded_tag;
+    p.decoded.portnum = meshtastic_PortNum_TEXT_MESSAGE_APP;
+    snprintf((char *)p.decoded.payload.bytes, sizeof(p.decoded.payload.bytes),
+             "{\"sensor\":\"weather-%u\",\"temperature\":21.5,\"humidity\":48,\"pressure\":1013.2,\"note\":\"hello mesh\"}",
+             (unsigned)id);
+    p.decoded.payload.size = strlen((char *)p.decoded.payload.bytes);
+    return p;
+}
+
+void setUp(void) {}
+
+void tearDown(void)
+{
+    delete workerPool;
+    workerPool = NULL;
+}
+
+void test_inline_without_workers(void)
+{
+    int ran = 0;
+    WorkerPool::submit([&ran]() { ran++; }, [&ran]() { ran *= 10; });
+    TEST_ASSERT_EQUAL(10, ran);
+}
+
+void test_completions_on_main_loop(void)
+{
+    workerPool = new WorkerPool(NUM_WORKERS);
+    const std::thread::id mainId = std::this_thread::get_id();
+    std::atomic<int> workedOffMain(0);
+    int completed = 0, completedOnMain = 0;
+
+    for (int i = 0; i < 100; i++) {
+        WorkerPool::submit(
+            [&workedOffMain, mainId]() {
+                if (std::this_thread::get_id() != mainId)
+                    workedOffMain++;
+            },
+            [&completed, &completedOnMain, mainId]() {
+                completed++;
+                if (std::this_thread::get_id() == mainId)
+                    completedOnMain++;
+            });
+    }
+    TEST_ASSERT_TRUE(loopUntil([&completed]() { return completed == 100; }));
+    TEST_ASSERT_EQUAL(100, workedOffMain.load());
+    TEST_ASSERT_EQUAL(100, completedOnMain);
+}
+
+/// The MQTT JSON job, built on the workers with a copy of the sender and published from the completions
+void test_json_on_workers(void)
+{
+    workerPool = new WorkerPool(NUM_WORKERS);
+    const std::string sender = "!a1b2c3d4";
+    std::vector<std::string> published;
+
+    for (uint32_t i = 0; i < 100; i++) {
+        auto packet = std::make_shared<meshtastic_MeshPacket>(textPacket(i));
+        auto json = std::make_shared<std::string>();
+        WorkerPool::submit(
+            [packet, json, sender]() { *json = MeshPacketSerializer::JsonSerialize(packet.get(), false, sender.c_str()); },
+            [json, &published]() { published.push_back(*json); });
+    }
+    TEST_ASSERT_TRUE(loopUntil([&published]() { return published.size() == 100; }));
+
+    for (const std::string &json : published)
+        TEST_ASSERT_TRUE(json.find("\"sender\":\"!a1b2c3d4\"") != std::string::npos);
+}
+
+void setup()
+{
+    initializeTestEnvironment();
+    UNITY_BEGIN();
+    RUN_TEST(test_inline_without_workers);
+    RUN_TEST(test_completions_on_main_loop);
+    RUN_TEST(test_json_on_workers);
+    exit(UNITY_END());
+}
+#else
+void setup()
+{
+    initializeTestEnvironment();
+    LOG_WARN("This test requires ARCH_PORTDUINO");
+    UNITY_BEGIN();
+    UNITY_END();
+}
+#endif
+
+void loop() {}